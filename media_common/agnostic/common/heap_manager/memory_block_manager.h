@@ -340,6 +340,26 @@ private:
         MemoryBlockInternal *block,
         MemoryBlockInternal::State state);
 
+    //!
+    //! \brief   Gets the size class bin of a free block
+    //! \details Bins are monotonic in size, so the blocks of one bin form a contiguous
+    //!          run within the size sorted free list.
+    //! \param   [in] size
+    //!          Size of the free block
+    //! \return  uint32_t
+    //!          Bin index, larger bins hold larger blocks
+    //!
+    static uint32_t GetFreeBin(uint32_t size);
+
+    //!
+    //! \brief  Gets the largest free block held in a bin smaller than \a bin
+    //! \param  [in] bin
+    //!         Bin index to search below
+    //! \return MemoryBlockInternal*
+    //!         First block of the next non-empty smaller bin, nullptr if there is none
+    //!
+    MemoryBlockInternal *GetFreeBinHeadBelow(uint32_t bin);
+
     //!
     //! \brief  Gets a pool type block from the sorted block pool, if pool is empty allocates a new one
     //!         \see m_sortedBlockList[MemoryBlockInternal::State::pool]
@@ -411,6 +431,10 @@ private:
     static const uint16_t m_heapAlignment = MOS_PAGE_SIZE;
     //! \brief Number of submissions before a refresh, currently fixed
     static const uint16_t m_numSubmissionsForRefresh = 128;
+    //! \brief Number of bins each power of two of free block sizes is split into, as log2
+    static const uint32_t m_freeBinSubdivisionBits = 2;
+    //! \brief Number of size class bins for the free list
+    static const uint32_t m_freeBinCount = 32 << m_freeBinSubdivisionBits;
 
     //! \brief Total size of all managed heaps.
     uint32_t m_totalSizeOfHeaps = 0;
@@ -421,6 +445,14 @@ private:
     //! \brief Pools of memory blocks sorted by their states based on the state indicated
     //!        by the latest TrackerId. The free pool is sorted in ascending order.
     MemoryBlockInternal *m_sortedBlockList[MemoryBlockInternal::State::stateCount] = {nullptr};
+    //! \brief   Largest free block of each size class bin. \see GetFreeBin
+    //! \details Used as the starting point when inserting into the free list, so
+    //!          insertion only walks the blocks of a single bin.
+    MemoryBlockInternal *m_freeBinHead[m_freeBinCount] = {nullptr};
+    //! \brief Bitmask of the non-empty size class bins
+    uint64_t m_freeBinMask[m_freeBinCount / 64] = {0};
+    //! \brief Last (smallest) block of the free list
+    MemoryBlockInternal *m_freeListTail = nullptr;
     //! \brief Number of entries in each sorted block list.
     uint32_t m_sortedBlockListNumEntries[MemoryBlockInternal::State::stateCount] = {0};
     //! \brief Sizes of each block pool.
@@ -441,6 +473,8 @@ private:
     
     //! \brief Persistent storage for the sorted sizes used during AcquireSpace()
     std::list<SortedSizePair> m_sortedSizes;
+    //! \brief Sizes of the largest free blocks while a request is checked, \see IsSpaceAvailable
+    std::vector<uint32_t> m_largestFreeSizes;
     //! \brief TrackerProducer
     FrameTrackerProducer *m_trackerProducer = nullptr;
     //! \bried Whether trackerProducer is set
@@ -157,6 +157,15 @@ public:
         bool isForReport = false,
         uint32_t option = MEDIA_USER_SETTING_INTERNAL);
 
+    //!
+    //! \brief    Re-read all declared items from registry and environment
+    //! \details  Internal reads are cached in a snapshot after the first read,
+    //!           later registry or environment changes are only seen after refresh
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if no error, otherwise will return failed reason
+    //!
+    virtual MOS_STATUS Refresh();
+
     //!
     //! \brief    Check whether the key has been registered 
     //! \param    [in] valueName
@@ -27,7 +27,11 @@
 #ifndef __MEDIA_USER_SETTING_CONFIGURE__H__
 #define __MEDIA_USER_SETTING_CONFIGURE__H__
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "media_user_setting_definition.h"
 #include "mos_utilities.h"
 
@@ -134,6 +138,17 @@ public:
         bool isForReport,
         uint32_t option = MEDIA_USER_SETTING_INTERNAL);
 
+    //!
+    //! \brief    Rebuild the read snapshot from the registry and environment
+    //! \details  Internal reads are served from an immutable snapshot taken the
+    //!           first time a declared item is read. Call this to pick up registry
+    //!           or environment changes made after that. Readers keep using the
+    //!           previous snapshot until the new one is published.
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if no error, otherwise will return failed reason
+    //!
+    MOS_STATUS RefreshSnapshot();
+
     //!
     //! \brief    Get the report path of the key
     //! \return   std::string
@@ -214,6 +229,71 @@ protected:
 
     const uint32_t GetRegAccessDataType(MOS_USER_FEATURE_VALUE_TYPE type);
 
+    //!
+    //! \brief    Resolved internal read of one item
+    //!
+    struct SnapshotItem
+    {
+        std::shared_ptr<Definition> def;
+        UFKEY_NEXT                  key;     //!< registry key the value was read from
+        MOS_STATUS                  status;  //!< registry/environment read status
+        Value                       value;   //!< value read when status is success
+    };
+
+    //!
+    //! \brief    Immutable layer of resolved reads, keyed by group and item name hash
+    //! \details  A layer holds the items resolved since its parent was published
+    //!           and shadows the parent's copies. A new layer absorbs parents no
+    //!           more than twice its size, so chains stay logarithmic in length.
+    //!
+    struct Snapshot
+    {
+        std::unordered_map<size_t, SnapshotItem> items[Group::MaxCount];
+        const Snapshot                          *parent = nullptr;
+        size_t                                   size   = 0;
+    };
+
+    //!
+    //! \brief    Read item from registry, then from environment variable
+    //! \details  Caller must hold m_mutexLock
+    //!
+    MOS_STATUS ReadItem(
+        std::shared_ptr<Definition> def,
+        const std::string &valueName,
+        uint32_t option,
+        Value &value,
+        UFKEY_NEXT &key);
+
+    //!
+    //! \brief    Get the current read snapshot, resolving items registered since it was built
+    //!
+    const Snapshot *GetSnapshot();
+
+    //!
+    //! \brief    Find the newest resolved read of an item in a snapshot chain
+    //!
+    static const SnapshotItem *FindSnapshotItem(const Snapshot *snapshot, const Group &group, size_t hash);
+
+    //!
+    //! \brief    Resolve items into a new snapshot layer
+    //! \param    [in] full
+    //!           Re-read every item if true, otherwise only items registered since the last update
+    //!
+    void UpdateSnapshot(bool full);
+
+    //!
+    //! \brief    Publish a snapshot layer on top of the current one
+    //! \details  Caller must hold m_mutexLock. Replaced layers are kept until
+    //!           teardown, since lock-free readers may still walk them.
+    //!
+    void PublishSnapshot(Snapshot *layer);
+
+    //!
+    //! \brief    Re-resolve one item if it was read from key
+    //! \details  Caller must hold m_mutexLock
+    //!
+    void RefreshSnapshotItem(const Group &group, size_t hash, const UFKEY_NEXT &key);
+
 protected:
     MosMutex m_mutexLock; //!< mutex for protecting definitions
     Definitions m_definitions[Group::MaxCount]{}; //!< definitions of media user setting
@@ -227,6 +307,10 @@ protected:
     static const std::map<uint32_t, ExtPathCFG> m_pathOption;
     std::string                                 m_statedConfigPath = "";
     std::string                                 m_statedReportPath = "";
+    std::atomic<const Snapshot *>               m_snapshot{nullptr};         //!< newest snapshot layer, read without locking
+    std::vector<std::unique_ptr<Snapshot>>      m_snapshots;                 //!< every published layer, freed at teardown
+    std::vector<std::pair<Group, size_t>>       m_pendingItems;              //!< items registered since the last snapshot update
+    std::atomic<bool>                           m_snapshotStale{true};       //!< m_pendingItems is not empty
 };
 }
 }
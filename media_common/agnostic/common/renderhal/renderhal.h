@@ -98,6 +98,9 @@ class XRenderHal_Platform_Interface;
 #define RENDERHAL_KERNEL_ALLOCATION_LOADING 4   // Kernel selected to be loaded (was stale or used)
 #define RENDERHAL_KERNEL_ALLOCATION_STALE   5   // Kernel memory block became invalid, needs to be reloaded
 
+#define RENDERHAL_KERNEL_LOOKUP_BITS        8   // Kernel lookup table, direct mapped by (iKUID, iKCID)
+#define RENDERHAL_KERNEL_LOOKUP_SIZE        (1 << RENDERHAL_KERNEL_LOOKUP_BITS)
+
 //!
 //! \brief  SSH defaults and limits
 //!
@@ -959,6 +962,7 @@ typedef struct _RENDERHAL_STATE_HEAP
 
     // Arrays created dynamically
     PRENDERHAL_KRN_ALLOCATION   pKernelAllocation;                              // Kernel allocation table (or linked list)
+    int32_t                 iKernelLookup[RENDERHAL_KERNEL_LOOKUP_SIZE];        // Kernel allocation index + 1 by (iKUID, iKCID) hash, 0 if empty; a hint, validated against the table
 
     // Dynamic Kernel States
     PMHW_MEMORY_POOL               pKernelAllocMemPool;                         // Kernel states memory pool (mallocs)
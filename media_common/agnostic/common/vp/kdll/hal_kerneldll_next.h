@@ -82,6 +82,14 @@
 
 #define DL_CHROMASITING_DISABLE -1  // Chromasiting is disabled
 
+#define DL_RULE_INDEX_SIZE 256  // Number of entries in the hashed rule lookup (power of 2)
+
+#define DL_DISK_CACHE_MAGIC 0x4C4C444B        // 'KDLL' - combined kernel disk cache record
+#define DL_DISK_CACHE_VERSION 1               // Disk cache record layout version
+#define DL_DISK_CACHE_MAX_SIZE (16 * 1024 * 1024)  // Max size of the disk cache file
+#define DL_DISK_CACHE_MIN_ALLOC_SIZE (64 * 1024)   // Initial size of the in-process disk cache
+#define DL_DISK_CACHE_MIN_INDEX_SIZE 64            // Initial size of the disk cache index (power of 2)
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -690,6 +698,65 @@ typedef struct tagKdll_KernelHashTable
     Kdll_KernelHashEntry HashEntry[DL_MAX_COMBINED_KERNELS];  // Hash table entries
 } Kdll_KernelHashTable;
 
+//--------------------------------------------------------------
+// Rule lookup index (search state -> matching rule set)
+//--------------------------------------------------------------
+typedef struct tagKdll_RuleIndexKey
+{
+    Kdll_ParserState state;                // Parser state
+    VPHAL_CSPACE     cspace;               // Destination color space
+    Kdll_FilterEntry filter;               // Current filter entry
+    int32_t          chromasiting;         // Chromasiting of the first filter entry
+    Kdll_Shuffling   ShuffleSamplerData;   // Shuffle sampler output
+    bool             bRTRotate;            // RT rotate
+    bool             bProcamp;             // Procamp
+    bool             bCscBeforeMix;        // CSC before Mix
+    bool             b64BSaveEnabled;      // 64B save kernel
+    int32_t          quadrant;             // Current quadrant
+    int32_t          layer_number;         // Current layer number
+    MOS_FORMAT       src0_format;          // Src0 source format
+    Kdll_Sampling    src0_sampling;        // Src0 sampling mode
+    int32_t          src0_colorfill;       // Src0 colorfill flag
+    int32_t          src0_lumakey;         // Src0 luma key
+    Kdll_CoeffID     src0_coeff;           // Src0 CSC coefficients
+    Kdll_Processing  src0_process;         // Src0 processing mode
+    VPHAL_ROTATION   src0_rotation;        // Src0 rotation
+    MOS_FORMAT       src1_format;          // Src1 source format
+    Kdll_Sampling    src1_sampling;        // Src1 sampling mode
+    int32_t          src1_lumakey;         // Src1 luma key
+    int32_t          src1_samplerlumakey;  // Src1 sampler luma key
+    Kdll_CoeffID     src1_coeff;           // Src1 CSC coefficients
+    Kdll_Processing  src1_process;         // Src1 processing mode
+    MOS_FORMAT       target_format;        // Render Target format
+    MOS_TILE_TYPE    target_tiletype;      // Render Target Tile Type
+} Kdll_RuleIndexKey;
+
+typedef struct tagKdll_RuleIndexEntry
+{
+    uint32_t           dwHash;    // 32-bit hash of the key (FNV-1a hash)
+    Kdll_RuleIndexKey  Key;       // Search state that produced the match
+    Kdll_RuleEntrySet *pRuleSet;  // Matching rule set (nullptr = empty entry)
+} Kdll_RuleIndexEntry;
+
+//--------------------------------------------------------------
+// Combined kernel disk cache record
+//   Header is followed by the search filter, the modified filter,
+//   CSC parameters, component kernel ids and the kernel binary.
+//--------------------------------------------------------------
+typedef struct tagKdll_DiskCacheHeader
+{
+    uint32_t     dwMagic;           // DL_DISK_CACHE_MAGIC
+    uint32_t     dwVersion;         // DL_DISK_CACHE_VERSION
+    uint32_t     dwBinaryHash;      // Hash of component kernels/rules used to build the kernel
+    uint32_t     dwHash;            // 32-bit hash of the search filter (FNV-1a hash)
+    int32_t      iFilterSize;       // Search filter size
+    int32_t      iOutFilterSize;    // Modified filter size
+    int32_t      iKernelCount;      // Number of component kernels
+    int32_t      iKernelSize;       // Combined kernel size
+    VPHAL_CSPACE colorfill_cspace;  // Intermediate color space for colorfill
+    uint32_t     dwChecksum;        // Checksum of the record payload (FNV-1a hash)
+} Kdll_DiskCacheHeader;
+
 //--------------------------------------------------------------
 // Dynamic linking state
 //--------------------------------------------------------------
@@ -729,6 +796,19 @@ typedef struct tagKdll_State
     // Colorfill
     VPHAL_CSPACE colorfill_cspace;  // Selected colorfill Color Space by Kdll
 
+    // Hashed rule lookup
+    Kdll_RuleIndexEntry RuleIndex[DL_RULE_INDEX_SIZE];  // Rule sets matched by previous searches
+
+    // Persistent combined kernel cache
+    char *    pcDiskCacheFile;       // Disk cache file name (nullptr if disabled)
+    uint8_t * pDiskCache;            // Validated disk cache records of the current binary
+    uint32_t  dwDiskCacheSize;       // Size of the validated records
+    uint32_t  dwDiskCacheAllocSize;  // Allocated size of pDiskCache
+    uint32_t *pDiskCacheIndex;       // Record offsets + 1 hashed by dwHash (0 = empty slot)
+    uint32_t  dwDiskCacheIndexSize;  // Number of index slots (power of 2)
+    uint32_t  dwDiskCacheCount;      // Number of indexed records
+    uint32_t  dwBinaryHash;          // Hash of component kernels and rules
+
     // Start kernel search
     void (*pfnStartKernelSearch)(PKdll_State pState,
         PKdll_SearchState                    pSearchState,
@@ -928,6 +1008,24 @@ Kdll_State *KernelDll_AllocateStates(
 // Release Kernel Dll State
 void KernelDll_ReleaseStates(Kdll_State *pState);
 
+// Load combined kernels persisted by previous processes
+bool KernelDll_LoadDiskCache(Kdll_State *pState,
+                             const char *pcFileName);
+
+// Find combined kernel in disk cache, setup search state for KernelDll_AddKernel
+bool KernelDll_GetDiskCachedKernel(Kdll_State       *pState,
+                                   Kdll_SearchState *pSearchState,
+                                   Kdll_FilterEntry *pFilter,
+                                   int               iFilterSize,
+                                   uint32_t          dwHash);
+
+// Persist combined kernel in disk cache
+bool KernelDll_StoreDiskCachedKernel(Kdll_State       *pState,
+                                     Kdll_SearchState *pSearchState,
+                                     Kdll_FilterEntry *pFilter,
+                                     int               iFilterSize,
+                                     uint32_t          dwHash);
+
 // Update CSC coefficients
 void KernelDll_UpdateCscCoefficients(Kdll_State *pState,
     Kdll_CSC_Matrix *                            pMatrix);
@@ -1445,31 +1445,31 @@ static VAStatus DdiMedia_HeapDestroy(
 {
     DDI_CHK_NULL(mediaCtx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
     // destroy heaps
-    MOS_FreeMemory(mediaCtx->pSurfaceHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pSurfaceHeap);
     MOS_FreeMemory(mediaCtx->pSurfaceHeap);
 
-    MOS_FreeMemory(mediaCtx->pBufferHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pBufferHeap);
     MOS_FreeMemory(mediaCtx->pBufferHeap);
 
-    MOS_FreeMemory(mediaCtx->pImageHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pImageHeap);
     MOS_FreeMemory(mediaCtx->pImageHeap);
 
-    MOS_FreeMemory(mediaCtx->pDecoderCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pDecoderCtxHeap);
     MOS_FreeMemory(mediaCtx->pDecoderCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pEncoderCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pEncoderCtxHeap);
     MOS_FreeMemory(mediaCtx->pEncoderCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pVpCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pVpCtxHeap);
     MOS_FreeMemory(mediaCtx->pVpCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pProtCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pProtCtxHeap);
     MOS_FreeMemory(mediaCtx->pProtCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pCmCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pCmCtxHeap);
     MOS_FreeMemory(mediaCtx->pCmCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pMfeCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pMfeCtxHeap);
     MOS_FreeMemory(mediaCtx->pMfeCtxHeap);
     // destroy the mutexs
     DdiMediaUtil_DestroyMutex(&mediaCtx->SurfaceMutex);
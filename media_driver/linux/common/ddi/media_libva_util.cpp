@@ -1621,24 +1621,21 @@ PDDI_MEDIA_SURFACE_HEAP_ELEMENT DdiMediaUtil_AllocPMediaSurfaceFromHeap(PDDI_MED
 
     if (nullptr == surfaceHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(surfaceHeap->pHeapBase, (surfaceHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
-
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = surfaceHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(surfaceHeap, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        surfaceHeap->pHeapBase                    = newHeapBase;
-        PDDI_MEDIA_SURFACE_HEAP_ELEMENT surfaceHeapBase  = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pHeapBase;
-        surfaceHeap->pFirstFreeHeapElement        = (void*)(&surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT surfaceHeapBase = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pHeapBase;
+        surfaceHeap->pFirstFreeHeapElement              = (void*)(&surfaceHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            mediaSurfaceHeapElmt                  = &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i];
-            mediaSurfaceHeapElmt->pNextFree       = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i + 1];
-            mediaSurfaceHeapElmt->uiVaSurfaceID   = surfaceHeap->uiAllocatedHeapElements + i;
-            mediaSurfaceHeapElmt->pSurface        = nullptr;
+            mediaSurfaceHeapElmt                = &surfaceHeapBase[firstNewElement + i];
+            mediaSurfaceHeapElmt->pNextFree     = (i == (newElements - 1)) ? nullptr : &surfaceHeapBase[firstNewElement + i + 1];
+            mediaSurfaceHeapElmt->uiVaSurfaceID = firstNewElement + i;
         }
-        surfaceHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     mediaSurfaceHeapElmt                          = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pFirstFreeHeapElement;
@@ -1672,22 +1669,21 @@ PDDI_MEDIA_BUFFER_HEAP_ELEMENT DdiMediaUtil_AllocPMediaBufferFromHeap(PDDI_MEDIA
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT  mediaBufferHeapElmt = nullptr;
     if (nullptr == bufferHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(bufferHeap->pHeapBase, (bufferHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = bufferHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(bufferHeap, sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        bufferHeap->pHeapBase                                 = newHeapBase;
-        PDDI_MEDIA_BUFFER_HEAP_ELEMENT mediaBufferHeapBase    = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pHeapBase;
-        bufferHeap->pFirstFreeHeapElement     = (void*)(&mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_BUFFER_HEAP_ELEMENT mediaBufferHeapBase = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pHeapBase;
+        bufferHeap->pFirstFreeHeapElement                  = (void*)(&mediaBufferHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            mediaBufferHeapElmt               = &mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements + i];
-            mediaBufferHeapElmt->pNextFree    = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements + i + 1];
-            mediaBufferHeapElmt->uiVaBufferID = bufferHeap->uiAllocatedHeapElements + i;
+            mediaBufferHeapElmt               = &mediaBufferHeapBase[firstNewElement + i];
+            mediaBufferHeapElmt->pNextFree    = (i == (newElements - 1)) ? nullptr : &mediaBufferHeapBase[firstNewElement + i + 1];
+            mediaBufferHeapElmt->uiVaBufferID = firstNewElement + i;
         }
-        bufferHeap->uiAllocatedHeapElements  += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     mediaBufferHeapElmt                       = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pFirstFreeHeapElement;
@@ -1718,24 +1714,21 @@ PDDI_MEDIA_IMAGE_HEAP_ELEMENT DdiMediaUtil_AllocPVAImageFromHeap(PDDI_MEDIA_HEAP
 
     if (nullptr == imageHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(imageHeap->pHeapBase, (imageHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
-
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = imageHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(imageHeap, sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        imageHeap->pHeapBase                           = newHeapBase;
-        PDDI_MEDIA_IMAGE_HEAP_ELEMENT vaimageHeapBase  = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pHeapBase;
-        imageHeap->pFirstFreeHeapElement               = (void*)(&vaimageHeapBase[imageHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_IMAGE_HEAP_ELEMENT vaimageHeapBase = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pHeapBase;
+        imageHeap->pFirstFreeHeapElement              = (void*)(&vaimageHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            vaimageHeapElmt                   = &vaimageHeapBase[imageHeap->uiAllocatedHeapElements + i];
-            vaimageHeapElmt->pNextFree        = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &vaimageHeapBase[imageHeap->uiAllocatedHeapElements + i + 1];
-            vaimageHeapElmt->uiVaImageID      = imageHeap->uiAllocatedHeapElements + i;
+            vaimageHeapElmt              = &vaimageHeapBase[firstNewElement + i];
+            vaimageHeapElmt->pNextFree   = (i == (newElements - 1)) ? nullptr : &vaimageHeapBase[firstNewElement + i + 1];
+            vaimageHeapElmt->uiVaImageID = firstNewElement + i;
         }
-        imageHeap->uiAllocatedHeapElements   += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
-
     }
 
     vaimageHeapElmt                           = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pFirstFreeHeapElement;
@@ -1769,24 +1762,21 @@ PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT DdiMediaUtil_AllocPVAContextFromHeap(PDDI_MEDI
 
     if (nullptr == vaContextHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(vaContextHeap->pHeapBase, (vaContextHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
-
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = vaContextHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(vaContextHeap, sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        vaContextHeap->pHeapBase                            = newHeapBase;
         PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT vacontextHeapBase = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)vaContextHeap->pHeapBase;
-        vaContextHeap->pFirstFreeHeapElement        = (void*)(&(vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements]));
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        vaContextHeap->pFirstFreeHeapElement                = (void*)(&vacontextHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            vacontextHeapElmt                       = &vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements + i];
-            vacontextHeapElmt->pNextFree            = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements + i + 1];
-            vacontextHeapElmt->uiVaContextID        = vaContextHeap->uiAllocatedHeapElements + i;
-            vacontextHeapElmt->pVaContext           = nullptr;
+            vacontextHeapElmt                = &vacontextHeapBase[firstNewElement + i];
+            vacontextHeapElmt->pNextFree     = (i == (newElements - 1)) ? nullptr : &vacontextHeapBase[firstNewElement + i + 1];
+            vacontextHeapElmt->uiVaContextID = firstNewElement + i;
         }
-        vaContextHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     vacontextHeapElmt                               = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)vaContextHeap->pFirstFreeHeapElement;
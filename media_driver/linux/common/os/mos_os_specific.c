@@ -5770,6 +5770,28 @@ finish:
     return eStatus;
 }
 
+//!
+//! \brief    Checks if GPU work submitted on a resource is still pending
+//! \details  Does not wait, a lock of an idle resource does not block
+//! \param    PMOS_INTERFACE pOsInterface
+//!           [in] Pointer to OS Interface
+//! \param    PMOS_RESOURCE pOsResource
+//!           [in] Pointer to OS Resource
+//! \return   bool
+//!           Return true if the resource is busy or unknown, false if idle
+//!
+bool Mos_Specific_IsResourceBusy(
+    PMOS_INTERFACE              pOsInterface,
+    PMOS_RESOURCE               pOsResource)
+{
+    if (pOsResource == nullptr || pOsResource->bo == nullptr)
+    {
+        return true;
+    }
+
+    return mos_bo_busy(pOsResource->bo) != 0;
+}
+
 //!
 //! \brief    Gets the HW rendering flags
 //! \details  Gets the HW rendering flags
@@ -7139,6 +7161,7 @@ MOS_STATUS Mos_Specific_InitInterface(
     pOsInterface->pfnCachePolicyGetMemoryObject             = Mos_Specific_CachePolicyGetMemoryObject;
     pOsInterface->pfnCachePolicyGetL1Config                 = Mos_Specific_CachePolicyGetL1Config;
     pOsInterface->pfnSkipResourceSync                       = Mos_Specific_SkipResourceSync;
+    pOsInterface->pfnIsResourceBusy                         = Mos_Specific_IsResourceBusy;
     pOsInterface->pfnIsGPUHung                              = Mos_Specific_IsGPUHung;
     pOsInterface->pfnGetAuxTableBaseAddr                    = Mos_Specific_GetAuxTableBaseAddr;
     pOsInterface->pfnSetSliceCount                          = Mos_Specific_SetSliceCount;
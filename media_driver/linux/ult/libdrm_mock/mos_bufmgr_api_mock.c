@@ -376,6 +376,12 @@ mos_bo_is_softpin(struct mos_linux_bo *bo)
     return bo->bufmgr->bo_is_softpin(bo);
 }
 
+drm_export bool
+mos_bo_is_mapped_wc(struct mos_linux_bo *bo)
+{
+    return false;
+}
+
 int
 mos_bo_map_gtt(struct mos_linux_bo *bo)
 {
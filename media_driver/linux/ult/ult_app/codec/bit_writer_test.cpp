@@ -0,0 +1,399 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <climits>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "bit_writer.h"
+
+using namespace std;
+using namespace encode;
+
+static const uint32_t GUARD_SIZE = 16;
+static const uint8_t  GUARD_BYTE = 0xA5;
+
+class BitWriterTest : public testing::Test
+{
+public:
+    //! Bit at a time reference writer, ue/se follow the H.264 spec definition
+    class RefWriter
+    {
+    public:
+        void PutBits(uint32_t n, uint64_t v)
+        {
+            for (uint32_t i = n; i > 0; i--)
+            {
+                m_bits.push_back((uint8_t)((v >> (i - 1)) & 1));
+            }
+        }
+
+        void PutUE(uint64_t codeNum)
+        {
+            uint32_t len = 0;
+            while (((codeNum + 1) >> len) > 1)
+            {
+                len++;
+            }
+            PutBits(len, 0);
+            PutBits(len + 1, codeNum + 1);
+        }
+
+        void PutSE(int32_t v)
+        {
+            PutUE(v > 0 ? 2 * (uint64_t)v - 1 : 2 * (uint64_t)(-(int64_t)v));
+        }
+
+        void PutTrailingBits()
+        {
+            PutBits(1, 1);
+            while (m_bits.size() % 8)
+            {
+                m_bits.push_back(0);
+            }
+        }
+
+        vector<uint8_t> Bytes() const
+        {
+            vector<uint8_t> bytes((m_bits.size() + 7) / 8, 0);
+            for (size_t i = 0; i < m_bits.size(); i++)
+            {
+                bytes[i / 8] |= m_bits[i] << (7 - i % 8);
+            }
+            return bytes;
+        }
+
+        size_t BitCount() const { return m_bits.size(); }
+
+        vector<uint8_t> m_bits;
+    };
+
+    //! Backing storage of size bytes followed by guard bytes the writer must never touch
+    vector<uint8_t> MakeBuffer(uint32_t size, uint8_t first = 0)
+    {
+        vector<uint8_t> buf(size + GUARD_SIZE, GUARD_BYTE);
+        if (size)
+        {
+            buf[0] = first;
+        }
+        return buf;
+    }
+
+    RefWriter MakeRef(uint8_t first, uint32_t bitOffset)
+    {
+        RefWriter ref;
+        ref.PutBits(bitOffset, first >> (8 - bitOffset));
+        return ref;
+    }
+
+    void CheckBuffer(const vector<uint8_t> &buf, uint32_t size, const BitWriter &bw, const RefWriter &ref)
+    {
+        vector<uint8_t> expected = ref.Bytes();
+        bool            overflow = ref.BitCount() > (size_t)size * 8;
+        size_t          checked  = overflow ? size : expected.size();
+
+        EXPECT_EQ(overflow, bw.IsOverflow());
+        for (size_t i = 0; i < checked; i++)
+        {
+            EXPECT_EQ(expected[i], buf[i]) << "byte " << i;
+        }
+        for (uint32_t i = 0; i < GUARD_SIZE; i++)
+        {
+            EXPECT_EQ(GUARD_BYTE, buf[size + i]) << "guard byte " << i;
+        }
+        if (!overflow)
+        {
+            EXPECT_EQ(buf.data() + ref.BitCount() / 8, bw.GetCurrent());
+            EXPECT_EQ(ref.BitCount() % 8, bw.GetBitOffset());
+        }
+    }
+
+    //! Reads the first bitCount bits of buf as a string of '0' and '1'
+    static string ToBitString(const vector<uint8_t> &buf, size_t bitCount)
+    {
+        string s;
+        for (size_t i = 0; i < bitCount; i++)
+        {
+            s += ((buf[i / 8] >> (7 - i % 8)) & 1) ? '1' : '0';
+        }
+        return s;
+    }
+};
+
+TEST_F(BitWriterTest, PutBits)
+{
+    vector<uint8_t> buf = MakeBuffer(32);
+    BitWriter       bw(buf.data(), 32);
+
+    bw.PutBits(3, 0x5);
+    bw.PutBits(5, 0x13);
+    EXPECT_EQ(0xB3, buf[0]);
+
+    // Bits above n are ignored
+    bw.PutBits(4, 0xFFF0);
+    bw.PutBits(0, 0xFFFFFFFF);
+    bw.PutBit(3);
+    EXPECT_EQ(0x08, buf[1]);
+    EXPECT_EQ(5u, bw.GetBitOffset());
+
+    bw.PutBits(32, 0x89ABCDEF);
+    bw.PutBits(3, 0);
+    EXPECT_EQ(0x0C, buf[1]);
+    EXPECT_EQ(0x4D, buf[2]);
+    EXPECT_EQ(0x5E, buf[3]);
+    EXPECT_EQ(0x6F, buf[4]);
+    EXPECT_EQ(0x78, buf[5]);
+    EXPECT_EQ(buf.data() + 6, bw.GetCurrent());
+    EXPECT_EQ(0u, bw.GetBitOffset());
+    EXPECT_FALSE(bw.IsOverflow());
+}
+
+TEST_F(BitWriterTest, PutUE)
+{
+    const struct
+    {
+        uint32_t v;
+        string   code;
+    } cases[] = {
+        {0, "1"},
+        {1, "010"},
+        {2, "011"},
+        {3, "00100"},
+        {6, "00111"},
+        {7, "0001000"},
+        {254, "000000011111111"},
+        {0xFFFFFFFE, string(31, '0') + "1" + string(31, '1')},
+        {0xFFFFFFFF, string(32, '0') + "1" + string(32, '0')},
+    };
+
+    for (auto &c : cases)
+    {
+        vector<uint8_t> buf = MakeBuffer(32);
+        BitWriter       bw(buf.data(), 32);
+        bw.PutUE(c.v);
+        EXPECT_EQ(c.code, ToBitString(buf, c.code.size())) << "ue(" << c.v << ")";
+        EXPECT_EQ(buf.data() + c.code.size() / 8, bw.GetCurrent());
+        EXPECT_EQ(c.code.size() % 8, bw.GetBitOffset());
+    }
+}
+
+TEST_F(BitWriterTest, PutSE)
+{
+    const struct
+    {
+        int32_t v;
+        string  code;
+    } cases[] = {
+        {0, "1"},
+        {1, "010"},
+        {-1, "011"},
+        {2, "00100"},
+        {-2, "00101"},
+        {INT32_MAX, string(31, '0') + "1" + string(30, '1') + "0"},
+        {-INT32_MAX, string(31, '0') + "1" + string(31, '1')},
+        // Code number 2^32, must not wrap to ue(0)
+        {INT32_MIN, string(32, '0') + "1" + string(31, '0') + "1"},
+    };
+
+    for (auto &c : cases)
+    {
+        vector<uint8_t> buf = MakeBuffer(32);
+        BitWriter       bw(buf.data(), 32);
+        bw.PutSE(c.v);
+        EXPECT_EQ(c.code, ToBitString(buf, c.code.size())) << "se(" << c.v << ")";
+        EXPECT_EQ(buf.data() + c.code.size() / 8, bw.GetCurrent());
+        EXPECT_EQ(c.code.size() % 8, bw.GetBitOffset());
+    }
+}
+
+TEST_F(BitWriterTest, PutTrailingBits)
+{
+    for (uint32_t n = 0; n < 16; n++)
+    {
+        vector<uint8_t> buf = MakeBuffer(32);
+        BitWriter       bw(buf.data(), 32);
+        RefWriter       ref;
+
+        bw.PutBits(n, 0x7FFF);
+        ref.PutBits(n, 0x7FFF);
+        bw.PutTrailingBits();
+        ref.PutTrailingBits();
+
+        EXPECT_EQ(0u, bw.GetBitOffset());
+        CheckBuffer(buf, 32, bw, ref);
+    }
+}
+
+TEST_F(BitWriterTest, BitOffset)
+{
+    // The leading bitOffset bits of the first byte are kept, the rest is overwritten
+    for (uint32_t bitOffset = 0; bitOffset < 8; bitOffset++)
+    {
+        vector<uint8_t> buf = MakeBuffer(32, 0xFF);
+        BitWriter       bw(buf.data(), 32, bitOffset);
+        RefWriter       ref = MakeRef(0xFF, bitOffset);
+
+        EXPECT_EQ(bitOffset, bw.GetBitOffset());
+        bw.PutBits(1, 0);
+        ref.PutBits(1, 0);
+        bw.PutUE(5);
+        ref.PutUE(5);
+        bw.PutSE(-9);
+        ref.PutSE(-9);
+        bw.PutBits(32, 0xF0F0F0F0);
+        ref.PutBits(32, 0xF0F0F0F0);
+        bw.PutTrailingBits();
+        ref.PutTrailingBits();
+
+        CheckBuffer(buf, 32, bw, ref);
+    }
+}
+
+TEST_F(BitWriterTest, LongCodeSplit)
+{
+    // 65 bit codes cross the 64 bit accumulator at every offset
+    for (uint32_t bitOffset = 0; bitOffset < 8; bitOffset++)
+    {
+        vector<uint8_t> buf = MakeBuffer(32, 0xAA);
+        BitWriter       bw(buf.data(), 32, bitOffset);
+        RefWriter       ref = MakeRef(0xAA, bitOffset);
+
+        bw.PutUE(0xFFFFFFFF);
+        ref.PutUE(0xFFFFFFFF);
+        bw.PutSE(INT32_MIN);
+        ref.PutSE(INT32_MIN);
+        bw.PutBits(32, 0xFFFFFFFF);
+        ref.PutBits(32, 0xFFFFFFFF);
+        bw.PutUE(0xFFFFFFFE);
+        ref.PutUE(0xFFFFFFFE);
+
+        CheckBuffer(buf, 32, bw, ref);
+    }
+}
+
+TEST_F(BitWriterTest, BufferEnd)
+{
+    // Sizes around 8 bytes switch between the 8 byte store and the byte loop
+    for (uint32_t size = 0; size <= 24; size++)
+    {
+        for (uint32_t bitOffset = 0; bitOffset < 8; bitOffset++)
+        {
+            if (size == 0 && bitOffset)
+            {
+                continue;
+            }
+            vector<uint8_t> buf = MakeBuffer(size, 0x5A);
+            BitWriter       bw(buf.data(), size, bitOffset);
+            RefWriter       ref = MakeRef(size ? 0x5A : 0, bitOffset);
+
+            while (ref.BitCount() < (size_t)size * 8)
+            {
+                bw.PutBits(13, 0x1ABC);
+                ref.PutBits(13, 0x1ABC);
+                CheckBuffer(buf, size, bw, ref);
+            }
+            bw.PutTrailingBits();
+            ref.PutTrailingBits();
+            CheckBuffer(buf, size, bw, ref);
+        }
+    }
+}
+
+TEST_F(BitWriterTest, Overflow)
+{
+    vector<uint8_t> buf = MakeBuffer(2);
+
+    BitWriter full(buf.data(), 2);
+    full.PutBits(16, 0xFFFF);
+    EXPECT_FALSE(full.IsOverflow());
+    EXPECT_EQ(buf.data() + 2, full.GetCurrent());
+
+    // Pending bits without a byte to hold them overflow as well
+    BitWriter pending(buf.data(), 2);
+    pending.PutBits(16, 0xFFFF);
+    pending.PutBit(1);
+    EXPECT_TRUE(pending.IsOverflow());
+
+    BitWriter ue(buf.data(), 2);
+    ue.PutUE(0xFFFFFFFF);
+    EXPECT_TRUE(ue.IsOverflow());
+
+    BitWriter offset(buf.data(), 1, 7);
+    offset.PutBits(1, 1);
+    EXPECT_FALSE(offset.IsOverflow());
+    offset.PutBits(1, 1);
+    EXPECT_TRUE(offset.IsOverflow());
+
+    for (uint32_t i = 0; i < GUARD_SIZE; i++)
+    {
+        EXPECT_EQ(GUARD_BYTE, buf[2 + i]);
+    }
+}
+
+TEST_F(BitWriterTest, RandomSequence)
+{
+    mt19937 rng(0x5eed);
+
+    for (uint32_t iter = 0; iter < 200; iter++)
+    {
+        uint32_t        size      = rng() % 64;
+        uint32_t        bitOffset = size ? rng() % 8 : 0;
+        uint8_t         first     = (uint8_t)rng();
+        vector<uint8_t> buf       = MakeBuffer(size, first);
+        BitWriter       bw(buf.data(), size, bitOffset);
+        RefWriter       ref = MakeRef(first, bitOffset);
+
+        for (uint32_t op = 0; op < 64; op++)
+        {
+            uint32_t v = rng();
+            switch (rng() % 5)
+            {
+            case 0:
+                bw.PutBit(v);
+                ref.PutBits(1, v & 1);
+                break;
+            case 1:
+            {
+                uint32_t n = rng() % 33;
+                bw.PutBits(n, v);
+                ref.PutBits(n, n ? v & (0xFFFFFFFFu >> (32 - n)) : 0);
+                break;
+            }
+            case 2:
+                v >>= rng() % 32;
+                bw.PutUE(v);
+                ref.PutUE(v);
+                break;
+            case 3:
+                v >>= rng() % 32;
+                bw.PutSE((int32_t)v);
+                ref.PutSE((int32_t)v);
+                break;
+            default:
+                bw.PutTrailingBits();
+                ref.PutTrailingBits();
+                break;
+            }
+        }
+        CheckBuffer(buf, size, bw, ref);
+    }
+}
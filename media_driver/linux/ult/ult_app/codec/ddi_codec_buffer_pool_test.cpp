@@ -0,0 +1,202 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ddi_codec_buffer_pool_specific.h"
+
+using namespace std;
+using namespace codec;
+
+// Parameter buffer sizes created for each decode frame: picture params,
+// IQ matrix, Huffman table, slice params of two sizes
+static const uint32_t kFrameDataSizes[] = {1024, 4096, 432, 2048, 2048, 64};
+
+class DdiCodecBufferPoolTest : public testing::Test
+{
+protected:
+    //! Number of MOS allocations currently alive
+    static int32_t LiveAllocations()
+    {
+        return *MosUtilities::m_mosMemAllocCounter;
+    }
+
+    //! Creates and destroys one frame of buffers, returns the number of new allocations
+    int32_t RunFrame(DdiCodecBufferPool &pool)
+    {
+        vector<DDI_MEDIA_BUFFER *> bufs;
+        int32_t                    allocations = 0;
+
+        for (auto size : kFrameDataSizes)
+        {
+            int32_t live = LiveAllocations();
+
+            DDI_MEDIA_BUFFER *buf = pool.AcquireBuffer();
+            EXPECT_NE(nullptr, buf);
+            EXPECT_EQ(0u, buf->iSize);
+            EXPECT_EQ(nullptr, buf->pData);
+
+            buf->iSize = size;
+            buf->pData = pool.AcquireData(size);
+            EXPECT_NE(nullptr, buf->pData);
+            EXPECT_EQ(0, memcmp(buf->pData, m_zero, size));
+
+            // Application writes the parameters
+            memset(buf->pData, 0xa5, size);
+            buf->uiNumElements = 1;
+
+            allocations += LiveAllocations() - live;
+            bufs.push_back(buf);
+        }
+
+        for (auto buf : bufs)
+        {
+            pool.ReleaseData(buf->pData, buf->iSize);
+            buf->pData = nullptr;
+            pool.ReleaseBuffer(buf);
+        }
+        return allocations;
+    }
+
+    uint8_t m_zero[4096] = {};
+};
+
+TEST_F(DdiCodecBufferPoolTest, NoAllocationsAfterWarmUp)
+{
+    int32_t live = LiveAllocations();
+    {
+        DdiCodecBufferPool pool;
+        int32_t            warmUp = RunFrame(pool);
+        int32_t            cached = LiveAllocations();
+
+        // One descriptor and one storage per buffer of the first frame
+        EXPECT_EQ(2 * (int32_t)(sizeof(kFrameDataSizes) / sizeof(kFrameDataSizes[0])), warmUp);
+
+        for (int frame = 0; frame < 1000; frame++)
+        {
+            ASSERT_EQ(0, RunFrame(pool)) << "frame " << frame;
+        }
+        EXPECT_EQ(cached, LiveAllocations());
+    }
+
+    // Pool frees all it cached
+    EXPECT_EQ(live, LiveAllocations());
+}
+
+TEST_F(DdiCodecBufferPoolTest, CacheIsBounded)
+{
+    const uint32_t             count = DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS + 44;
+    const uint32_t             size  = DDI_CODEC_BUFFER_POOL_MAX_DATA_SIZE / 4;
+    int32_t                    live  = LiveAllocations();
+    vector<DDI_MEDIA_BUFFER *> bufs;
+    vector<uint8_t *>          data;
+    {
+        DdiCodecBufferPool pool;
+        int32_t            base = LiveAllocations();
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            bufs.push_back(pool.AcquireBuffer());
+        }
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            data.push_back(pool.AcquireData(size));
+        }
+        EXPECT_EQ(base + (int32_t)count + 5, LiveAllocations());
+
+        // Descriptors and storage beyond the limits are freed
+        for (auto buf : bufs)
+        {
+            pool.ReleaseBuffer(buf);
+        }
+        for (auto d : data)
+        {
+            pool.ReleaseData(d, size);
+        }
+        EXPECT_EQ(base + DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS + 4, LiveAllocations());
+
+        // Cached storage only serves its own size
+        uint8_t *other = pool.AcquireData(size / 2);
+        EXPECT_EQ(base + DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS + 5, LiveAllocations());
+        pool.ReleaseData(other, size / 2);
+        EXPECT_EQ(base + DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS + 4, LiveAllocations());
+    }
+    EXPECT_EQ(live, LiveAllocations());
+}
+
+TEST_F(DdiCodecBufferPoolTest, ForeignMemory)
+{
+    int32_t live = LiveAllocations();
+    {
+        DdiCodecBufferPool pool;
+
+        // Memory allocated outside the pool can be released into it
+        DDI_MEDIA_BUFFER *buf  = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+        uint8_t          *data = (uint8_t *)MOS_AllocAndZeroMemory(256);
+        buf->iSize             = 256;
+        pool.ReleaseBuffer(buf);
+        pool.ReleaseData(data, 256);
+
+        EXPECT_EQ(buf, pool.AcquireBuffer());
+        EXPECT_EQ(0u, buf->iSize);
+        EXPECT_EQ(data, pool.AcquireData(256));
+
+        // And pool memory can be freed outside it
+        MOS_FreeMemory(buf);
+        MOS_FreeMemory(data);
+
+        EXPECT_EQ(nullptr, pool.AcquireData(0));
+        pool.ReleaseBuffer(nullptr);
+        pool.ReleaseData(nullptr, 16);
+    }
+    EXPECT_EQ(live, LiveAllocations());
+}
+
+TEST_F(DdiCodecBufferPoolTest, ConcurrentContexts)
+{
+    const int threadCount = 4;
+    int32_t   live        = LiveAllocations();
+    {
+        DdiCodecBufferPool pool;
+        vector<thread>     threads;
+
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&]() {
+                for (int frame = 0; frame < 500; frame++)
+                {
+                    RunFrame(pool);
+                }
+            });
+        }
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+
+        // At most the buffers of all threads' frames are cached
+        EXPECT_LE(LiveAllocations() - live, threadCount * 2 * (int32_t)(sizeof(kFrameDataSizes) / sizeof(kFrameDataSizes[0])));
+        EXPECT_EQ(0, RunFrame(pool));
+    }
+    EXPECT_EQ(live, LiveAllocations());
+}
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+#include "decode_av1_default_cdf.h"
+
+using namespace std;
+using namespace decode;
+
+class DecodeAv1DefaultCdfTest : public testing::Test
+{
+public:
+    static const uint32_t ENTRY_NUM    = Av1DefaultCdf::m_cdfMaxNumBytes / sizeof(uint16_t);
+    static const uint32_t ENTRY_PER_CL = 32;
+
+    //! Builds one default frame context the way the decoder did before the images were shared
+    vector<uint16_t> BuildFrameContext(uint8_t index, uint16_t fill)
+    {
+        vector<uint16_t> ctx(ENTRY_NUM, fill);
+        EXPECT_EQ(MOS_STATUS_SUCCESS, Av1DefaultCdf::InitDefaultFrameContextBuffer(ctx.data(), index));
+        return ctx;
+    }
+};
+
+TEST_F(DecodeAv1DefaultCdfTest, ImageMatchesBuilder)
+{
+    for (uint8_t index = 0; index < Av1DefaultCdf::av1DefaultCdfTableNum; index++)
+    {
+        const uint16_t *image = Av1DefaultCdf::GetImage(index);
+        ASSERT_NE(nullptr, image) << "index = " << (uint32_t)index;
+
+        vector<uint16_t> ctx = BuildFrameContext(index, 0);
+        EXPECT_EQ(0, memcmp(image, ctx.data(), Av1DefaultCdf::m_cdfMaxNumBytes)) << "index = " << (uint32_t)index;
+    }
+}
+
+TEST_F(DecodeAv1DefaultCdfTest, ImageBuiltOnce)
+{
+    for (uint8_t index = 0; index < Av1DefaultCdf::av1DefaultCdfTableNum; index++)
+    {
+        EXPECT_EQ(Av1DefaultCdf::GetImage(index), Av1DefaultCdf::GetImage(index));
+    }
+    EXPECT_EQ(nullptr, Av1DefaultCdf::GetImage(Av1DefaultCdf::av1DefaultCdfTableNum));
+}
+
+TEST_F(DecodeAv1DefaultCdfTest, UnusedEntriesAreZero)
+{
+    // Entries the builder leaves untouched keep the fill value, the image must have zero there
+    const uint16_t  *image = Av1DefaultCdf::GetImage(0);
+    vector<uint16_t> ctx   = BuildFrameContext(0, 0xffff);
+    ASSERT_NE(nullptr, image);
+
+    uint32_t unused = 0;
+    for (uint32_t i = 0; i < ENTRY_NUM; i++)
+    {
+        if (ctx[i] == 0xffff)
+        {
+            EXPECT_EQ(0, image[i]) << "entry = " << i;
+            unused++;
+        }
+    }
+    EXPECT_NE(0u, unused);
+}
+
+TEST_F(DecodeAv1DefaultCdfTest, Layout)
+{
+    for (uint8_t index = 0; index < Av1DefaultCdf::av1DefaultCdfTableNum; index++)
+    {
+        const uint16_t *image = Av1DefaultCdf::GetImage(index);
+        ASSERT_NE(nullptr, image);
+
+        // partition_8x8 starts the first cache line
+        EXPECT_EQ(0, memcmp(image, &defaultPartitionCdf8x8[0][0], 12 * sizeof(uint16_t)));
+        // txb_skip is the first coeff cdf, addressed by index from cache line 86
+        EXPECT_EQ(0, memcmp(image + 86 * ENTRY_PER_CL, &av1DefaultTxbSkipCdfs[index][0][0][0], ENTRY_PER_CL * sizeof(uint16_t)));
+        // switchable_interp fills the last cache line
+        EXPECT_EQ(0, memcmp(image + 235 * ENTRY_PER_CL, &defaultSwitchableInterpCdf[0][0], ENTRY_PER_CL * sizeof(uint16_t)));
+    }
+
+    // Only the coeff cdfs in cache lines 86 to 167 depend on the index
+    const uint16_t *image0 = Av1DefaultCdf::GetImage(0);
+    for (uint8_t index = 1; index < Av1DefaultCdf::av1DefaultCdfTableNum; index++)
+    {
+        const uint16_t *image = Av1DefaultCdf::GetImage(index);
+        EXPECT_EQ(0, memcmp(image, image0, 86 * ENTRY_PER_CL * sizeof(uint16_t)));
+        EXPECT_NE(0, memcmp(image + 86 * ENTRY_PER_CL, image0 + 86 * ENTRY_PER_CL, 82 * ENTRY_PER_CL * sizeof(uint16_t)));
+        EXPECT_EQ(0, memcmp(image + 168 * ENTRY_PER_CL, image0 + 168 * ENTRY_PER_CL, 68 * ENTRY_PER_CL * sizeof(uint16_t)));
+    }
+}
@@ -0,0 +1,193 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "decode_vp8_entropy_state.h"
+
+using namespace std;
+using namespace decode;
+
+// Hashes of the frame head parse over the corpus below, taken from the 32 bit
+// bool decoder that read the bitstream buffer in place
+static const uint64_t kFirstFrameHashes[] = {
+    0xa03dcef037306207ull,
+    0x2068dd4ca5fbb01bull,
+    0xc40b5074be1c8985ull,
+    0x3377d97e7c9eaafdull,
+    0x4d8ba4b63489fd0eull,
+    0x9626198c2b39c4c2ull,
+    0x8b55cf664b5dac86ull,
+    0xace0c3acccc84cceull,
+};
+static const uint64_t kCorpusHash  = 0x25104e1549506e75ull;
+static const int      kCorpusSize  = 19995;
+static const uint64_t kFnvBasis    = 0xcbf29ce484222325ull;
+
+class DecodeVp8EntropyStateTest : public testing::Test
+{
+protected:
+    static uint64_t Fnv(uint64_t hash, const void *data, size_t size)
+    {
+        const uint8_t *bytes = (const uint8_t *)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    static void SetFrameTag(vector<uint8_t> &frame, bool keyFrame, uint32_t firstPartitionSize)
+    {
+        uint32_t tag = (keyFrame ? 0 : 1) | (1 << 4) | (firstPartitionSize << 5);
+        frame[0]     = tag & 0xff;
+        frame[1]     = (tag >> 8) & 0xff;
+        frame[2]     = (tag >> 16) & 0xff;
+    }
+
+    //! Parses the first headSize bytes of a frame the way Vp8BasicFeature does after CopyFrameHead
+    MOS_STATUS Parse(vector<uint8_t> &frame, uint32_t headSize, uint32_t firstPartitionSize)
+    {
+        memset(&m_picParams, 0, sizeof(m_picParams));
+        memset(&m_frameHead, 0, sizeof(m_frameHead));
+        m_picParams.uiFirstPartitionSize = firstPartitionSize;
+
+        vector<uint8_t> head(frame.begin(), frame.begin() + headSize);
+        Vp8EntropyState entropyState;
+        entropyState.Initialize(&m_frameHead, head.data(), headSize, (uint32_t)frame.size());
+        return entropyState.ParseFrameHead(&m_picParams);
+    }
+
+    uint64_t ParseHash(MOS_STATUS status)
+    {
+        uint64_t hash = Fnv(kFnvBasis, &status, sizeof(status));
+        hash          = Fnv(hash, &m_picParams, sizeof(m_picParams));
+        return Fnv(hash, &m_frameHead, sizeof(m_frameHead));
+    }
+
+    CODEC_VP8_PIC_PARAMS           m_picParams = {};
+    CODECHAL_DECODE_VP8_FRAME_HEAD m_frameHead = {};
+};
+
+TEST_F(DecodeVp8EntropyStateTest, CorpusMatchesReference)
+{
+    const uint32_t partitionSizeDataSize = 7 * 3;
+
+    mt19937  rand(2024);
+    uint64_t corpusHash = kFnvBasis;
+    int      tested     = 0;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        uint32_t        frameSize = 64 + rand() % 4000;
+        vector<uint8_t> frame(frameSize);
+        for (auto &byte : frame)
+        {
+            byte = (uint8_t)rand();
+        }
+        bool     keyFrame   = rand() & 1;
+        uint32_t uncompSize = keyFrame ? 10 : 3;
+        uint32_t padding    = rand() % 6;
+
+        // Find where the first partition ends, then size it to that plus some padding
+        uint32_t probeSize = frameSize - uncompSize - partitionSizeDataSize;
+        SetFrameTag(frame, keyFrame, probeSize);
+        Parse(frame, frameSize, probeSize);
+        uint32_t consumed = m_picParams.uiFirstMbByteOffset;
+        if (consumed < uncompSize || consumed + padding + partitionSizeDataSize > frameSize)
+        {
+            continue;
+        }
+
+        uint32_t firstPartitionSize = consumed - uncompSize + padding;
+        uint32_t headSize           = uncompSize + firstPartitionSize + partitionSizeDataSize;
+        SetFrameTag(frame, keyFrame, firstPartitionSize);
+        uint64_t hash = ParseHash(Parse(frame, headSize, firstPartitionSize));
+
+        if (tested < (int)(sizeof(kFirstFrameHashes) / sizeof(kFirstFrameHashes[0])))
+        {
+            EXPECT_EQ(kFirstFrameHashes[tested], hash) << "frame = " << tested;
+        }
+        corpusHash = Fnv(corpusHash, &hash, sizeof(hash));
+        tested++;
+    }
+
+    EXPECT_EQ(kCorpusSize, tested);
+    EXPECT_EQ(kCorpusHash, corpusHash);
+}
+
+TEST_F(DecodeVp8EntropyStateTest, FrameHeadCopyMatchesFullFrame)
+{
+    mt19937 rand(7);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        uint32_t        frameSize = 256 + rand() % 2048;
+        vector<uint8_t> frame(frameSize);
+        for (auto &byte : frame)
+        {
+            byte = (uint8_t)rand();
+        }
+        bool     keyFrame           = rand() & 1;
+        uint32_t firstPartitionSize = 32 + rand() % 128;
+        uint32_t headSize           = (keyFrame ? 10 : 3) + firstPartitionSize + 7 * 3;
+        SetFrameTag(frame, keyFrame, firstPartitionSize);
+
+        uint64_t fullHash = ParseHash(Parse(frame, frameSize, firstPartitionSize));
+        EXPECT_EQ(fullHash, ParseHash(Parse(frame, headSize, firstPartitionSize))) << "frame = " << i;
+    }
+}
+
+TEST_F(DecodeVp8EntropyStateTest, PartitionSizesOutOfBuffer)
+{
+    const uint32_t firstPartitionSize = 64;
+    const uint32_t uncompSize         = 3;
+
+    mt19937 rand(11);
+    int     checked = 0;
+
+    for (int i = 0; i < 64; i++)
+    {
+        vector<uint8_t> frame(4096);
+        for (auto &byte : frame)
+        {
+            byte = (uint8_t)rand();
+        }
+        SetFrameTag(frame, false, firstPartitionSize);
+
+        ASSERT_EQ(MOS_STATUS_SUCCESS, Parse(frame, uncompSize + firstPartitionSize + 7 * 3, firstPartitionSize));
+        uint32_t partitionNum = 1 << m_frameHead.MultiTokenPartition;
+        if (partitionNum == 1)
+        {
+            continue;
+        }
+
+        // the size table of the token partitions is cut off by the copied head
+        uint32_t tableSize = (partitionNum - 1) * 3;
+        EXPECT_EQ(MOS_STATUS_SUCCESS, Parse(frame, uncompSize + firstPartitionSize + tableSize, firstPartitionSize));
+        EXPECT_EQ(MOS_STATUS_INVALID_PARAMETER, Parse(frame, uncompSize + firstPartitionSize + tableSize - 1, firstPartitionSize));
+        checked++;
+    }
+    EXPECT_GT(checked, 0);
+}
@@ -0,0 +1,60 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "media_libva_util_next.h"
+#include "media_libva_interface_next.h"
+#include "mos_interface.h"
+
+// MediaLibvaCommonNext is linked from the driver sources for its heap
+// management, the surface, buffer and resource services it references are
+// stubbed.
+MOS_STATUS MosInterface::ConvertResourceFromDdi(
+    OsSpecificRes       osResource,
+    MOS_RESOURCE_HANDLE &resource,
+    uint32_t            firstArraySlice,
+    uint32_t            mipSlice)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+VAStatus MediaLibvaUtilNext::CreateSurface(DDI_MEDIA_SURFACE *surface, PDDI_MEDIA_CONTEXT mediaDrvCtx)
+{
+    return VA_STATUS_ERROR_UNIMPLEMENTED;
+}
+
+void MediaLibvaUtilNext::FreeSurface(DDI_MEDIA_SURFACE *surface)
+{
+}
+
+VAStatus MediaLibvaInterfaceNext::MapBuffer(
+    VADriverContextP ctx,
+    VABufferID       buf_id,
+    void             **pbuf)
+{
+    return VA_STATUS_ERROR_UNIMPLEMENTED;
+}
+
+VAStatus MediaLibvaInterfaceNext::UnmapBuffer(
+    VADriverContextP ctx,
+    VABufferID       bufId)
+{
+    return VA_STATUS_ERROR_UNIMPLEMENTED;
+}
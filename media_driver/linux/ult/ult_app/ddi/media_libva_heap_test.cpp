@@ -0,0 +1,220 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_libva_common_next.h"
+
+using namespace std;
+
+class MediaLibvaHeapTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_liveAllocations = LiveAllocations();
+    }
+
+    void TearDown() override
+    {
+        MediaLibvaCommonNext::FreeHeap(&m_heap);
+        EXPECT_EQ(nullptr, m_heap.pHeapBase);
+        EXPECT_EQ(nullptr, m_heap.pRetiredHeapBase);
+        EXPECT_EQ(m_liveAllocations, LiveAllocations());
+    }
+
+    //! Number of MOS allocations currently alive
+    static int32_t LiveAllocations()
+    {
+        return *MosUtilities::m_mosMemAllocCounter;
+    }
+
+    //! Surface pointer stored for an ID, only compared and never dereferenced
+    static PDDI_MEDIA_SURFACE Tag(uint32_t id)
+    {
+        return (PDDI_MEDIA_SURFACE)(uintptr_t)((id + 1) * sizeof(void *));
+    }
+
+    static uint32_t RetiredBases(PDDI_MEDIA_HEAP heap)
+    {
+        uint32_t count = 0;
+        for (PDDI_MEDIA_RETIRED_HEAP_BASE retired = heap->pRetiredHeapBase; retired; retired = retired->pNext)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    //! Creates a surface heap element as the DDI does, must be called with m_mutex held
+    PDDI_MEDIA_SURFACE_HEAP_ELEMENT AllocElement()
+    {
+        if (nullptr == m_heap.pFirstFreeHeapElement)
+        {
+            uint32_t firstNewElement = m_heap.uiAllocatedHeapElements;
+            uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(&m_heap, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+            EXPECT_NE(0u, newElements);
+            if (0 == newElements)
+            {
+                return nullptr;
+            }
+            m_growths++;
+
+            PDDI_MEDIA_SURFACE_HEAP_ELEMENT heapBase = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)m_heap.pHeapBase;
+            m_heap.pFirstFreeHeapElement             = &heapBase[firstNewElement];
+            for (uint32_t i = 0; i < newElements; i++)
+            {
+                heapBase[firstNewElement + i].pNextFree     = (i == newElements - 1) ? nullptr : &heapBase[firstNewElement + i + 1];
+                heapBase[firstNewElement + i].uiVaSurfaceID = firstNewElement + i;
+            }
+        }
+
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT element = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)m_heap.pFirstFreeHeapElement;
+        m_heap.pFirstFreeHeapElement            = element->pNextFree;
+        return element;
+    }
+
+    //! Looks an ID up without the mutex, as GetSurfaceFromVASurfaceID does
+    PDDI_MEDIA_SURFACE Lookup(uint32_t id)
+    {
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT element = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)MediaLibvaCommonNext::GetHeapElement(
+            &m_heap, id, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+        if (nullptr == element || element->uiVaSurfaceID != id)
+        {
+            return nullptr;
+        }
+        return __atomic_load_n(&element->pSurface, __ATOMIC_ACQUIRE);
+    }
+
+    DDI_MEDIA_HEAP m_heap            = {};
+    mutex          m_mutex;
+    uint32_t       m_growths         = 0;
+    int32_t        m_liveAllocations = 0;
+};
+
+TEST_F(MediaLibvaHeapTest, GrowthKeepsElements)
+{
+    const uint32_t count = 5000;
+
+    EXPECT_EQ(nullptr, Lookup(0));
+    for (uint32_t id = 0; id < count; id++)
+    {
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT element = AllocElement();
+        ASSERT_NE(nullptr, element);
+        ASSERT_EQ(id, element->uiVaSurfaceID);
+        element->pSurface = Tag(id);
+    }
+
+    // Every ID survives the copies into the new bases
+    for (uint32_t id = 0; id < count; id++)
+    {
+        ASSERT_EQ(Tag(id), Lookup(id)) << "id " << id;
+    }
+    EXPECT_EQ(nullptr, MediaLibvaCommonNext::GetHeapElement(&m_heap, m_heap.uiAllocatedHeapElements, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT)));
+    EXPECT_EQ(nullptr, MediaLibvaCommonNext::GetHeapElement(nullptr, 0, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT)));
+
+    // The heap doubles, so there are few retired bases and they are smaller
+    // than the live one together
+    uint32_t expectedGrowths = 1;
+    for (uint32_t allocated = DDI_MEDIA_HEAP_INCREMENTAL_SIZE; allocated < count; allocated *= 2)
+    {
+        expectedGrowths++;
+    }
+    EXPECT_EQ(expectedGrowths, m_growths);
+    EXPECT_EQ(m_growths - 1, RetiredBases(&m_heap));
+    EXPECT_LT(m_heap.uiAllocatedHeapElements, 2 * count);
+}
+
+TEST_F(MediaLibvaHeapTest, ConcurrentLookups)
+{
+    const uint32_t count       = 20000;
+    const int      readerCount = 3;
+
+    atomic<uint32_t> created(0);
+    atomic<bool>     done(false);
+    atomic<uint32_t> lookups(0);
+    atomic<uint32_t> mismatches(0);
+
+    // Readers only look up IDs whose creation they have observed, as an
+    // application passing IDs between threads does
+    vector<thread> readers;
+    for (int r = 0; r < readerCount; r++)
+    {
+        readers.emplace_back([&, r]() {
+            mt19937 rand(r);
+            while (!done.load(memory_order_acquire))
+            {
+                uint32_t visible = created.load(memory_order_acquire);
+                if (0 == visible)
+                {
+                    this_thread::yield();
+                    continue;
+                }
+                for (int i = 0; i < 64; i++)
+                {
+                    uint32_t id = rand() % visible;
+                    if (Lookup(id) != Tag(id))
+                    {
+                        mismatches++;
+                    }
+                    // The newest IDs are the ones a growth just copied
+                    if (Lookup(visible - 1) != Tag(visible - 1))
+                    {
+                        mismatches++;
+                    }
+                }
+                lookups += 128;
+                this_thread::yield();
+            }
+        });
+    }
+
+    for (uint32_t id = 0; id < count; id++)
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            PDDI_MEDIA_SURFACE_HEAP_ELEMENT element = AllocElement();
+            if (nullptr == element)
+            {
+                break;
+            }
+            element->pSurface = Tag(element->uiVaSurfaceID);
+        }
+        created.store(id + 1, memory_order_release);
+        if (0 == id % 32)
+        {
+            this_thread::yield();
+        }
+    }
+    done.store(true, memory_order_release);
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    RecordProperty("lookups", (int)lookups.load());
+    EXPECT_LT(0u, lookups.load());
+    EXPECT_EQ(0u, mismatches.load());
+    EXPECT_EQ(m_growths - 1, RetiredBases(&m_heap));
+}
@@ -30,19 +30,6 @@
 
 using namespace std;
 
-#if MOS_MESSAGES_ENABLED
-void MosUtilDebug::MosMessage(
-    MOS_MESSAGE_LEVEL level,
-    MOS_COMPONENT_ID  compID,
-    uint8_t           subCompID,
-    const PCCHAR      functionName,
-    int32_t           lineNum,
-    const PCCHAR      message,
-    ...)
-{
-}
-#endif
-
 void UltGetCmdBuf(PMOS_COMMAND_BUFFER pCmdBuffer);
 
 extern char               *g_driverPath;
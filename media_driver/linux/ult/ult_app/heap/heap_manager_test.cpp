@@ -0,0 +1,281 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "heap_manager.h"
+
+using namespace std;
+
+static const uint32_t kHeapSize = 1024 * 1024;
+
+// Heaps the fake OS interface hands out, by resource
+static map<PMOS_RESOURCE, vector<uint8_t>> g_heaps;
+
+#if MOS_MESSAGES_ENABLED
+static MOS_STATUS FakeAllocateResource(
+    PMOS_INTERFACE osInterface, PMOS_ALLOC_GFXRES_PARAMS params, const char *functionName, const char *filename, int32_t line, PMOS_RESOURCE res)
+#else
+static MOS_STATUS FakeAllocateResource(PMOS_INTERFACE osInterface, PMOS_ALLOC_GFXRES_PARAMS params, PMOS_RESOURCE res)
+#endif
+{
+    vector<uint8_t> &data = g_heaps[res];
+    data.assign(params->dwBytes, 0);
+    res->pData = data.data();
+    // Only marks the resource as allocated, never dereferenced
+    res->bo    = (MOS_LINUX_BO *)data.data();
+    return MOS_STATUS_SUCCESS;
+}
+
+#if MOS_MESSAGES_ENABLED
+static void FakeFreeResource(PMOS_INTERFACE osInterface, const char *functionName, const char *filename, int32_t line, PMOS_RESOURCE res)
+#else
+static void FakeFreeResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE res)
+#endif
+{
+    g_heaps.erase(res);
+    res->pData = nullptr;
+    res->bo    = nullptr;
+}
+
+static MOS_STATUS FakeSkipResourceSync(PMOS_RESOURCE res)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+static void *FakeLockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE res, PMOS_LOCK_PARAMS flags)
+{
+    return res->pData;
+}
+
+static MOS_STATUS FakeUnlockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE res)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+class HeapManagerTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_osInterface = (PMOS_INTERFACE)MOS_AllocAndZeroMemory(sizeof(MOS_INTERFACE));
+        ASSERT_NE(nullptr, m_osInterface);
+        m_osInterface->pfnAllocateResource = FakeAllocateResource;
+        m_osInterface->pfnFreeResource     = FakeFreeResource;
+        m_osInterface->pfnSkipResourceSync = FakeSkipResourceSync;
+        m_osInterface->pfnLockResource     = FakeLockResource;
+        m_osInterface->pfnUnlockResource   = FakeUnlockResource;
+
+        // The client handles a full heap by waiting for the GPU, so the
+        // manager never extends and all blocks come from one heap
+        m_manager.reset(new HeapManager);
+        m_manager->SetDefaultBehavior(HeapManager::clientControlled);
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager->RegisterOsInterface(m_osInterface));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager->SetInitialHeapSize(kHeapSize));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager->RegisterTrackerResource(&m_completedFrame));
+    }
+
+    void TearDown() override
+    {
+        m_manager.reset();
+        EXPECT_TRUE(g_heaps.empty());
+        MOS_FreeMemory(m_osInterface);
+    }
+
+    //! Acquires and submits the blocks of one frame, completing the oldest
+    //! frames on the GPU while the heap is full
+    bool RunFrame(vector<uint32_t> &sizes, uint32_t frame = 0)
+    {
+        frame = frame ? frame : ++m_submittedFrame;
+        vector<MemoryBlock> blocks;
+        uint32_t            spaceNeeded = 0;
+
+        MemoryBlockManager::AcquireParams params(frame, sizes);
+        while (m_manager->AcquireSpace(params, blocks, spaceNeeded) != MOS_STATUS_SUCCESS)
+        {
+            EXPECT_LT(0u, spaceNeeded);
+            if (m_completedFrame >= m_submittedFrame)
+            {
+                ADD_FAILURE() << "frame " << frame << " does not fit in an idle heap";
+                return false;
+            }
+            Complete(m_completedFrame + 1);
+            blocks.clear();
+        }
+
+        EXPECT_EQ(sizes.size(), blocks.size());
+        for (uint32_t i = 0; i < blocks.size(); i++)
+        {
+            if (!ExpectFree(blocks[i], sizes[i]))
+            {
+                return false;
+            }
+            m_inUse[blocks[i].GetOffset()] = {blocks[i].GetOffset() + blocks[i].GetSize(), frame};
+            m_frameBlocks[frame].push_back(blocks[i].GetOffset());
+        }
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_manager->SubmitBlocks(blocks));
+        return true;
+    }
+
+    //! Checks a new block lies in the heap and overlaps no block still in use
+    bool ExpectFree(MemoryBlock &block, uint32_t size)
+    {
+        EXPECT_TRUE(block.IsValid());
+        EXPECT_LE(size, block.GetSize());
+        EXPECT_EQ(0u, block.GetOffset() % 64);
+        EXPECT_LE(block.GetOffset() + block.GetSize(), kHeapSize);
+
+        auto next = m_inUse.lower_bound(block.GetOffset());
+        if (next != m_inUse.end() && next->first < block.GetOffset() + block.GetSize())
+        {
+            ADD_FAILURE() << "block at " << block.GetOffset() << " overlaps block at " << next->first
+                          << " of frame " << next->second.second << ", completed " << m_completedFrame;
+            return false;
+        }
+        if (next != m_inUse.begin() && prev(next)->second.first > block.GetOffset())
+        {
+            ADD_FAILURE() << "block at " << block.GetOffset() << " overlaps block at " << prev(next)->first
+                          << " of frame " << prev(next)->second.second << ", completed " << m_completedFrame;
+            return false;
+        }
+        return true;
+    }
+
+    //! The GPU is done with every frame up to frame
+    void Complete(uint32_t frame)
+    {
+        m_completedFrame = frame;
+        while (!m_frameBlocks.empty() && m_frameBlocks.begin()->first <= frame)
+        {
+            for (auto offset : m_frameBlocks.begin()->second)
+            {
+                m_inUse.erase(offset);
+            }
+            m_frameBlocks.erase(m_frameBlocks.begin());
+        }
+    }
+
+    PMOS_INTERFACE              m_osInterface    = nullptr;
+    unique_ptr<HeapManager>     m_manager;
+    uint32_t                    m_completedFrame = 0;
+    uint32_t                    m_submittedFrame = 0;
+    //! Blocks the GPU may still use: offset to end offset and frame
+    map<uint32_t, pair<uint32_t, uint32_t>> m_inUse;
+    map<uint32_t, vector<uint32_t>>         m_frameBlocks;
+};
+
+TEST_F(HeapManagerTest, AllocateSubmitRefresh)
+{
+    mt19937 rand(2024);
+
+    // Frames of mostly small state blocks with the odd kernel sized one,
+    // with the GPU a few frames behind
+    for (int i = 0; i < 3000; i++)
+    {
+        vector<uint32_t> sizes(1 + rand() % 12);
+        for (auto &size : sizes)
+        {
+            size = (rand() % 8) ? 64 + rand() % 4096 : 4096 + rand() % 65536;
+        }
+        ASSERT_TRUE(RunFrame(sizes)) << "frame " << i;
+        if (rand() % 4 == 0 && m_completedFrame + 3 < m_submittedFrame)
+        {
+            Complete(m_submittedFrame - 3);
+        }
+    }
+    EXPECT_EQ(kHeapSize, m_manager->GetTotalSize());
+    EXPECT_EQ(1u, g_heaps.size());
+
+    // Once the GPU is idle the free blocks merge back into the whole heap
+    Complete(m_submittedFrame);
+    vector<uint32_t> whole = {kHeapSize};
+    EXPECT_TRUE(RunFrame(whole));
+}
+
+TEST_F(HeapManagerTest, RequestLargerThanFreeSpace)
+{
+    // Each block fits in the idle heap but not both of them: the request
+    // must fail without keeping part of the space
+    vector<uint32_t>    sizes       = {kHeapSize - 64, 128};
+    vector<MemoryBlock> blocks;
+    uint32_t            spaceNeeded = 0;
+
+    MemoryBlockManager::AcquireParams params(++m_submittedFrame, sizes);
+    EXPECT_EQ(MOS_STATUS_CLIENT_AR_NO_SPACE, m_manager->AcquireSpace(params, blocks, spaceNeeded));
+    EXPECT_EQ(128u, spaceNeeded);
+    EXPECT_TRUE(blocks.empty());
+
+    // Blocks filling the heap exactly
+    vector<uint32_t> halves = {kHeapSize / 2, kHeapSize / 2};
+    EXPECT_TRUE(RunFrame(halves));
+    Complete(m_submittedFrame);
+    vector<uint32_t> whole = {kHeapSize};
+    EXPECT_TRUE(RunFrame(whole));
+}
+
+TEST_F(HeapManagerTest, FragmentedHeapCost)
+{
+    mt19937 rand(7);
+
+    // Blocks of a long running workload interleaved with blocks of one frame
+    // leave hundreds of free holes of different sizes once the frame completes
+    const uint32_t holes        = 600;
+    const uint32_t longRunning  = 1000000;
+    uint32_t       holesFrame   = ++m_submittedFrame;
+    for (uint32_t i = 0; i < 2 * holes; i++)
+    {
+        vector<uint32_t> size = {64 * (1 + (uint32_t)rand() % 12)};
+        ASSERT_TRUE(RunFrame(size, (i & 1) ? longRunning : holesFrame));
+    }
+    Complete(holesFrame);
+
+    // Each frame splits holes and merges them back when the GPU is done
+    const int count = 20000;
+    auto      start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        vector<uint32_t> frameSizes(1 + rand() % 4);
+        for (auto &size : frameSizes)
+        {
+            size = 64 * (1 + rand() % 8);
+        }
+        // Now and then a block only the largest free block can hold
+        if (i % 64 == 0)
+        {
+            frameSizes.push_back(128 * 1024);
+        }
+        ASSERT_TRUE(RunFrame(frameSizes)) << "frame " << i;
+        if (rand() % 2)
+        {
+            Complete(m_submittedFrame - 1);
+        }
+    }
+    int64_t ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    RecordProperty("ns_per_frame", (int)(ns / count));
+
+    Complete(longRunning);
+    vector<uint32_t> whole = {kHeapSize};
+    EXPECT_TRUE(RunFrame(whole));
+}
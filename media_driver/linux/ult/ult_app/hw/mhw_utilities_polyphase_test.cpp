@@ -0,0 +1,273 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mhw_state_heap.h"
+#include "mhw_utilities_next.h"
+
+using namespace std;
+
+// Hashes of the tables computed for each sweep, taken from the calculation
+// before polyphase tables were cached
+static const uint64_t kYTablesHash        = 0x50190554f3770d3dull;
+static const uint64_t kUVTablesHash       = 0x2fe97d6515cfa9d3ull;
+static const uint64_t kUVOffsetTablesHash = 0x5a39cec5a28807ddull;
+
+// Marks buffer entries the calculation must not write
+static const int32_t kGuard = 0x5a5a5a5a;
+
+struct PolyphaseYArgs
+{
+    float      scaleFactor;
+    uint32_t   plane;
+    MOS_FORMAT format;
+    float      hpStrength;
+    bool       use8x8Filter;
+    uint32_t   hwPhase;
+    float      lanczosT;
+};
+
+struct PolyphaseUVArgs
+{
+    float   lanczosT;
+    float   inverseScaleFactor;
+    int32_t uvPhaseOffset;
+    bool    offset;
+};
+
+class MhwPolyphaseTableTest : public testing::Test
+{
+protected:
+    static uint64_t Hash(uint64_t hash, const vector<int32_t> &table)
+    {
+        for (auto coef : table)
+        {
+            hash = (hash ^ (uint32_t)coef) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    static vector<float> ScaleFactors()
+    {
+        vector<float> factors = {0.125f, 0.25f, 1.0f / 3.0f, 0.5f, 2.0f / 3.0f, 0.75f, 0.999f,
+            1.0f, 1.001f, 1.25f, 1.5f, 2.0f, 3.0f, 4.0f, 8.0f};
+        mt19937 rand(2024);
+        for (int i = 0; i < 17; i++)
+        {
+            factors.push_back(0.1f + (float)(rand() % 100000) / 10000.0f);
+        }
+        return factors;
+    }
+
+    static vector<PolyphaseYArgs> YSweep()
+    {
+        const uint32_t   planes[]   = {MHW_Y_PLANE, MHW_U_PLANE, MHW_V_PLANE};
+        const MOS_FORMAT formats[]  = {Format_NV12, Format_P010, Format_A8R8G8B8, Format_Y410, Format_AYUV, Format_R5G6B5};
+        const float      strengths[] = {0.0f, 0.5f};
+        const uint32_t   hwPhases[]  = {MHW_NUM_HW_POLYPHASE_TABLES, NUM_HW_POLYPHASE_TABLES};
+
+        vector<PolyphaseYArgs> sweep;
+        for (auto scaleFactor : ScaleFactors())
+        {
+            for (auto plane : planes)
+            {
+                for (auto format : formats)
+                {
+                    for (auto strength : strengths)
+                    {
+                        for (auto hwPhase : hwPhases)
+                        {
+                            sweep.push_back({scaleFactor, plane, format, strength, true, hwPhase, 2.0f});
+                            sweep.push_back({scaleFactor, plane, format, strength, false, hwPhase, 3.0f});
+                        }
+                    }
+                }
+            }
+        }
+        return sweep;
+    }
+
+    static vector<PolyphaseUVArgs> UVSweep(bool offset)
+    {
+        const float lanczosTs[] = {2.0f, 3.0f, 4.0f};
+
+        vector<PolyphaseUVArgs> sweep;
+        for (auto scaleFactor : ScaleFactors())
+        {
+            for (auto lanczosT : lanczosTs)
+            {
+                if (!offset)
+                {
+                    sweep.push_back({lanczosT, 1.0f / scaleFactor, 0, false});
+                    continue;
+                }
+                for (int32_t phaseOffset = -16; phaseOffset <= 16; phaseOffset += 4)
+                {
+                    sweep.push_back({lanczosT, 1.0f / scaleFactor, phaseOffset, true});
+                }
+            }
+        }
+        return sweep;
+    }
+
+    //! Table size of the call, written into a buffer with guard entries after it
+    static vector<int32_t> CalcY(const PolyphaseYArgs &args)
+    {
+        uint32_t        entries = (args.plane == MHW_Y_PLANE) ? NUM_POLYPHASE_Y_ENTRIES : NUM_POLYPHASE_UV_ENTRIES;
+        uint32_t        count   = args.hwPhase * entries;
+        vector<int32_t> buffer(count + 8, kGuard);
+
+        EXPECT_EQ(MOS_STATUS_SUCCESS, Mhw_CalcPolyphaseTablesY(buffer.data(), args.scaleFactor, args.plane, args.format,
+            args.hpStrength, args.use8x8Filter, args.hwPhase, args.lanczosT));
+        for (uint32_t i = count; i < buffer.size(); i++)
+        {
+            EXPECT_EQ(kGuard, buffer[i]);
+        }
+        buffer.resize(count);
+        return buffer;
+    }
+
+    static vector<int32_t> CalcUV(const PolyphaseUVArgs &args)
+    {
+        uint32_t        count = MHW_SCALER_UV_WIN_SIZE * MHW_TABLE_PHASE_COUNT;
+        vector<int32_t> buffer(count + 8, kGuard);
+
+        if (args.offset)
+        {
+            EXPECT_EQ(MOS_STATUS_SUCCESS, Mhw_CalcPolyphaseTablesUVOffset(buffer.data(), args.lanczosT, args.inverseScaleFactor, args.uvPhaseOffset));
+        }
+        else
+        {
+            EXPECT_EQ(MOS_STATUS_SUCCESS, Mhw_CalcPolyphaseTablesUV(buffer.data(), args.lanczosT, args.inverseScaleFactor));
+        }
+        for (uint32_t i = count; i < buffer.size(); i++)
+        {
+            EXPECT_EQ(kGuard, buffer[i]);
+        }
+        buffer.resize(count);
+        return buffer;
+    }
+
+    //! Hash of the sweep, each table is calculated twice and both must match
+    template <class Args, class Calc>
+    static uint64_t SweepHash(const vector<Args> &sweep, Calc calc)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (auto &args : sweep)
+        {
+            vector<int32_t> table = calc(args);
+            EXPECT_TRUE(table == calc(args));
+            hash = Hash(hash, table);
+        }
+        return hash;
+    }
+};
+
+TEST_F(MhwPolyphaseTableTest, YTablesMatchCalculation)
+{
+    vector<PolyphaseYArgs> sweep = YSweep();
+
+    // Second pass finds the tables the cache still holds, the rest are evicted
+    EXPECT_EQ(kYTablesHash, SweepHash(sweep, CalcY));
+    EXPECT_EQ(kYTablesHash, SweepHash(sweep, CalcY));
+}
+
+TEST_F(MhwPolyphaseTableTest, UVTablesMatchCalculation)
+{
+    vector<PolyphaseUVArgs> sweep       = UVSweep(false);
+    vector<PolyphaseUVArgs> offsetSweep = UVSweep(true);
+
+    EXPECT_EQ(kUVTablesHash, SweepHash(sweep, CalcUV));
+    EXPECT_EQ(kUVOffsetTablesHash, SweepHash(offsetSweep, CalcUV));
+    EXPECT_EQ(kUVTablesHash, SweepHash(sweep, CalcUV));
+    EXPECT_EQ(kUVOffsetTablesHash, SweepHash(offsetSweep, CalcUV));
+}
+
+TEST_F(MhwPolyphaseTableTest, ConcurrentCallers)
+{
+    const int              threadCount = 4;
+    const int              count       = 2000;
+    vector<PolyphaseYArgs> sweep       = YSweep();
+    vector<vector<int32_t>> expected;
+
+    for (auto &args : sweep)
+    {
+        expected.push_back(CalcY(args));
+    }
+
+    vector<thread> threads;
+    vector<int>    mismatches(threadCount);
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]() {
+            mt19937 rand(t);
+            for (int i = 0; i < count; i++)
+            {
+                size_t index = rand() % sweep.size();
+                if (CalcY(sweep[index]) != expected[index])
+                {
+                    mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    for (int t = 0; t < threadCount; t++)
+    {
+        EXPECT_EQ(0, mismatches[t]);
+    }
+}
+
+TEST_F(MhwPolyphaseTableTest, CachedTableCost)
+{
+    const int      count = 2000;
+    PolyphaseYArgs args  = {1.0f, MHW_Y_PLANE, Format_NV12, 0.5f, true, NUM_HW_POLYPHASE_TABLES, 2.0f};
+
+    // Each scale factor is new, so every call computes its table
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        args.scaleFactor = nextafterf(args.scaleFactor, 2.0f);
+        CalcY(args);
+    }
+    int64_t computed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / count;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        CalcY(args);
+    }
+    int64_t cached = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / count;
+
+    RecordProperty("ns_computed", (int)computed);
+    RecordProperty("ns_cached", (int)cached);
+    EXPECT_LT(cached, computed);
+}
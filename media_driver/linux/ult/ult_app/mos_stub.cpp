@@ -19,15 +19,34 @@
 * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 * OTHER DEALINGS IN THE SOFTWARE.
 */
-#include <cstring>
-#include "mos_utilities.h"
-using namespace std;
+#include "mos_os.h"
+#include "mos_interface.h"
+#include "mos_oca_util_debug.h"
 
-void MosUtilities::MosZeroMemory(void *pDestination, size_t stLength)
+// MOS utilities are linked from the driver sources, only the device
+// specific pieces they reference are stubbed.
+MOS_USER_FEATURE_KEY_PATH_INFO *Mos_GetDeviceUfPathInfo(
+    PMOS_CONTEXT mosContext)
 {
-    if(pDestination != nullptr)
+    return nullptr;
+}
+
+#if !EMUL
+void OcaOnMosCriticalMessage(const PCCHAR functionName, int32_t lineNum)
+{
+}
+#endif
+
+bool MosInterface::MosResourceIsNull(PMOS_RESOURCE resource)
+{
+    if (nullptr == resource)
     {
-        memset(pDestination, 0, stLength);
+        return true;
     }
-}
 
+    return ((resource->bo == nullptr)
+#if (_DEBUG || _RELEASE_INTERNAL)
+         && (resource->pData == nullptr)
+#endif
+    );
+}
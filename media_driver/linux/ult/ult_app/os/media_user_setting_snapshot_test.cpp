@@ -0,0 +1,299 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_user_setting_configure.h"
+
+using namespace std;
+using namespace MediaUserSetting;
+
+// Configure over an in-memory registry, with the uncached read as reference
+class MockRegistryConfigure : public Internal::Configure
+{
+public:
+    MockRegistryConfigure()
+    {
+        // start from an empty registry whatever the host has configured
+        m_regBufferMap.clear();
+    }
+
+    void SetRegistry(const string &name, const string &value)
+    {
+        m_regBufferMap[USER_SETTING_CONFIG_PATH][name] = value;
+    }
+
+    MOS_STATUS Declare(const string &name, const Group &group, const Value &defaultValue, bool isReportKey = false)
+    {
+        return Register(name, group, defaultValue, isReportKey, false, false, "", false);
+    }
+
+    //! Read the registry and environment directly, as Read did before snapshots
+    MOS_STATUS ReadUncached(Value &value, const string &name, const Group &group)
+    {
+        auto def = GetDefinitions(group)[MakeHash(name)];
+        if (def == nullptr)
+        {
+            return MOS_STATUS_INVALID_HANDLE;
+        }
+
+        UFKEY_NEXT key = {};
+        m_mutexLock.Lock();
+        MOS_STATUS status = ReadItem(def, name, MEDIA_USER_SETTING_INTERNAL, value, key);
+        m_mutexLock.Unlock();
+        if (status != MOS_STATUS_SUCCESS)
+        {
+            value = def->DefaultValue();
+        }
+        return status;
+    }
+};
+
+class MediaUserSettingSnapshotTest : public testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        for (auto &name : m_envNames)
+        {
+            unsetenv(name.c_str());
+        }
+    }
+
+    void SetEnv(const string &name, const string &value)
+    {
+        string envName = name;
+        replace(envName.begin(), envName.end(), ' ', '_');
+        setenv(envName.c_str(), value.c_str(), 1);
+        m_envNames.push_back(envName);
+    }
+
+    //! Checks Read returns the same status and value as the uncached read
+    void ExpectSameRead(const string &name, const Group &group)
+    {
+        Value      cached, uncached;
+        MOS_STATUS cachedStatus   = m_config.Read(cached, name, group, Value());
+        MOS_STATUS uncachedStatus = m_config.ReadUncached(uncached, name, group);
+        EXPECT_EQ(uncachedStatus, cachedStatus) << name;
+        EXPECT_EQ(uncached.ConstString(), cached.ConstString()) << name;
+    }
+
+    MockRegistryConfigure m_config;
+    vector<string>        m_envNames;
+};
+
+TEST_F(MediaUserSettingSnapshotTest, ReadsMatchUncached)
+{
+    const Group groups[] = {Device, Sequence, Frame};
+    vector<pair<string, Group>> items;
+
+    for (int i = 0; i < 60; i++)
+    {
+        string name  = "Snapshot Item " + to_string(i);
+        Group  group = groups[i % 3];
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare(name, group, Value((int32_t)-i)));
+        items.emplace_back(name, group);
+
+        // registry set, environment set, both set, or neither
+        if (i % 4 == 0 || i % 4 == 2)
+        {
+            m_config.SetRegistry(name, to_string(i * 10));
+        }
+        if (i % 4 == 1 || i % 4 == 2)
+        {
+            SetEnv(name, to_string(i * 100));
+        }
+    }
+
+    for (auto &item : items)
+    {
+        ExpectSameRead(item.first, item.second);
+    }
+
+    Value value;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Read(value, "Snapshot Item 2", Frame, Value()));
+    EXPECT_EQ(20, value.Get<int32_t>());
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Read(value, "Snapshot Item 1", Sequence, Value()));
+    EXPECT_EQ(100, value.Get<int32_t>());
+    EXPECT_NE(MOS_STATUS_SUCCESS, m_config.Read(value, "Snapshot Item 3", Device, Value((int32_t)7), true));
+    EXPECT_EQ(7, value.Get<int32_t>());
+}
+
+TEST_F(MediaUserSettingSnapshotTest, KeyedByGroup)
+{
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare("Grouped Item", Sequence, Value((int32_t)1)));
+    m_config.SetRegistry("Grouped Item", "5");
+
+    Value value;
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Read(value, "Grouped Item", Sequence, Value()));
+    EXPECT_EQ(5, value.Get<int32_t>());
+
+    // the same name in another group is not declared
+    EXPECT_EQ(MOS_STATUS_INVALID_HANDLE, m_config.Read(value, "Grouped Item", Device, Value()));
+    EXPECT_EQ(MOS_STATUS_INVALID_HANDLE, m_config.Read(value, "Grouped Item", Frame, Value()));
+
+    // and a full rebuild after those lookups still serves the declared one
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.RefreshSnapshot());
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Read(value, "Grouped Item", Sequence, Value()));
+    EXPECT_EQ(5, value.Get<int32_t>());
+}
+
+TEST_F(MediaUserSettingSnapshotTest, RegisterAfterRead)
+{
+    const int count = 4000;
+
+    // each declaration is followed by a read, as components do at creation
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        string name = "Late Item " + to_string(i);
+        if (i % 5 == 0)
+        {
+            m_config.SetRegistry(name, to_string(i));
+        }
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare(name, Device, Value((int32_t)-1)));
+
+        Value value;
+        m_config.Read(value, name, Device, Value());
+        EXPECT_EQ(i % 5 == 0 ? i : -1, value.Get<int32_t>());
+    }
+    int64_t elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    RecordProperty("us_per_register", (int)(elapsed / count));
+
+    // every item stays readable once the layers are merged
+    for (int i = 0; i < count; i += 97)
+    {
+        ExpectSameRead("Late Item " + to_string(i), Device);
+    }
+}
+
+TEST_F(MediaUserSettingSnapshotTest, WriteAndRefresh)
+{
+    // an item read from the report path sees its own writes at once
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Register("Reported Item", Frame, Value((int32_t)0), true, false, true, USER_SETTING_REPORT_PATH, false));
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare("Config Item", Frame, Value((int32_t)0)));
+
+    Value value;
+    m_config.Read(value, "Reported Item", Frame, Value());
+    EXPECT_EQ(0, value.Get<int32_t>());
+
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Write("Reported Item", Value((int32_t)42), Frame, true));
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.Read(value, "Reported Item", Frame, Value()));
+    EXPECT_EQ(42, value.Get<int32_t>());
+    ExpectSameRead("Reported Item", Frame);
+
+    // registry edits behind the configure's back show after a refresh
+    m_config.Read(value, "Config Item", Frame, Value());
+    m_config.SetRegistry("Config Item", "9");
+    m_config.Read(value, "Config Item", Frame, Value());
+    EXPECT_EQ(0, value.Get<int32_t>());
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_config.RefreshSnapshot());
+    m_config.Read(value, "Config Item", Frame, Value());
+    EXPECT_EQ(9, value.Get<int32_t>());
+    ExpectSameRead("Reported Item", Frame);
+}
+
+TEST_F(MediaUserSettingSnapshotTest, ConcurrentReadsDuringRegister)
+{
+    const int  threadCount = 4;
+    const int  count       = 2000;
+    atomic<int> declared(0);
+
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare("Stable Item", Sequence, Value((int32_t)3)));
+    m_config.SetRegistry("Stable Item", "11");
+
+    vector<thread> readers;
+    atomic<int>    mismatches(0);
+    for (int t = 0; t < threadCount; t++)
+    {
+        readers.emplace_back([&]() {
+            while (declared.load() < count)
+            {
+                Value value;
+                m_config.Read(value, "Stable Item", Sequence, Value());
+                if (value.Get<int32_t>() != 11)
+                {
+                    mismatches++;
+                }
+                int last = declared.load() - 1;
+                if (last >= 0)
+                {
+                    m_config.Read(value, "Racing Item " + to_string(last), Device, Value());
+                    if (value.Get<int32_t>() != last)
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        string name = "Racing Item " + to_string(i);
+        m_config.SetRegistry(name, to_string(i));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare(name, Device, Value((int32_t)-1)));
+        declared++;
+    }
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+    EXPECT_EQ(0, mismatches.load());
+}
+
+TEST_F(MediaUserSettingSnapshotTest, ReadCost)
+{
+    const int count = 20000;
+
+    for (int i = 0; i < 200; i++)
+    {
+        string name = "Costed Item " + to_string(i);
+        m_config.SetRegistry(name, to_string(i));
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_config.Declare(name, (Group)(i % 3), Value((int32_t)0)));
+    }
+    const string name  = "Costed Item 100";
+    const Group  group = (Group)(100 % 3);
+
+    auto measure = [&](bool cached) {
+        Value value;
+        auto  start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+        {
+            cached ? m_config.Read(value, name, group, Value()) : m_config.ReadUncached(value, name, group);
+        }
+        EXPECT_EQ(100, value.Get<int32_t>());
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / count;
+    };
+
+    measure(true);
+    int64_t cachedNs   = measure(true);
+    int64_t uncachedNs = measure(false);
+    RecordProperty("ns_per_snapshot_read", (int)cachedNs);
+    RecordProperty("ns_per_uncached_read", (int)uncachedNs);
+    EXPECT_LT(cachedNs, uncachedNs);
+}
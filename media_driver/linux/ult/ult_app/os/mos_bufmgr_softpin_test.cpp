@@ -0,0 +1,291 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "i915_drm.h"
+#include "mos_bufmgr_api.h"
+#include "mos_defs.h"
+#include "mos_resource_defs.h"
+
+using namespace std;
+
+// Minimal i915 device for mos_bufmgr: buffers are only created, submitted
+// and closed, and each execbuffer's object list is recorded.
+static uint32_t         g_nextHandle;
+static set<uint32_t>    g_liveHandles;
+static vector<uint32_t> g_execHandles;
+static vector<uint64_t> g_execFlags;
+static uint32_t         g_execCount;
+
+extern "C" int drmIoctl(int fd, unsigned long request, void *arg)
+{
+    switch (request)
+    {
+    case DRM_IOCTL_VERSION:
+    {
+        drm_version_t *version = (drm_version_t *)arg;
+        strncpy(version->name, "i915", version->name_len);
+        return 0;
+    }
+    case DRM_IOCTL_I915_GETPARAM:
+    {
+        drm_i915_getparam_t *gp = (drm_i915_getparam_t *)arg;
+        *gp->value = (gp->param == I915_PARAM_CHIPSET_ID) ? 0x9a49 : 1;
+        return 0;
+    }
+    case DRM_IOCTL_I915_GEM_GET_APERTURE:
+        ((struct drm_i915_gem_get_aperture *)arg)->aper_available_size = 1ull << 32;
+        return 0;
+    case DRM_IOCTL_I915_GEM_CONTEXT_GETPARAM:
+        ((struct drm_i915_gem_context_param *)arg)->value = 1ull << 48;
+        return 0;
+    case DRM_IOCTL_I915_GEM_CREATE:
+        ((struct drm_i915_gem_create *)arg)->handle = ++g_nextHandle;
+        g_liveHandles.insert(g_nextHandle);
+        return 0;
+    case DRM_IOCTL_GEM_CLOSE:
+        g_liveHandles.erase(((struct drm_gem_close *)arg)->handle);
+        return 0;
+    case DRM_IOCTL_I915_GEM_EXECBUFFER2_WR:
+    {
+        struct drm_i915_gem_execbuffer2   *execbuf = (struct drm_i915_gem_execbuffer2 *)arg;
+        struct drm_i915_gem_exec_object2 *objects = (struct drm_i915_gem_exec_object2 *)execbuf->buffers_ptr;
+        g_execHandles.clear();
+        g_execFlags.clear();
+        for (uint32_t i = 0; i < execbuf->buffer_count; i++)
+        {
+            g_execHandles.push_back(objects[i].handle);
+            g_execFlags.push_back(objects[i].flags);
+        }
+        g_execCount++;
+        return 0;
+    }
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+}
+
+extern "C" int drmPrimeHandleToFD(int fd, uint32_t handle, uint32_t flags, int *prime_fd)
+{
+    errno = EINVAL;
+    return -1;
+}
+
+extern "C" int drmPrimeFDToHandle(int fd, int prime_fd, uint32_t *handle)
+{
+    errno = EINVAL;
+    return -1;
+}
+
+class MosBufmgrSoftpinTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_nextHandle = 0;
+        g_liveHandles.clear();
+        g_execHandles.clear();
+        g_execCount = 0;
+
+        m_bufmgr = mos_bufmgr_gem_init(m_fd, 4096);
+        ASSERT_NE(nullptr, m_bufmgr);
+        mos_bufmgr_enable_softpin(m_bufmgr, false);
+    }
+
+    void TearDown() override
+    {
+        mos_bufmgr_destroy(m_bufmgr);
+        EXPECT_TRUE(g_liveHandles.empty());
+    }
+
+    struct mos_linux_bo *Alloc(const char *name)
+    {
+        struct mos_linux_bo *bo = mos_bo_alloc(m_bufmgr, name, 4096, 4096, MOS_MEMPOOL_SYSTEMMEMORY);
+        EXPECT_NE(nullptr, bo);
+        EXPECT_EQ(0, mos_bo_set_softpin(bo));
+        return bo;
+    }
+
+    vector<struct mos_linux_bo *> AllocTargets(size_t count)
+    {
+        vector<struct mos_linux_bo *> targets;
+        for (size_t i = 0; i < count; i++)
+        {
+            targets.push_back(Alloc("target"));
+        }
+        return targets;
+    }
+
+    void Release(vector<struct mos_linux_bo *> &bos)
+    {
+        for (auto bo : bos)
+        {
+            mos_bo_unreference(bo);
+        }
+        bos.clear();
+    }
+
+    //! Submits batch and checks the execbuffer lists each bo exactly once
+    void ExpectExec(struct mos_linux_bo *batch, const set<struct mos_linux_bo *> &targets)
+    {
+        ASSERT_EQ(0, mos_bo_context_exec2(batch, 4096, nullptr, nullptr, 0, 0, I915_EXEC_RENDER, nullptr));
+
+        set<uint32_t> expected;
+        expected.insert(batch->handle);
+        for (auto target : targets)
+        {
+            expected.insert(target->handle);
+        }
+        EXPECT_EQ(expected.size(), g_execHandles.size());
+        EXPECT_EQ(expected, set<uint32_t>(g_execHandles.begin(), g_execHandles.end()));
+    }
+
+    int                m_fd     = 1;
+    struct mos_bufmgr *m_bufmgr = nullptr;
+};
+
+TEST_F(MosBufmgrSoftpinTest, ExecObjectsAreUnique)
+{
+    struct mos_linux_bo          *batch   = Alloc("batch");
+    vector<struct mos_linux_bo *> targets = AllocTargets(300);
+    set<struct mos_linux_bo *>    added;
+    mt19937                       rand(2024);
+
+    // Resources are referenced by many commands of the batch
+    for (int frame = 0; frame < 4; frame++)
+    {
+        for (int i = 0; i < 3000; i++)
+        {
+            struct mos_linux_bo *target = targets[rand() % targets.size()];
+            ASSERT_EQ(0, mos_bo_add_softpin_target(batch, target, rand() & 1));
+            added.insert(target);
+        }
+        ExpectExec(batch, added);
+        mos_bo_clear_relocs(batch, 0);
+        added.clear();
+    }
+
+    mos_bo_unreference(batch);
+    Release(targets);
+}
+
+TEST_F(MosBufmgrSoftpinTest, SharedTargetsAreUnique)
+{
+    struct mos_linux_bo          *primary   = Alloc("primary");
+    struct mos_linux_bo          *secondary = Alloc("secondary");
+    vector<struct mos_linux_bo *> targets   = AllocTargets(64);
+    set<struct mos_linux_bo *>    primaryAdded, secondaryAdded;
+    mt19937                       rand(7);
+
+    // Targets interleave between two live lists, then one of them is
+    // cleared while the other keeps adding the same targets
+    for (int round = 0; round < 8; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            struct mos_linux_bo *target = targets[rand() % targets.size()];
+            if (rand() & 1)
+            {
+                ASSERT_EQ(0, mos_bo_add_softpin_target(primary, target, false));
+                primaryAdded.insert(target);
+            }
+            else
+            {
+                ASSERT_EQ(0, mos_bo_add_softpin_target(secondary, target, true));
+                secondaryAdded.insert(target);
+            }
+        }
+        if (round & 1)
+        {
+            ExpectExec(primary, primaryAdded);
+            mos_bo_clear_relocs(primary, 0);
+            primaryAdded.clear();
+        }
+        else
+        {
+            ExpectExec(secondary, secondaryAdded);
+            mos_bo_clear_relocs(secondary, 0);
+            secondaryAdded.clear();
+        }
+    }
+    ExpectExec(primary, primaryAdded);
+    ExpectExec(secondary, secondaryAdded);
+
+    // Batches hold one reference per unique target: all handles close
+    mos_bo_unreference(primary);
+    mos_bo_unreference(secondary);
+    Release(targets);
+}
+
+TEST_F(MosBufmgrSoftpinTest, WriteFlagMerged)
+{
+    struct mos_linux_bo *batch  = Alloc("batch");
+    struct mos_linux_bo *target = Alloc("target");
+
+    ASSERT_EQ(0, mos_bo_add_softpin_target(batch, target, false));
+    ASSERT_EQ(0, mos_bo_add_softpin_target(batch, target, true));
+    ASSERT_EQ(0, mos_bo_add_softpin_target(batch, target, false));
+
+    ExpectExec(batch, {target});
+    EXPECT_EQ(target->handle, g_execHandles[0]);
+    EXPECT_TRUE(g_execFlags[0] & EXEC_OBJECT_WRITE);
+
+    mos_bo_unreference(batch);
+    mos_bo_unreference(target);
+}
+
+TEST_F(MosBufmgrSoftpinTest, RecycledTargetsAddInLinearTime)
+{
+    struct mos_linux_bo          *batch   = Alloc("batch");
+    vector<struct mos_linux_bo *> targets = AllocTargets(16384);
+
+    // Every target was on a list before: adding it again must not walk the
+    // batch's list, else building the batch is quadratic in its size
+    auto build = [&]() {
+        auto start = chrono::steady_clock::now();
+        for (auto target : targets)
+        {
+            EXPECT_EQ(0, mos_bo_add_softpin_target(batch, target, false));
+        }
+        auto elapsed = chrono::steady_clock::now() - start;
+        mos_bo_clear_relocs(batch, 0);
+        return chrono::duration_cast<chrono::microseconds>(elapsed).count();
+    };
+
+    int64_t first = build();
+    int64_t recycled = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        recycled = max(recycled, build());
+    }
+    EXPECT_LT(recycled, 10 * first + 20000);
+
+    mos_bo_unreference(batch);
+    Release(targets);
+}
@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "mos_utilities.h"
+
+using namespace std;
+
+// Budget of one startTick or stopTick call on a hot tag
+static const int64_t kProbeOverheadNs = 1000;
+
+class PerfUtilityTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char dirName[] = "/tmp/perf_utility_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirName));
+        m_dir = string(dirName) + "/";
+        m_perf.setupFilePath(m_dir.c_str());
+    }
+
+    void TearDown() override
+    {
+        unlink(m_perf.sSummaryFileName);
+        unlink(m_perf.sDetailsFileName);
+        unlink(m_perf.sTraceFileName);
+        rmdir(m_dir.c_str());
+    }
+
+    //! Hit count of each tag in the summary file
+    map<string, uint32_t> SavedCounts()
+    {
+        m_perf.savePerfData();
+
+        map<string, uint32_t> counts;
+        ifstream              fin(m_perf.sSummaryFileName);
+        string                line;
+        getline(fin, line);  // "Summary: "
+        getline(fin, line);  // column names
+        while (getline(fin, line))
+        {
+            size_t comma = line.find(',');
+            if (comma != string::npos)
+            {
+                counts[line.substr(0, comma)] = (uint32_t)stoul(line.substr(comma + 1));
+            }
+        }
+        return counts;
+    }
+
+    string ReadTrace()
+    {
+        ifstream     fin(m_perf.sTraceFileName);
+        stringstream ss;
+        ss << fin.rdbuf();
+        return ss.str();
+    }
+
+    PerfUtility m_perf;
+    string      m_dir;
+};
+
+TEST_F(PerfUtilityTest, ProbeOverhead)
+{
+    const string tag   = "ProbeOverhead";
+    const int    count = 20000;
+
+    // first use interns the tag
+    m_perf.startTick(tag);
+    m_perf.stopTick(tag);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        m_perf.startTick(tag);
+        m_perf.stopTick(tag);
+    }
+    int64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    int64_t perProbe = elapsed / (2 * count);
+    RecordProperty("ns_per_probe", (int)perProbe);
+    EXPECT_LT(perProbe, kProbeOverheadNs);
+    EXPECT_EQ(count + 1u, SavedCounts()[tag]);
+}
+
+TEST_F(PerfUtilityTest, NestedTicks)
+{
+    m_perf.startTick("Outer");
+    m_perf.startTick("Inner");
+    m_perf.startTick("Inner");
+    m_perf.stopTick("Inner");
+    m_perf.stopTick("Inner");
+    m_perf.stopTick("Outer");
+    m_perf.startTick("Open");
+
+    // stop without start is ignored
+    m_perf.stopTick("Unknown");
+
+    auto counts = SavedCounts();
+    EXPECT_EQ(1u, counts["Outer"]);
+    EXPECT_EQ(2u, counts["Inner"]);
+    EXPECT_EQ(0u, counts.count("Open"));
+    EXPECT_EQ(0u, counts.count("Unknown"));
+}
+
+TEST_F(PerfUtilityTest, CrossThreadStop)
+{
+    // started by a worker, stopped by this thread
+    thread worker([this]() { m_perf.startTick("Submit"); });
+    worker.join();
+    m_perf.stopTick("Submit");
+
+    // started here and stopped by a worker, then by this thread again
+    m_perf.startTick("Wait");
+    m_perf.startTick("Wait");
+    thread stopper([this]() { m_perf.stopTick("Wait"); });
+    stopper.join();
+    m_perf.stopTick("Wait");
+    m_perf.stopTick("Wait");
+
+    auto counts = SavedCounts();
+    EXPECT_EQ(1u, counts["Submit"]);
+    EXPECT_EQ(2u, counts["Wait"]);
+}
+
+TEST_F(PerfUtilityTest, RingIsBounded)
+{
+    const uint32_t count = (uint32_t)PerfUtility::PERF_TICK_RING_SIZE + 1000;
+
+    // an open tick overwritten by the ring can't be stopped any more
+    m_perf.startTick("Lost");
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_perf.startTick("Frame");
+        m_perf.stopTick("Frame");
+    }
+    m_perf.stopTick("Lost");
+
+    auto counts = SavedCounts();
+    EXPECT_EQ((uint32_t)PerfUtility::PERF_TICK_RING_SIZE, counts["Frame"]);
+    EXPECT_EQ(0u, counts.count("Lost"));
+}
+
+TEST_F(PerfUtilityTest, ConcurrentThreads)
+{
+    const int threadCount = 8;
+    const int count       = 5000;
+
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([this, t]() {
+            string own = "Thread" + to_string(t);
+            for (int i = 0; i < count; i++)
+            {
+                m_perf.startTick("Shared");
+                m_perf.startTick(own);
+                m_perf.stopTick(own);
+                m_perf.stopTick("Shared");
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    auto counts = SavedCounts();
+    EXPECT_EQ((uint32_t)(threadCount * count), counts["Shared"]);
+    for (int t = 0; t < threadCount; t++)
+    {
+        EXPECT_EQ((uint32_t)count, counts["Thread" + to_string(t)]);
+    }
+}
+
+TEST_F(PerfUtilityTest, TraceEscapesNames)
+{
+    m_perf.startTick("Quote\"Back\\slash");
+    m_perf.stopTick("Quote\"Back\\slash");
+    m_perf.startTick("Tab\tName");
+    m_perf.stopTick("Tab\tName");
+    m_perf.savePerfData();
+
+    string trace = ReadTrace();
+    EXPECT_NE(string::npos, trace.find("\"name\":\"Quote\\\"Back\\\\slash\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"Tab\\u0009Name\""));
+    EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+}
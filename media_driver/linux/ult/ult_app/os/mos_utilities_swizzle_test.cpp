@@ -0,0 +1,168 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mos_utilities.h"
+
+using namespace std;
+
+class MosSwizzleTest : public testing::Test
+{
+protected:
+    static const size_t kGuard = 64;
+
+    //! Per byte translation MosSwizzleData did before copying by spans
+    static void Reference(
+        uint8_t       *src,
+        uint8_t       *dst,
+        MOS_TILE_TYPE srcTiling,
+        MOS_TILE_TYPE dstTiling,
+        int32_t       height,
+        int32_t       pitch)
+    {
+        bool    tiledToLinear = (srcTiling != MOS_TILE_LINEAR);
+        int32_t linearOffset  = 0;
+        for (int32_t y = 0; y < height; y++)
+        {
+            for (int32_t x = 0; x < pitch; x++, linearOffset++)
+            {
+                int32_t tileOffset = MosUtilities::MosSwizzleOffsetWrapper(
+                    x, y, pitch, tiledToLinear ? srcTiling : dstTiling, false, 0);
+                if (tileOffset < height * pitch)
+                {
+                    if (tiledToLinear)
+                    {
+                        dst[linearOffset] = src[tileOffset];
+                    }
+                    else
+                    {
+                        dst[tileOffset] = src[linearOffset];
+                    }
+                }
+            }
+        }
+    }
+
+    //! Swizzles a random surface both ways and compares the whole destination, guards included
+    void ExpectSwizzle(MOS_TILE_TYPE tiling, bool tiledToLinear, int32_t height, int32_t pitch)
+    {
+        size_t          size = (size_t)height * pitch;
+        vector<uint8_t> src(size);
+        vector<uint8_t> dst(size + 2 * kGuard, 0xcd);
+        vector<uint8_t> ref(size + 2 * kGuard, 0xcd);
+        for (size_t i = 0; i < size; i++)
+        {
+            src[i] = (uint8_t)(i * 131 + (i >> 8) * 17 + 7);
+        }
+
+        MOS_TILE_TYPE srcTiling = tiledToLinear ? tiling : MOS_TILE_LINEAR;
+        MOS_TILE_TYPE dstTiling = tiledToLinear ? MOS_TILE_LINEAR : tiling;
+        Reference(src.data(), ref.data() + kGuard, srcTiling, dstTiling, height, pitch);
+        MosUtilities::MosSwizzleData(src.data(), dst.data() + kGuard, srcTiling, dstTiling, height, pitch, 0);
+
+        ASSERT_TRUE(ref == dst) << (tiling == MOS_TILE_X ? "TileX" : "TileY")
+                                << (tiledToLinear ? " to linear" : " from linear")
+                                << " height " << height << " pitch " << pitch;
+    }
+};
+
+TEST_F(MosSwizzleTest, MatchesPerByteSwizzle)
+{
+    // Whole and partial tile rows, pitches that are not a multiple of a tile
+    // or of a span, and surfaces smaller than one tile
+    const int32_t heights[] = {1, 2, 7, 8, 9, 31, 32, 33, 64, 100};
+    const int32_t pitches[] = {1, 15, 16, 17, 100, 128, 500, 512, 513, 1000, 1024, 2064};
+
+    for (auto tiling : {MOS_TILE_X, MOS_TILE_Y})
+    {
+        for (auto tiledToLinear : {true, false})
+        {
+            for (auto height : heights)
+            {
+                for (auto pitch : pitches)
+                {
+                    ExpectSwizzle(tiling, tiledToLinear, height, pitch);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(MosSwizzleTest, RoundTrip)
+{
+    // NV12 1080p surface as locked with software swizzling
+    const int32_t   pitch  = 2048;
+    const int32_t   height = 1088 * 3 / 2;
+    size_t          size   = (size_t)height * pitch;
+    vector<uint8_t> linear(size);
+    vector<uint8_t> tiled(size);
+    vector<uint8_t> back(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        linear[i] = (uint8_t)(i * 7 + (i >> 11));
+    }
+
+    for (auto tiling : {MOS_TILE_X, MOS_TILE_Y})
+    {
+        MosUtilities::MosSwizzleData(linear.data(), tiled.data(), MOS_TILE_LINEAR, tiling, height, pitch, 0);
+        MosUtilities::MosSwizzleData(tiled.data(), back.data(), tiling, MOS_TILE_LINEAR, height, pitch, 0);
+        EXPECT_TRUE(linear == back);
+        EXPECT_FALSE(linear == tiled);
+    }
+}
+
+TEST_F(MosSwizzleTest, Throughput)
+{
+    // NV12 1080p readback, the case of a whole surface lock
+    const int32_t   pitch  = 2048;
+    const int32_t   height = 1088 * 3 / 2;
+    size_t          size   = (size_t)height * pitch;
+    vector<uint8_t> src(size, 0x5a);
+    vector<uint8_t> dst(size);
+
+    auto measure = [&](bool perByte, int count) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+        {
+            if (perByte)
+            {
+                Reference(src.data(), dst.data(), MOS_TILE_Y, MOS_TILE_LINEAR, height, pitch);
+            }
+            else
+            {
+                MosUtilities::MosSwizzleData(src.data(), dst.data(), MOS_TILE_Y, MOS_TILE_LINEAR, height, pitch, 0);
+            }
+        }
+        int64_t us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        return (int)((int64_t)size * count / (us + 1));
+    };
+
+    measure(false, 1);
+    int perByteMBps = measure(true, 1);
+    int spanMBps    = measure(false, 8);
+
+    RecordProperty("per_byte_MB_per_s", perByteMBps);
+    RecordProperty("span_MB_per_s", spanMBps);
+    EXPECT_GT(spanMBps, 10 * perByteMBps);
+}
@@ -0,0 +1,322 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "mos_vma.h"
+
+using namespace std;
+
+static const uint64_t kHeapStart = 1ull << 20;
+static const uint64_t kHeapSize  = 1ull << 40;
+static const uint64_t kPageSize  = 4096;
+
+// Budget of one 64KB aligned allocation with thousands of holes in the heap
+static const int64_t kAllocCostNs = 20000;
+
+// The address ordered hole list mos_vma used before the hole tree, kept as
+// the reference for the differential test
+class ReferenceVmaHeap
+{
+public:
+    ReferenceVmaHeap(uint64_t start, uint64_t size)
+    {
+        m_holes[start] = size;
+    }
+
+    uint64_t Alloc(uint64_t size, uint64_t alignment)
+    {
+        if (m_allocHigh)
+        {
+            for (auto hole = m_holes.rbegin(); hole != m_holes.rend(); ++hole)
+            {
+                if (size > hole->second)
+                {
+                    continue;
+                }
+                uint64_t offset = (hole->second - size) + hole->first;
+                offset          = (offset / alignment) * alignment;
+                if (offset >= hole->first)
+                {
+                    Take(hole->first, offset, size);
+                    return offset;
+                }
+            }
+        }
+        else
+        {
+            for (auto hole = m_holes.begin(); hole != m_holes.end(); ++hole)
+            {
+                if (size > hole->second)
+                {
+                    continue;
+                }
+                uint64_t misalign = hole->first % alignment;
+                uint64_t pad      = misalign ? alignment - misalign : 0;
+                if (pad <= hole->second - size)
+                {
+                    uint64_t offset = hole->first + pad;
+                    Take(hole->first, offset, size);
+                    return offset;
+                }
+            }
+        }
+        return 0;
+    }
+
+    bool AllocAddr(uint64_t offset, uint64_t size)
+    {
+        auto hole = m_holes.upper_bound(offset);
+        if (hole == m_holes.begin())
+        {
+            return false;
+        }
+        --hole;
+        if (hole->second < offset - hole->first + size)
+        {
+            return false;
+        }
+        Take(hole->first, offset, size);
+        return true;
+    }
+
+    void Free(uint64_t offset, uint64_t size)
+    {
+        auto high = m_holes.upper_bound(offset);
+        if (high != m_holes.end() && offset + size == high->first)
+        {
+            size += high->second;
+            high = m_holes.erase(high);
+        }
+        if (high != m_holes.begin())
+        {
+            auto low = prev(high);
+            if (low->first + low->second == offset)
+            {
+                low->second += size;
+                return;
+            }
+        }
+        m_holes[offset] = size;
+    }
+
+    map<uint64_t, uint64_t> m_holes;
+    bool                    m_allocHigh = true;
+
+private:
+    void Take(uint64_t holeOffset, uint64_t offset, uint64_t size)
+    {
+        uint64_t holeSize = m_holes[holeOffset];
+        uint64_t waste    = (holeSize - size) - (offset - holeOffset);
+        m_holes.erase(holeOffset);
+        if (offset > holeOffset)
+        {
+            m_holes[holeOffset] = offset - holeOffset;
+        }
+        if (waste > 0)
+        {
+            m_holes[offset + size] = waste;
+        }
+    }
+};
+
+class MosVmaTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        mos_vma_heap_init(&m_heap, kHeapStart, kHeapSize);
+    }
+
+    void TearDown() override
+    {
+        mos_vma_heap_finish(&m_heap);
+    }
+
+    //! Largest size a hole can hold at the given alignment
+    static uint64_t AlignedSize(const mos_vma_hole *hole, uint64_t alignment)
+    {
+        uint64_t misalign = hole->offset % alignment;
+        uint64_t pad      = misalign ? alignment - misalign : 0;
+        return pad <= hole->size ? hole->size - pad : 0;
+    }
+
+    //! Checks the order, priorities and subtree maxima of the hole tree and
+    //! collects its holes in address order
+    void ValidateTree(const mos_vma_hole *hole, vector<const mos_vma_hole *> &holes)
+    {
+        if (hole == nullptr)
+        {
+            return;
+        }
+        uint64_t maxSize = hole->size;
+        uint64_t maxAligned[MOS_VMA_ALIGN_CLASS_COUNT];
+        for (int i = 0; i < MOS_VMA_ALIGN_CLASS_COUNT; i++)
+        {
+            maxAligned[i] = AlignedSize(hole, 1ull << MOS_VMA_ALIGN_CLASS_SHIFT(i));
+        }
+        for (const mos_vma_hole *child : {hole->left, hole->right})
+        {
+            if (child == nullptr)
+            {
+                continue;
+            }
+            EXPECT_LE(child->priority, hole->priority);
+            maxSize = max(maxSize, child->max_size);
+            for (int i = 0; i < MOS_VMA_ALIGN_CLASS_COUNT; i++)
+            {
+                maxAligned[i] = max(maxAligned[i], child->max_aligned_size[i]);
+            }
+        }
+        EXPECT_EQ(maxSize, hole->max_size);
+        for (int i = 0; i < MOS_VMA_ALIGN_CLASS_COUNT; i++)
+        {
+            EXPECT_EQ(maxAligned[i], hole->max_aligned_size[i]);
+        }
+
+        ValidateTree(hole->left, holes);
+        if (!holes.empty())
+        {
+            EXPECT_LT(holes.back()->offset, hole->offset);
+        }
+        holes.push_back(hole);
+        ValidateTree(hole->right, holes);
+    }
+
+    //! Compares the hole list and the hole tree with the reference
+    void ExpectSameHoles(const ReferenceVmaHeap &reference)
+    {
+        vector<const mos_vma_hole *> treeHoles;
+        ValidateTree(m_heap.root, treeHoles);
+
+        // the list runs from high to low addresses
+        vector<const mos_vma_hole *> listHoles;
+        list_for_each_entry(mos_vma_hole, hole, &m_heap.holes, link)
+        {
+            listHoles.insert(listHoles.begin(), hole);
+        }
+        EXPECT_EQ(listHoles, treeHoles);
+
+        ASSERT_EQ(reference.m_holes.size(), treeHoles.size());
+        auto expected = reference.m_holes.begin();
+        for (const mos_vma_hole *hole : treeHoles)
+        {
+            EXPECT_EQ(expected->first, hole->offset);
+            EXPECT_EQ(expected->second, hole->size);
+            ++expected;
+        }
+    }
+
+    mos_vma_heap m_heap;
+};
+
+TEST_F(MosVmaTest, MatchesHoleListReference)
+{
+    const uint64_t alignments[] = {kPageSize, 3 * kPageSize, 1ull << 16, 1ull << 20, 1ull << 21};
+    const int      opCount      = 40000;
+
+    ReferenceVmaHeap                 reference(kHeapStart, kHeapSize);
+    vector<pair<uint64_t, uint64_t>> live;
+    mt19937_64                       rng(7);
+
+    for (int op = 0; op < opCount; op++)
+    {
+        if (op % 5000 == 0)
+        {
+            m_heap.alloc_high = reference.m_allocHigh = (op / 5000) % 2 == 0;
+        }
+
+        uint32_t kind = rng() % 8;
+        if (kind < 4 || live.empty())
+        {
+            // mostly small buffers, sometimes a large one
+            uint64_t size      = (rng() % 16 == 0) ? (1 + rng() % 1024) * kPageSize : (1 + rng() % 32) * kPageSize;
+            uint64_t alignment = alignments[rng() % (sizeof(alignments) / sizeof(alignments[0]))];
+            uint64_t offset    = mos_vma_heap_alloc(&m_heap, size, alignment);
+            ASSERT_EQ(reference.Alloc(size, alignment), offset) << "op " << op;
+            ASSERT_NE(0u, offset);
+            ASSERT_EQ(0u, offset % alignment);
+            live.push_back(make_pair(offset, size));
+        }
+        else if (kind == 4)
+        {
+            // a range inside a random hole, as an imported buffer would take
+            auto hole = reference.m_holes.begin();
+            advance(hole, rng() % reference.m_holes.size());
+            uint64_t pages  = hole->second / kPageSize;
+            uint64_t offset = hole->first + (rng() % pages) * kPageSize;
+            uint64_t size   = (1 + rng() % 16) * kPageSize;
+            bool     ok     = mos_vma_heap_alloc_addr(&m_heap, offset, size);
+            ASSERT_EQ(reference.AllocAddr(offset, size), ok) << "op " << op;
+            if (ok)
+            {
+                live.push_back(make_pair(offset, size));
+            }
+        }
+        else
+        {
+            size_t index = rng() % live.size();
+            mos_vma_heap_free(&m_heap, live[index].first, live[index].second);
+            reference.Free(live[index].first, live[index].second);
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        if (op % 1000 == 0 || op < 1000)
+        {
+            ExpectSameHoles(reference);
+            if (HasFailure())
+            {
+                FAIL() << "op " << op;
+            }
+        }
+    }
+
+    for (auto &range : live)
+    {
+        mos_vma_heap_free(&m_heap, range.first, range.second);
+        reference.Free(range.first, range.second);
+    }
+    ExpectSameHoles(reference);
+    ASSERT_EQ(1u, reference.m_holes.size());
+    EXPECT_EQ(kHeapSize, reference.m_holes.begin()->second);
+}
+
+TEST_F(MosVmaTest, AlignmentWasteCost)
+{
+    // mos_bufmgr aligns every softpinned buffer to 64KB, so each small
+    // buffer leaves a hole that no later allocation can use
+    const int count = 16384;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_NE(0u, mos_vma_heap_alloc(&m_heap, kPageSize, 1ull << 16));
+    }
+    int64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    int64_t perAlloc = elapsed / count;
+    RecordProperty("ns_per_alloc", (int)perAlloc);
+    EXPECT_LT(perAlloc, kAllocCostNs);
+}
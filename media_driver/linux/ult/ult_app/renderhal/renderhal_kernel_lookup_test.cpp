@@ -0,0 +1,227 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "renderhal.h"
+
+using namespace std;
+
+int32_t RenderHal_LoadKernel(
+    PRENDERHAL_INTERFACE     pRenderHal,
+    PCRENDERHAL_KERNEL_PARAM pParameters,
+    PMHW_KERNEL_PARAM        pKernel,
+    Kdll_CacheEntry          *pKernelEntry);
+
+MOS_STATUS RenderHal_UnloadKernel(
+    PRENDERHAL_INTERFACE pRenderHal,
+    int32_t              iKernelAllocationID);
+
+void RenderHal_TouchKernel(
+    PRENDERHAL_INTERFACE pRenderHal,
+    int32_t              iKernelAllocationID);
+
+void RenderHal_ResetKernels(
+    PRENDERHAL_INTERFACE pRenderHal);
+
+// Every kernel is idle, any of them may be evicted
+static MOS_STATUS RefreshSync(PRENDERHAL_INTERFACE pRenderHal)
+{
+    pRenderHal->pStateHeap->dwSyncTag = pRenderHal->pStateHeap->dwNextTag;
+    return MOS_STATUS_SUCCESS;
+}
+
+class RenderHalKernelLookupTest : public testing::Test
+{
+protected:
+    static const int32_t kKernelCount     = 128;
+    static const int32_t kKernelBlockSize = 64;
+    static const int32_t kKernelHeapSize  = 32 * 1024;
+
+    void SetUp() override
+    {
+        m_allocations.resize(kKernelCount);
+        m_ish.resize(kKernelHeapSize);
+
+        m_renderHal.pStateHeap                         = &m_stateHeap;
+        m_renderHal.StateHeapSettings.iKernelCount     = kKernelCount;
+        m_renderHal.StateHeapSettings.iKernelHeapSize  = kKernelHeapSize;
+        m_renderHal.StateHeapSettings.iKernelBlockSize = kKernelBlockSize;
+        m_renderHal.pfnTouchKernel                     = RenderHal_TouchKernel;
+        m_renderHal.pfnUnloadKernel                    = RenderHal_UnloadKernel;
+        m_renderHal.pfnRefreshSync                     = RefreshSync;
+
+        m_stateHeap.pKernelAllocation = m_allocations.data();
+        m_stateHeap.pIshBuffer        = m_ish.data();
+        m_stateHeap.bGshLocked        = true;
+        m_stateHeap.dwNextTag         = 1;
+        RenderHal_ResetKernels(&m_renderHal);
+    }
+
+    //! Kernel binary filled with a pattern of its ids
+    MHW_KERNEL_PARAM &Kernel(int32_t uid, int32_t cid)
+    {
+        m_kernel          = {};
+        m_kernel.iKUID    = uid;
+        m_kernel.iKCID    = cid;
+        m_kernel.iSize    = kKernelBlockSize * (1 + (uid + cid) % 6) - (uid & 31);
+        m_binary.resize(m_kernel.iSize);
+        for (int32_t i = 0; i < m_kernel.iSize; i++)
+        {
+            m_binary[i] = (uint8_t)(uid * 31 + cid * 7 + i);
+        }
+        m_kernel.pBinary = m_binary.data();
+        return m_kernel;
+    }
+
+    //! The allocation the table scan finds for a kernel, -1 if not loaded
+    int32_t Scan(int32_t uid, int32_t cid)
+    {
+        for (int32_t i = 0; i < kKernelCount; i++)
+        {
+            if (m_allocations[i].iKUID == uid && m_allocations[i].iKCID == cid)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    int32_t Load(int32_t uid, int32_t cid)
+    {
+        MHW_KERNEL_PARAM &kernel   = Kernel(uid, cid);
+        int32_t           expected = Scan(uid, cid);
+        int32_t           id       = RenderHal_LoadKernel(&m_renderHal, &m_params, &kernel, nullptr);
+
+        EXPECT_GE(id, 0);
+        if (id < 0)
+        {
+            return id;
+        }
+        if (expected >= 0)
+        {
+            EXPECT_EQ(expected, id) << "kernel " << uid << ":" << cid;
+        }
+        EXPECT_EQ(uid, m_allocations[id].iKUID);
+        EXPECT_EQ(cid, m_allocations[id].iKCID);
+        EXPECT_EQ(0, memcmp(m_ish.data() + m_allocations[id].dwOffset, m_binary.data(), kernel.iSize)) << "kernel " << uid << ":" << cid;
+        return id;
+    }
+
+    RENDERHAL_INTERFACE              m_renderHal = {};
+    RENDERHAL_STATE_HEAP             m_stateHeap = {};
+    RENDERHAL_KERNEL_PARAM           m_params    = {};
+    MHW_KERNEL_PARAM                 m_kernel    = {};
+    vector<RENDERHAL_KRN_ALLOCATION> m_allocations;
+    vector<uint8_t>                  m_ish;
+    vector<uint8_t>                  m_binary;
+};
+
+TEST_F(RenderHalKernelLookupTest, LoadUnloadCycles)
+{
+    mt19937 rand(2024);
+
+    // more kernels than allocations and heap space, so loads evict and reuse slots
+    for (int cycle = 0; cycle < 20000; cycle++)
+    {
+        int32_t uid = rand() % 400;
+        int32_t cid = rand() % 3;
+
+        switch (rand() % 8)
+        {
+        case 0:
+        {
+            // unload whatever sits in a slot
+            int32_t id = rand() % kKernelCount;
+            RenderHal_UnloadKernel(&m_renderHal, id);
+            break;
+        }
+        case 1:
+        {
+            // another loader reuses a slot without going through RenderHal_LoadKernel
+            int32_t id = rand() % kKernelCount;
+            if (m_allocations[id].dwFlags != RENDERHAL_KERNEL_ALLOCATION_FREE)
+            {
+                m_allocations[id].iKUID = 1000 + uid;
+            }
+            break;
+        }
+        default:
+            Load(uid, cid);
+            break;
+        }
+        if (HasFailure())
+        {
+            FAIL() << "cycle " << cycle;
+        }
+
+        if (cycle % 5000 == 4999)
+        {
+            RenderHal_ResetKernels(&m_renderHal);
+        }
+    }
+}
+
+TEST_F(RenderHalKernelLookupTest, ReloadAfterUnload)
+{
+    int32_t id = Load(1, 0);
+    EXPECT_EQ(id, Load(1, 0));
+
+    // the freed slot is refilled by another kernel, the hint to it must not be taken
+    ASSERT_EQ(MOS_STATUS_SUCCESS, RenderHal_UnloadKernel(&m_renderHal, id));
+    EXPECT_EQ(-1, Scan(1, 0));
+    int32_t other = Load(2, 0);
+    EXPECT_EQ(id, other);
+    int32_t reloaded = Load(1, 0);
+    EXPECT_NE(other, reloaded);
+    EXPECT_EQ(other, Load(2, 0));
+    EXPECT_EQ(reloaded, Load(1, 0));
+
+    // same unique id in another cache entry is another kernel
+    EXPECT_NE(reloaded, Load(1, 1));
+}
+
+TEST_F(RenderHalKernelLookupTest, LoadedKernelCost)
+{
+    const int count = 200000;
+
+    vector<int32_t> ids;
+    for (int32_t uid = 0; uid < kKernelCount && m_stateHeap.iKernelUsed < kKernelHeapSize / 2; uid++)
+    {
+        ids.push_back(Load(uid, 0));
+    }
+    int32_t lastUid = (int32_t)ids.size() - 1;
+
+    // the kernel loaded last sits at the end of the table scan
+    MHW_KERNEL_PARAM &kernel = Kernel(lastUid, 0);
+    auto              start  = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(ids.back(), RenderHal_LoadKernel(&m_renderHal, &m_params, &kernel, nullptr));
+    }
+    int64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    RecordProperty("kernels_loaded", (int)ids.size());
+    RecordProperty("ns_per_loaded_kernel", (int)(elapsed / count));
+}
@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "renderhal.h"
+#include "frame_tracker.h"
+#include "hal_oca_interface_next.h"
+#include "media_interfaces_renderhal.h"
+#include "mhw_memory_pool.h"
+#include "mhw_state_heap.h"
+
+// RenderHal is linked from the driver sources for its kernel heap management,
+// the platform, command buffer and debug pieces it references are stubbed.
+MOS_STATUS RenderHal_SendTimingData(
+    PRENDERHAL_INTERFACE pRenderHal,
+    PMOS_COMMAND_BUFFER  pCmdBuffer,
+    bool                 bStartTime)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+uint16_t RenderHal_CalculateYOffset(
+    PMOS_INTERFACE pOsInterface,
+    PMOS_RESOURCE  pOsResource)
+{
+    return 0;
+}
+
+MOS_STATUS RenderHal_AllocateDebugSurface(
+    PRENDERHAL_INTERFACE pRenderHal)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+MOS_STATUS RenderHal_SetupDebugSurfaceState(
+    PRENDERHAL_INTERFACE pRenderHal)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+void RenderHal_FreeDebugSurface(
+    PRENDERHAL_INTERFACE pRenderHal)
+{
+}
+
+MOS_STATUS RenderHal_AddDebugControl(
+    PRENDERHAL_INTERFACE pRenderHal,
+    PMOS_COMMAND_BUFFER  pCmdBuffer)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+MOS_STATUS RenderHal_SetSurfaceStateToken(
+    PRENDERHAL_INTERFACE      pRenderHal,
+    PMHW_SURFACE_TOKEN_PARAMS pParams,
+    void                      *pSurfaceStateToken)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+MOS_STATUS RenderHal_SendSurfaces_PatchList(
+    PRENDERHAL_INTERFACE pRenderHal,
+    PMOS_COMMAND_BUFFER  pCmdBuffer)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+void RenderHal_InitInterfaceEx(
+    PRENDERHAL_INTERFACE pRenderHal)
+{
+}
+
+XRenderHal_Platform_Interface *RenderHalDevice::CreateFactory(
+    PMOS_INTERFACE osInterface)
+{
+    return nullptr;
+}
+
+void HalOcaInterfaceNext::OnIndirectState(MOS_COMMAND_BUFFER &cmdBuffer, MOS_CONTEXT_HANDLE mosContext, void *pMosResource, uint32_t offsetOfIndirectState, bool bUseSizeOfResource, uint32_t sizeOfIndirectState)
+{
+}
+
+void HalOcaInterfaceNext::DumpResourceInfo(MOS_COMMAND_BUFFER &cmdBuffer, MOS_INTERFACE &osInterface, MOS_RESOURCE &res, MOS_HW_COMMAND hwCmdType, uint32_t locationInCmd, uint32_t offsetInRes)
+{
+}
+
+MHW_MEMORY_POOL::~MHW_MEMORY_POOL()
+{
+}
+
+MOS_STATUS XMHW_STATE_HEAP_INTERFACE::LockStateHeap(
+    PMHW_STATE_HEAP pStateHeap)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
@@ -0,0 +1,389 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_copy.h"
+#include "media_copy_common.h"
+
+using namespace std;
+
+// A surface the fake OS interface hands out: linear memory plus the state
+// GMM and the kernel would report for it
+struct FakeSurface
+{
+    MOS_RESOURCE            res          = {};
+    vector<uint8_t>         data;
+    MOS_FORMAT              format       = Format_NV12;
+    uint32_t                width        = 64;
+    uint32_t                height       = 64;
+    uint32_t                pitch        = 64;
+    MOS_TILE_TYPE           tileType     = MOS_TILE_LINEAR;
+    MOS_RESOURCE_MMC_MODE   mmcMode      = MOS_MMC_DISABLED;
+    bool                    cpTagged     = false;
+    bool                    busy         = false;
+    bool                    notLockable  = false;
+    bool                    lockFails    = false;
+};
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+// TaskDispatch reads the resource info of both surfaces for the surface dumps
+static const uint32_t kDumpInfoCalls = 2;
+#else
+static const uint32_t kDumpInfoCalls = 0;
+#endif
+
+static map<GMM_RESOURCE_INFO *, FakeSurface *> g_surfaces;
+static uint32_t                                g_resourceInfoCalls;
+static uint32_t                                g_lockCalls;
+static MediaFeatureTable                       g_skuTable;
+
+static FakeSurface *Lookup(PMOS_RESOURCE res)
+{
+    auto it = g_surfaces.find(res->pGmmResInfo);
+    return it == g_surfaces.end() ? nullptr : it->second;
+}
+
+static MOS_STATUS FakeGetResourceInfo(PMOS_INTERFACE osInterface, PMOS_RESOURCE res, PMOS_SURFACE details)
+{
+    FakeSurface *surface = Lookup(res);
+    if (surface == nullptr)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+    g_resourceInfoCalls++;
+    details->Format   = surface->format;
+    details->dwWidth  = surface->width;
+    details->dwHeight = surface->height;
+    details->dwPitch  = surface->pitch;
+    details->dwSize   = (uint32_t)surface->data.size();
+    details->TileType = surface->tileType;
+    details->UPlaneOffset.iSurfaceOffset = surface->pitch * surface->height;
+    details->VPlaneOffset.iSurfaceOffset = surface->pitch * surface->height;
+    return MOS_STATUS_SUCCESS;
+}
+
+static MOS_STATUS FakeGetMemoryCompressionMode(PMOS_INTERFACE osInterface, PMOS_RESOURCE res, PMOS_MEMCOMP_STATE mmcMode)
+{
+    *mmcMode = (MOS_MEMCOMP_STATE)Lookup(res)->mmcMode;
+    return MOS_STATUS_SUCCESS;
+}
+
+static uint64_t FakeGetResourceHandle(MOS_STREAM_HANDLE streamState, PMOS_RESOURCE res)
+{
+    return (uint64_t)(uintptr_t)res->pGmmResInfo;
+}
+
+static void *FakeLockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE res, PMOS_LOCK_PARAMS flags)
+{
+    g_lockCalls++;
+    FakeSurface *surface = Lookup(res);
+    return surface->lockFails ? nullptr : surface->data.data();
+}
+
+static MOS_STATUS FakeUnlockResource(PMOS_INTERFACE osInterface, PMOS_RESOURCE res)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+static bool FakeIsResourceBusy(PMOS_INTERFACE osInterface, PMOS_RESOURCE res)
+{
+    return Lookup(res)->busy;
+}
+
+static MEDIA_FEATURE_TABLE *FakeGetSkuTable(PMOS_INTERFACE osInterface)
+{
+    return &g_skuTable;
+}
+
+static MediaUserSettingSharedPtr FakeGetUserSettingInstance(PMOS_INTERFACE osInterface)
+{
+    return nullptr;
+}
+
+static void FakeDestroy(PMOS_INTERFACE osInterface, int32_t destroySharedResources)
+{
+}
+
+// Media copy with GPU engines that copy on the CPU and record which one ran
+class TestMediaCopy : public MediaCopyBaseState
+{
+public:
+    TestMediaCopy()
+    {
+        m_osInterface = (PMOS_INTERFACE)MOS_AllocAndZeroMemory(sizeof(MOS_INTERFACE));
+        m_osInterface->pfnGetResourceInfo            = FakeGetResourceInfo;
+        m_osInterface->pfnGetMemoryCompressionMode   = FakeGetMemoryCompressionMode;
+        m_osInterface->pfnGetResourceHandle          = FakeGetResourceHandle;
+        m_osInterface->pfnLockResource               = FakeLockResource;
+        m_osInterface->pfnUnlockResource             = FakeUnlockResource;
+        m_osInterface->pfnIsResourceBusy             = FakeIsResourceBusy;
+        m_osInterface->pfnGetSkuTable                = FakeGetSkuTable;
+        m_osInterface->pfnGetUserSettingInstance     = FakeGetUserSettingInstance;
+        m_osInterface->pfnDestroy                    = FakeDestroy;
+        m_inUseGPUMutex    = MosUtilities::MosCreateMutex();
+        m_engineCacheMutex = MosUtilities::MosCreateMutex();
+    }
+
+    vector<MCPY_ENGINE> m_engines;
+    bool                m_veboxFormats  = true;
+    bool                m_renderFormats = true;
+
+protected:
+    // GMM is not available here, the key is read from the fake surface instead
+    MOS_STATUS GetResourceKey(PMOS_RESOURCE res, MCPY_RESOURCE_KEY &key) override
+    {
+        FakeSurface *surface = Lookup(res);
+        MCPY_CHK_NULL_RETURN(surface);
+        key.pGmmResInfo     = res->pGmmResInfo;
+        key.handle          = FakeGetResourceHandle(nullptr, res);
+        key.width           = surface->width;
+        key.height          = surface->height;
+        key.pitch           = surface->pitch;
+        key.size            = surface->data.size();
+        key.bNotLockable    = surface->notLockable;
+        key.CompressionMode = surface->mmcMode;
+        key.CpMode          = surface->cpTagged ? MCPY_CPMODE_CP : MCPY_CPMODE_CLEAR;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    bool IsVeboxCopySupported(PMOS_RESOURCE src, PMOS_RESOURCE dst) override
+    {
+        return m_veboxFormats;
+    }
+
+    bool RenderFormatSupportCheck(PMOS_RESOURCE src, PMOS_RESOURCE dst) override
+    {
+        return m_renderFormats;
+    }
+
+    MOS_STATUS GpuCopy(MCPY_ENGINE engine, PMOS_RESOURCE src, PMOS_RESOURCE dst)
+    {
+        m_engines.push_back(engine);
+        FakeSurface *source = Lookup(src);
+        FakeSurface *target = Lookup(dst);
+        memcpy(target->data.data(), source->data.data(), min(source->data.size(), target->data.size()));
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_STATUS MediaBltCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst) override
+    {
+        return GpuCopy(MCPY_ENGINE_BLT, src, dst);
+    }
+
+    MOS_STATUS MediaRenderCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst) override
+    {
+        return GpuCopy(MCPY_ENGINE_RENDER, src, dst);
+    }
+
+    MOS_STATUS MediaVeboxCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst) override
+    {
+        return GpuCopy(MCPY_ENGINE_VEBOX, src, dst);
+    }
+
+    MOS_STATUS MediaCpuCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst, uint32_t srcSize, uint32_t dstSize) override
+    {
+        MOS_STATUS status = MediaCopyBaseState::MediaCpuCopy(src, dst, srcSize, dstSize);
+        if (status == MOS_STATUS_SUCCESS)
+        {
+            m_engines.push_back(MCPY_ENGINE_CPU);
+        }
+        return status;
+    }
+};
+
+class MediaCopyTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_surfaces.clear();
+        g_resourceInfoCalls = 0;
+        g_lockCalls         = 0;
+        g_skuTable.reset();
+    }
+
+    void TearDown() override
+    {
+        for (auto surface : m_surfaces)
+        {
+            delete surface;
+        }
+        g_surfaces.clear();
+    }
+
+    FakeSurface *CreateSurface(uint32_t size, uint8_t seed)
+    {
+        FakeSurface *surface = new FakeSurface;
+        surface->data.resize(size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            surface->data[i] = (uint8_t)(seed + i * 7);
+        }
+        // the GMM resource info only serves as identity
+        surface->res.pGmmResInfo = (GMM_RESOURCE_INFO *)surface;
+        g_surfaces[surface->res.pGmmResInfo] = surface;
+        m_surfaces.push_back(surface);
+        return surface;
+    }
+
+    MCPY_ENGINE Copy(FakeSurface *src, FakeSurface *dst, MCPY_METHOD method)
+    {
+        size_t count = m_copy.m_engines.size();
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_copy.SurfaceCopy(&src->res, &dst->res, method));
+        EXPECT_EQ(count + 1, m_copy.m_engines.size());
+        EXPECT_EQ(src->data, vector<uint8_t>(dst->data.begin(), dst->data.begin() + src->data.size()));
+        return m_copy.m_engines.back();
+    }
+
+    TestMediaCopy         m_copy;
+    vector<FakeSurface *> m_surfaces;
+};
+
+TEST_F(MediaCopyTest, EngineFollowsMethod)
+{
+    FakeSurface *src = CreateSurface(1 << 20, 1);
+    FakeSurface *dst = CreateSurface(1 << 20, 2);
+
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_DEFAULT));
+    EXPECT_EQ(MCPY_ENGINE_VEBOX, Copy(src, dst, MCPY_METHOD_BALANCE));
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src, dst, MCPY_METHOD_POWERSAVING));
+
+    // capabilities narrow the choice
+    FakeSurface *src2 = CreateSurface(1 << 20, 3);
+    m_copy.m_renderFormats = false;
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src2, dst, MCPY_METHOD_PERFORMANCE));
+    m_copy.m_veboxFormats = false;
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src2, dst, MCPY_METHOD_BALANCE));
+}
+
+TEST_F(MediaCopyTest, CachedPairSkipsResourceInfo)
+{
+    FakeSurface *src = CreateSurface(1 << 20, 4);
+    FakeSurface *dst = CreateSurface(1 << 20, 5);
+
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+    EXPECT_EQ(2u + kDumpInfoCalls, g_resourceInfoCalls);
+
+    // a cached pair keeps its engine even if the format checks would change it now
+    m_copy.m_renderFormats = false;
+    g_resourceInfoCalls    = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        src->data[i] ^= 0xff;
+        EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+    }
+    EXPECT_EQ(10 * kDumpInfoCalls, g_resourceInfoCalls);
+
+    // state that changes on a live resource misses the cache
+    dst->mmcMode = MOS_MMC_RC;
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+
+    // so does a resource reallocated behind the same identity with a new layout
+    dst->mmcMode = MOS_MMC_DISABLED;
+    dst->pitch   = 128;
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+}
+
+TEST_F(MediaCopyTest, CpuCopyForSmallIdleSurfaces)
+{
+    FakeSurface *src = CreateSurface(6144, 6);
+    FakeSurface *dst = CreateSurface(6144, 7);
+
+    EXPECT_EQ(MCPY_ENGINE_CPU, Copy(src, dst, MCPY_METHOD_DEFAULT));
+    EXPECT_EQ(2u, g_lockCalls);
+
+    // explicit methods keep their gpu engine
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+    EXPECT_EQ(MCPY_ENGINE_BLT, Copy(src, dst, MCPY_METHOD_POWERSAVING));
+
+    // a busy surface goes to the gpu, the same pair goes back to the cpu once idle
+    src->busy = true;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_DEFAULT));
+    src->busy = false;
+    src->data[0] ^= 0xff;
+    EXPECT_EQ(MCPY_ENGINE_CPU, Copy(src, dst, MCPY_METHOD_DEFAULT));
+
+    // a failed lock falls back to the gpu engine
+    dst->lockFails = true;
+    src->data[0] ^= 0xff;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_DEFAULT));
+}
+
+TEST_F(MediaCopyTest, CpuCopyRestrictions)
+{
+    FakeSurface *large = CreateSurface(MCPY_CPU_COPY_MAX_SIZE + 4096, 8);
+    FakeSurface *largeDst = CreateSurface(MCPY_CPU_COPY_MAX_SIZE + 4096, 9);
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(large, largeDst, MCPY_METHOD_DEFAULT));
+
+    FakeSurface *tiled = CreateSurface(6144, 10);
+    FakeSurface *linear = CreateSurface(6144, 11);
+    tiled->tileType = MOS_TILE_Y;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(tiled, linear, MCPY_METHOD_DEFAULT));
+
+    FakeSurface *protectedSrc = CreateSurface(6144, 12);
+    protectedSrc->cpTagged = true;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(protectedSrc, linear, MCPY_METHOD_DEFAULT));
+
+    FakeSurface *lockless = CreateSurface(6144, 13);
+    lockless->notLockable = true;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(lockless, linear, MCPY_METHOD_DEFAULT));
+
+    FakeSurface *otherPitch = CreateSurface(6144, 14);
+    otherPitch->pitch = 32;
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(otherPitch, linear, MCPY_METHOD_DEFAULT));
+
+    // device local memory is never read back through the cpu
+    FakeSurface *src = CreateSurface(6144, 15);
+    MEDIA_WR_SKU(&g_skuTable, FtrLocalMemory, 1);
+    EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, linear, MCPY_METHOD_DEFAULT));
+}
+
+TEST_F(MediaCopyTest, CacheIsBounded)
+{
+    vector<FakeSurface *> sources;
+    FakeSurface          *dst = CreateSurface(1 << 20, 16);
+    for (uint32_t i = 0; i < 2 * MCPY_ENGINE_CACHE_SIZE; i++)
+    {
+        sources.push_back(CreateSurface(1 << 20, (uint8_t)(17 + i)));
+    }
+
+    for (int round = 0; round < 2; round++)
+    {
+        for (auto src : sources)
+        {
+            EXPECT_EQ(MCPY_ENGINE_RENDER, Copy(src, dst, MCPY_METHOD_PERFORMANCE));
+        }
+    }
+
+    // the last pairs are still cached
+    g_resourceInfoCalls = 0;
+    Copy(sources.back(), dst, MCPY_METHOD_PERFORMANCE);
+    EXPECT_EQ(kDumpInfoCalls, g_resourceInfoCalls);
+
+    // the first ones were evicted
+    g_resourceInfoCalls = 0;
+    Copy(sources.front(), dst, MCPY_METHOD_PERFORMANCE);
+    EXPECT_EQ(2u + kDumpInfoCalls, g_resourceInfoCalls);
+}
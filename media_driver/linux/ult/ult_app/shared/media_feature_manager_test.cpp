@@ -0,0 +1,225 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_feature.h"
+#include "media_feature_manager.h"
+
+using namespace std;
+
+// Features of an encode pipeline register this many, give or take
+static const int kFeatureCount = 20;
+
+// A MHW ParSetting interface: one SETPAR per command, empty by default
+template <int N>
+class FakeParSetting
+{
+public:
+    virtual ~FakeParSetting() {}
+
+    virtual MOS_STATUS SetPar(uint32_t &par) const
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+};
+
+class FakeFeature : public MediaFeature
+{
+public:
+    FakeFeature(uint32_t weight) : m_weight(weight) {}
+
+protected:
+    MOS_STATUS AddWeight(uint32_t &par) const
+    {
+        par += m_weight;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    uint32_t m_weight;
+};
+
+class FeatureSetting01 : public FakeFeature, public FakeParSetting<0>, public FakeParSetting<1>
+{
+public:
+    using FakeFeature::FakeFeature;
+    MOS_STATUS SetPar(uint32_t &par) const override { return AddWeight(par); }
+};
+
+class FeatureSetting12 : public FakeFeature, public FakeParSetting<1>, public FakeParSetting<2>
+{
+public:
+    using FakeFeature::FakeFeature;
+    MOS_STATUS SetPar(uint32_t &par) const override { return AddWeight(par); }
+};
+
+class FeatureSetting2 : public FakeFeature, public FakeParSetting<2>
+{
+public:
+    using FakeFeature::FakeFeature;
+    MOS_STATUS SetPar(uint32_t &par) const override { return AddWeight(par); }
+};
+
+class FeatureNoSetting : public FakeFeature
+{
+public:
+    using FakeFeature::FakeFeature;
+};
+
+class MediaFeatureManagerTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for (int id = 0; id < kFeatureCount; id++)
+        {
+            MediaFeature *feature = nullptr;
+            switch (id % 4)
+            {
+            case 0:
+                feature = MOS_New(FeatureSetting01, 1u << id);
+                break;
+            case 1:
+                feature = MOS_New(FeatureSetting12, 1u << id);
+                break;
+            case 2:
+                feature = MOS_New(FeatureSetting2, 1u << id);
+                break;
+            default:
+                feature = MOS_New(FeatureNoSetting, 1u << id);
+                break;
+            }
+            ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.RegisterFeatures(id, feature));
+        }
+    }
+
+    //! SETPAR as it was: cast every feature to the setting interface
+    template <typename T>
+    static uint32_t SetParByCast(MediaFeatureManager::ManagerLite &manager)
+    {
+        uint32_t par = 0;
+        for (auto feature : manager)
+        {
+            auto p = dynamic_cast<const T *>(feature);
+            if (p)
+            {
+                p->SetPar(par);
+            }
+        }
+        return par;
+    }
+
+    //! SETPAR as it is: walk the cached list of the setting interface
+    template <typename T>
+    static uint32_t SetParByCache(MediaFeatureManager::ManagerLite &manager)
+    {
+        uint32_t par = 0;
+        for (auto feature : manager.template GetSettingFeatures<T>())
+        {
+            static_cast<const T *>(feature)->SetPar(par);
+        }
+        return par;
+    }
+
+    MediaFeatureManager m_manager;
+};
+
+TEST_F(MediaFeatureManagerTest, SettingFeaturesMatchCast)
+{
+    auto packet = m_manager.GetPacketLevelFeatureManager(0);
+
+    // twice, the second time from the cache
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(SetParByCast<FakeParSetting<0>>(*packet), SetParByCache<FakeParSetting<0>>(*packet));
+        EXPECT_EQ(SetParByCast<FakeParSetting<1>>(*packet), SetParByCache<FakeParSetting<1>>(*packet));
+        EXPECT_EQ(SetParByCast<FakeParSetting<2>>(*packet), SetParByCache<FakeParSetting<2>>(*packet));
+        EXPECT_TRUE(packet->GetSettingFeatures<FakeParSetting<3>>().empty());
+    }
+    EXPECT_EQ(5u, packet->GetSettingFeatures<FakeParSetting<0>>().size());
+    EXPECT_EQ(10u, packet->GetSettingFeatures<FakeParSetting<1>>().size());
+    EXPECT_EQ(10u, packet->GetSettingFeatures<FakeParSetting<2>>().size());
+
+    // the pointers are the interface subobjects, not the features
+    for (auto feature : packet->GetSettingFeatures<FakeParSetting<1>>())
+    {
+        EXPECT_NE(nullptr, dynamic_cast<const FakeFeature *>(static_cast<const FakeParSetting<1> *>(feature)));
+    }
+}
+
+TEST_F(MediaFeatureManagerTest, PacketListsFollowBlockList)
+{
+    // feature 0 is blocked from packet 1, feature 4 only allowed in packet 2
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.RegisterFeatures(0, MOS_New(FeatureSetting01, 1u), {1}, LIST_TYPE::BLOCK_LIST));
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.RegisterFeatures(4, MOS_New(FeatureSetting01, 1u << 4), {2}, LIST_TYPE::ALLOW_LIST));
+
+    auto packet1 = m_manager.GetPacketLevelFeatureManager(1);
+    auto packet2 = m_manager.GetPacketLevelFeatureManager(2);
+    uint32_t all = 0x11111;
+    EXPECT_EQ(all & ~0x11u, SetParByCache<FakeParSetting<0>>(*packet1));
+    EXPECT_EQ(all, SetParByCache<FakeParSetting<0>>(*packet2));
+}
+
+TEST_F(MediaFeatureManagerTest, CacheDroppedOnRegister)
+{
+    EXPECT_EQ(0x11111u, SetParByCache<FakeParSetting<0>>(*m_manager.GetPacketLevelFeatureManager(0)));
+
+    // the pipeline level list is filled before a feature is added and replaced
+    EXPECT_EQ(5u, m_manager.GetSettingFeatures<FakeParSetting<0>>().size());
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.RegisterFeatures(kFeatureCount, MOS_New(FeatureSetting01, 1u << kFeatureCount)));
+    EXPECT_EQ(6u, m_manager.GetSettingFeatures<FakeParSetting<0>>().size());
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.RegisterFeatures(0, MOS_New(FeatureNoSetting, 1u)));
+    EXPECT_EQ(5u, m_manager.GetSettingFeatures<FakeParSetting<0>>().size());
+
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_manager.Destroy());
+    EXPECT_TRUE(m_manager.GetSettingFeatures<FakeParSetting<0>>().empty());
+}
+
+TEST_F(MediaFeatureManagerTest, SetparCost)
+{
+    const int count = 20000;
+    auto      packet = m_manager.GetPacketLevelFeatureManager(0);
+    uint32_t  sum    = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        sum += SetParByCast<FakeParSetting<0>>(*packet);
+        sum += SetParByCast<FakeParSetting<1>>(*packet);
+        sum += SetParByCast<FakeParSetting<2>>(*packet);
+    }
+    int64_t castNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        sum -= SetParByCache<FakeParSetting<0>>(*packet);
+        sum -= SetParByCache<FakeParSetting<1>>(*packet);
+        sum -= SetParByCache<FakeParSetting<2>>(*packet);
+    }
+    int64_t cacheNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(0u, sum);
+    RecordProperty("ns_per_setpar_cast", (int)(castNs / (3 * count)));
+    RecordProperty("ns_per_setpar_cache", (int)(cacheNs / (3 * count)));
+    EXPECT_LT(cacheNs, castNs);
+}
@@ -0,0 +1,283 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media_status_report.h"
+
+using namespace std;
+
+enum TestReportStatus
+{
+    reportCompleted = 0,
+    reportIncomplete,
+    reportUnavailable,
+};
+
+struct TestReport
+{
+    uint32_t         frame;
+    TestReportStatus status;
+};
+
+// Status report whose slots hold the frame number submitted into them
+class TestStatusReport : public MediaStatusReport
+{
+public:
+    TestStatusReport()
+    {
+        m_sizeOfReport   = sizeof(TestReport);
+        m_completedCount = &m_completed;
+    }
+
+    MOS_STATUS Create() override
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_STATUS Init(void *inputPar) override
+    {
+        m_frames[CounterToIndex(m_submittedCount)] = *(uint32_t *)inputPar;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    MOS_STATUS Reset() override
+    {
+        m_submittedCount++;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    //! Stands for the gpu writing the completed count
+    void Complete(uint32_t count)
+    {
+        __atomic_store_n(&m_completed, count, __ATOMIC_RELEASE);
+    }
+
+    vector<uint32_t> m_parsedFrames;  //!< In parse order, written under the report lock
+
+protected:
+    MOS_STATUS ParseStatus(void *report, uint32_t index) override
+    {
+        TestReport *testReport = (TestReport *)report;
+        testReport->frame      = m_frames[index];
+        testReport->status     = reportCompleted;
+        m_parsedFrames.push_back(m_frames[index]);
+        return NotifyObservers(nullptr, nullptr, testReport);
+    }
+
+    MOS_STATUS SetStatus(void *report, uint32_t index, bool outOfRange) override
+    {
+        TestReport *testReport = (TestReport *)report;
+        testReport->frame      = m_frames[index];
+        testReport->status     = outOfRange ? reportUnavailable : reportIncomplete;
+        return MOS_STATUS_SUCCESS;
+    }
+
+    uint32_t m_completed = 0;
+    uint32_t m_frames[m_statusNum] = {};
+};
+
+class TestObserver : public MediaStatusReportObserver
+{
+public:
+    MOS_STATUS Completed(void *mfxStatus, void *rcsStatus, void *statusReport) override
+    {
+        m_count++;
+        if (m_gone)
+        {
+            m_lateCount++;
+        }
+        return MOS_STATUS_SUCCESS;
+    }
+
+    atomic<uint32_t> m_count{0};
+    atomic<uint32_t> m_lateCount{0};  //!< Notifications after UnregistObserver returned
+    atomic<bool>     m_gone{false};
+};
+
+class MediaStatusReportTest : public testing::Test
+{
+protected:
+    void Submit(uint32_t frame)
+    {
+        m_report.Init(&frame);
+        m_report.Reset();
+    }
+
+    TestStatusReport m_report;
+};
+
+TEST_F(MediaStatusReportTest, InOrderReports)
+{
+    TestObserver observer;
+    m_report.RegistObserver(&observer);
+
+    for (uint32_t frame = 0; frame < 3; frame++)
+    {
+        Submit(frame);
+    }
+    m_report.Complete(2);
+
+    TestReport reports[1] = {};
+    for (uint32_t frame = 0; frame < 2; frame++)
+    {
+        EXPECT_EQ(MOS_STATUS_SUCCESS, m_report.GetReport(1, reports));
+        EXPECT_EQ(frame, reports[0].frame);
+        EXPECT_EQ(reportCompleted, reports[0].status);
+    }
+
+    // submitted but not completed, then not submitted at all
+    m_report.GetReport(1, reports);
+    EXPECT_EQ(2u, reports[0].frame);
+    EXPECT_EQ(reportIncomplete, reports[0].status);
+    EXPECT_EQ(2u, m_report.GetReportedCount());
+
+    m_report.Complete(3);
+    m_report.GetReport(1, reports);
+    EXPECT_EQ(reportCompleted, reports[0].status);
+    m_report.GetReport(1, reports);
+    EXPECT_EQ(reportUnavailable, reports[0].status);
+
+    EXPECT_EQ(3u, observer.m_count);
+    EXPECT_EQ(MOS_STATUS_SUCCESS, m_report.UnregistObserver(&observer));
+    EXPECT_EQ(MOS_STATUS_INVALID_PARAMETER, m_report.UnregistObserver(&observer));
+}
+
+TEST_F(MediaStatusReportTest, ReverseOrderReports)
+{
+    for (uint32_t frame = 0; frame < 4; frame++)
+    {
+        Submit(frame);
+    }
+    m_report.Complete(4);
+
+    // more than one report is returned newest first
+    TestReport reports[5] = {};
+    m_report.GetReport(5, reports);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(3 - i, reports[i].frame);
+        EXPECT_EQ(reportCompleted, reports[i].status);
+    }
+    EXPECT_EQ(reportUnavailable, reports[4].status);
+    EXPECT_EQ(4u, m_report.GetReportedCount());
+}
+
+TEST_F(MediaStatusReportTest, ConcurrentSubmitAndQuery)
+{
+    const uint32_t frameCount  = 5000;
+    const uint32_t queryCount  = 3;
+    const uint32_t ringInUse   = 256;
+
+    TestObserver         observer;
+    TestObserver         transient;
+    atomic<bool>         done{false};
+    atomic<int64_t>      queryNs{0};
+    atomic<uint32_t>     queries{0};
+    atomic<uint32_t>     registCycles{0};
+    int64_t              submitMaxNs = 0;
+
+    m_report.RegistObserver(&observer);
+
+    thread submitter([&]() {
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            // the application doesn't run further ahead than the ring
+            while (frame - m_report.GetReportedCount() >= ringInUse)
+            {
+                this_thread::yield();
+            }
+            auto start = chrono::steady_clock::now();
+            Submit(frame);
+            submitMaxNs = max(submitMaxNs,
+                (int64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+        }
+    });
+
+    thread gpu([&]() {
+        uint32_t completed = 0;
+        while (completed < frameCount)
+        {
+            uint32_t submitted = m_report.GetSubmittedCount();
+            if (completed < submitted)
+            {
+                completed = min(submitted, completed + 7);
+                m_report.Complete(completed);
+            }
+            this_thread::yield();
+        }
+    });
+
+    vector<thread> queriers;
+    for (uint32_t q = 0; q < queryCount; q++)
+    {
+        queriers.emplace_back([&]() {
+            TestReport report = {};
+            while (m_report.GetReportedCount() < frameCount)
+            {
+                auto start = chrono::steady_clock::now();
+                m_report.GetReport(1, &report);
+                queryNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+                queries++;
+            }
+        });
+    }
+
+    // observers come and go while frames complete
+    thread registrar([&]() {
+        while (!done)
+        {
+            transient.m_gone = false;
+            m_report.RegistObserver(&transient);
+            this_thread::yield();
+            m_report.UnregistObserver(&transient);
+            transient.m_gone = true;
+            registCycles++;
+        }
+    });
+
+    submitter.join();
+    gpu.join();
+    for (auto &t : queriers)
+    {
+        t.join();
+    }
+    done = true;
+    registrar.join();
+
+    // every frame is parsed exactly once and in submission order
+    ASSERT_EQ(frameCount, m_report.m_parsedFrames.size());
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        ASSERT_EQ(frame, m_report.m_parsedFrames[frame]);
+    }
+    EXPECT_EQ(frameCount, observer.m_count);
+    EXPECT_EQ(0u, transient.m_lateCount);
+    EXPECT_GT(registCycles, 0u);
+
+    RecordProperty("submit_max_ns", (int)submitMaxNs);
+    RecordProperty("ns_per_query", (int)(queryNs / max(1u, (uint32_t)queries)));
+    RecordProperty("queries", (int)queries);
+}
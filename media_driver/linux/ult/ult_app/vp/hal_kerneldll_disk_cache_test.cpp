@@ -0,0 +1,344 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "hal_kerneldll_next.h"
+#include "cm_fc_ld.h"
+
+using namespace std;
+
+// Kernel linking is not exercised: the disk cache is fed prebuilt search states.
+const char *g_cInit_ComponentNames[] = {nullptr};
+
+int cm_fc_combine_kernels(size_t num_kernels, cm_fc_kernel_t *kernels,
+                          char *out_buf, size_t *out_size,
+                          const char *options)
+{
+    return CM_FC_FAILURE;
+}
+
+class KdllDiskCacheTest : public testing::Test
+{
+public:
+    struct Record
+    {
+        vector<Kdll_FilterEntry> filter;
+        uint32_t                 hash;
+        Kdll_SearchState        *search;
+    };
+
+protected:
+    void SetUp() override
+    {
+        char dirName[] = "/tmp/kdll_disk_cache_XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirName));
+        m_dir  = dirName;
+        m_file = m_dir + "/fc.cache";
+    }
+
+    void TearDown() override
+    {
+        for (auto &record : m_records)
+        {
+            delete record.search;
+        }
+        unlink(m_file.c_str());
+        rmdir(m_dir.c_str());
+    }
+
+    //! Kdll state of a driver binary; binaries differ by their component kernels
+    Kdll_State *CreateState(uint8_t binary)
+    {
+        Kdll_State *state = (Kdll_State *)MOS_AllocAndZeroMemory(sizeof(Kdll_State));
+        EXPECT_NE(nullptr, state);
+        state->ComponentKernelCache.iCacheSize = 256;
+        state->ComponentKernelCache.pCache     = (uint8_t *)MOS_AllocMemory(256);
+        EXPECT_NE(nullptr, state->ComponentKernelCache.pCache);
+        memset(state->ComponentKernelCache.pCache, binary, 256);
+        return state;
+    }
+
+    //! Random combined kernel; hash collides every 7 records to exercise the index probing
+    Record &CreateRecord(uint32_t kernelSize)
+    {
+        Record record;
+
+        record.filter.resize(1 + m_rand() % DL_MAX_SEARCH_FILTER_SIZE);
+        FillRandom(record.filter.data(), record.filter.size() * sizeof(Kdll_FilterEntry));
+        record.hash = (uint32_t)(m_records.size() % 7);
+
+        record.search = new Kdll_SearchState;
+        memset(record.search, 0, sizeof(Kdll_SearchState));
+        record.search->iFilterSize = 1 + m_rand() % DL_MAX_SEARCH_FILTER_SIZE;
+        FillRandom(record.search->Filter, record.search->iFilterSize * sizeof(Kdll_FilterEntry));
+        FillRandom(&record.search->CscParams, sizeof(Kdll_CSC_Params));
+        for (int i = 0; i < DL_CSC_MAX; i++)
+        {
+            record.search->CscParams.Matrix[i].iProcampID = DL_PROCAMP_DISABLED;
+        }
+        record.search->KernelCount = m_rand() % DL_MAX_KERNELS;
+        FillRandom(record.search->KernelID, record.search->KernelCount * sizeof(int));
+        record.search->KernelSize = kernelSize ? kernelSize : 1 + m_rand() % 4096;
+        FillRandom(record.search->Kernel, record.search->KernelSize);
+
+        m_records.push_back(record);
+        return m_records.back();
+    }
+
+    bool Store(Kdll_State *state, Record &record)
+    {
+        return KernelDll_StoreDiskCachedKernel(state, record.search, record.filter.data(), (int32_t)record.filter.size(), record.hash);
+    }
+
+    //! Looks the record up and compares the restored search state byte for byte
+    bool Find(Kdll_State *state, Record &record)
+    {
+        Kdll_SearchState *out = new Kdll_SearchState;
+        memset(out, 0xcd, sizeof(Kdll_SearchState));
+
+        bool found = KernelDll_GetDiskCachedKernel(state, out, record.filter.data(), (int32_t)record.filter.size(), record.hash);
+        if (found)
+        {
+            Kdll_SearchState *in = record.search;
+            EXPECT_EQ(in->iFilterSize, out->iFilterSize);
+            EXPECT_EQ(0, memcmp(in->Filter, out->Filter, in->iFilterSize * sizeof(Kdll_FilterEntry)));
+            EXPECT_EQ(0, memcmp(&in->CscParams, &out->CscParams, sizeof(Kdll_CSC_Params)));
+            EXPECT_EQ(in->KernelCount, out->KernelCount);
+            EXPECT_EQ(0, memcmp(in->KernelID, out->KernelID, in->KernelCount * sizeof(int)));
+            EXPECT_EQ(in->KernelSize, out->KernelSize);
+            EXPECT_EQ((int)sizeof(out->Kernel) - in->KernelSize, out->KernelLeft);
+            EXPECT_EQ(0, memcmp(in->Kernel, out->Kernel, in->KernelSize));
+        }
+
+        delete out;
+        return found;
+    }
+
+    off_t FileSize()
+    {
+        struct stat fileStat;
+        return stat(m_file.c_str(), &fileStat) == 0 ? fileStat.st_size : -1;
+    }
+
+    void FillRandom(void *data, size_t size)
+    {
+        uint8_t *ptr = (uint8_t *)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            ptr[i] = (uint8_t)m_rand();
+        }
+    }
+
+    string         m_dir;
+    string         m_file;
+    vector<Record> m_records;
+    mt19937        m_rand{2024};
+};
+
+TEST_F(KdllDiskCacheTest, RoundTrip)
+{
+    Kdll_State *writer = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(writer, m_file.c_str()));
+    for (int i = 0; i < 500; i++)
+    {
+        Record &record = CreateRecord(0);
+        ASSERT_TRUE(Store(writer, record)) << "record " << i;
+    }
+
+    // In-process copy and a fresh load of the file return the same kernels
+    Kdll_State *reader = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(reader, m_file.c_str()));
+    EXPECT_EQ(writer->dwDiskCacheSize, reader->dwDiskCacheSize);
+    EXPECT_EQ((off_t)reader->dwDiskCacheSize, FileSize());
+    for (size_t i = 0; i < m_records.size(); i++)
+    {
+        EXPECT_TRUE(Find(writer, m_records[i])) << "record " << i;
+        EXPECT_TRUE(Find(reader, m_records[i])) << "record " << i;
+    }
+
+    // Same hash, different filter
+    Record &missing = CreateRecord(0);
+    EXPECT_FALSE(Find(reader, missing));
+
+    KernelDll_ReleaseStates(writer);
+    KernelDll_ReleaseStates(reader);
+}
+
+TEST_F(KdllDiskCacheTest, FileIsPrivate)
+{
+    Kdll_State *state = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(state, m_file.c_str()));
+    ASSERT_TRUE(Store(state, CreateRecord(0)));
+    ASSERT_TRUE(Store(state, CreateRecord(0)));
+
+    struct stat fileStat;
+    ASSERT_EQ(0, stat(m_file.c_str(), &fileStat));
+    EXPECT_EQ(geteuid(), fileStat.st_uid);
+    EXPECT_EQ(0u, fileStat.st_mode & (S_IRWXG | S_IRWXO));
+
+    KernelDll_ReleaseStates(state);
+}
+
+TEST_F(KdllDiskCacheTest, UntrustedFileRefused)
+{
+    Kdll_State *writer = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(writer, m_file.c_str()));
+    Record &record = CreateRecord(0);
+    ASSERT_TRUE(Store(writer, record));
+    KernelDll_ReleaseStates(writer);
+    off_t size = FileSize();
+
+    // Group writable
+    ASSERT_EQ(0, chmod(m_file.c_str(), 0660));
+    Kdll_State *reader = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(reader, m_file.c_str()));
+    EXPECT_FALSE(Find(reader, record));
+    EXPECT_EQ(nullptr, reader->pcDiskCacheFile);
+    EXPECT_FALSE(Store(reader, CreateRecord(0)));
+    EXPECT_EQ(size, FileSize());
+    KernelDll_ReleaseStates(reader);
+
+    // Symbolic link
+    ASSERT_EQ(0, chmod(m_file.c_str(), 0600));
+    string link = m_dir + "/link.cache";
+    ASSERT_EQ(0, symlink(m_file.c_str(), link.c_str()));
+    reader = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(reader, link.c_str()));
+    EXPECT_FALSE(Find(reader, record));
+    EXPECT_EQ(nullptr, reader->pcDiskCacheFile);
+    KernelDll_ReleaseStates(reader);
+    unlink(link.c_str());
+}
+
+TEST_F(KdllDiskCacheTest, OtherBinaryRecordsKept)
+{
+    Kdll_State *first = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(first, m_file.c_str()));
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(Store(first, CreateRecord(0)));
+    }
+    KernelDll_ReleaseStates(first);
+
+    // Another driver build shares the file: it sees none of the records and doesn't drop them
+    Kdll_State *second = CreateState(2);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(second, m_file.c_str()));
+    EXPECT_EQ(0u, second->dwDiskCacheCount);
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_FALSE(Find(second, m_records[i]));
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(Store(second, CreateRecord(0)));
+    }
+    KernelDll_ReleaseStates(second);
+
+    first  = CreateState(1);
+    second = CreateState(2);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(first, m_file.c_str()));
+    ASSERT_TRUE(KernelDll_LoadDiskCache(second, m_file.c_str()));
+    EXPECT_EQ((off_t)(first->dwDiskCacheSize + second->dwDiskCacheSize), FileSize());
+    for (size_t i = 0; i < m_records.size(); i++)
+    {
+        EXPECT_EQ(i < 10, Find(first, m_records[i])) << "record " << i;
+        EXPECT_EQ(i >= 10, Find(second, m_records[i])) << "record " << i;
+    }
+    KernelDll_ReleaseStates(first);
+    KernelDll_ReleaseStates(second);
+}
+
+TEST_F(KdllDiskCacheTest, TornAppendDropped)
+{
+    Kdll_State *writer = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(writer, m_file.c_str()));
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(Store(writer, CreateRecord(0)));
+    }
+    off_t size = FileSize();
+
+    // Partial record left by a crashed writer
+    Record &torn = CreateRecord(0);
+    ASSERT_TRUE(Store(writer, torn));
+    ASSERT_EQ(0, truncate(m_file.c_str(), FileSize() - 16));
+    KernelDll_ReleaseStates(writer);
+
+    Kdll_State *reader = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(reader, m_file.c_str()));
+    EXPECT_EQ(size, FileSize());
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_TRUE(Find(reader, m_records[i]));
+    }
+    EXPECT_FALSE(Find(reader, torn));
+
+    // Appends continue after the valid records
+    Record &record = CreateRecord(0);
+    ASSERT_TRUE(Store(reader, record));
+    KernelDll_ReleaseStates(reader);
+
+    reader = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(reader, m_file.c_str()));
+    EXPECT_TRUE(Find(reader, record));
+    KernelDll_ReleaseStates(reader);
+}
+
+TEST_F(KdllDiskCacheTest, FullCacheEvictsOldest)
+{
+    const uint32_t kernelSize = DL_MAX_KERNEL_SIZE;
+
+    // Another binary fills the file
+    Kdll_State *other = CreateState(2);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(other, m_file.c_str()));
+    while (Store(other, CreateRecord(kernelSize)))
+    {
+    }
+    m_records.pop_back();
+    size_t otherCount = m_records.size();
+    KernelDll_ReleaseStates(other);
+    ASSERT_GT(otherCount, 2u);
+    ASSERT_LE(FileSize(), (off_t)DL_DISK_CACHE_MAX_SIZE);
+
+    Kdll_State *state = CreateState(1);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(state, m_file.c_str()));
+    Record &record = CreateRecord(kernelSize);
+    ASSERT_TRUE(Store(state, record));
+    EXPECT_LE(FileSize(), (off_t)DL_DISK_CACHE_MAX_SIZE / 2);
+    KernelDll_ReleaseStates(state);
+
+    state = CreateState(1);
+    other = CreateState(2);
+    ASSERT_TRUE(KernelDll_LoadDiskCache(state, m_file.c_str()));
+    ASSERT_TRUE(KernelDll_LoadDiskCache(other, m_file.c_str()));
+    EXPECT_TRUE(Find(state, record));
+    EXPECT_FALSE(Find(other, m_records[0]));
+    EXPECT_TRUE(Find(other, m_records[otherCount - 1]));
+    KernelDll_ReleaseStates(state);
+    KernelDll_ReleaseStates(other);
+}
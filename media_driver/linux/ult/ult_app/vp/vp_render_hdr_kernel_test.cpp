@@ -0,0 +1,270 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <chrono>
+#include <vector>
+#include "gtest/gtest.h"
+#include "vp_render_hdr_kernel.h"
+
+using namespace std;
+using namespace vp;
+
+class TestHdrKernel : public VpRenderHdrKernel
+{
+public:
+    TestHdrKernel(PVpAllocator allocator) : VpRenderHdrKernel(nullptr, allocator)
+    {
+        m_surfaceGroup = &m_group;
+    }
+
+    using VpRenderHdrKernel::InitCri3DLUT;
+    using VpRenderHdrKernel::VpHal_HdrColorTransfer3dLut;
+
+    VP_SURFACE_GROUP m_group;
+};
+
+//! 3D LUT surface in system memory, prefilled so untouched bytes can be told apart
+struct LutSurface
+{
+    LutSurface(MOS_FORMAT format, uint32_t lutSize, uint32_t padding)
+    {
+        uint32_t bytePerPixel = (format == Format_A16B16G16R16) ? 8 : 4;
+
+        os.Format          = format;
+        os.dwPitch         = lutSize * bytePerPixel + padding;
+        mem.resize((size_t)lutSize * lutSize * os.dwPitch);
+        for (size_t i = 0; i < mem.size(); i++)
+        {
+            mem[i] = (uint8_t)(0xa5 + i * 7);
+        }
+        os.OsResource.pData = mem.data();
+        vp.osSurface        = &os;
+    }
+
+    MOS_SURFACE     os = {};
+    VP_SURFACE      vp;
+    vector<uint8_t> mem;
+};
+
+class VpRenderHdrKernelTest : public testing::Test
+{
+protected:
+    VpRenderHdrKernelTest() : m_allocator(nullptr, nullptr), m_kernel(&m_allocator)
+    {
+    }
+
+    //! BT.2020 PQ source to sRGB, with tone mapping and gamut conversion
+    void InitH2S(RENDER_HDR_PARAMS &params, int32_t index, uint32_t lutSize)
+    {
+        params.Cri3DLUTSize                          = lutSize;
+        params.StageEnableFlags[index].EOTFEnable    = 1;
+        params.StageEnableFlags[index].CCMEnable     = 1;
+        params.StageEnableFlags[index].PWLFEnable    = 1;
+        params.StageEnableFlags[index].OETFEnable    = 1;
+        params.EOTFGamma[index]                      = VPHAL_GAMMA_SMPTE_ST2084;
+        params.CCM[index]                            = VPHAL_HDR_CCM_BT2020_TO_BT601_BT709_MATRIX;
+        params.HdrMode[index]                        = VPHAL_HDR_MODE_TONE_MAPPING;
+        params.OETFGamma[index]                      = VPHAL_GAMMA_SRGB;
+    }
+
+    //! YUV source through every stage, including the monitor CCM
+    void InitYuvToMonitor(RENDER_HDR_PARAMS &params, int32_t index, uint32_t lutSize)
+    {
+        InitH2S(params, index, lutSize);
+        params.StageEnableFlags[index].PriorCSCEnable = 1;
+        params.StageEnableFlags[index].CCMExt1Enable  = 1;
+        params.StageEnableFlags[index].PostCSCEnable  = 1;
+        params.PriorCSC[index]                        = VPHAL_HDR_CSC_YUV_TO_RGB_BT2020;
+        params.CCMExt1[index]                         = VPHAL_HDR_CCM_BT2020_TO_MONITOR_MATRIX;
+        params.PostCSC[index]                         = VPHAL_HDR_CSC_RGB_TO_YUV_BT709;
+        params.HdrMode[index]                         = VPHAL_HDR_MODE_H2H;
+        params.OETFGamma[index]                       = VPHAL_GAMMA_SMPTE_ST2084;
+
+        HDR_PARAMS &target                    = params.targetHDRParams[0];
+        target.display_primaries_x[0]         = 35400;
+        target.display_primaries_y[0]         = 14600;
+        target.display_primaries_x[1]         = 8500;
+        target.display_primaries_y[1]         = 39850;
+        target.display_primaries_x[2]         = 6550;
+        target.display_primaries_y[2]         = 2300;
+        target.white_point_x                  = 15635;
+        target.white_point_y                  = 16450;
+        target.max_display_mastering_luminance = 1000;
+        target.min_display_mastering_luminance = 50;
+        target.MaxCLL                         = 1000;
+        target.MaxFALL                        = 400;
+    }
+
+    //! Scalar reference: one color transfer per point written straight into the surface
+    vector<uint8_t> Reference(RENDER_HDR_PARAMS params, int32_t index, const LutSurface &surface)
+    {
+        uint32_t        lutSize      = params.Cri3DLUTSize;
+        uint32_t        pitch        = surface.os.dwPitch;
+        uint32_t        bytePerPixel = (surface.os.Format == Format_A16B16G16R16) ? 8 : 4;
+        vector<uint8_t> mem(surface.mem);
+
+        for (uint32_t i = 0; i < lutSize; i++)
+        {
+            for (uint32_t j = 0; j < lutSize; j++)
+            {
+                for (uint32_t k = 0; k < lutSize; k++)
+                {
+                    uint16_t x = 0, y = 0, z = 0;
+                    uint8_t *dst = mem.data() + i * lutSize * pitch + j * pitch + k * bytePerPixel;
+
+                    m_kernel.VpHal_HdrColorTransfer3dLut(&params,
+                        index,
+                        (float)k / (float)(lutSize - 1),
+                        (float)j / (float)(lutSize - 1),
+                        (float)i / (float)(lutSize - 1),
+                        &x,
+                        &y,
+                        &z);
+
+                    if (bytePerPixel == 8)
+                    {
+                        ((uint16_t *)dst)[0] = x;
+                        ((uint16_t *)dst)[1] = y;
+                        ((uint16_t *)dst)[2] = z;
+                    }
+                    else
+                    {
+                        *(uint32_t *)dst = (uint32_t)x + ((uint32_t)y << 10) + ((uint32_t)z << 20);
+                    }
+                }
+            }
+        }
+        return mem;
+    }
+
+    //! Generates the LUT into a fresh surface and compares it with the reference
+    void ExpectMatchesReference(RENDER_HDR_PARAMS &params, int32_t index, MOS_FORMAT format, uint32_t padding)
+    {
+        LutSurface      surface(format, params.Cri3DLUTSize, padding);
+        vector<uint8_t> expected = Reference(params, index, surface);
+
+        params.f3DLUTNormalizationFactor = 0;
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, index, &surface.vp));
+        EXPECT_TRUE(expected == surface.mem);
+        EXPECT_EQ(params.bGpuGenerate3DLUT ? 1023.0f : 65535.0f, params.f3DLUTNormalizationFactor);
+    }
+
+    VpAllocator   m_allocator;
+    TestHdrKernel m_kernel;
+};
+
+TEST_F(VpRenderHdrKernelTest, Cri3DLUTMatchesReference)
+{
+    const MOS_FORMAT formats[]  = {Format_A16B16G16R16, Format_R10G10B10A2};
+    const uint32_t   lutSizes[] = {VPHAL_HDR_CRI_3DLUT_SIZE, 33, 65};
+
+    for (auto format : formats)
+    {
+        for (auto lutSize : lutSizes)
+        {
+            RENDER_HDR_PARAMS params = {};
+            params.bGpuGenerate3DLUT = (format == Format_R10G10B10A2);
+            InitH2S(params, 0, lutSize);
+            ExpectMatchesReference(params, 0, format, 0);
+
+            // Padding and alpha keep whatever the surface held
+            InitYuvToMonitor(params, 1, lutSize);
+            ExpectMatchesReference(params, 1, format, 40);
+        }
+    }
+}
+
+TEST_F(VpRenderHdrKernelTest, Cri3DLUTFollowsParams)
+{
+    RENDER_HDR_PARAMS params = {};
+    VP_SURFACE        input  = {};
+    MOS_SURFACE       osInput = {};
+
+    InitYuvToMonitor(params, 0, VPHAL_HDR_CRI_3DLUT_SIZE);
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 16);
+
+    // Reused LUT is written into a surface with other contents
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 16);
+
+    // Each change of the inputs regenerates the LUT
+    params.targetHDRParams[0].MaxCLL = 4000;
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 16);
+    params.OETFGamma[0] = VPHAL_GAMMA_SRGB;
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 16);
+    params.StageEnableFlags[0].CCMExt1Enable = 0;
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 16);
+    ExpectMatchesReference(params, 0, Format_A16B16G16R16, 32);
+    ExpectMatchesReference(params, 0, Format_R10G10B10A2, 32);
+    params.bGpuGenerate3DLUT = true;
+    ExpectMatchesReference(params, 0, Format_R10G10B10A2, 32);
+
+    // AYUV input swaps the prior CSC channels
+    osInput.Format = Format_AYUV;
+    input.osSurface = &osInput;
+    m_kernel.m_group[SurfaceTypeHdrInputLayer0] = &input;
+    ExpectMatchesReference(params, 0, Format_R10G10B10A2, 32);
+    m_kernel.m_group.clear();
+    ExpectMatchesReference(params, 0, Format_R10G10B10A2, 32);
+
+    // Layers keep their own LUT
+    InitH2S(params, 3, 33);
+    ExpectMatchesReference(params, 3, Format_R10G10B10A2, 0);
+    ExpectMatchesReference(params, 0, Format_R10G10B10A2, 32);
+}
+
+TEST_F(VpRenderHdrKernelTest, Cri3DLUTInvalidParams)
+{
+    RENDER_HDR_PARAMS params = {};
+    LutSurface        surface(Format_A16B16G16R16, VPHAL_HDR_CRI_3DLUT_SIZE, 0);
+    vector<uint8_t>   before = surface.mem;
+
+    InitH2S(params, 0, VPHAL_HDR_CRI_3DLUT_SIZE);
+    EXPECT_NE(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, -1, &surface.vp));
+    EXPECT_NE(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, VPHAL_MAX_HDR_INPUT_LAYER, &surface.vp));
+
+    surface.os.Format = Format_A8R8G8B8;
+    EXPECT_NE(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, 0, &surface.vp));
+    EXPECT_TRUE(before == surface.mem);
+}
+
+TEST_F(VpRenderHdrKernelTest, Cri3DLUTReuseCost)
+{
+    const int         count  = 50;
+    RENDER_HDR_PARAMS params = {};
+    LutSurface        surface(Format_A16B16G16R16, 65, 0);
+
+    InitYuvToMonitor(params, 0, 65);
+
+    auto    start     = chrono::steady_clock::now();
+    ASSERT_EQ(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, 0, &surface.vp));
+    int64_t generated = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(MOS_STATUS_SUCCESS, m_kernel.InitCri3DLUT(&params, 0, &surface.vp));
+    }
+    int64_t reused = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count() / count;
+
+    RecordProperty("us_generated", (int)generated);
+    RecordProperty("us_reused", (int)reused);
+    EXPECT_LT(reused, generated);
+}
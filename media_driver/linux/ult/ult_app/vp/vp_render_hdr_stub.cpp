@@ -0,0 +1,94 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "vp_render_hdr_kernel.h"
+#include "vp_dumper.h"
+#include "hal_oca_interface_next.h"
+
+using namespace vp;
+
+// The HDR kernel object is linked from the driver sources for its 3D LUT
+// generation, the allocator only maps the resource's system memory and the
+// platform, dump and OCA pieces it references are stubbed.
+uint16_t VpHal_FloatToHalfFloat(
+    float fInput)
+{
+    return 0;
+}
+
+VpAllocator::VpAllocator(PMOS_INTERFACE osInterface, MediaMemComp *mmc) :
+    m_osInterface(osInterface),
+    m_mmc(mmc)
+{
+}
+
+VpAllocator::~VpAllocator()
+{
+}
+
+void *VpAllocator::Lock(MOS_RESOURCE *resource, MOS_LOCK_PARAMS *lockFlag)
+{
+    return resource ? resource->pData : nullptr;
+}
+
+MOS_STATUS VpAllocator::UnLock(MOS_RESOURCE *resource)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS VpAllocator::UpdateResourceUsageType(
+    PMOS_RESOURCE       osResource,
+    MOS_HW_RESOURCE_DEF resUsageType)
+{
+    return MOS_STATUS_SUCCESS;
+}
+
+const std::string VpRenderKernel::s_kernelNameNonAdvKernels = "vpFcKernels";
+
+MOS_STATUS VpPlatformInterface::GetKernelParam(VpKernelID kernlId, RENDERHAL_KERNEL_PARAM &param)
+{
+    return MOS_STATUS_UNIMPLEMENTED;
+}
+
+bool VpUtils::GetCscMatrixForRender8Bit(
+    VPHAL_COLOR_SAMPLE_8 *output,
+    VPHAL_COLOR_SAMPLE_8 *input,
+    VPHAL_CSPACE          srcCspace,
+    VPHAL_CSPACE          dstCspace)
+{
+    return false;
+}
+
+const char *VpDumperTool::GetFormatStr(
+    MOS_FORMAT format)
+{
+    return "";
+}
+
+void HalOcaInterfaceNext::DumpVpKernelInfo(MOS_COMMAND_BUFFER &cmdBuffer, MOS_CONTEXT_HANDLE mosContext, int vpKernelID, int fcKernelCount, int *fcKernelList)
+{
+}
+
+void HalOcaInterfaceNext::On1stLevelBBStart(MOS_COMMAND_BUFFER &cmdBuffer, MOS_CONTEXT_HANDLE mosContext,
+    uint32_t gpuContextHandle, std::shared_ptr<mhw::mi::Itf> miItf, MHW_MI_MMIOREGISTERS &mmioRegisters,
+    uint32_t offsetOf1stLevelBB, bool bUseSizeOfCmdBuf, uint32_t sizeOf1stLevelBB)
+{
+}
@@ -27,24 +27,33 @@
 #include "decode_av1_basic_feature.h"
 #include "decode_utils.h"
 #include "decode_allocator.h"
+#include <map>
+#include <mutex>
 
 namespace decode
 {
-    Av1BasicFeature::~Av1BasicFeature()
+    //! \brief Default cdf table buffers shared by the AV1 decode instances of one device
+    struct Av1SharedCdfBuffers
     {
-        for (uint8_t i = 0; i < av1DefaultCdfTableNum; i++)
-        {
-            if (!m_allocator->ResourceIsNull(&m_tmpCdfBuffers[i]->OsResource))
-            {
-                m_allocator->Destroy(m_tmpCdfBuffers[i]);
-            }
+        PMOS_BUFFER defaultCdfBuffers[Av1BasicFeature::av1DefaultCdfTableNum] = {};
+        uint32_t    refCount                                                  = 0;
+    };
 
-            if (!m_allocator->ResourceIsNull(&m_defaultCdfBuffers[i]->OsResource))
-            {
-                m_allocator->Destroy(m_defaultCdfBuffers[i]);
-            }
+    static std::mutex                             s_sharedCdfMutex;
+    static std::map<void *, Av1SharedCdfBuffers>  s_sharedCdfBuffers;
 
+    static void DestroySharedCdfBuffers(DecodeAllocator *allocator, Av1SharedCdfBuffers &shared)
+    {
+        for (uint8_t i = 0; i < Av1BasicFeature::av1DefaultCdfTableNum; i++)
+        {
+            allocator->DestroySharedBuffer(shared.defaultCdfBuffers[i]);
         }
+    }
+
+    Av1BasicFeature::~Av1BasicFeature()
+    {
+        ReleaseDefaultCdfBuffers();
+
         if (m_usingDummyWl == true)
         {
             m_allocator->Destroy(m_destSurfaceForDummyWL);
@@ -706,163 +715,97 @@ namespace decode
         return MOS_STATUS_SUCCESS;
     }
 
-    MOS_STATUS Av1BasicFeature::InitDefaultFrameContextBuffer(
-        uint16_t              *ctxBuffer,
-        uint8_t               index)
+    MOS_STATUS Av1BasicFeature::AcquireDefaultCdfBuffers()
     {
-        DECODE_CHK_NULL(ctxBuffer);
-
-        //initialize the layout and default table info for each syntax element
-        struct SyntaxElementCdfTableLayout syntaxElementsLayout[syntaxElementMax] =
-        {
-        //m_entryCountPerCL, m_entryCountTotal, m_startCL, *m_srcInitBuffer
-        //PartI: Intra
-        { 30,    12  ,    0  ,    (uint16_t *)&defaultPartitionCdf8x8[0][0] },        //    partition_8x8
-        { 27,    108 ,    1  ,    (uint16_t *)&defaultPartitionCdfNxN[0][0] },        //    partition
-        { 28,    28  ,    5  ,    (uint16_t *)&defaultPartitionCdf128x128[0][0] },    //    partition_128x128
-        { 32,    3   ,    6  ,    (uint16_t *)&defaultSkipCdfs[0][0] },               //    skip
-        { 30,    3   ,    7  ,    (uint16_t *)&defaultDeltaQCdf[0] },                 //    delta_q
-        { 30,    3   ,    8  ,    (uint16_t *)&defaultDeltaLfCdf[0] },                //    delta_lf
-        { 30,    12  ,    9  ,    (uint16_t *)&defaultDeltaLfMultiCdf[0][0] },        //    delta_lf_multi
-        { 28,    21  ,    10 ,    (uint16_t *)&defaultSpatialPredSegTreeCdf[0][0] },  //    segment_id
-        { 24,    300 ,    11 ,    (uint16_t *)&defaultKfYModeCdf[0][0][0] },          //    intra_y_mode
-        { 24,    156 ,    24 ,    (uint16_t *)&defaultUvModeCdf0[0][0] },             //    uv_mode_0
-        { 26,    169 ,    31 ,    (uint16_t *)&defaultUvModeCdf1[0][0] },             //    uv_mode_1
-        { 32,    21  ,    38 ,    (uint16_t *)&defaultPaletteYModeCdf[0][0][0] },     //    palette_y_mode
-        { 32,    2   ,    39 ,    (uint16_t *)&defaultPaletteUvModeCdf[0][0] },       //    palette_uv_mode
-        { 30,    42  ,    40 ,    (uint16_t *)&defaultPaletteYSizeCdf[0][0] },        //    palette_y_size
-        { 30,    42  ,    42 ,    (uint16_t *)&defaultPaletteUvSizeCdf[0][0] },       //    palette_uv_size
-        { 30,    312 ,    44 ,    (uint16_t *)&defaultIntraExtTxCdf1[0][0][0] },      //    intra_tx_type_1
-        { 32,    208 ,    55 ,    (uint16_t *)&defaultIntraExtTxCdf2[0][0][0] },      //    intra_tx_type_2
-        { 32,    3   ,    62 ,    (uint16_t *)&defaultTxSizeCdf0[0][0] },             //    depth_0
-        { 32,    18  ,    63 ,    (uint16_t *)&defaultTxSizeCdf[0][0][0] },           //    depth
-        { 28,    7   ,    64 ,    (uint16_t *)&defaultCflSignCdf[0] },                //    cfl_joint_sign
-        { 30,    90  ,    65 ,    (uint16_t *)&defaultCflAlphaCdf[0][0] },            //    cdf_alpha
-        { 30,    48  ,    68 ,    (uint16_t *)&defaultAngleDeltaCdf[0][0] },          //    angle_delta
-        { 32,    5   ,    70 ,    (uint16_t *)&defaultPaletteYColorIndexCdf0[0][0] }, //    palette_y_color_idx_0
-        { 32,    10  ,    71 ,    (uint16_t *)&defaultPaletteYColorIndexCdf1[0][0] }, //    palette_y_color_idx_1
-        { 30,    15  ,    72 ,    (uint16_t *)&defaultPaletteYColorIndexCdf2[0][0] }, //    palette_y_color_idx_2
-        { 32,    20  ,    73 ,    (uint16_t *)&defaultPaletteYColorIndexCdf3[0][0] }, //    palette_y_color_idx_3
-        { 30,    25  ,    74 ,    (uint16_t *)&defaultPaletteYColorIndexCdf4[0][0] }, //    palette_y_color_idx_4
-        { 30,    30  ,    75 ,    (uint16_t *)&defaultPaletteYColorIndexCdf5[0][0] }, //    palette_y_color_idx_5
-        { 28,    35  ,    76 ,    (uint16_t *)&defaultPaletteYColorIndexCdf6[0][0] }, //    palette_y_color_idx_6
-        { 32,    5   ,    78 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf0[0][0] }, //    palette_uv_color_idx_0
-        { 32,    10  ,    79 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf1[0][0] }, //    palette_uv_color_idx_1
-        { 30,    15  ,    80 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf2[0][0] }, //    palette_uv_color_idx_2
-        { 32,    20  ,    81 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf3[0][0] }, //    palette_uv_color_idx_3
-        { 30,    25  ,    82 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf4[0][0] }, //    palette_uv_color_idx_4
-        { 30,    30  ,    83 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf5[0][0] }, //    palette_uv_color_idx_5
-        { 28,    35  ,    84 ,    (uint16_t *)&defaultPaletteUvColorIndexCdf6[0][0] }, //    palette_uv_color_idx_6
-        //coeff cdfs addressed by index
-        { 32,    65  ,    86 ,    (uint16_t *)&av1DefaultTxbSkipCdfs[index][0][0][0] },               //    txb_skip
-        { 32,    16  ,    89 ,    (uint16_t *)&av1DefaultEobMulti16Cdfs[index][0][0][0] },            //    eob_pt_0
-        { 30,    20  ,    90 ,    (uint16_t *)&av1DefaultEobMulti32Cdfs[index][0][0][0] },            //    eob_pt_1
-        { 30,    24  ,    91 ,    (uint16_t *)&av1DefaultEobMulti64Cdfs[index][0][0][0] },            //    eob_pt_2
-        { 28,    28  ,    92 ,    (uint16_t *)&av1DefaultEobMulti128Cdfs[index][0][0][0] },           //    eob_pt_3
-        { 32,    32  ,    93 ,    (uint16_t *)&av1DefaultEobMulti256Cdfs[index][0][0][0] },           //    eob_pt_4
-        { 27,    36  ,    94 ,    (uint16_t *)&av1DefaultEobMulti512Cdfs[index][0][0][0] },           //    eob_pt_5
-        { 30,    40  ,    96 ,    (uint16_t *)&av1DefaultEobMulti1024Cdfs[index][0][0][0] },          //    eob_pt_6
-        { 32,    90  ,    98 ,    (uint16_t *)&av1DefaultEobExtraCdfs[index][0][0][0][0] },           //    eob_extra
-        { 32,    80  ,    101,    (uint16_t *)&av1DefaultCoeffBaseEobMultiCdfs[index][0][0][0][0] },  //    coeff_base_eob
-        { 30,    1260,    104,    (uint16_t *)&av1DefaultCoeffBaseMultiCdfs[index][0][0][0][0] },     //    coeff_base
-        { 32,    6   ,    146,    (uint16_t *)&av1DefaultDcSignCdfs[index][0][0][0] },                //    dc_sign
-        { 30,    630 ,    147,    (uint16_t *)&av1DefaultCoeffLpsMultiCdfs[index][0][0][0][0] },      //    coeff_br
-        { 32,    2   ,    168,    (uint16_t *)&defaultSwitchableRestoreCdf[0] },  //    switchable_restore
-        { 32,    1   ,    169,    (uint16_t *)&defaultWienerRestoreCdf[0] },      //    wiener_restore
-        { 32,    1   ,    170,    (uint16_t *)&defaultSgrprojRestoreCdf[0] },     //    sgrproj_restore
-        { 32,    1   ,    171,    (uint16_t *)&defaultIntrabcCdf[0] },            //    use_intrabc
-        { 32,    22  ,    172,    (uint16_t *)&default_filter_intra_cdfs[0][0] }, //    use_filter_intra
-        { 32,    4   ,    173,    (uint16_t *)&defaultFilterIntraModeCdf[0] },    //    filter_intra_mode
-        { 30,    3   ,    174,    (uint16_t *)&defaultJointCdf[0] },              //    dv_joint_type
-        { 32,    2   ,    175,    (uint16_t *)&defaultSignCdf[0][0] },            //    dv_sign
-        { 32,    20  ,    176,    (uint16_t *)&defaultBitsCdf[0][0][0] },         //    dv_sbits
-        { 30,    20  ,    177,    (uint16_t *)&defaultClassesCdf[0][0] },         //    dv_class
-        { 32,    2   ,    178,    (uint16_t *)&defaultClass0Cdf[0][0] },          //    dv_class0
-        { 30,    6   ,    179,    (uint16_t *)&defaultFpCdf[0][0] },              //    dv_fr
-        { 30,    12  ,    180,    (uint16_t *)&defaultClass0FpCdf[0][0][0] },     //    dv_class0_fr
-        { 32,    2   ,    181,    (uint16_t *)&defaultHpCdf[0][0] },              //    dv_hp
-        { 32,    2   ,    182,    (uint16_t *)&defaultClass0HpCdf[0][0] },        //    dv_class0_hp
-        //PartII: Inter
-        { 32,    3   ,    183,    (uint16_t *)&defaultSkipModeCdfs[0][0] },           //    skip_mode
-        { 32,    3   ,    184,    (uint16_t *)&defaultSegmentPredCdf[0][0] },         //    pred_seg_id
-        { 24,    48  ,    185,    (uint16_t *)&defaultIfYModeCdf[0][0] },             //    y_mode
-        { 30,    60  ,    187,    (uint16_t *)&defaultInterExtTxCdf1[0][0] },         //    inter_tx_type_1
-        { 22,    44  ,    189,    (uint16_t *)&defaultInterExtTxCdf2[0][0] },         //    inter_tx_type_2
-        { 32,    4   ,    191,    (uint16_t *)&defaultInterExtTxCdf3[0][0] },         //    inter_tx_type_3
-        { 32,    4   ,    192,    (uint16_t *)&defaultIntraInterCdf[0][0] },          //    is_inter
-        { 32,    21  ,    193,    (uint16_t *)&defaultTxfmPartitionCdf[0][0] },       //    tx_split
-        { 32,    5   ,    194,    (uint16_t *)&defaultCompInterCdf[0][0] },           //    ref_mode
-        { 32,    5   ,    195,    (uint16_t *)&defaultCompRefTypeCdf[0][0] },         //    comp_ref_type
-        { 32,    9   ,    196,    (uint16_t *)&defaultUniCompRefCdf[0][0][0] },       //    unidir_comp_ref
-        { 32,    9   ,    197,    (uint16_t *)&defaultCompRefCdf[0][0][0] },          //    ref_bit
-        { 32,    6   ,    198,    (uint16_t *)&defaultCompBwdrefCdf[0][0][0] },       //    ref_bit_bwd
-        { 32,    18  ,    199,    (uint16_t *)&defaultSingleRefCdf[0][0][0] },        //    single_ref_bit
-        { 28,    56  ,    200,    (uint16_t *)&defaultInterCompoundModeCdf[0][0] },   // inter_compound_mode
-        { 32,    6   ,    202,    (uint16_t *)&defaultNewmvCdf[0][0] },               //    is_newmv
-        { 32,    2   ,    203,    (uint16_t *)&defaultZeromvCdf[0][0] },              //    is_zeromv
-        { 32,    6   ,    204,    (uint16_t *)&defaultRefmvCdf[0][0] },               //    is_refmv
-        { 30,    3   ,    205,    (uint16_t *)&defaultJointCdf[0] },                  //    mv_joint_type
-        { 32,    2   ,    206,    (uint16_t *)&defaultSignCdf[0][0] },                //    mv_sign
-        { 32,    20  ,    207,    (uint16_t *)&defaultBitsCdf[0][0][0] },             //    mv_sbits
-        { 30,    20  ,    208,    (uint16_t *)&defaultClassesCdf[0][0] },             //    mv_class
-        { 32,    2   ,    209,    (uint16_t *)&defaultClass0Cdf[0][0] },              //    mv_class0
-        { 30,    6   ,    210,    (uint16_t *)&defaultFpCdf[0][0] },                  //    mv_fr
-        { 30,    12  ,    211,    (uint16_t *)&defaultClass0FpCdf[0][0][0] },         //    mv_class0_fr
-        { 32,    2   ,    212,    (uint16_t *)&defaultHpCdf[0][0] },                  //    mv_hp
-        { 32,    2   ,    213,    (uint16_t *)&defaultClass0HpCdf[0][0] },            //    mv_class0_hp
-        { 32,    4   ,    214,    (uint16_t *)&defaultInterintraCdf[0][0] },          //    interintra
-        { 30,    12  ,    215,    (uint16_t *)&defaultInterintraModeCdf[0][0] },      //    interintra_mode
-        { 32,    22  ,    216,    (uint16_t *)&defaultWedgeInterintraCdf[0][0] },     //    use_wedge_interintra
-        { 30,    330 ,    217,    (uint16_t *)&defaultWedgeIdxCdf[0][0] },            //    wedge_index
-        { 32,    3   ,    228,    (uint16_t *)&defaultDrlCdf[0][0] },                 //    drl_idx
-        { 32,    22  ,    229,    (uint16_t *)&defaultObmcCdf[0][0] },                //    obmc_motion_mode
-        { 32,    44  ,    230,    (uint16_t *)&defaultMotionModeCdf[0][0] },          //    non_obmc_motion_mode
-        { 32,    6   ,    232,    (uint16_t *)&defaultCompGroupIdxCdfs[0][0] },       //    comp_group_idx
-        { 32,    6   ,    233,    (uint16_t *)&defaultCompoundIdxCdfs[0][0] },        //    compound_idx
-        { 32,    22  ,    234,    (uint16_t *)&defaultCompoundTypeCdf[0][0] },        //    interinter_compound_type
-        { 32,    32  ,    235,    (uint16_t *)&defaultSwitchableInterpCdf[0][0] },    //    switchable_interp
-        };
-
-        for (auto idx = (uint32_t)partition8x8; idx < (uint32_t)syntaxElementMax; idx++)
-        {
-            DECODE_CHK_STATUS(SyntaxElementCdfTableInit(
-                ctxBuffer,
-                syntaxElementsLayout[idx]));
+        DECODE_FUNC_CALL();
+
+        DECODE_CHK_NULL(m_osInterface);
+        DECODE_CHK_NULL(m_allocator);
+
+        void *device = m_osInterface;
+        if (m_osInterface->osStreamState != nullptr && m_osInterface->osStreamState->osDeviceContext != nullptr)
+        {
+            device = m_osInterface->osStreamState->osDeviceContext;
         }
 
+        std::lock_guard<std::mutex> lock(s_sharedCdfMutex);
+
+        Av1SharedCdfBuffers &shared = s_sharedCdfBuffers[device];
+        if (shared.refCount == 0)
+        {
+            // Filled once by CPU here and only read by GPU afterwards, so the decode
+            // contexts sharing the buffers never write them or wait for each other.
+            MOS_STATUS status = MOS_STATUS_SUCCESS;
+            for (uint8_t index = 0; index < av1DefaultCdfTableNum && status == MOS_STATUS_SUCCESS; index++)
+            {
+                status = MOS_STATUS_NO_SPACE;
+
+                const uint16_t *image = Av1DefaultCdf::GetImage(index);
+                if (image == nullptr)
+                {
+                    break;
+                }
+
+                shared.defaultCdfBuffers[index] = m_allocator->AllocateSharedBuffer(
+                    MOS_ALIGN_CEIL(m_cdfMaxNumBytes, CODECHAL_PAGE_SIZE), "m_defaultCdfBuffers",
+                    resourceInternalRead, lockableVideoMem);
+                if (shared.defaultCdfBuffers[index] == nullptr)
+                {
+                    break;
+                }
+
+                auto data = (uint16_t *)m_allocator->LockResourceForWrite(&shared.defaultCdfBuffers[index]->OsResource);
+                if (data == nullptr)
+                {
+                    break;
+                }
+
+                status = MOS_SecureMemcpy(data, m_cdfMaxNumBytes, image, m_cdfMaxNumBytes);
+                m_allocator->UnLock(shared.defaultCdfBuffers[index]);
+            }
+
+            if (status != MOS_STATUS_SUCCESS)
+            {
+                DestroySharedCdfBuffers(m_allocator, shared);
+                s_sharedCdfBuffers.erase(device);
+                DECODE_ASSERTMESSAGE("Failed to create default cdf table buffers");
+                return status;
+            }
+        }
+
+        shared.refCount++;
+        for (uint8_t index = 0; index < av1DefaultCdfTableNum; index++)
+        {
+            m_defaultCdfBuffers[index] = shared.defaultCdfBuffers[index];
+        }
+        m_cdfBufferDevice = device;
+
         return MOS_STATUS_SUCCESS;
     }
 
-    MOS_STATUS Av1BasicFeature::SyntaxElementCdfTableInit(
-        uint16_t                    *ctxBuffer,
-        SyntaxElementCdfTableLayout SyntaxElement)
+    void Av1BasicFeature::ReleaseDefaultCdfBuffers()
     {
-        DECODE_CHK_NULL(SyntaxElement.m_srcInitBuffer);
-
-        uint16_t    entryCountPerCL = SyntaxElement.m_entryCountPerCL;  //one entry means one uint16_t value
-        uint16_t    entryCountTotal = SyntaxElement.m_entryCountTotal;  //total number of entrie for this Syntax element's CDF tables
-        uint16_t    startCL         = SyntaxElement.m_startCL;
+        DECODE_FUNC_CALL();
 
-        uint16_t *src = SyntaxElement.m_srcInitBuffer;
-        uint16_t *dst = ctxBuffer + startCL * 32;   //one CL equals to 32 uint16_t
-        uint16_t entryCountLeft = entryCountTotal;
-        while (entryCountLeft >= entryCountPerCL)
+        if (m_cdfBufferDevice == nullptr)
         {
-            //copy one CL
-            MOS_SecureMemcpy(dst, entryCountPerCL * sizeof(uint16_t), src, entryCountPerCL * sizeof(uint16_t));
-            entryCountLeft -= entryCountPerCL;
+            return;
+        }
 
-            //go to next CL
-            src += entryCountPerCL;
-            dst += 32;
-        };
-        //copy the remaining which are less than a CL
-        if (entryCountLeft > 0)
+        std::lock_guard<std::mutex> lock(s_sharedCdfMutex);
+
+        auto it = s_sharedCdfBuffers.find(m_cdfBufferDevice);
+        if (it != s_sharedCdfBuffers.end() && --it->second.refCount == 0)
         {
-            MOS_SecureMemcpy(dst, entryCountLeft * sizeof(uint16_t), src, entryCountLeft * sizeof(uint16_t));
+            DestroySharedCdfBuffers(m_allocator, it->second);
+            s_sharedCdfBuffers.erase(it);
         }
 
-        return MOS_STATUS_SUCCESS;
+        for (uint8_t index = 0; index < av1DefaultCdfTableNum; index++)
+        {
+            m_defaultCdfBuffers[index] = nullptr;
+        }
+        m_cdfBufferDevice = nullptr;
     }
 
     MOS_STATUS Av1BasicFeature :: UpdateDefaultCdfTable()
@@ -871,24 +814,7 @@ namespace decode
 
         if (!m_defaultFcInitialized)
         {
-            for (uint8_t index = 0; index < av1DefaultCdfTableNum; index++)
-            {
-                m_tmpCdfBuffers[index] = m_allocator->AllocateBuffer(
-                    MOS_ALIGN_CEIL(m_cdfMaxNumBytes, CODECHAL_PAGE_SIZE), "TempCdfTableBuffer",
-                    resourceInternalRead, lockableVideoMem);
-                DECODE_CHK_NULL(m_tmpCdfBuffers[index]);
-
-                auto data = (uint16_t *)m_allocator->LockResourceForWrite(&m_tmpCdfBuffers[index]->OsResource);
-                DECODE_CHK_NULL(data);
-
-                // reset all CDF tables to default values
-                DECODE_CHK_STATUS(InitDefaultFrameContextBuffer(data, index));
-                m_defaultCdfBuffers[index] = m_allocator->AllocateBuffer(
-                    MOS_ALIGN_CEIL(m_cdfMaxNumBytes, CODECHAL_PAGE_SIZE), "m_defaultCdfBuffers",
-                    resourceInternalRead, notLockableVideoMem);
-                DECODE_CHK_NULL(m_defaultCdfBuffers[index]);
-            }
-
+            DECODE_CHK_STATUS(AcquireDefaultCdfBuffers());
             m_defaultFcInitialized = true;//set only once, won't set again
         }
 
@@ -31,6 +31,7 @@
 #include "decode_av1_reference_frames.h"
 #include "decode_av1_temporal_buffers.h"
 #include "decode_av1_tile_coding.h"
+#include "decode_av1_default_cdf.h"
 #include "mhw_vdbox_avp_itf.h"
 #include "decode_internal_target.h"
 
@@ -77,33 +78,6 @@ namespace decode
         //!
         virtual MOS_STATUS ErrorDetectAndConceal();
 
-        //!
-        //! \brief    Initialize one of AV1 Decode frame context buffers with default values
-        //! \param    [in] ctxBuffer
-        //!           Pointer to frame context buffer
-        //! \param    [in] index
-        //!           flag to indicate the coeff CDF table index
-        //! \return   MOS_STATUS
-        //!           MOS_STATUS_SUCCESS if success, else fail reason
-        //!
-        MOS_STATUS InitDefaultFrameContextBuffer(
-            uint16_t              *ctxBuffer,
-            uint8_t               index);
-
-        //!
-        //! \brief    Initialize CDF tables for one Syntax Element
-        //! \details  Initialize CDF tables for one Syntax Element according to its CDF table layout and the initialization buffer
-        //! \param    [in] ctxBuffer
-        //!           Pointer to frame context buffer
-        //! \param    [in] SyntaxElement
-        //!           CDF table layout info and the initialization buffer for this syntax element
-        //! \return   MOS_STATUS
-        //!           MOS_STATUS_SUCCESS if success, else fail reason
-        //!
-        MOS_STATUS SyntaxElementCdfTableInit(
-            uint16_t                    *ctxBuffer,
-            SyntaxElementCdfTableLayout SyntaxElement);
-
         //!
         //! \brief    Update default cdfTable buffers
         //! \details  Update default cdfTable buffers for AV1 decoder
@@ -122,12 +96,11 @@ namespace decode
         CodecAv1SegmentsParams          *m_segmentParams           = nullptr;      //!< Pointer to AV1 segments parameter
         CodecAv1TileParams              *m_av1TileParams           = nullptr;      //!< Pointer to AV1 tiles parameter
 
-        PMOS_BUFFER                     m_tmpCdfBuffers[4]         = {};           //!< 4 temporal cdf table buffers for later use.
-        PMOS_BUFFER                     m_defaultCdfBuffers[4]     = {};           //!< 4 default frame contexts per base_qindex
+        PMOS_BUFFER                     m_defaultCdfBuffers[4]     = {};           //!< 4 default frame contexts per base_qindex, shared per device
         PMOS_BUFFER                     m_defaultCdfBufferInUse    = nullptr;      //!< default cdf table used base on current base_qindex
         uint8_t                         m_curCoeffCdfQCtx          = 0;            //!< Coeff CDF Q context ID for current frame
-        static const uint32_t           m_cdfMaxNumBytes           = 15104;        //!< Max number of bytes for CDF tables buffer, which equals to 236*64 (236 Cache Lines)
-        static const uint32_t           av1DefaultCdfTableNum      = 4;            //!< Number of inited cdf table
+        static const uint32_t           m_cdfMaxNumBytes           = Av1DefaultCdf::m_cdfMaxNumBytes;        //!< Max number of bytes for CDF tables buffer
+        static const uint32_t           av1DefaultCdfTableNum      = Av1DefaultCdf::av1DefaultCdfTableNum; //!< Number of inited cdf table
                                                                                    //for Internal buffer upating
         bool                            m_defaultFcInitialized     = false;        //!< default Frame context initialized flag. default frame context should be initialized only once, and set this flag to 1 once initialized.
 
@@ -164,8 +137,26 @@ namespace decode
         //!
         MOS_STATUS CalculateGlobalMotionParams();
 
+        //!
+        //! \brief    Acquire default cdf table buffers
+        //! \details  The default cdf tables never change, so the buffers are created once per device,
+        //!           filled with the default frame contexts and shared by all AV1 decode instances.
+        //! \return   MOS_STATUS
+        //!           MOS_STATUS_SUCCESS if success, else fail reason
+        //!
+        MOS_STATUS AcquireDefaultCdfBuffers();
+
+        //!
+        //! \brief    Release default cdf table buffers
+        //! \details  Drop the reference to the shared default cdf table buffers, the last
+        //!           reference of the device destroys them.
+        //! \return   void
+        //!
+        void ReleaseDefaultCdfBuffers();
+
         std::shared_ptr<mhw::vdbox::avp::Itf> m_avpItf = nullptr;
         PMOS_INTERFACE m_osInterface = nullptr;
+        void          *m_cdfBufferDevice     = nullptr;  //!< Device of the shared default cdf buffers, nullptr if not acquired
 
     MEDIA_CLASS_DEFINE_END(decode__Av1BasicFeature)
     };
@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     decode_av1_default_cdf.h
+//! \brief    Defines the default cdf tables for av1 decode
+//!
+#ifndef __DECODE_AV1_DEFAULT_CDF_H__
+#define __DECODE_AV1_DEFAULT_CDF_H__
+
+#include "codec_def_common_av1.h"
+#include "mos_defs.h"
+
+namespace decode
+{
+    class Av1DefaultCdf
+    {
+    public:
+        static const uint32_t m_cdfMaxNumBytes        = 15104;  //!< Max number of bytes for CDF tables buffer, which equals to 236*64 (236 Cache Lines)
+        static const uint32_t av1DefaultCdfTableNum   = 4;      //!< Number of inited cdf table
+
+        //!
+        //! \brief    Get one of the AV1 default frame context images
+        //! \details  The four images are built once per process on first use and never change,
+        //!           so they can be copied into any number of default cdf buffers.
+        //! \param    [in] index
+        //!           Coeff CDF table index
+        //! \return   const uint16_t *
+        //!           Image of m_cdfMaxNumBytes bytes, nullptr if index is invalid
+        //!
+        static const uint16_t *GetImage(uint8_t index);
+
+        //!
+        //! \brief    Initialize one of AV1 Decode frame context buffers with default values
+        //! \param    [in] ctxBuffer
+        //!           Pointer to frame context buffer
+        //! \param    [in] index
+        //!           flag to indicate the coeff CDF table index
+        //! \return   MOS_STATUS
+        //!           MOS_STATUS_SUCCESS if success, else fail reason
+        //!
+        static MOS_STATUS InitDefaultFrameContextBuffer(
+            uint16_t              *ctxBuffer,
+            uint8_t               index);
+
+        //!
+        //! \brief    Initialize CDF tables for one Syntax Element
+        //! \details  Initialize CDF tables for one Syntax Element according to its CDF table layout and the initialization buffer
+        //! \param    [in] ctxBuffer
+        //!           Pointer to frame context buffer
+        //! \param    [in] SyntaxElement
+        //!           CDF table layout info and the initialization buffer for this syntax element
+        //! \return   MOS_STATUS
+        //!           MOS_STATUS_SUCCESS if success, else fail reason
+        //!
+        static MOS_STATUS SyntaxElementCdfTableInit(
+            uint16_t                    *ctxBuffer,
+            SyntaxElementCdfTableLayout SyntaxElement);
+    };
+}  // namespace decode
+#endif  // !__DECODE_AV1_DEFAULT_CDF_H__
@@ -22,6 +22,7 @@ if(${AV1_Decode_Supported} STREQUAL "yes")
 set(SOFTLET_DECODE_AV1_SOURCES_
     ${SOFTLET_DECODE_AV1_SOURCES_}
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_basic_feature.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/decode_av1_default_cdf.cpp
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_feature_manager.cpp
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_reference_frames.cpp
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_tile_coding.cpp
@@ -31,6 +32,7 @@ set(SOFTLET_DECODE_AV1_SOURCES_
 set(SOFTLET_DECODE_AV1_HEADERS_
     ${SOFTLET_DECODE_AV1_HEADERS_}
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_basic_feature.h
+    ${CMAKE_CURRENT_LIST_DIR}/decode_av1_default_cdf.h
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_feature_manager.h
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_reference_frames.h
     ${CMAKE_CURRENT_LIST_DIR}/decode_av1_tile_coding.h
@@ -27,7 +27,6 @@
 #include "decode_utils.h"
 #include "codechal_setting.h"
 #include "decode_av1_feature_manager.h"
-#include "decode_huc_packet_creator_base.h"
 #include "media_debug_fast_dump.h"
 
 namespace decode {
@@ -45,15 +44,6 @@ MOS_STATUS Av1Pipeline::Initialize(void *settings)
     DECODE_FUNC_CALL();
     DECODE_CHK_STATUS(DecodePipeline::Initialize(settings));
 
-    HucPacketCreatorBase *hucPktCreator = dynamic_cast<HucPacketCreatorBase *>(this);
-    DECODE_CHK_NULL(hucPktCreator);
-    m_cdfCopyPkt = hucPktCreator->CreateHucCopyPkt(this, m_task, m_hwInterface); 
-    DECODE_CHK_NULL(m_cdfCopyPkt);
-    MediaPacket *packet = dynamic_cast<MediaPacket *>(m_cdfCopyPkt);
-    DECODE_CHK_NULL(packet);
-    DECODE_CHK_STATUS(RegisterPacket(DecodePacketId(this, defaultCdfBufCopyPacketId), packet));
-    DECODE_CHK_STATUS(packet->Init());
-
     auto *codecSettings = (CodechalSetting*)settings;
     DECODE_CHK_NULL(codecSettings);
 
@@ -75,19 +65,6 @@ MOS_STATUS Av1Pipeline::Prepare(void *params)
     DECODE_CHK_NULL(basicFeature);
     DECODE_CHK_STATUS(DecodePipeline::Prepare(params));
 
-    if (basicFeature->m_frameNum == 0)
-    {
-        for (uint8_t i = 0; i < basicFeature->av1DefaultCdfTableNum; i++)
-        {
-            HucCopyPktItf::HucCopyParams copyParams = {};
-            copyParams.srcBuffer  = &(basicFeature->m_tmpCdfBuffers[i]->OsResource);
-            copyParams.srcOffset  = 0;
-            copyParams.destBuffer = &(basicFeature->m_defaultCdfBuffers[i]->OsResource);
-            copyParams.destOffset = 0;
-            copyParams.copyLength = basicFeature->m_cdfMaxNumBytes;
-            m_cdfCopyPkt->PushCopyParams(copyParams);
-        }
-    }
     return MOS_STATUS_SUCCESS;
 }
 
@@ -114,12 +91,6 @@ MOS_STATUS Av1Pipeline::ActivateDecodePackets()
 
     bool immediateSubmit = true;
 
-    if (m_isFirstTileInFrm)
-    {
-        DECODE_CHK_STATUS(ActivatePacket(DecodePacketId(this, defaultCdfBufCopyPacketId), false, 0, 0));
-        m_isFirstTileInFrm = false;
-    }
-
     if (!m_forceTileBasedDecoding)
     {
         immediateSubmit = false;
@@ -62,7 +62,6 @@ public:
     DeclareDecodePacketId(av1DecodePacketId);
     DeclareDecodePacketId(av1PictureSubPacketId);
     DeclareDecodePacketId(av1TileSubPacketId);
-    DeclareDecodePacketId(defaultCdfBufCopyPacketId);
 
 protected:
     //!
@@ -150,10 +149,8 @@ protected:
 #endif
 
 protected:
-    HucCopyPktItf  *m_cdfCopyPkt       = nullptr;          //!< Update default cdf buffer with huc stream out packet
     Av1DecodeMode  m_decodeMode       = baseDecodeMode;   //!< Decode mode
     uint16_t       m_passNum          = 1;                //!< Decode pass number
-    bool           m_isFirstTileInFrm = true;             //!< First tile in the first frame
     bool           m_forceTileBasedDecoding = false;      //!< Force tile based decoding
     bool           m_allowVirtualNodeReassign = false;            //!< Whether allow virtual node reassign
 
@@ -97,6 +97,42 @@ MOS_BUFFER* DecodeAllocator::AllocateBuffer(
     return buffer;
 }
 
+MOS_BUFFER* DecodeAllocator::AllocateSharedBuffer(
+    const uint32_t sizeOfBuffer, const char* nameOfBuffer,
+    ResourceUsage resUsageType, ResourceAccessReq accessReq)
+{
+    if (!m_osInterface)
+        return nullptr;
+
+    MOS_ALLOC_GFXRES_PARAMS allocParams;
+    MOS_ZeroMemory(&allocParams, sizeof(MOS_ALLOC_GFXRES_PARAMS));
+    allocParams.Type            = MOS_GFXRES_BUFFER;
+    allocParams.TileType        = MOS_TILE_LINEAR;
+    allocParams.Format          = Format_Buffer;
+    allocParams.dwBytes         = sizeOfBuffer;
+    allocParams.pBufName        = nameOfBuffer;
+    allocParams.ResUsageType    = static_cast<MOS_HW_RESOURCE_DEF>(resUsageType);
+    SetAccessRequirement(accessReq, allocParams);
+
+    MOS_BUFFER* buffer = MOS_New(MOS_BUFFER);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+
+    MOS_ZeroMemory(buffer, sizeof(MOS_BUFFER));
+    if (m_osInterface->pfnAllocateResource(m_osInterface, &allocParams, &buffer->OsResource) != MOS_STATUS_SUCCESS)
+    {
+        MOS_Delete(buffer);
+        return nullptr;
+    }
+
+    buffer->size = sizeOfBuffer;
+    buffer->name = nameOfBuffer;
+
+    return buffer;
+}
+
 BufferArray * DecodeAllocator::AllocateBufferArray(
     const uint32_t sizeOfBuffer, const char* nameOfBuffer, const uint32_t numberOfBuffer,
     ResourceUsage resUsageType, ResourceAccessReq accessReq,
@@ -473,6 +509,20 @@ MOS_STATUS DecodeAllocator::Destroy(MOS_BUFFER* & buffer)
     return MOS_STATUS_SUCCESS;
 }
 
+MOS_STATUS DecodeAllocator::DestroySharedBuffer(MOS_BUFFER* & buffer)
+{
+    DECODE_CHK_NULL(m_osInterface);
+    if (buffer == nullptr)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+    m_osInterface->pfnFreeResource(m_osInterface, &buffer->OsResource);
+    MOS_Delete(buffer);
+    buffer = nullptr;
+    return MOS_STATUS_SUCCESS;
+}
+
 MOS_STATUS DecodeAllocator::Destroy(MOS_SURFACE* & surface)
 {
     DECODE_CHK_NULL(m_allocator);
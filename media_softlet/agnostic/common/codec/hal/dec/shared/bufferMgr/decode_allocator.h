@@ -111,6 +111,24 @@ public:
         ResourceUsage resUsageType = resourceDefault, ResourceAccessReq accessReq = lockableVideoMem,
         bool initOnAllocate = false, uint8_t initValue = 0, bool bPersistent = false);
 
+    //!
+    //! \brief  Allocate buffer shared between decode instances
+    //! \details The buffer is not tracked by this allocator, so it may outlive the allocator.
+    //!          It must be released with DestroySharedBuffer by any allocator of the same device.
+    //! \param  [in] sizeOfBuffer
+    //!         Buffer size
+    //! \param  [in] nameOfBuffer
+    //!         Buffer name
+    //! \param  [in] resUsageType
+    //!         ResourceUsage to be set
+    //! \param  [in] accessReq
+    //!         Resource access requirement, by default is lockable
+    //! \return MOS_BUFFER*
+    //!         return the pointer to MOS_BUFFER
+    //!
+    MOS_BUFFER* AllocateSharedBuffer(const uint32_t sizeOfBuffer, const char* nameOfBuffer,
+        ResourceUsage resUsageType = resourceDefault, ResourceAccessReq accessReq = lockableVideoMem);
+
     //!
     //! \brief  Allocate buffer array
     //! \param  [in] sizeOfBuffer
@@ -304,6 +322,15 @@ public:
     //!
     MOS_STATUS Destroy(MOS_BUFFER* & resource);
 
+    //!
+    //! \brief  Destroy buffer allocated by AllocateSharedBuffer
+    //! \param  [in] buffer
+    //!         The buffer to be destroyed
+    //! \return MOS_STATUS
+    //!         MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS DestroySharedBuffer(MOS_BUFFER* & buffer);
+
     //!
     //! \brief  Destroy Surface
     //! \param  [in] surface
@@ -118,12 +118,17 @@ MOS_STATUS Vp8BasicFeature::SetPictureStructs(CodechalDecodeParams *decodeParams
         DECODE_CHK_STATUS(AllocateCoefProbBuffer());
         if (decodeParams->m_bitstreamLockable)
         {
-            ResourceAutoLock resLock(m_allocator, &m_resDataBuffer.OsResource);
-            auto             bitstreamBuffer = (uint8_t *)resLock.LockResourceForRead();
+            uint32_t frameHeadSize = 0;
+            {
+                ResourceAutoLock resLock(m_allocator, &m_resDataBuffer.OsResource);
+                auto             bitstreamBuffer = (uint8_t *)resLock.LockResourceForRead();
+
+                DECODE_CHK_NULL(bitstreamBuffer);
 
-            DECODE_CHK_NULL(bitstreamBuffer);
+                DECODE_CHK_STATUS(CopyFrameHead(bitstreamBuffer + m_dataOffset, m_dataSize, frameHeadSize));
+            }
 
-            DECODE_CHK_STATUS(ParseFrameHead(bitstreamBuffer + m_dataOffset, m_dataSize));
+            DECODE_CHK_STATUS(ParseFrameHead(m_frameHeadData.data(), frameHeadSize, m_dataSize));
         }
         else
         {
@@ -162,7 +167,52 @@ MOS_STATUS Vp8BasicFeature::AllocateCoefProbBuffer()
     return eStatus;
 }
 
-MOS_STATUS Vp8BasicFeature::ParseFrameHead(uint8_t *bitstreamBuffer, uint32_t bitstreamBufferSize)
+MOS_STATUS Vp8BasicFeature::CopyFrameHead(const uint8_t *bitstreamBuffer, uint32_t bitstreamBufferSize, uint32_t &frameHeadSize)
+{
+    DECODE_FUNC_CALL();
+
+    DECODE_CHK_NULL(bitstreamBuffer);
+
+    // Frame tag is 3 bytes, key frames add 7 bytes of start code and frame size.
+    // The sizes of token partitions 1 to 7 follow the first partition, 3 bytes each.
+    const uint32_t frameTagSize          = 3;
+    const uint32_t keyFrameHeadSize      = 10;
+    const uint32_t partitionSizeDataSize = 7 * 3;
+    if (bitstreamBufferSize < frameTagSize)
+    {
+        DECODE_ASSERTMESSAGE("VP8 bitstream is too small to hold a frame tag");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    uint8_t frameTag[frameTagSize];
+    DECODE_CHK_STATUS(MOS_SecureMemcpyFromWC(frameTag, sizeof(frameTag), bitstreamBuffer, sizeof(frameTag)));
+
+    uint32_t headSize           = (frameTag[0] & 1) ? frameTagSize : keyFrameHeadSize;
+    uint32_t firstPartitionSize = (frameTag[0] | (frameTag[1] << 8) | (frameTag[2] << 16)) >> 5;
+    if (m_vp8PicParams != nullptr)
+    {
+        // The parser locates the partition sizes with the first partition size from pic params
+        firstPartitionSize = MOS_MAX(firstPartitionSize, m_vp8PicParams->uiFirstPartitionSize);
+    }
+    if (bitstreamBufferSize < headSize)
+    {
+        DECODE_ASSERTMESSAGE("VP8 bitstream is too small to hold a frame head");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    // The parser never reads past the partition sizes of a conformant stream
+    frameHeadSize = (uint32_t)MOS_MIN((uint64_t)bitstreamBufferSize, (uint64_t)headSize + firstPartitionSize + partitionSizeDataSize);
+    if (m_frameHeadData.size() < frameHeadSize)
+    {
+        m_frameHeadData.resize(frameHeadSize);
+    }
+
+    DECODE_CHK_STATUS(MOS_SecureMemcpyFromWC(m_frameHeadData.data(), frameHeadSize, bitstreamBuffer, frameHeadSize));
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS Vp8BasicFeature::ParseFrameHead(uint8_t *bitstreamBuffer, uint32_t bitstreamBufferSize, uint32_t frameSize)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
@@ -170,7 +220,7 @@ MOS_STATUS Vp8BasicFeature::ParseFrameHead(uint8_t *bitstreamBuffer, uint32_t bi
 
     DECODE_CHK_NULL(bitstreamBuffer);
 
-    m_vp8EntropyState.Initialize(&m_vp8FrameHead, bitstreamBuffer, bitstreamBufferSize);
+    m_vp8EntropyState.Initialize(&m_vp8FrameHead, bitstreamBuffer, bitstreamBufferSize, frameSize);
 
     eStatus = m_vp8EntropyState.ParseFrameHead(m_vp8PicParams);
 
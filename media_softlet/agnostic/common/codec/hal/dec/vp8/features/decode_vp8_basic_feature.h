@@ -31,6 +31,7 @@
 #include "codec_def_vp8_probs.h"
 #include "decode_vp8_reference_frames.h"
 #include "decode_vp8_entropy_state.h"
+#include <vector>
 
 namespace decode
 {
@@ -66,7 +67,7 @@ public:
     
     MOS_STATUS AllocateCoefProbBuffer();
 
-    MOS_STATUS ParseFrameHead(uint8_t* bitstreamBuffer, uint32_t bitstreamBufferSize);
+    MOS_STATUS ParseFrameHead(uint8_t* bitstreamBuffer, uint32_t bitstreamBufferSize, uint32_t frameSize);
 
     // Parameters passed by application
     uint16_t                    picWidthInMB                = 0;
@@ -99,7 +100,25 @@ public:
 protected:
 
     virtual MOS_STATUS SetRequiredBitstreamSize(uint32_t requiredSize) override;
-    
+
+    //!
+    //! \brief    Copy VP8 frame head out of the bitstream buffer
+    //! \details  Copy the frame tag, the key frame start code and the first partition, which hold
+    //!           everything the frame head parser reads, so that it runs on cached memory instead
+    //!           of the bitstream buffer mapping and the buffer can be unlocked before parsing.
+    //! \param    [in] bitstreamBuffer
+    //!           Pointer to the locked bitstream buffer
+    //! \param    [in] bitstreamBufferSize
+    //!           Size of the bitstream buffer
+    //! \param    [out] frameHeadSize
+    //!           Size of the frame head copied to m_frameHeadData
+    //! \return   MOS_STATUS
+    //!           MOS_STATUS_SUCCESS if success, else fail reason
+    //!
+    MOS_STATUS CopyFrameHead(const uint8_t *bitstreamBuffer, uint32_t bitstreamBufferSize, uint32_t &frameHeadSize);
+
+    std::vector<uint8_t>            m_frameHeadData;                                //!< CPU copy of frame head for parsing
+
     //! \brief OS Interface
     PMOS_INTERFACE                  m_osInterface           = nullptr;
 
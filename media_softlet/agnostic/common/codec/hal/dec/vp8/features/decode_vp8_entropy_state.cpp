@@ -31,6 +31,8 @@
 
 namespace decode
 {
+    // The bool decoder keeps its bit by bit DecodeBool, normalized through the Norm table.
+    // Only the value window is 64 bits wide, so DecodeFill loads up to 7 bytes per call.
     void Vp8EntropyState::DecodeFill()
     {
         int32_t        shift       = m_bdValueSize - 8 - (m_count + 8);
@@ -50,7 +52,7 @@ namespace decode
             while (shift >= loopEnd)
             {
                 m_count += CHAR_BIT;
-                m_value |= (uint32_t)*m_buffer << shift;
+                m_value |= (uint64_t)*m_buffer << shift;
                 ++m_buffer;
                 shift -= CHAR_BIT;
             }
@@ -60,7 +62,7 @@ namespace decode
     uint32_t Vp8EntropyState::DecodeBool(int32_t probability)
     {
         uint32_t split     = 1 + (((m_range - 1) * probability) >> 8);
-        uint32_t bigSplit  = (uint32_t)split << (m_bdValueSize - 8);
+        uint64_t bigSplit  = (uint64_t)split << (m_bdValueSize - 8);
         uint32_t origRange = m_range;
         m_range            = split;
 
@@ -607,7 +609,7 @@ namespace decode
         }
 
         vp8PicParams->ucP0EntropyCount = 8 - (m_count & 0x07);
-        vp8PicParams->ucP0EntropyValue = (uint8_t)(m_value >> 24);
+        vp8PicParams->ucP0EntropyValue = (uint8_t)(m_value >> (m_bdValueSize - 8));
         vp8PicParams->uiP0EntropyRange = m_range;
 
         uint32_t firstPartitionAndUncompSize;
@@ -626,6 +628,12 @@ namespace decode
         m_dataBuffer              = m_bitstreamBuffer + firstPartitionAndUncompSize;
         if (partitionNum > 1)
         {
+            if ((uint64_t)firstPartitionAndUncompSize + (partitionNum - 1) * 3 > m_bitstreamBufferSize)
+            {
+                DECODE_ASSERTMESSAGE("VP8 partition sizes are out of bitstream buffer");
+                return MOS_STATUS_INVALID_PARAMETER;
+            }
+
             for (int32_t i = 1; i < (int32_t)partitionNum; i++)
             {
                 vp8PicParams->uiPartitionSize[i] = m_dataBuffer[0] + (m_dataBuffer[1] << 8) + (m_dataBuffer[2] << 16);
@@ -634,10 +642,11 @@ namespace decode
             }
         }
 
-        uint32_t offsetCounter                      = ((m_count & 0x18) >> 3) + (((m_count & 0x07) != 0) ? 1 : 0);
+        // Bytes loaded into m_value but not consumed yet, m_count holds at most 56 + 7 bits besides m_lotsOfBits
+        uint32_t offsetCounter                      = ((m_count & 0x38) >> 3) + (((m_count & 0x07) != 0) ? 1 : 0);
         vp8PicParams->uiFirstMbByteOffset           = (uint32_t)(m_buffer - m_bitstreamBuffer) - offsetCounter;
         vp8PicParams->uiPartitionSize[0]            = firstPartitionAndUncompSize - (uint32_t)(m_buffer - m_bitstreamBuffer) + offsetCounter;
-        vp8PicParams->uiPartitionSize[partitionNum] = m_bitstreamBufferSize - firstPartitionAndUncompSize - (partitionNum - 1) * 3 - partitionSizeSum;
+        vp8PicParams->uiPartitionSize[partitionNum] = m_frameSize - firstPartitionAndUncompSize - (partitionNum - 1) * 3 - partitionSizeSum;
 
         return eStatus;
     }
@@ -660,13 +669,15 @@ namespace decode
     void Vp8EntropyState::Initialize(
         PCODECHAL_DECODE_VP8_FRAME_HEAD vp8FrameHeadIn,
         uint8_t*        bitstreamBufferIn,
-        uint32_t        bitstreamBufferSizeIn)
+        uint32_t        bitstreamBufferSizeIn,
+        uint32_t        frameSizeIn)
         {
         m_frameHead           = vp8FrameHeadIn;
         m_dataBuffer          = bitstreamBufferIn;
         m_dataBufferEnd       = bitstreamBufferIn + bitstreamBufferSizeIn;
         m_bitstreamBuffer     = bitstreamBufferIn;
         m_bitstreamBufferSize = bitstreamBufferSizeIn;
+        m_frameSize           = frameSizeIn;
 
         m_frameHead->iFrameType                    = m_dataBuffer[0] & 1;
         m_frameHead->iVersion                      = (m_dataBuffer[0] >> 1) & 7;
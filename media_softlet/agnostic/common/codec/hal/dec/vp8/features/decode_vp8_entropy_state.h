@@ -277,7 +277,7 @@ class Vp8EntropyState
 public:
     const uint8_t  m_keyFrame    = 0;                                        //!< VP8 Key Frame Flag
     const uint8_t  m_interFrame  = 1;                                        //!< VP8 Inter Frame Flag
-    const uint32_t m_bdValueSize = ((uint32_t)sizeof(uint32_t) * CHAR_BIT);  // VP8 BD Value Size
+    const uint32_t m_bdValueSize = ((uint32_t)sizeof(uint64_t) * CHAR_BIT);  // VP8 BD Value Size
     const uint32_t m_lotsOfBits  = 0x40000000;                               //!< Offset for parsing frame head
     const uint8_t  m_probHalf    = 128;                                      //!< VP8 Half Probability
 
@@ -299,12 +299,15 @@ public:
     //!           Pointer to VP8 bitstream buffer
     //! \param    [in] bitstreamBufferSizeIn
     //!           VP8 bitstream buffer size
+    //! \param    [in] frameSizeIn
+    //!           VP8 frame size, the bitstream buffer may only hold the frame head of it
     //! \return   void
     //!
     void Initialize(
         PCODECHAL_DECODE_VP8_FRAME_HEAD vp8FrameHeadIn,
         uint8_t*        bitstreamBufferIn,
-        uint32_t        bitstreamBufferSizeIn);
+        uint32_t        bitstreamBufferSizeIn,
+        uint32_t        frameSizeIn);
 
     //!
     //! \brief    Parse VP8 Frame Head
@@ -362,6 +365,7 @@ protected:
     PCODECHAL_DECODE_VP8_FRAME_HEAD m_frameHead           = nullptr;  //!< Pointer to VP8 Frame Head
     uint8_t *                       m_bitstreamBuffer     = nullptr;  //!< Pointer to Bitstream Buffer
     uint32_t                        m_bitstreamBufferSize = 0;        //!< Size of Bitstream Buffer
+    uint32_t                        m_frameSize           = 0;        //!< Size of VP8 Frame
     uint8_t *                       m_dataBuffer          = nullptr;  //!< Pointer to Data Buffer
     uint8_t *                       m_dataBufferEnd       = nullptr;  //<! Pointer to Data Buffer End
 
@@ -500,7 +504,7 @@ private:
     const uint8_t *m_bufferEnd = nullptr;  //!< Pointer to Data Buffer End
     const uint8_t *m_buffer = nullptr;     //!< Pointer to Data Buffer
     int32_t        m_count = 0;      //!< Bits Count for Bitstream Buffer
-    uint32_t       m_value = 0;      //!< Entropy Value
+    uint64_t       m_value = 0;      //!< Entropy Value, refilled with up to 7 bytes at once
     uint32_t       m_range = 0;      //!< Entropy Range
 
 MEDIA_CLASS_DEFINE_END(decode__Vp8EntropyState)
@@ -26,6 +26,7 @@
 
 #include "encode_avc_header_packer.h"
 #include "encode_utils.h"
+#include "bit_writer.h"
 
 namespace encode
 {
@@ -50,111 +51,50 @@ static void SetNalUnit(uint8_t **bsbuffer, uint8_t refIDC, CODECHAL_ENCODE_AVC_N
     *bsbuffer = byte;
 }
 
-static void PutBit(BSBuffer *bsbuffer, uint32_t code)
+// Bit writes go through a BitWriter positioned at pCurrent/BitOffset and store the position back,
+// so byte oriented code such as SetNalUnit can be interleaved freely with them.
+static BitWriter GetBitWriter(BSBuffer *bsbuffer)
 {
-    if (code & 1)
-    {
-        *(bsbuffer->pCurrent) = (*(bsbuffer->pCurrent) | (uint8_t)(0x01 << (7 - bsbuffer->BitOffset)));
-    }
-
-    bsbuffer->BitOffset++;
-    if (bsbuffer->BitOffset == 8)
-    {
-        bsbuffer->BitOffset = 0;
-        bsbuffer->pCurrent++;
-        *(bsbuffer->pCurrent) = 0;
-    }
+    return BitWriter(bsbuffer->pCurrent, (uint32_t)(bsbuffer->pBase + bsbuffer->BufferSize - bsbuffer->pCurrent), bsbuffer->BitOffset);
 }
 
-static void PutBitsSub(BSBuffer *bsbuffer, uint32_t code, uint32_t length)
+static void UpdateBsBuffer(BSBuffer *bsbuffer, const BitWriter &bs)
 {
-    uint8_t *byte = bsbuffer->pCurrent;
-
-    // make sure that the number of bits given is <= 24
-    ENCODE_ASSERT(length <= 24);
-
-    code <<= (32 - length);
+    ENCODE_ASSERT(!bs.IsOverflow());
 
-    // shift field so that the given code begins at the current bit
-    // offset in the most significant byte of the 32-bit word
-    length += bsbuffer->BitOffset;
-    code >>= bsbuffer->BitOffset;
-
-    // write bytes back into memory, big-endian
-    byte[0] = (uint8_t)((code >> 24) | byte[0]);
-    byte[1] = (uint8_t)(code >> 16);
-    if (length > 16)
-    {
-        byte[2] = (uint8_t)(code >> 8);
-        byte[3] = (uint8_t)code;
-    }
-    else
-    {
-        byte[2] = 0;
-    }
+    bsbuffer->pCurrent  = bs.GetCurrent();
+    bsbuffer->BitOffset = (uint8_t)bs.GetBitOffset();
+}
 
-    // update bitstream pointer and bit offset
-    bsbuffer->pCurrent += (length >> 3);
-    bsbuffer->BitOffset = (length & 7);
+static void PutBit(BSBuffer *bsbuffer, uint32_t code)
+{
+    BitWriter bs = GetBitWriter(bsbuffer);
+    bs.PutBit(code);
+    UpdateBsBuffer(bsbuffer, bs);
 }
 
 static void PutBits(BSBuffer *bsbuffer, uint32_t code, uint32_t length)
 {
-    uint32_t code1, code2;
-
     // temp solution, only support up to 32 bits based on current usage
     ENCODE_ASSERT(length <= 32);
 
-    if (length >= 24)
-    {
-        code1 = code & 0xFFFF;
-        code2 = code >> 16;
-
-        // high bits go first
-        PutBitsSub(bsbuffer, code2, length - 16);
-        PutBitsSub(bsbuffer, code1, 16);
-    }
-    else
-    {
-        PutBitsSub(bsbuffer, code, length);
-    }
+    BitWriter bs = GetBitWriter(bsbuffer);
+    bs.PutBits(length, code);
+    UpdateBsBuffer(bsbuffer, bs);
 }
 
 static void PutVLCCode(BSBuffer *bsbuffer, uint32_t code)
 {
-    uint8_t  leadingZeroBits, bitcount;
-    uint32_t code1, bits;
-
-    code1    = code + 1;
-    bitcount = 0;
-    while (code1)
-    {
-        code1 >>= 1;
-        bitcount++;
-    }
-
-    if (bitcount == 1)
-    {
-        PutBit(bsbuffer, 1);
-    }
-    else
-    {
-        leadingZeroBits = bitcount - 1;
-        bits            = code + 1 - (1 << leadingZeroBits);
-        PutBits(bsbuffer, 1, leadingZeroBits + 1);
-        PutBits(bsbuffer, bits, leadingZeroBits);
-    }
+    BitWriter bs = GetBitWriter(bsbuffer);
+    bs.PutUE(code);
+    UpdateBsBuffer(bsbuffer, bs);
 }
 
 static void SetTrailingBits(BSBuffer *bsbuffer)
 {
-    // Write Stop Bit
-    PutBits(bsbuffer, 1, 1);
-    // Make byte aligned
-    while (bsbuffer->BitOffset)
-    {
-        PutBit(bsbuffer, 0);
-    }
+    BitWriter bs = GetBitWriter(bsbuffer);
+    bs.PutTrailingBits();
+    UpdateBsBuffer(bsbuffer, bs);
 }
 
 static void PackScalingList(BSBuffer *bsbuffer, uint8_t *scalingList, uint8_t sizeOfScalingList)
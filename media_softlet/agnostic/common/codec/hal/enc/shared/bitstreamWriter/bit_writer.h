@@ -0,0 +1,227 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     bit_writer.h
+//! \brief    Defines the MSB first bit writer shared by the encode header packers
+//!
+
+#ifndef __BIT_WRITER_H__
+#define __BIT_WRITER_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "media_class_trace.h"
+
+namespace encode
+{
+//!
+//! \class  BitWriter
+//! \brief  MSB first bit writer used by the AVC/HEVC header packers and the encode DDI
+//! \details Each put composes the pending bits of the current byte and the new code in a
+//!          64 bit accumulator and stores all completed bytes at once. The buffer is kept
+//!          consistent after every call: the current byte holds the pending bits padded
+//!          with zeros, so callers may hand the position over to byte oriented code at any
+//!          time. Writes past the end of the buffer are dropped and reported by IsOverflow.
+//!
+class BitWriter
+{
+public:
+    //!
+    //! \brief    Constructor
+    //!
+    //! \param    [in] buf
+    //!           Buffer to write to, the first bitOffset bits of buf[0] are kept
+    //! \param    [in] size
+    //!           Size of buffer in bytes
+    //! \param    [in] bitOffset
+    //!           Bit offset in buf[0] to start writing at
+    //!
+    BitWriter(uint8_t *buf, uint32_t size, uint32_t bitOffset = 0)
+        : m_cur(buf), m_end(buf + size), m_bitOffset(bitOffset & 7)
+    {
+    }
+
+    //!
+    //! \brief    Write the lsb of v
+    //!
+    void PutBit(uint32_t v)
+    {
+        PutCode(1, v & 1);
+    }
+
+    //!
+    //! \brief    Write the n lsbs of v, n <= 32
+    //!
+    void PutBits(uint32_t n, uint32_t v)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        PutCode(n, v & (0xFFFFFFFFu >> (32 - n)));
+    }
+
+    //!
+    //! \brief    Write v as unsigned Exp-Golomb code ue(v)
+    //!
+    void PutUE(uint32_t v)
+    {
+        PutExpGolomb(v);
+    }
+
+    //!
+    //! \brief    Write v as signed Exp-Golomb code se(v)
+    //! \details  The code number is computed in 64 bits, INT32_MIN maps to 2^32 which
+    //!           does not fit the argument of PutUE.
+    //!
+    void PutSE(int32_t v)
+    {
+        PutExpGolomb(v > 0 ? 2 * (uint64_t)v - 1 : 2 * (uint64_t)(-(int64_t)v));
+    }
+
+    //!
+    //! \brief    Write rbsp_stop_one_bit and zero bits up to the next byte boundary
+    //!
+    void PutTrailingBits()
+    {
+        PutBit(1);
+        if (m_bitOffset)
+        {
+            PutCode(8 - m_bitOffset, 0);
+        }
+    }
+
+    //!
+    //! \brief    Get the byte the next bit is written to
+    //!
+    uint8_t *GetCurrent() const { return m_cur; }
+
+    //!
+    //! \brief    Get the bit offset inside the current byte
+    //!
+    uint32_t GetBitOffset() const { return m_bitOffset; }
+
+    //!
+    //! \brief    Whether any write went past the end of the buffer
+    //!
+    bool IsOverflow() const { return m_overflow; }
+
+private:
+    static uint32_t CountLeadingZeros(uint64_t v)
+    {
+#if defined(__GNUC__)
+        return (uint32_t)__builtin_clzll(v);
+#else
+        uint32_t n = 0;
+        for (uint64_t mask = 1ull << 63; mask && !(v & mask); mask >>= 1)
+        {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    //!
+    //! \brief    Write codeNum as Exp-Golomb code, codeNum <= 2^32
+    //!
+    void PutExpGolomb(uint64_t codeNum)
+    {
+        uint64_t code = codeNum + 1;
+        uint32_t len  = 64 - CountLeadingZeros(code);
+
+        // len - 1 leading zeros are implied by the width of the code
+        PutCode(2 * len - 1, code);
+    }
+
+    //!
+    //! \brief    Write the n lsbs of code, code must not have bits set above n
+    //!
+    void PutCode(uint32_t n, uint64_t code)
+    {
+        if (m_bitOffset + n > 64)
+        {
+            // Only very long Exp-Golomb codes get here
+            PutCode(n - 32, code >> 32);
+            PutCode(32, code & 0xFFFFFFFFu);
+            return;
+        }
+
+        // Locals keep the byte stores below from aliasing the members
+        uint8_t *cur  = m_cur;
+        uint32_t bits = m_bitOffset + n;
+        uint64_t acc  = (m_bitOffset && cur < m_end) ? (uint64_t)(*cur >> (8 - m_bitOffset)) : 0;
+        acc           = (n == 64) ? code : ((acc << n) | code);
+
+        if (m_end - cur >= 8)
+        {
+            // Store 8 bytes msb first at once, bytes after the pending bits become zero
+            uint64_t out = acc << (64 - bits);
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            out = __builtin_bswap64(out);
+            memcpy(cur, &out, sizeof(out));
+#else
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                cur[i] = (uint8_t)(out >> (56 - 8 * i));
+            }
+#endif
+            m_cur       = cur + (bits >> 3);
+            m_bitOffset = bits & 7;
+            return;
+        }
+
+        while (bits >= 8)
+        {
+            bits -= 8;
+            if (cur < m_end)
+            {
+                *cur++ = (uint8_t)(acc >> bits);
+            }
+            else
+            {
+                m_overflow = true;
+            }
+        }
+
+        if (cur < m_end)
+        {
+            *cur = bits ? (uint8_t)(acc << (8 - bits)) : 0;
+        }
+        else if (bits)
+        {
+            // No byte left for the pending bits
+            m_overflow = true;
+        }
+        m_cur       = cur;
+        m_bitOffset = bits;
+    }
+
+    uint8_t *m_cur       = nullptr;
+    uint8_t *m_end       = nullptr;
+    uint32_t m_bitOffset = 0;
+    bool     m_overflow  = false;
+
+MEDIA_CLASS_DEFINE_END(encode__BitWriter)
+};
+}  // namespace encode
+
+#endif  // __BIT_WRITER_H__
@@ -70,77 +70,27 @@ void BitstreamWriter::PutBitsBuffer(mfxU32 n, void *bb, mfxU32 o)
 void BitstreamWriter::PutBits(mfxU32 n, mfxU32 b)
 {
     assert(n <= sizeof(b) * 8);
-    while (n > 24)
-    {
-        n -= 16;
-        PutBits(16, (b >> n));
-    }
-
-    b <<= (32 - n);
-
-    if (!m_bitOffset)
-    {
-        m_bs[0] = (mfxU8)(b >> 24);
-        m_bs[1] = (mfxU8)(b >> 16);
-    }
-    else
-    {
-        b >>= m_bitOffset;
-        n += m_bitOffset;
-
-        m_bs[0] |= (mfxU8)(b >> 24);
-        m_bs[1] = (mfxU8)(b >> 16);
-    }
-
-    if (n > 16)
-    {
-        m_bs[2] = (mfxU8)(b >> 8);
-        m_bs[3] = (mfxU8)b;
-    }
 
-    m_bs += (n >> 3);
-    m_bitOffset = (n & 7);
+    encode::BitWriter bs(m_bs, mfxU32(m_bsEnd - m_bs), m_bitOffset);
+    bs.PutBits(n, b);
+    m_bs        = bs.GetCurrent();
+    m_bitOffset = (mfxU8)bs.GetBitOffset();
 }
 
 void BitstreamWriter::PutBit(mfxU32 b)
 {
-    switch (m_bitOffset)
-    {
-    case 0:
-        m_bs[0]     = (mfxU8)(b << 7);
-        m_bitOffset = 1;
-        break;
-    case 7:
-        m_bs[0] |= (mfxU8)(b & 1);
-        m_bs++;
-        m_bitOffset = 0;
-        break;
-    default:
-        if (b & 1)
-            m_bs[0] |= (mfxU8)(1 << (7 - m_bitOffset));
-        m_bitOffset++;
-        break;
-    }
+    encode::BitWriter bs(m_bs, mfxU32(m_bsEnd - m_bs), m_bitOffset);
+    bs.PutBit(b);
+    m_bs        = bs.GetCurrent();
+    m_bitOffset = (mfxU8)bs.GetBitOffset();
 }
 
 void BitstreamWriter::PutGolomb(mfxU32 b)
 {
-    if (!b)
-    {
-        PutBit(1);
-    }
-    else
-    {
-        mfxU32 n = 1;
-
-        b++;
-
-        while (b >> n)
-            n++;
-
-        PutBits(n - 1, 0);
-        PutBits(n, b);
-    }
+    encode::BitWriter bs(m_bs, mfxU32(m_bsEnd - m_bs), m_bitOffset);
+    bs.PutUE(b);
+    m_bs        = bs.GetCurrent();
+    m_bitOffset = (mfxU8)bs.GetBitOffset();
 }
 
 void BitstreamWriter::PutTrailingBits(bool bCheckAligened)
@@ -28,6 +28,7 @@
 #define __BITSTREAM_WRITER_H__
 
 #include "media_class_trace.h"
+#include "bit_writer.h"
 #include <map>
 
 typedef unsigned char  mfxU8;
@@ -122,33 +123,20 @@ const mfxU8 tab_cabacTransTbl[2][128] =
     }
 };
 
-class IBsWriter
-{
-public:
-    virtual ~IBsWriter() {}
-    virtual void PutBits(mfxU32 n, mfxU32 b) = 0;
-    virtual void PutBit(mfxU32 b)            = 0;
-    virtual void PutUE(mfxU32 b)             = 0;
-    virtual void PutSE(mfxI32 b)             = 0;
-
-MEDIA_CLASS_DEFINE_END(IBsWriter)
-};
-
 class BitstreamWriter
-    : public IBsWriter
 {
 public:
     BitstreamWriter(mfxU8 *bs, mfxU32 size, mfxU8 bitOffset = 0);
     ~BitstreamWriter();
 
-    virtual void PutBits(mfxU32 n, mfxU32 b) override;
-    void         PutBitsBuffer(mfxU32 n, void *b, mfxU32 offset = 0);
-    virtual void PutBit(mfxU32 b) override;
-    void         PutGolomb(mfxU32 b);
-    void         PutTrailingBits(bool bCheckAligned = false);
+    void PutBits(mfxU32 n, mfxU32 b);
+    void PutBitsBuffer(mfxU32 n, void *b, mfxU32 offset = 0);
+    void PutBit(mfxU32 b);
+    void PutGolomb(mfxU32 b);
+    void PutTrailingBits(bool bCheckAligned = false);
 
-    virtual void PutUE(mfxU32 b) override { PutGolomb(b); }
-    virtual void PutSE(mfxI32 b) override { (b > 0) ? PutGolomb((b << 1) - 1) : PutGolomb((-b) << 1); }
+    void PutUE(mfxU32 b) { PutGolomb(b); }
+    void PutSE(mfxI32 b) { (b > 0) ? PutGolomb((b << 1) - 1) : PutGolomb((-b) << 1); }
 
     mfxU32 GetOffset()
     {
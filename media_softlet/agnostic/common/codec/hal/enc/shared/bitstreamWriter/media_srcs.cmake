@@ -24,6 +24,7 @@ set(TMP_SOURCES_
 )
 
 set(TMP_HEADERS_
+    ${CMAKE_CURRENT_LIST_DIR}/bit_writer.h
     ${CMAKE_CURRENT_LIST_DIR}/bitstream_writer.h
 )
 
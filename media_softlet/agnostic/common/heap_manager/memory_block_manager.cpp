@@ -26,6 +26,27 @@
 
 #include "memory_block_manager.h"
 
+//!
+//! \brief  Gets the index of the most significant set bit
+//! \param  [in] value
+//!         Must be non-zero
+//! \return uint32_t
+//!         Index of the highest set bit
+//!
+static inline uint32_t HeapGetMsb(uint64_t value)
+{
+    uint32_t msb = 0;
+    for (uint32_t shift = 32; shift != 0; shift >>= 1)
+    {
+        if (value >= (1ull << shift))
+        {
+            value >>= shift;
+            msb += shift;
+        }
+    }
+    return msb;
+}
+
 MemoryBlockManager::~MemoryBlockManager()
 {
     HEAP_FUNCTION_ENTER;
@@ -426,54 +447,38 @@ MOS_STATUS MemoryBlockManager::IsSpaceAvailable(
         }
     }
 
+    // AllocateSpace places the requests largest first, each in the largest free
+    // block, and returns the remainder to the free list. Only the largest free
+    // blocks can be used, at most one per request.
+    m_largestFreeSizes.clear();
     auto block = m_sortedBlockList[MemoryBlockInternal::State::free];
- 
+    while (block != nullptr && m_largestFreeSizes.size() < m_sortedSizes.size())
+    {
+        m_largestFreeSizes.push_back(block->GetSize());
+        block = block->m_stateNext;
+    }
+
     for (auto requestIterator = m_sortedSizes.begin();
         requestIterator != m_sortedSizes.end();
         ++requestIterator)
     {
-        if (block == nullptr)
-        {
-            // There is no free space available, add up all requested sizes
-            spaceNeeded += (*requestIterator).m_blockSize;
-        }
-        else
+        uint32_t blockSize = (*requestIterator).m_blockSize;
+        if (m_largestFreeSizes.empty() || blockSize > m_largestFreeSizes.front())
         {
-            // Determine whether or not there is space available
-            if ((*requestIterator).m_blockSize > block->GetSize())
-            {
-                // The requested size is larger than the largest free block size
-                spaceNeeded += (*requestIterator).m_blockSize;
-                continue;
-            }
-            else
-            {
-                // determine if there is enough space in the heaps
-                auto freeBlockSize = block->GetSize();
-                while (requestIterator != m_sortedSizes.end())
-                {
-                    if ((*requestIterator).m_blockSize < freeBlockSize)
-                    {
-                        // if the aligned size fits within the current free block, consider it used
-                        freeBlockSize -= (*requestIterator).m_blockSize;
-                        ++requestIterator;
-                    }
-                    else
-                    {
-                        // if the aligned size does not fit within the curret free block, continue for loop
-                        break;
-                    }
-                }
-                if (requestIterator == m_sortedSizes.end())
-                {
-                    break;
-                }
-            }
+            // The requested size is larger than the largest free block size
+            spaceNeeded += blockSize;
+            continue;
         }
-        if (block != nullptr)
+
+        // Move the remainder of the largest block to keep the sizes in descending order
+        uint32_t remainder = m_largestFreeSizes.front() - blockSize;
+        uint32_t idx       = 0;
+        while (idx + 1 < m_largestFreeSizes.size() && m_largestFreeSizes[idx + 1] > remainder)
         {
-            block = block->m_stateNext;
+            m_largestFreeSizes[idx] = m_largestFreeSizes[idx + 1];
+            idx++;
         }
+        m_largestFreeSizes[idx] = remainder;
     }
 
     return MOS_STATUS_SUCCESS;
@@ -673,42 +678,51 @@ MOS_STATUS MemoryBlockManager::AddBlockToSortedList(
     {
         case MemoryBlockInternal::State::free:
         {
-            bool inserted = false;
-            MemoryBlockInternal *prev = nullptr;
-            while (curr != nullptr)
+            // The free list is sorted by descending size, start the search from the
+            // size class bin of the block instead of the beginning of the list
+            uint32_t bin = GetFreeBin(block->GetSize());
+            curr = m_freeBinHead[bin];
+            if (curr == nullptr)
             {
-                if (curr->GetSize() <= block->GetSize())
-                {
-                    if (prev)
-                    {
-                        prev->m_stateNext = block;
-                    }
-                    else
-                    {
-                        m_sortedBlockList[state] = block;
-                    }
-                    curr->m_statePrev = block;
-                    block->m_statePrev = prev;
-                    block->m_stateNext = curr;
-                    inserted = true;
-                    break;
-                }
-                prev = curr;
-                curr = curr->m_stateNext;
+                curr = GetFreeBinHeadBelow(bin);
+                m_freeBinHead[bin] = block;
+                m_freeBinMask[bin / 64] |= (1ull << (bin % 64));
             }
-            if (!inserted)
+            else
             {
-                if (prev == nullptr)
+                auto binHead = curr;
+                while (curr != nullptr &&
+                    curr->GetSize() > block->GetSize() &&
+                    GetFreeBin(curr->GetSize()) == bin)
                 {
-                    block->m_stateNext = m_sortedBlockList[state];
-                    m_sortedBlockList[state] = block;
+                    curr = curr->m_stateNext;
                 }
-                else
+                if (curr == binHead)
                 {
-                    block->m_statePrev = prev;
-                    prev->m_stateNext = block;
+                    m_freeBinHead[bin] = block;
                 }
             }
+
+            // insert before curr, or at the end of the list if curr is null
+            MemoryBlockInternal *prev = curr ? curr->m_statePrev : m_freeListTail;
+            block->m_statePrev = prev;
+            block->m_stateNext = curr;
+            if (prev)
+            {
+                prev->m_stateNext = block;
+            }
+            else
+            {
+                m_sortedBlockList[state] = block;
+            }
+            if (curr)
+            {
+                curr->m_statePrev = block;
+            }
+            else
+            {
+                m_freeListTail = block;
+            }
             block->m_stateListType = state;
             m_sortedBlockListNumEntries[state]++;
             m_sortedBlockListSizes[state] += block->GetSize();
@@ -760,6 +774,28 @@ MOS_STATUS MemoryBlockManager::RemoveBlockFromSortedList(
         case MemoryBlockInternal::State::submitted:
         case MemoryBlockInternal::State::deleted:
         {
+            if (state == MemoryBlockInternal::State::free)
+            {
+                uint32_t bin = GetFreeBin(block->GetSize());
+                if (m_freeBinHead[bin] == block)
+                {
+                    auto next = block->m_stateNext;
+                    if (next && GetFreeBin(next->GetSize()) == bin)
+                    {
+                        m_freeBinHead[bin] = next;
+                    }
+                    else
+                    {
+                        m_freeBinHead[bin] = nullptr;
+                        m_freeBinMask[bin / 64] &= ~(1ull << (bin % 64));
+                    }
+                }
+                if (m_freeListTail == block)
+                {
+                    m_freeListTail = block->m_statePrev;
+                }
+            }
+
             if (block->m_statePrev)
             {
                 block->m_statePrev->m_stateNext = block->m_stateNext;
@@ -788,6 +824,40 @@ MOS_STATUS MemoryBlockManager::RemoveBlockFromSortedList(
     return MOS_STATUS_SUCCESS;
 }
 
+uint32_t MemoryBlockManager::GetFreeBin(uint32_t size)
+{
+    if (size < (1u << m_freeBinSubdivisionBits))
+    {
+        return size;
+    }
+
+    // Split each power of two into 2^m_freeBinSubdivisionBits bins using the bits below the MSB
+    uint32_t msb = HeapGetMsb(size);
+    uint32_t subBin = (size >> (msb - m_freeBinSubdivisionBits)) & ((1u << m_freeBinSubdivisionBits) - 1);
+    return (msb << m_freeBinSubdivisionBits) + subBin;
+}
+
+MemoryBlockInternal *MemoryBlockManager::GetFreeBinHeadBelow(uint32_t bin)
+{
+    if (bin == 0)
+    {
+        return nullptr;
+    }
+
+    int32_t word = (bin - 1) / 64;
+    uint64_t bits = m_freeBinMask[word] & (~0ull >> (63 - (bin - 1) % 64));
+    while (bits == 0)
+    {
+        if (--word < 0)
+        {
+            return nullptr;
+        }
+        bits = m_freeBinMask[word];
+    }
+
+    return m_freeBinHead[word * 64 + HeapGetMsb(bits)];
+}
+
 MemoryBlockInternal *MemoryBlockManager::GetBlockFromPool()
 {
     HEAP_FUNCTION_ENTER_VERBOSE;
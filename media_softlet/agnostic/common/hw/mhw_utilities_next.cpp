@@ -25,6 +25,11 @@
 //!
 
 #include <math.h>
+#include <array>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "mhw_utilities_next.h"
 #include "mhw_state_heap.h"
 #include "mos_interface.h"
@@ -36,6 +41,89 @@
 #include "mhw_mi_itf.h"
 
 #define MHW_NS_PER_TICK_RENDER_ENGINE 80  // 80 nano seconds per tick in render engine
+#define MHW_POLYPHASE_TABLE_CACHE_SIZE 128  // Max number of polyphase tables kept in cache
+
+//!
+//! \brief  Polyphase table cache
+//! \details Polyphase tables only depend on the calculation arguments, so every argument
+//!          is part of the key (float by bit pattern) and cached tables are bit exact.
+//!          Tables are evicted in insertion order once the cache is full.
+//!
+enum MHW_POLYPHASE_TABLE_TYPE
+{
+    MHW_POLYPHASE_TABLE_Y = 0,
+    MHW_POLYPHASE_TABLE_UV,
+    MHW_POLYPHASE_TABLE_UV_OFFSET
+};
+
+typedef std::array<uint32_t, 8> MHW_POLYPHASE_TABLE_KEY;
+
+static std::mutex                                               g_polyphaseTableMutex;
+static std::map<MHW_POLYPHASE_TABLE_KEY, std::vector<int32_t>>  g_polyphaseTables;
+static std::deque<MHW_POLYPHASE_TABLE_KEY>                      g_polyphaseTableOrder;
+
+static inline uint32_t Mhw_FloatToBits(float fValue)
+{
+    uint32_t dwBits = 0;
+    MOS_SecureMemcpy(&dwBits, sizeof(dwBits), &fValue, sizeof(fValue));
+    return dwBits;
+}
+
+//!
+//! \brief    Get polyphase table from cache
+//! \param    const MHW_POLYPHASE_TABLE_KEY &key
+//!           [in] Table key
+//! \param    int32_t *piCoefs
+//!           [out] Polyphase table to fill
+//! \param    uint32_t dwCount
+//!           [in] Number of coefficients in table
+//! \return   bool
+//!           true if table was found in cache
+//!
+static bool Mhw_GetCachedPolyphaseTable(
+    const MHW_POLYPHASE_TABLE_KEY &key,
+    int32_t                       *piCoefs,
+    uint32_t                      dwCount)
+{
+    std::lock_guard<std::mutex> lock(g_polyphaseTableMutex);
+
+    auto it = g_polyphaseTables.find(key);
+    if (it == g_polyphaseTables.end() || it->second.size() != dwCount)
+    {
+        return false;
+    }
+    MOS_SecureMemcpy(piCoefs, dwCount * sizeof(int32_t), it->second.data(), dwCount * sizeof(int32_t));
+    return true;
+}
+
+//!
+//! \brief    Add polyphase table to cache
+//! \param    const MHW_POLYPHASE_TABLE_KEY &key
+//!           [in] Table key
+//! \param    const int32_t *piCoefs
+//!           [in] Calculated polyphase table
+//! \param    uint32_t dwCount
+//!           [in] Number of coefficients in table
+//!
+static void Mhw_AddCachedPolyphaseTable(
+    const MHW_POLYPHASE_TABLE_KEY &key,
+    const int32_t                 *piCoefs,
+    uint32_t                      dwCount)
+{
+    std::lock_guard<std::mutex> lock(g_polyphaseTableMutex);
+
+    if (g_polyphaseTables.find(key) != g_polyphaseTables.end())
+    {
+        return;
+    }
+    if (g_polyphaseTableOrder.size() >= MHW_POLYPHASE_TABLE_CACHE_SIZE)
+    {
+        g_polyphaseTables.erase(g_polyphaseTableOrder.front());
+        g_polyphaseTableOrder.pop_front();
+    }
+    g_polyphaseTables.emplace(key, std::vector<int32_t>(piCoefs, piCoefs + dwCount));
+    g_polyphaseTableOrder.push_back(key);
+}
 
 //!
 //! \brief    Set mocs index
@@ -667,6 +755,7 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
     float                   fBase, fPos, fSumCoefs;
     int32_t                 iCenterPixel;
     int32_t                 iSumQuantCoefs;
+    MHW_POLYPHASE_TABLE_KEY key;
 
     MHW_FUNCTION_ENTER;
 
@@ -682,6 +771,13 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
         dwNumEntries = NUM_POLYPHASE_UV_ENTRIES;
     }
 
+    key = {MHW_POLYPHASE_TABLE_Y, Mhw_FloatToBits(fScaleFactor), dwPlane, (uint32_t)srcFmt,
+        Mhw_FloatToBits(fHPStrength), (uint32_t)bUse8x8Filter, dwHwPhase, Mhw_FloatToBits(fLanczosT)};
+    if (Mhw_GetCachedPolyphaseTable(key, iCoefs, dwHwPhase * dwNumEntries))
+    {
+        return eStatus;
+    }
+
     MOS_ZeroMemory(fPhaseCoefs    , sizeof(fPhaseCoefs));
     MOS_ZeroMemory(fPhaseCoefsCopy, sizeof(fPhaseCoefsCopy));
 
@@ -779,6 +875,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesY(
         }
     }
 
+    Mhw_AddCachedPolyphaseTable(key, iCoefs, dwHwPhase * dwNumEntries);
+
     return eStatus;
 }
 
@@ -805,6 +903,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUV(
     int32_t     minCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     maxCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     i, j;
+    int32_t     *piTable;
+    MHW_POLYPHASE_TABLE_KEY key;
     MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
 
     MHW_FUNCTION_ENTER;
@@ -817,6 +917,13 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUV(
     tableCoefUnit   = 1 << MHW_TBL_COEF_PREC;
     sf              = MOS_MIN(1.0, fInverseScaleFactor); // Sf isn't used for upscaling
 
+    key = {MHW_POLYPHASE_TABLE_UV, Mhw_FloatToBits(fLanczosT), Mhw_FloatToBits(fInverseScaleFactor), 0};
+    if (Mhw_GetCachedPolyphaseTable(key, piCoefs, MHW_SCALER_UV_WIN_SIZE * phaseCount))
+    {
+        return eStatus;
+    }
+    piTable = piCoefs;
+
     MOS_ZeroMemory(piCoefs, sizeof(int32_t) * MHW_SCALER_UV_WIN_SIZE * phaseCount);
     MOS_ZeroMemory(minCoef, sizeof(minCoef));
     MOS_ZeroMemory(maxCoef, sizeof(maxCoef));
@@ -867,6 +974,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUV(
         }
     }
 
+    Mhw_AddCachedPolyphaseTable(key, piTable, MHW_SCALER_UV_WIN_SIZE * phaseCount);
+
     return eStatus;
 }
 
@@ -898,6 +1007,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
     int32_t     maxCoef[MHW_SCALER_UV_WIN_SIZE];
     int32_t     i, j;
     int32_t     adjusted_phase;
+    int32_t     *piTable;
+    MHW_POLYPHASE_TABLE_KEY key;
     MOS_STATUS              eStatus = MOS_STATUS_SUCCESS;
 
     MHW_FUNCTION_ENTER;
@@ -910,6 +1021,13 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
         (double)iUvPhaseOffset / (double)(phaseCount));
     tableCoefUnit = 1 << MHW_TBL_COEF_PREC;
 
+    key = {MHW_POLYPHASE_TABLE_UV_OFFSET, Mhw_FloatToBits(fLanczosT), Mhw_FloatToBits(fInverseScaleFactor), (uint32_t)iUvPhaseOffset};
+    if (Mhw_GetCachedPolyphaseTable(key, piCoefs, MHW_SCALER_UV_WIN_SIZE * phaseCount))
+    {
+        return eStatus;
+    }
+    piTable = piCoefs;
+
     MOS_ZeroMemory(minCoef, sizeof(minCoef));
     MOS_ZeroMemory(maxCoef, sizeof(maxCoef));
     MOS_ZeroMemory(piCoefs, sizeof(int32_t)* MHW_SCALER_UV_WIN_SIZE * phaseCount);
@@ -962,6 +1080,8 @@ MOS_STATUS Mhw_CalcPolyphaseTablesUVOffset(
         }
     }
 
+    Mhw_AddCachedPolyphaseTable(key, piTable, MHW_SCALER_UV_WIN_SIZE * phaseCount);
+
     return eStatus;
 }
 
@@ -57,11 +57,8 @@ MOS_STATUS CmdBufMgrNext::Initialize(OsContextNext *osContext, uint32_t cmdBufSi
     {
         m_osContext          = osContext;
 
-        m_inUsePoolMutex     = MosUtilities::MosCreateMutex();
-        MOS_OS_CHK_NULL_RETURN(m_inUsePoolMutex);
-
-        m_availablePoolMutex = MosUtilities::MosCreateMutex();
-        MOS_OS_CHK_NULL_RETURN(m_availablePoolMutex);
+        m_poolMutex          = MosUtilities::MosCreateMutex();
+        MOS_OS_CHK_NULL_RETURN(m_poolMutex);
 
         for (uint32_t i = 0; i < m_initBufNum; i++)
         {
@@ -81,9 +78,9 @@ MOS_STATUS CmdBufMgrNext::Initialize(OsContextNext *osContext, uint32_t cmdBufSi
                 return MOS_STATUS_INVALID_HANDLE;
             }
 
-            MosUtilities::MosLockMutex(m_availablePoolMutex);
+            MosUtilities::MosLockMutex(m_poolMutex);
             m_availableCmdBufPool.push_back(cmdBuf);
-            MosUtilities::MosUnlockMutex(m_availablePoolMutex);
+            MosUtilities::MosUnlockMutex(m_poolMutex);
 
             m_cmdBufTotalNum++;
         }
@@ -103,7 +100,7 @@ MOS_STATUS CmdBufMgrNext::Reset()
     MOS_OS_CHK_NULL_RETURN(gpuContextMgr);
     std::vector<CommandBufferNext *> tmpInUseCmdBufPool = {};
 
-    MosUtilities::MosLockMutex(m_inUsePoolMutex);
+    MosUtilities::MosLockMutex(m_poolMutex);
 
     if (!m_inUseCmdBufPool.empty())
     {
@@ -112,9 +109,7 @@ MOS_STATUS CmdBufMgrNext::Reset()
 
     // clear in-use command buffer pool
     m_inUseCmdBufPool.clear();
-    MosUtilities::MosUnlockMutex(m_inUsePoolMutex);
 
-    MosUtilities::MosLockMutex(m_availablePoolMutex);
     if (!tmpInUseCmdBufPool.empty())
     {
         for (auto& cmdBuf : tmpInUseCmdBufPool)
@@ -151,7 +146,7 @@ MOS_STATUS CmdBufMgrNext::Reset()
         }
     }
     m_cmdBufTotalNum = m_availableCmdBufPool.size();
-    MosUtilities::MosUnlockMutex(m_availablePoolMutex);
+    MosUtilities::MosUnlockMutex(m_poolMutex);
     return MOS_STATUS_SUCCESS;
 }
 
@@ -160,21 +155,18 @@ void CmdBufMgrNext::CleanUp()
     MOS_OS_FUNCTION_ENTER;
 
     CommandBufferNext *cmdBuf = nullptr;
-    MosUtilities::MosLockMutex(m_availablePoolMutex);
+    MosUtilities::MosLockMutex(m_poolMutex);
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    MOS_OS_NORMALMESSAGE("Cmd buf pool: %d hits, %d misses, %d allocated, %d trimmed, %d total",
+        m_pickupHitCount, m_pickupMissCount, m_allocCount, m_trimCount, m_cmdBufTotalNum);
+#endif
 
     for (auto& cmdBuf : m_availableCmdBufPool)
     {
         if (cmdBuf != nullptr)
         {
-            auto gpuContext         = cmdBuf->GetLastNativeGpuContext();
-            auto gpuContextHandle   = cmdBuf->GetLastNativeGpuContextHandle();
-            auto gpuContextMgr      = m_osContext->GetGpuContextMgr();
-            if (gpuContext != nullptr && gpuContextMgr && gpuContext == gpuContextMgr->GetGpuContext(gpuContextHandle))
-            {
-                cmdBuf->UnBindToGpuContext(true);
-            }
-            cmdBuf->Free();
-            MOS_Delete(cmdBuf);
+            DestroyCmdBuf(cmdBuf);
         }
         else
         {
@@ -184,8 +176,6 @@ void CmdBufMgrNext::CleanUp()
 
     // clear available command buffer pool
     m_availableCmdBufPool.clear();
-    MosUtilities::MosUnlockMutex(m_availablePoolMutex);
-    MosUtilities::MosLockMutex(m_inUsePoolMutex);
 
     if (!m_inUseCmdBufPool.empty())
     {
@@ -201,14 +191,46 @@ void CmdBufMgrNext::CleanUp()
 
     // clear in-use command buffer pool
     m_inUseCmdBufPool.clear();
-    MosUtilities::MosUnlockMutex(m_inUsePoolMutex);
+    MosUtilities::MosUnlockMutex(m_poolMutex);
 
     m_cmdBufTotalNum = 0;
     m_initialized    = false;
-    MosUtilities::MosDestroyMutex(m_inUsePoolMutex);
-    m_inUsePoolMutex = nullptr;
-    MosUtilities::MosDestroyMutex(m_availablePoolMutex);
-    m_availablePoolMutex = nullptr;
+    MosUtilities::MosDestroyMutex(m_poolMutex);
+    m_poolMutex = nullptr;
+}
+
+void CmdBufMgrNext::DestroyCmdBuf(CommandBufferNext *cmdBuf)
+{
+    auto gpuContext         = cmdBuf->GetLastNativeGpuContext();
+    auto gpuContextHandle   = cmdBuf->GetLastNativeGpuContextHandle();
+    auto gpuContextMgr      = m_osContext->GetGpuContextMgr();
+    if (gpuContext != nullptr && gpuContextMgr && gpuContext == gpuContextMgr->GetGpuContext(gpuContextHandle))
+    {
+        cmdBuf->UnBindToGpuContext(true);
+    }
+    cmdBuf->Free();
+    MOS_Delete(cmdBuf);
+}
+
+void CmdBufMgrNext::TrimAvailablePool()
+{
+    while (m_availableCmdBufPool.size() > m_maxAvailableBufNum)
+    {
+        auto iter = std::find_if(m_availableCmdBufPool.rbegin(), m_availableCmdBufPool.rend(),
+            [](CommandBufferNext *p) { return p != nullptr && !p->IsUsedByHw() && !p->IsInCmdList(); });
+        if (iter == m_availableCmdBufPool.rend())
+        {
+            // everything is still used by HW, try again on next release
+            break;
+        }
+
+        DestroyCmdBuf(*iter);
+        m_availableCmdBufPool.erase(std::next(iter).base());
+        m_cmdBufTotalNum--;
+#if (_DEBUG || _RELEASE_INTERNAL)
+        m_trimCount++;
+#endif
+    }
 }
 
 CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
@@ -222,8 +244,7 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
     }
 
     // lock for both in-use and available command buffer pool before pick up
-    MosUtilities::MosLockMutex(m_inUsePoolMutex);
-    MosUtilities::MosLockMutex(m_availablePoolMutex);
+    MosUtilities::MosLockMutex(m_poolMutex);
 
     CommandBufferNext* cmdBuf = nullptr;
     CommandBufferNext* retbuf  = nullptr;
@@ -231,21 +252,38 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
 
     if (!m_availableCmdBufPool.empty())
     {
-        cmdBuf = *(m_availableCmdBufPool.begin());
-        if (cmdBuf == nullptr)
+        // pool is sorted by descending size, so the buffers large enough are a prefix of it
+        auto fitEnd = std::partition_point(m_availableCmdBufPool.begin(), m_availableCmdBufPool.end(),
+            [=](CommandBufferNext *p) { return p == nullptr || p->GetCmdBufSize() >= size; });
+
+        // pick the smallest fitting buffer which HW is done with
+        auto fit = m_availableCmdBufPool.end();
+        for (auto iter = fitEnd; iter != m_availableCmdBufPool.begin();)
         {
-            MOS_OS_ASSERTMESSAGE("available command buf pool is null.");
-            MosUtilities::MosUnlockMutex(m_inUsePoolMutex);
-            MosUtilities::MosUnlockMutex(m_availablePoolMutex);
-            return nullptr;
+            --iter;
+            if (*iter == nullptr)
+            {
+                MOS_OS_ASSERTMESSAGE("available command buf pool is null.");
+                MosUtilities::MosUnlockMutex(m_poolMutex);
+                return nullptr;
+            }
+            if (!(*iter)->IsUsedByHw() && !(*iter)->IsInCmdList())
+            {
+                fit = iter;
+                break;
+            }
         }
 
         // find available buf
-        if (size <= cmdBuf->GetCmdBufSize() && !cmdBuf->IsUsedByHw() && !cmdBuf->IsInCmdList())
+        if (fit != m_availableCmdBufPool.end())
         {
+            cmdBuf = *fit;
             m_inUseCmdBufPool.push_back(cmdBuf);
 
-            m_availableCmdBufPool.erase(m_availableCmdBufPool.begin());
+            m_availableCmdBufPool.erase(fit);
+#if (_DEBUG || _RELEASE_INTERNAL)
+            m_pickupHitCount++;
+#endif
 
             MOS_OS_VERBOSEMESSAGE("successfully get available buf from pool");
         }
@@ -253,6 +291,9 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
         else
         {
             MOS_OS_VERBOSEMESSAGE("find available buf, but is not large enough or it is still used by HW");
+#if (_DEBUG || _RELEASE_INTERNAL)
+            m_pickupMissCount++;
+#endif
 
             cmdBuf = CommandBufferNext::CreateCmdBuf(this);
             if (cmdBuf == nullptr)
@@ -270,7 +311,9 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
                 // directly push into inuse pool
                 m_inUseCmdBufPool.push_back(cmdBuf);
                 m_cmdBufTotalNum++;
-
+#if (_DEBUG || _RELEASE_INTERNAL)
+                m_allocCount++;
+#endif
             }
         }
 
@@ -280,6 +323,9 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
     else
     {
         MOS_OS_VERBOSEMESSAGE("No more cmd buf in the pool");
+#if (_DEBUG || _RELEASE_INTERNAL)
+        m_pickupMissCount++;
+#endif
 
         if (m_cmdBufTotalNum < m_maxPoolSize)
         {
@@ -313,6 +359,9 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
                     m_availableCmdBufPool.insert(m_availableCmdBufPool.begin(), cmdBuf);
                 }
                 m_cmdBufTotalNum++;
+#if (_DEBUG || _RELEASE_INTERNAL)
+                m_allocCount++;
+#endif
             }
 
             // sort by decent order
@@ -326,8 +375,7 @@ CommandBufferNext *CmdBufMgrNext::PickupOneCmdBuf(uint32_t size)
     }
 
     // unlock after got return buffer
-    MosUtilities::MosUnlockMutex(m_inUsePoolMutex);
-    MosUtilities::MosUnlockMutex(m_availablePoolMutex);
+    MosUtilities::MosUnlockMutex(m_poolMutex);
 
     return retbuf;
 }
@@ -353,8 +401,7 @@ MOS_STATUS CmdBufMgrNext::ReleaseCmdBuf(CommandBufferNext *cmdBuf)
     MOS_OS_CHK_NULL_RETURN(cmdBuf);
 
     // lock for both in-use and available command buffer pool before release
-    MosUtilities::MosLockMutex(m_inUsePoolMutex);
-    MosUtilities::MosLockMutex(m_availablePoolMutex);
+    MosUtilities::MosLockMutex(m_poolMutex);
 
     bool           found = false;
     for (auto iter = m_inUseCmdBufPool.begin(); iter != m_inUseCmdBufPool.end(); iter++)
@@ -375,11 +422,11 @@ MOS_STATUS CmdBufMgrNext::ReleaseCmdBuf(CommandBufferNext *cmdBuf)
     else
     {
         UpperInsert(cmdBuf);
+        TrimAvailablePool();
     }
 
     // unlock after release buffer
-    MosUtilities::MosUnlockMutex(m_availablePoolMutex);
-    MosUtilities::MosUnlockMutex(m_inUsePoolMutex);
+    MosUtilities::MosUnlockMutex(m_poolMutex);
 
     return eStatus;
 }
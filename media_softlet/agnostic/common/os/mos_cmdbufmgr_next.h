@@ -76,11 +76,12 @@ public:
     //! \brief    Clean up the command buffer manager
     //! \details  This function will pick up one proper command buffer from 
     //!           available pool, internal logic in below 3 conditions:
-    //!           1: if available pool has command buffer and its size bigger than
-    //!              required, directly put it into in use pool and return;
-    //!           2: if available pool has command buffer but size smaller than
-    //!              required, only create one command buffer as reqired and put
-    //!              it to in  use pool directly;
+    //!           1: if available pool has command buffers not used by HW and at
+    //!              least as big as required, put the smallest of them into in
+    //!              use pool and return;
+    //!           2: if available pool has command buffer but none of them fits,
+    //!              only create one command buffer as reqired and put it to in
+    //!              use pool directly;
     //!           3: if available pool is empty, will re-allocate bunch of command
     //!              buffers, buffer number base on m_initBufNum, buffer size
     //!              base on input required size. After re-allocate, put first buf
@@ -183,6 +184,20 @@ public:
     //!
     static bool GreaterSizeSort(CommandBufferNext *a, CommandBufferNext *b);
 
+    //!
+    //! \brief    Free command buffers from available pool beyond m_maxAvailableBufNum
+    //! \details  Smallest buffers not used by HW are freed first. Must be called
+    //!           with m_poolMutex held.
+    //!
+    void TrimAvailablePool();
+
+    //!
+    //! \brief    Unbind and free one command buffer of available pool
+    //! \param    [in] cmdBuf
+    //!           Command buffer to be destroyed
+    //!
+    void DestroyCmdBuf(CommandBufferNext *cmdBuf);
+
     //! \brief   Max comamnd buffer number for per manager, including all
     //!          command buffer in availble pool and in-use pool
     constexpr static uint32_t m_maxPoolSize = 1098304;
@@ -196,17 +211,25 @@ public:
     //! \brief   Initial command buffer number
     constexpr static uint32_t m_initBufNum = 32;
 
-    //! \brief   Sorted List of available command buffer pool
-    std::vector<CommandBufferNext *> m_availableCmdBufPool;
+    //! \brief   Max command buffer number kept in available pool, idle buffers
+    //!          beyond it are freed on release
+    constexpr static uint32_t m_maxAvailableBufNum = 2 * m_initBufNum;
 
-    //! \brief   Mutex for available command buffer pool
-    PMOS_MUTEX m_availablePoolMutex = nullptr;
+    //! \brief   List of available command buffer pool, sorted by descending size
+    std::vector<CommandBufferNext *> m_availableCmdBufPool;
 
     //! \brief   List of in used command buffer pool
     std::vector<CommandBufferNext *> m_inUseCmdBufPool;
 
-    //! \brief   Mutex for in-use command buffer pool
-    PMOS_MUTEX m_inUsePoolMutex = nullptr;
+    //! \brief   Mutex for both available and in-use command buffer pool
+    PMOS_MUTEX m_poolMutex = nullptr;
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    uint32_t m_pickupHitCount  = 0;    //!< Pick ups served from available pool
+    uint32_t m_pickupMissCount = 0;    //!< Pick ups with no fitting idle buffer in available pool
+    uint32_t m_allocCount      = 0;    //!< Command buffers allocated after initialization
+    uint32_t m_trimCount       = 0;    //!< Idle command buffers freed by trimming
+#endif
 
     //! \brief   Flag to indicate cmd buf mgr initialized or not
     bool m_initialized = false;
@@ -26,6 +26,7 @@
 //!
 #ifndef __MOS_UTILITIES_H__
 #define __MOS_UTILITIES_H__
+#include <atomic>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -34,6 +35,7 @@
 #include <fstream>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include "mos_utilities_common.h"
 #include "media_class_trace.h"
 #include "mos_utilities_specific.h"
@@ -1188,6 +1190,33 @@ public:
         const void          *pSource,
         size_t              srcLength);
 
+    //!
+    //! \brief    Memory copy from write-combined memory with security checks.
+    //! \details  Same as MosSecureMemcpy, but reads pSource with streaming loads
+    //!           when the CPU supports them. Plain loads from write-combined
+    //!           memory (e.g. mapped BO) are uncached and much slower.
+    //! \param    [out] pDestination
+    //!           Pointer to destination buffer
+    //! \param    [in] dstLength
+    //!           Size of the destination buffer
+    //! \param    [in] pSource
+    //!           Pointer to the source buffer
+    //! \param    [in] srcLength
+    //!           Number of bytes to copy from source to destination
+    //! \param    [in] fence
+    //!           Order the loads after earlier writes to write-combined memory.
+    //!           Callers copying a plane row by row only need it for the first row.
+    //! \return   MOS_STATUS
+    //!           Returns one of the MOS_STATUS error codes if failed,
+    //!           else MOS_STATUS_SUCCESS
+    //!
+    static MOS_STATUS MosSecureMemcpyFromWC(
+        void                *pDestination,
+        size_t              dstLength,
+        const void          *pSource,
+        size_t              srcLength,
+        bool                fence = true);
+
     //!
     //! \brief    Open a file with security checks.
     //! \details  Open a file with security checks.
@@ -3246,6 +3275,9 @@ do{                                                     \
 #define MOS_SecureMemcpy(pDestination, dstLength, pSource, srcLength)                               \
     MosUtilities::MosSecureMemcpy(pDestination, dstLength, pSource, srcLength)
 
+#define MOS_SecureMemcpyFromWC(pDestination, dstLength, pSource, srcLength)                         \
+    MosUtilities::MosSecureMemcpyFromWC(pDestination, dstLength, pSource, srcLength)
+
 #define MOS_SecureStringPrint(buffer, bufSize, length, format, ...)                                 \
     MosUtilities::MosSecureStringPrint(buffer, bufSize, length, format, ##__VA_ARGS__)
 
@@ -3384,10 +3416,9 @@ class PerfUtility
 public:
     struct Tick
     {
-        double freq;
-        int64_t start;
-        int64_t stop;
-        double time;
+        uint32_t siteId;
+        int64_t  start;  // monotonic ns
+        int64_t  stop;   // monotonic ns, 0 while the probe is still open
     };
     struct PerfInfo
     {
@@ -3396,35 +3427,112 @@ public:
         double max;
         double min;
     };
+    //!
+    //! \brief   Interned tag
+    //! \details openSlot holds the newest start of the site on any thread,
+    //!          (thread index + 1) << 48 | tick sequence, so stopTick can
+    //!          close a tick started on another thread without scanning.
+    //!
+    struct Site
+    {
+        uint32_t              id = 0;
+        std::string           tag;
+        std::atomic<uint64_t> openSlot{0};
+    };
+    //!
+    //! \brief   Per-thread tick ring
+    //! \details Only the owning thread appends to ticks, so the mutex is
+    //!          uncontended except while savePerfData snapshots the ring or
+    //!          another thread stops a probe started by the owner. Once
+    //!          PERF_TICK_RING_SIZE ticks are held the oldest are overwritten.
+    //!
+    struct ThreadRecords
+    {
+        std::mutex                                mutex;
+        uint32_t                                  tid   = 0;
+        uint32_t                                  index = 0;          // position in threadRecords
+        uint64_t                                  next  = 0;          // sequence of the next tick
+        std::vector<Tick>                         ticks;              // ring, tick seq at seq % PERF_TICK_RING_SIZE
+        std::unordered_map<std::string, Site *>   siteCache;          // owner thread only
+        std::vector<std::vector<uint64_t>>        openTicks;          // owner thread only, open tick seqs by site id
+    };
+    //!
+    //! \brief   Copy of one thread's ticks taken by savePerfData
+    //!
+    struct ThreadSnapshot
+    {
+        uint32_t          tid = 0;
+        std::vector<Tick> ticks;
+    };
+
+    static const uint64_t PERF_TICK_RING_SIZE = 1 << 16;
 
 public:
     static PerfUtility *getInstance();
     virtual ~PerfUtility();
     PerfUtility();
-    virtual void startTick(std::string tag);
-    virtual void stopTick(std::string tag);
+    virtual void startTick(const std::string &tag);
+    virtual void stopTick(const std::string &tag);
     virtual void savePerfData();
     virtual void setupFilePath(const char *perfFilePath);
     virtual void setupFilePath();
     bool bPerfUtilityKey    = false;
     char sSummaryFileName[MOS_MAX_PERF_FILENAME_LEN + 1] = {'\0'};
     char sDetailsFileName[MOS_MAX_PERF_FILENAME_LEN + 1] = {'\0'};
+    char sTraceFileName[MOS_MAX_PERF_FILENAME_LEN + 1]   = {'\0'};
     int32_t dwPerfUtilityIsEnabled = false;
 
 private:
     void printPerfSummary();
     void printPerfDetails();
+    void printPerfTrace();
     void printHeader(std::ofstream& fout);
     void printBody(std::ofstream& fout);
     void printFooter(std::ofstream& fout);
-    std::string formatPerfData(std::string tag, std::vector<Tick>& record);
-    void getPerfInfo(std::vector<Tick>& record, PerfInfo* info);
+    std::string formatPerfData(std::string tag, std::vector<double>& record);
+    void getPerfInfo(std::vector<double>& record, PerfInfo* info);
     std::string getDashString(uint32_t num);
 
+    //!
+    //! \brief   Get the calling thread's tick buffer, registering it on first use
+    //!
+    ThreadRecords *getThreadRecords();
+
+    //!
+    //! \brief   Map a tag to its site, interning it on first use
+    //! \details The per-thread cache is checked first so the global site
+    //!          table is only locked the first time a thread sees a tag.
+    //!
+    Site *getSite(ThreadRecords *records, const std::string &tag);
+
+    //!
+    //! \brief   Close the tick with sequence seq in one tick ring
+    //! \return  true if the tick is still in the ring, open and of the site
+    //!
+    bool closeTick(ThreadRecords *records, uint64_t seq, uint32_t siteId, int64_t stop);
+
+    //!
+    //! \brief   Copy the site tags and all tick rings, oldest tick first
+    //!
+    void snapshot(std::vector<std::string> &tags, std::vector<ThreadSnapshot> &threads);
+
+    //!
+    //! \brief   Collect the closed tick durations (ms) of all threads by site
+    //!
+    void collectRecords(std::vector<std::vector<double>> &durations);
+
+    //!
+    //! \brief   Read the monotonic clock in nanoseconds
+    //!
+    static int64_t getTimeNs();
+
 private:
     static std::shared_ptr<PerfUtility> instance;
-    static std::mutex perfMutex;
-    std::map<std::string, std::vector<Tick>*> records {};
+    static std::mutex perfMutex;                                  // guards sites and threadRecords
+    std::vector<std::unique_ptr<Site>> sites {};                  // site id -> site
+    std::unordered_map<std::string, uint32_t> siteIds {};         // tag -> site id
+    std::vector<std::shared_ptr<ThreadRecords>> threadRecords {};
+    uint32_t instanceId = 0;                                      // tells thread_local rings of other instances apart
 MEDIA_CLASS_DEFINE_END(PerfUtility)
 };
 
@@ -730,6 +730,71 @@ int32_t MosUtilities::MosSwizzleOffsetWrapper(
     return Mos_SwizzleOffset(OffsetX, OffsetY, Pitch, TileFormat, CsxSwizzle, Flags);
 }
 
+#ifndef _MOS_UTILITY_EXT
+//!
+//! \brief    Swizzle data between linear and tiled layout line by line
+//! \details  Inside one tile line, MosSwizzleOffset maps (1 << LPos) consecutive
+//!           linear bytes to consecutive tiled bytes: one OWORD for TileY and
+//!           512 bytes for TileX. Moving each such span with one copy gives the
+//!           same result as the per byte translation, including the clipping
+//!           of offsets beyond the surface, at a fraction of the cost.
+//! \param    [in] pSrc
+//!           Pointer to source data.
+//! \param    [out] pDst
+//!           Pointer to destiny data.
+//! \param    [in] TileFormat
+//!           Tile type of the tiled side
+//! \param    [in] bTiledToLinear
+//!           true if pSrc is tiled and pDst is linear, false for the reverse
+//! \param    [in] iHeight
+//!           Height
+//! \param    [in] iPitch
+//!           Pitch
+//! \return   void
+//!
+static void MosSwizzleDataBySpan(
+    uint8_t         *pSrc,
+    uint8_t         *pDst,
+    MOS_TILE_TYPE   TileFormat,
+    bool            bTiledToLinear,
+    int32_t         iHeight,
+    int32_t         iPitch)
+{
+    // Same Line/Col decomposition as MosSwizzleOffset without CSX swizzling
+    int32_t LBits     = (TileFormat == MOS_TILE_Y) ? 5 : 3;
+    int32_t LPos      = (TileFormat == MOS_TILE_Y) ? 4 : 9;
+    int32_t SpanSize  = 1 << LPos;
+    int32_t Cols      = iPitch >> LPos;
+    int64_t TotalSize = (int64_t)iHeight * iPitch;
+
+    for (int32_t y = 0; y < iHeight; y++)
+    {
+        int32_t  Row    = y >> LBits;
+        int32_t  Line   = y & ((1 << LBits) - 1);
+        uint8_t *pLinear = (bTiledToLinear ? pDst : pSrc) + (int64_t)y * iPitch;
+
+        for (int32_t x = 0; x < iPitch; x += SpanSize)
+        {
+            int64_t TileOffset = (((((int64_t)Row * Cols) + (x >> LPos)) << LBits) + Line) << LPos;
+            if (TileOffset >= TotalSize)
+            {
+                continue;
+            }
+
+            int64_t Size = MOS_MIN3((int64_t)SpanSize, (int64_t)(iPitch - x), TotalSize - TileOffset);
+            if (bTiledToLinear)
+            {
+                memcpy(pLinear + x, pSrc + TileOffset, (size_t)Size);
+            }
+            else
+            {
+                memcpy(pDst + TileOffset, pLinear + x, (size_t)Size);
+            }
+        }
+    }
+}
+#endif
+
 void MosUtilities::MosSwizzleData(
     uint8_t         *pSrc,
     uint8_t         *pDst,
@@ -744,6 +809,22 @@ void MosUtilities::MosSwizzleData(
 #define IS_TILED_TO_LINEAR(_a, _b)  (IS_TILED(_a) && !IS_TILED(_b))
 #define IS_LINEAR_TO_TILED(_a, _b)  (!IS_TILED(_a) && IS_TILED(_b))
 
+#ifndef _MOS_UTILITY_EXT
+    if (pSrc != nullptr && pDst != nullptr && iHeight > 0 && iPitch > 0)
+    {
+        if (IS_TILED_TO_LINEAR(SrcTiling, DstTiling))
+        {
+            MosSwizzleDataBySpan(pSrc, pDst, SrcTiling, true, iHeight, iPitch);
+            return;
+        }
+        else if (IS_LINEAR_TO_TILED(SrcTiling, DstTiling))
+        {
+            MosSwizzleDataBySpan(pSrc, pDst, DstTiling, false, iHeight, iPitch);
+            return;
+        }
+    }
+#endif
+
     int32_t LinearOffset;
     int32_t TileOffset;
     int32_t x;
@@ -804,20 +885,209 @@ PerfUtility *PerfUtility::getInstance()
 
 PerfUtility::PerfUtility()
 {
+    static std::atomic<uint32_t> instanceCount(0);
+    instanceId      = ++instanceCount;
     bPerfUtilityKey = false;
     dwPerfUtilityIsEnabled = 0;
 }
 
 PerfUtility::~PerfUtility()
 {
-    for (const auto &data : records)
+    std::lock_guard<std::mutex> lock(perfMutex);
+    threadRecords.clear();
+    siteIds.clear();
+    sites.clear();
+}
+
+PerfUtility::ThreadRecords *PerfUtility::getThreadRecords()
+{
+    static thread_local uint32_t                       localOwner   = 0;
+    static thread_local std::shared_ptr<ThreadRecords> localRecords = nullptr;
+    if (localOwner != instanceId || localRecords == nullptr)
+    {
+        localRecords      = std::make_shared<ThreadRecords>();
+        localRecords->tid = MosUtilities::MosGetCurrentThreadId();
+        localOwner        = instanceId;
+
+        // the owner keeps its buffer alive past thread exit through this list
+        std::lock_guard<std::mutex> lock(perfMutex);
+        localRecords->index = (uint32_t)threadRecords.size();
+        threadRecords.push_back(localRecords);
+    }
+    return localRecords.get();
+}
+
+PerfUtility::Site *PerfUtility::getSite(ThreadRecords *records, const std::string &tag)
+{
+    auto cached = records->siteCache.find(tag);
+    if (cached != records->siteCache.end())
     {
-        if (data.second)
+        return cached->second;
+    }
+
+    Site *site = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(perfMutex);
+        auto it = siteIds.find(tag);
+        if (it == siteIds.end())
+        {
+            std::unique_ptr<Site> newSite(new Site);
+            newSite->id  = (uint32_t)sites.size();
+            newSite->tag = tag;
+            siteIds.emplace(tag, newSite->id);
+            sites.push_back(std::move(newSite));
+            site = sites.back().get();
+        }
+        else
+        {
+            site = sites[it->second].get();
+        }
+    }
+    records->siteCache.emplace(tag, site);
+    if (records->openTicks.size() <= site->id)
+    {
+        records->openTicks.resize(site->id + 1);
+    }
+    return site;
+}
+
+void PerfUtility::startTick(const std::string &tag)
+{
+    ThreadRecords *records = getThreadRecords();
+    Site          *site    = getSite(records, tag);
+    uint64_t       seq     = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(records->mutex);
+        seq = records->next++;
+        if (records->ticks.size() < PERF_TICK_RING_SIZE)
+        {
+            records->ticks.push_back({site->id, getTimeNs(), 0});
+        }
+        else
+        {
+            records->ticks[seq % PERF_TICK_RING_SIZE] = {site->id, getTimeNs(), 0};
+        }
+    }
+
+    // probes nest per thread; the ring bounds how many can still be open
+    std::vector<uint64_t> &open = records->openTicks[site->id];
+    if (!open.empty() && seq - open.front() >= PERF_TICK_RING_SIZE)
+    {
+        open.erase(open.begin());
+    }
+    open.push_back(seq);
+    site->openSlot.store(((uint64_t)(records->index + 1) << 48) | (seq & ((1ull << 48) - 1)), std::memory_order_release);
+}
+
+void PerfUtility::stopTick(const std::string &tag)
+{
+    ThreadRecords *records = getThreadRecords();
+    Site          *site    = getSite(records, tag);
+    int64_t        stop    = getTimeNs();
+
+    // close the innermost open tick of this site on this thread, skipping
+    // ticks already stopped from another thread or dropped from the ring
+    std::vector<uint64_t> &open = records->openTicks[site->id];
+    while (!open.empty())
+    {
+        uint64_t seq = open.back();
+        open.pop_back();
+        if (closeTick(records, seq, site->id, stop))
+        {
+            return;
+        }
+    }
+
+    // probe started on another thread: close the newest start of the site
+    uint64_t slot  = site->openSlot.load(std::memory_order_acquire);
+    uint32_t index = (uint32_t)(slot >> 48);
+    if (index == 0 || index - 1 == records->index)
+    {
+        return;  // stop without a matching start, should not happen
+    }
+
+    std::shared_ptr<ThreadRecords> owner;
+    {
+        std::lock_guard<std::mutex> lock(perfMutex);
+        if (index - 1 < threadRecords.size())
         {
-            delete data.second;
+            owner = threadRecords[index - 1];
+        }
+    }
+    if (owner)
+    {
+        closeTick(owner.get(), slot & ((1ull << 48) - 1), site->id, stop);
+    }
+}
+
+bool PerfUtility::closeTick(ThreadRecords *records, uint64_t seq, uint32_t siteId, int64_t stop)
+{
+    std::lock_guard<std::mutex> lock(records->mutex);
+    if (seq >= records->next || records->next - seq > PERF_TICK_RING_SIZE)
+    {
+        return false;
+    }
+    Tick &tick = records->ticks[seq % PERF_TICK_RING_SIZE];
+    if (tick.siteId != siteId || tick.stop != 0)
+    {
+        return false;
+    }
+    tick.stop = stop;
+    return true;
+}
+
+void PerfUtility::snapshot(std::vector<std::string> &tags, std::vector<ThreadSnapshot> &threads)
+{
+    std::vector<std::shared_ptr<ThreadRecords>> records;
+    {
+        std::lock_guard<std::mutex> lock(perfMutex);
+        tags.clear();
+        for (const auto &site : sites)
+        {
+            tags.push_back(site->tag);
+        }
+        records = threadRecords;
+    }
+
+    threads.assign(records.size(), ThreadSnapshot());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        std::lock_guard<std::mutex> lock(records[i]->mutex);
+        const std::vector<Tick> &ticks = records[i]->ticks;
+        size_t                   first = (size_t)(records[i]->next % PERF_TICK_RING_SIZE);
+
+        threads[i].tid = records[i]->tid;
+        if (ticks.size() < PERF_TICK_RING_SIZE)
+        {
+            threads[i].ticks = ticks;
+        }
+        else
+        {
+            threads[i].ticks.reserve(ticks.size());
+            threads[i].ticks.insert(threads[i].ticks.end(), ticks.begin() + first, ticks.end());
+            threads[i].ticks.insert(threads[i].ticks.end(), ticks.begin(), ticks.begin() + first);
+        }
+    }
+}
+
+void PerfUtility::collectRecords(std::vector<std::vector<double>> &durations)
+{
+    std::vector<std::string>    tags;
+    std::vector<ThreadSnapshot> threads;
+    snapshot(tags, threads);
+
+    durations.assign(tags.size(), std::vector<double>());
+    for (const auto &thread : threads)
+    {
+        for (const auto &t : thread.ticks)
+        {
+            if (t.stop != 0 && t.siteId < durations.size())
+            {
+                durations[t.siteId].push_back(double(t.stop - t.start) / 1000000.0);  // ms
+            }
         }
     }
-    records.clear();
 }
 
 void PerfUtility::setupFilePath(const char *perfFilePath)
@@ -827,6 +1097,8 @@ void PerfUtility::setupFilePath(const char *perfFilePath)
         "%sperf_summary_pid%d.csv", perfFilePath, pid);
     MOS_SecureStringPrint(sDetailsFileName, MOS_MAX_PATH_LENGTH + 1, MOS_MAX_PATH_LENGTH + 1,
         "%sperf_details_pid%d.txt", perfFilePath, pid);
+    MOS_SecureStringPrint(sTraceFileName, MOS_MAX_PATH_LENGTH + 1, MOS_MAX_PATH_LENGTH + 1,
+        "%sperf_trace_pid%d.json", perfFilePath, pid);
 }
 
 void PerfUtility::setupFilePath()
@@ -836,6 +1108,8 @@ void PerfUtility::setupFilePath()
         "perf_summary_pid%d.csv", pid);
     MOS_SecureStringPrint(sDetailsFileName, MOS_MAX_PATH_LENGTH + 1, MOS_MAX_PATH_LENGTH + 1,
         "perf_details_pid%d.txt", pid);
+    MOS_SecureStringPrint(sTraceFileName, MOS_MAX_PATH_LENGTH + 1, MOS_MAX_PATH_LENGTH + 1,
+        "perf_trace_pid%d.json", pid);
 }
 
 void PerfUtility::savePerfData()
@@ -843,6 +1117,8 @@ void PerfUtility::savePerfData()
     printPerfSummary();
 
     printPerfDetails();
+
+    printPerfTrace();
 }
 
 void PerfUtility::printPerfSummary()
@@ -869,14 +1145,27 @@ void PerfUtility::printPerfDetails()
         fout.close();
         return;
     }
-    for (auto data : records)
+
+    std::vector<std::vector<double>> durations;
+    collectRecords(durations);
+    std::map<std::string, uint32_t> sortedSites;
     {
-        fout << getDashString((uint32_t)data.first.length());
-        fout << data.first << std::endl;
-        fout << getDashString((uint32_t)data.first.length());
-        for (auto t : *data.second)
+        std::lock_guard<std::mutex> lock(perfMutex);
+        sortedSites.insert(siteIds.begin(), siteIds.end());
+    }
+
+    for (const auto &site : sortedSites)
+    {
+        if (site.second >= durations.size() || durations[site.second].empty())
         {
-            fout << t.time << std::endl;
+            continue;
+        }
+        fout << getDashString((uint32_t)site.first.length());
+        fout << site.first << std::endl;
+        fout << getDashString((uint32_t)site.first.length());
+        for (auto time : durations[site.second])
+        {
+            fout << time << std::endl;
         }
         fout << std::endl;
     }
@@ -885,6 +1174,74 @@ void PerfUtility::printPerfDetails()
     return;
 }
 
+void PerfUtility::printPerfTrace()
+{
+    std::vector<std::string>    tags;
+    std::vector<ThreadSnapshot> threads;
+    snapshot(tags, threads);
+
+    // JSON string escaping of the tags
+    for (auto &tag : tags)
+    {
+        std::string escaped;
+        for (char c : tag)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                char code[8];
+                MOS_SecureStringPrint(code, sizeof(code), sizeof(code), "\\u%04x", (unsigned char)c);
+                escaped += code;
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        tag = escaped;
+    }
+
+    std::ofstream fout;
+    fout.open(sTraceFileName);
+    if(fout.good() == false)
+    {
+        fout.close();
+        return;
+    }
+
+    // Chrome trace_event format, one complete ("X") event per closed tick
+    int32_t pid   = MosUtilities::MosGetPid();
+    bool    first = true;
+    fout << "{\"traceEvents\":[" << std::endl;
+    fout.precision(3);
+    fout.setf(std::ios::fixed, std::ios::floatfield);
+
+    for (const auto &thread : threads)
+    {
+        for (const auto &t : thread.ticks)
+        {
+            if (t.stop == 0 || t.siteId >= tags.size())
+            {
+                continue;
+            }
+            fout << (first ? "" : ",\n");
+            fout << "{\"name\":\"" << tags[t.siteId] << "\",\"ph\":\"X\""
+                 << ",\"pid\":" << pid << ",\"tid\":" << thread.tid
+                 << ",\"ts\":" << double(t.start) / 1000.0
+                 << ",\"dur\":" << double(t.stop - t.start) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    fout << std::endl << "]}" << std::endl;
+
+    fout.close();
+    return;
+}
+
 void PerfUtility::printHeader(std::ofstream& fout)
 {
     fout << "Summary: " << std::endl;
@@ -899,13 +1256,24 @@ void PerfUtility::printHeader(std::ofstream& fout)
 
 void PerfUtility::printBody(std::ofstream& fout)
 {
-    for (const auto& data : records)
+    std::vector<std::vector<double>> durations;
+    collectRecords(durations);
+    std::map<std::string, uint32_t> sortedSites;
     {
-        fout << formatPerfData(data.first, *data.second);
+        std::lock_guard<std::mutex> lock(perfMutex);
+        sortedSites.insert(siteIds.begin(), siteIds.end());
+    }
+
+    for (const auto &site : sortedSites)
+    {
+        if (site.second < durations.size() && !durations[site.second].empty())
+        {
+            fout << formatPerfData(site.first, durations[site.second]);
+        }
     }
 }
 
-std::string PerfUtility::formatPerfData(std::string tag, std::vector<Tick>& record)
+std::string PerfUtility::formatPerfData(std::string tag, std::vector<double>& record)
 {
     std::stringstream ss;
     PerfInfo info = {};
@@ -927,18 +1295,18 @@ std::string PerfUtility::formatPerfData(std::string tag, std::vector<Tick>& reco
     return ss.str();
 }
 
-void PerfUtility::getPerfInfo(std::vector<Tick>& record, PerfInfo* info)
+void PerfUtility::getPerfInfo(std::vector<double>& record, PerfInfo* info)
 {
     if (record.size() <= 0)
         return;
 
     info->count = (uint32_t)record.size();
     double sum = 0, max = 0, min = 10000000.0;
-    for (auto t : record)
+    for (auto time : record)
     {
-        sum += t.time;
-        max = (max < t.time) ? t.time : max;
-        min = (min > t.time) ? t.time : min;
+        sum += time;
+        max = (max < time) ? time : max;
+        min = (min > time) ? time : min;
     }
     info->avg = sum / info->count;
     info->max = max;
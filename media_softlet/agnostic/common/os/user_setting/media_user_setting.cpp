@@ -87,6 +87,11 @@ MOS_STATUS MediaUserSetting::Write(
     return m_configure.Write(valueName, value, group, isForReport, option);
 }
 
+MOS_STATUS MediaUserSetting::Refresh()
+{
+    return m_configure.RefreshSnapshot();
+}
+
 bool MediaUserSetting::IsDeclaredUserSetting(const std::string &valueName)
 {
     return m_configure.IsDefinitionExist(valueName);
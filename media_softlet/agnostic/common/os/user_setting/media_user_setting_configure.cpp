@@ -118,45 +118,32 @@ MOS_STATUS Configure::Register(
                 m_rootKey,
                 statePath)));
 
+    m_pendingItems.emplace_back(group, MakeHash(valueName));
+    m_snapshotStale.store(true, std::memory_order_release);
     m_mutexLock.Unlock();
 
     return MOS_STATUS_SUCCESS;
 }
 
-MOS_STATUS Configure::Read(Value &value,
+MOS_STATUS Configure::ReadItem(
+    std::shared_ptr<Definition> def,
     const std::string &valueName,
-    const Group &group,
-    const Value &customValue,
-    bool useCustomValue,
-    uint32_t option)
+    uint32_t option,
+    Value &value,
+    UFKEY_NEXT &key)
 {
-    int32_t     ret     = 0;
-    MOS_STATUS  status  = MOS_STATUS_SUCCESS;
-    auto        &defs   = GetDefinitions(group);
-    auto        def     = defs[MakeHash(valueName)];
-    if (def == nullptr)
-    {
-        return MOS_STATUS_INVALID_HANDLE;
-    }
+    MOS_STATUS  status      = MOS_STATUS_SUCCESS;
     auto        defaultType = def->DefaultValue().ValueType();
 
-    if (def->IsDebugOnly() && !m_isDebugMode)
-    {
-        value = useCustomValue ? customValue : def->DefaultValue();
-        return MOS_STATUS_SUCCESS;
-    }
     //First, Read user setting. If succeed, return;
     {
         std::string path = GetReadPath(def, option);
-        UFKEY_NEXT  key  = {};
 
         status = MosUtilities::MosOpenRegKey(m_rootKey, path, KEY_READ, &key, m_regBufferMap);
 
         if (status == MOS_STATUS_SUCCESS)
         {
-            m_mutexLock.Lock();
             status = MosUtilities::MosGetRegValue(key, valueName, defaultType, value, m_regBufferMap);
-            m_mutexLock.Unlock();
             MosUtilities::MosCloseRegKey(key);
         }
     }
@@ -168,6 +155,186 @@ MOS_STATUS Configure::Read(Value &value,
         status = MosUtilities::MosReadEnvVariable(def->ItemEnvName(), defaultType, value);
     }
 
+    return status;
+}
+
+const Configure::Snapshot *Configure::GetSnapshot()
+{
+    if (m_snapshotStale.load(std::memory_order_acquire))
+    {
+        UpdateSnapshot(false);
+    }
+    return m_snapshot.load(std::memory_order_acquire);
+}
+
+const Configure::SnapshotItem *Configure::FindSnapshotItem(const Snapshot *snapshot, const Group &group, size_t hash)
+{
+    if (group < Group::Device || group >= Group::MaxCount)
+    {
+        return nullptr;
+    }
+    for (; snapshot != nullptr; snapshot = snapshot->parent)
+    {
+        auto item = snapshot->items[group].find(hash);
+        if (item != snapshot->items[group].end())
+        {
+            return &item->second;
+        }
+    }
+    return nullptr;
+}
+
+void Configure::UpdateSnapshot(bool full)
+{
+    m_mutexLock.Lock();
+
+    // clear before resolving so a concurrent Register marks it stale again
+    m_snapshotStale.store(false, std::memory_order_release);
+
+    std::vector<std::pair<Group, size_t>> items;
+    if (full || m_snapshot.load(std::memory_order_relaxed) == nullptr)
+    {
+        for (uint32_t i = Group::Device; i < Group::MaxCount; i++)
+        {
+            for (auto &it : m_definitions[i])
+            {
+                items.emplace_back(static_cast<Group>(i), it.first);
+            }
+        }
+    }
+    else
+    {
+        items.swap(m_pendingItems);
+    }
+    m_pendingItems.clear();
+
+    std::unique_ptr<Snapshot> layer(new Snapshot);
+    for (auto &it : items)
+    {
+        auto def = m_definitions[it.first].find(it.second);
+        // skip debug only items out of debug mode, Read returns their default directly
+        if (def == m_definitions[it.first].end() || def->second == nullptr ||
+            (def->second->IsDebugOnly() && !m_isDebugMode))
+        {
+            continue;
+        }
+
+        SnapshotItem item = {def->second, "", MOS_STATUS_SUCCESS, Value()};
+        item.status       = ReadItem(def->second, def->second->ItemName(), MEDIA_USER_SETTING_INTERNAL, item.value, item.key);
+        layer->items[it.first].emplace(it.second, std::move(item));
+        layer->size++;
+    }
+
+    if (full)
+    {
+        // a full rebuild replaces the whole chain
+        layer->parent = nullptr;
+        m_snapshots.push_back(std::move(layer));
+        m_snapshot.store(m_snapshots.back().get(), std::memory_order_release);
+    }
+    else if (layer->size > 0 || m_snapshot.load(std::memory_order_relaxed) == nullptr)
+    {
+        PublishSnapshot(layer.release());
+    }
+
+    m_mutexLock.Unlock();
+}
+
+void Configure::PublishSnapshot(Snapshot *layer)
+{
+    const Snapshot *parent = m_snapshot.load(std::memory_order_relaxed);
+
+    // absorb small parents, copying only the items the layer doesn't shadow
+    while (parent != nullptr && parent->size <= 2 * layer->size)
+    {
+        for (uint32_t i = Group::Device; i < Group::MaxCount; i++)
+        {
+            for (auto &item : parent->items[i])
+            {
+                if (layer->items[i].insert(item).second)
+                {
+                    layer->size++;
+                }
+            }
+        }
+        parent = parent->parent;
+    }
+    layer->parent = parent;
+
+    m_snapshots.emplace_back(layer);
+    m_snapshot.store(layer, std::memory_order_release);
+}
+
+void Configure::RefreshSnapshotItem(const Group &group, size_t hash, const UFKEY_NEXT &key)
+{
+    auto item = FindSnapshotItem(m_snapshot.load(std::memory_order_relaxed), group, hash);
+    if (item == nullptr || item->key != key)
+    {
+        return;
+    }
+
+    SnapshotItem refreshed = {item->def, "", MOS_STATUS_SUCCESS, Value()};
+    refreshed.status       = ReadItem(item->def, item->def->ItemName(), MEDIA_USER_SETTING_INTERNAL, refreshed.value, refreshed.key);
+
+    Snapshot *layer = new Snapshot;
+    layer->items[group].emplace(hash, std::move(refreshed));
+    layer->size = 1;
+    PublishSnapshot(layer);
+}
+
+MOS_STATUS Configure::RefreshSnapshot()
+{
+    UpdateSnapshot(true);
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS Configure::Read(Value &value,
+    const std::string &valueName,
+    const Group &group,
+    const Value &customValue,
+    bool useCustomValue,
+    uint32_t option)
+{
+    MOS_STATUS  status  = MOS_STATUS_SUCCESS;
+
+    // Internal reads of declared items are served from the snapshot without locking
+    if (option == MEDIA_USER_SETTING_INTERNAL)
+    {
+        auto item = FindSnapshotItem(GetSnapshot(), group, MakeHash(valueName));
+        if (item != nullptr)
+        {
+            if (item->status == MOS_STATUS_SUCCESS)
+            {
+                value = item->value;
+            }
+            else
+            {
+                value = useCustomValue ? customValue : item->def->DefaultValue();
+            }
+            return item->status;
+        }
+    }
+
+    auto        &defs   = GetDefinitions(group);
+    auto        def     = defs[MakeHash(valueName)];
+    if (def == nullptr)
+    {
+        return MOS_STATUS_INVALID_HANDLE;
+    }
+
+    if (def->IsDebugOnly() && !m_isDebugMode)
+    {
+        value = useCustomValue ? customValue : def->DefaultValue();
+        return MOS_STATUS_SUCCESS;
+    }
+
+    {
+        UFKEY_NEXT key = {};
+        m_mutexLock.Lock();
+        status = ReadItem(def, valueName, option, value, key);
+        m_mutexLock.Unlock();
+    }
+
     if (status != MOS_STATUS_SUCCESS)
     {
         // customValue is only for internal user setting Read
@@ -227,6 +394,10 @@ MOS_STATUS Configure::Write(
 
         MosUtilities::MosCloseRegKey(key);
     }
+    if (status == MOS_STATUS_SUCCESS)
+    {
+        RefreshSnapshotItem(group, MakeHash(valueName), key);
+    }
     m_mutexLock.Unlock();
 
     if (status != MOS_STATUS_SUCCESS)
@@ -2149,6 +2149,24 @@ MOS_STATUS RenderHal_RefreshSync(PRENDERHAL_INTERFACE pRenderHal)
     return eStatus;
 }
 
+//!
+//! \brief    Get Kernel Lookup Index
+//! \details  Hash kernel unique ID and cache ID into the kernel lookup table
+//! \param    int32_t iKernelUniqueID
+//!           [in] Kernel unique ID
+//! \param    int32_t iKernelCacheID
+//!           [in] Kernel cache ID
+//! \return   int32_t
+//!           Index into RENDERHAL_STATE_HEAP::iKernelLookup
+//!
+static inline int32_t RenderHal_GetKernelLookupIndex(
+    int32_t iKernelUniqueID,
+    int32_t iKernelCacheID)
+{
+    uint32_t dwHash = (uint32_t)iKernelUniqueID * 0x9E3779B1u ^ (uint32_t)iKernelCacheID * 0x85EBCA77u;
+    return (int32_t)(dwHash >> (32 - RENDERHAL_KERNEL_LOOKUP_BITS));
+}
+
 //!
 //! \brief    Load Kernel
 //! \details  Load a kernel from cache into GSH; searches for unused space in 
@@ -2183,6 +2201,7 @@ int32_t RenderHal_LoadKernel(
     void    *pKernelPtr;
     int32_t iKernelSize;
     int32_t iSearchIndex;
+    int32_t iLookupIndex;           // Kernel lookup table index
     int32_t iMaxKernels;            // Max number of kernels allowed in GSH
     uint32_t dwOffset;
     int32_t iSize;
@@ -2230,9 +2249,33 @@ int32_t RenderHal_LoadKernel(
         iKernelUniqueID = pKernel->iKUID;
         iKernelCacheID  = pKernel->iKCID;
 
-        // Check if kernel is already loaded; Search free allocation index
-        iSearchIndex      = -1;
-        iMaxKernels       = pRenderHal->StateHeapSettings.iKernelCount;
+        // Check if kernel is already loaded through the lookup table hint
+        iSearchIndex        = -1;
+        iMaxKernels         = pRenderHal->StateHeapSettings.iKernelCount;
+        iLookupIndex        = RenderHal_GetKernelLookupIndex(iKernelUniqueID, iKernelCacheID);
+        iKernelAllocationID = pStateHeap->iKernelLookup[iLookupIndex] - 1;
+        if (iKernelAllocationID >= 0 && iKernelAllocationID < iMaxKernels)
+        {
+            pKernelAllocation = &(pStateHeap->pKernelAllocation[iKernelAllocationID]);
+            if (pKernelAllocation->iKUID == iKernelUniqueID &&
+                pKernelAllocation->iKCID == iKernelCacheID)
+            {
+                // Update kernel usage
+                pRenderHal->pfnTouchKernel(pRenderHal, iKernelAllocationID);
+
+                // Increment reference counter
+                if (pKernelEntry)
+                {
+                    pKernelEntry->dwLoaded = 1;
+                }
+                pRenderHal->iKernelAllocationID = iKernelAllocationID;
+
+                // Return kernel allocation index
+                return iKernelAllocationID;
+            }
+        }
+
+        // Hint missed; Check if kernel is already loaded; Search free allocation index
         pKernelAllocation = pStateHeap->pKernelAllocation;
         for (iKernelAllocationID = 0;
              iKernelAllocationID < iMaxKernels;
@@ -2241,6 +2284,8 @@ int32_t RenderHal_LoadKernel(
             if (pKernelAllocation->iKUID == iKernelUniqueID &&
                 pKernelAllocation->iKCID == iKernelCacheID)
             {
+                pStateHeap->iKernelLookup[iLookupIndex] = iKernelAllocationID + 1;
+
                 if (iKernelAllocationID != RENDERHAL_KERNEL_LOAD_FAIL)
                 {
                     // Update kernel usage
@@ -2282,50 +2327,6 @@ int32_t RenderHal_LoadKernel(
             break;
         }
 
-        // Kernel parameters
-        pKernelPtr      = pKernel->pBinary;
-        iKernelSize     = pKernel->iSize;
-        iKernelUniqueID = pKernel->iKUID;
-        iKernelCacheID  = pKernel->iKCID;
-
-        // Check if kernel is already loaded; Search free allocation index
-        iSearchIndex      = -1;
-        iMaxKernels       = pRenderHal->StateHeapSettings.iKernelCount;
-        pKernelAllocation = pStateHeap->pKernelAllocation;
-        for (iKernelAllocationID = 0;
-             iKernelAllocationID < iMaxKernels;
-             iKernelAllocationID++, pKernelAllocation++)
-        {
-            if (pKernelAllocation->iKUID == iKernelUniqueID &&
-                pKernelAllocation->iKCID == iKernelCacheID)
-            {
-                break;
-            }
-
-            if (iSearchIndex < 0 &&
-                pKernelAllocation->dwFlags == RENDERHAL_KERNEL_ALLOCATION_FREE)
-            {
-                iSearchIndex = iKernelAllocationID;
-            }
-        }
-
-        // The kernel size to be dumped in oca buffer.
-        pStateHeap->iKernelUsedForDump = iKernelSize;
-
-        // Kernel already loaded: refresh timer; return allocation index
-        if (iKernelAllocationID < iMaxKernels)
-        {
-            // To reload the kernel forcibly if needed
-            if (pKernel->bForceReload)
-            {
-                dwOffset = pKernelAllocation->dwOffset;
-                MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
-
-                pKernel->bForceReload = false;
-            }
-            break;
-        }
-
         // Simple allocation: allocation index available, space available
         if ((iSearchIndex >= 0) &&
             (pStateHeap->iKernelUsed + iKernelSize <= pStateHeap->iKernelSize))
@@ -2451,6 +2452,7 @@ int32_t RenderHal_LoadKernel(
         pKernelAllocation->Params       = *pParameters;
         pKernelAllocation->pKernelEntry = pKernelEntry;
         pKernelAllocation->iAllocIndex  = iKernelAllocationID;
+        pStateHeap->iKernelLookup[iLookupIndex] = iKernelAllocationID + 1;
 
         // Copy kernel data
         MOS_SecureMemcpy(pStateHeap->pIshBuffer + dwOffset, iKernelSize, pKernelPtr, iKernelSize);
@@ -2633,6 +2635,8 @@ void RenderHal_ResetKernels(
         pKernelAllocation->Params           = g_cRenderHal_InitKernelParams;
     }
 
+    MOS_ZeroMemory(pStateHeap->iKernelLookup, sizeof(pStateHeap->iKernelLookup));
+
     // Free Kernel Heap
     pStateHeap->dwAccessCounter = 0;
     pStateHeap->iKernelSize = pRenderHal->StateHeapSettings.iKernelHeapSize;
@@ -56,6 +56,7 @@ MOS_STATUS MediaFeatureManager::RegisterFeatures(
     }
     m_packetIdList[featureID]      = std::move(packetIds);
     m_packetIdListTypes[featureID] = packetIdListType;
+    m_settingCache.Invalidate();
 
     return MOS_STATUS_SUCCESS;
 }
@@ -120,6 +121,7 @@ MOS_STATUS MediaFeatureManager::Destroy()
         };
     }
     m_features.clear();
+    m_settingCache.Invalidate();
 
     if (m_featureConstSettings != nullptr)
     {
@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <atomic>
 #include "media_user_setting.h"
 #include "media_utils.h"
 #include "mos_defs.h"
@@ -102,6 +103,87 @@ struct FeatureIDs
 
 class MediaFeature;
 
+//!
+//! \class   MediaFeatureSettingCache
+//! \brief   Caches, per MHW ParSetting interface, the features implementing it.
+//! \details SETPAR runs for every HW command of every frame. Instead of doing
+//!          a dynamic_cast of every feature to the command's ParSetting
+//!          interface each time, the casted feature list is built once per
+//!          interface and then walked as a flat array. Each interface type gets
+//!          a process-wide slot index on first use, so the lookup is indexed.
+//!
+class MediaFeatureSettingCache
+{
+public:
+    using list_t = std::vector<const void *>;
+
+    //!
+    //! \brief  Get features which implement setting interface T
+    //! \param  [in] features
+    //!         Features to be checked when the list is not cached yet
+    //! \return const list_t &
+    //!         Feature pointers which are statically castable to const T *
+    //!
+    template <typename T, typename Container>
+    const list_t &Get(const Container &features)
+    {
+        uint32_t slot = GetSlot<T>();
+        if (slot >= m_lists.size())
+        {
+            m_lists.resize(slot + 1);
+        }
+
+        auto &entry = m_lists[slot];
+        if (!entry.valid)
+        {
+            entry.features.clear();
+            for (const auto &e : features)
+            {
+                auto p = dynamic_cast<const T *>(e.second);
+                if (p)
+                {
+                    entry.features.push_back(static_cast<const void *>(p));
+                }
+            }
+            entry.valid = true;
+        }
+        return entry.features;
+    }
+
+    //!
+    //! \brief  Drop all cached lists, must be called when features change
+    //!
+    void Invalidate()
+    {
+        for (auto &entry : m_lists)
+        {
+            entry.valid = false;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        list_t features;
+        bool   valid = false;
+    };
+
+    static uint32_t NextSlot()
+    {
+        static std::atomic<uint32_t> slotCount(0);
+        return slotCount++;
+    }
+
+    template <typename T>
+    static uint32_t GetSlot()
+    {
+        static const uint32_t slot = NextSlot();
+        return slot;
+    }
+
+    std::vector<Entry> m_lists;
+};
+
 enum class LIST_TYPE
 {
     BLOCK_LIST,
@@ -143,8 +225,20 @@ public:
             return iter->second;
         }
 
+        //!
+        //! \brief  Get features implementing setting interface T
+        //! \return const MediaFeatureSettingCache::list_t &
+        //!         Feature pointers which are statically castable to const T *
+        //!
+        template <typename T>
+        const MediaFeatureSettingCache::list_t &GetSettingFeatures()
+        {
+            return m_settingCache.Get<T>(m_features);
+        }
+
     private:
-        container_t m_features;
+        container_t              m_features;
+        MediaFeatureSettingCache m_settingCache;
     };
 
 public:
@@ -251,6 +345,18 @@ public:
     //!         actual pass number after feature check
     //!
     uint8_t GetNumPass() { return m_passNum; };
+
+    //!
+    //! \brief  Get features implementing setting interface T
+    //! \return const MediaFeatureSettingCache::list_t &
+    //!         Feature pointers which are statically castable to const T *
+    //!
+    template <typename T>
+    const MediaFeatureSettingCache::list_t &GetSettingFeatures()
+    {
+        return m_settingCache.Get<T>(m_features);
+    }
+
     MediaFeatureConstSettings *GetFeatureSettings() { return m_featureConstSettings; };
     //!
     //! \brief  Check the conflict between features
@@ -287,6 +393,7 @@ protected:
     uint8_t GetTargetUsage(){return m_targetUsage;}
 
     container_t m_features;
+    MediaFeatureSettingCache m_settingCache;
     std::map<int, std::vector<int>> m_packetIdList;  // map feature ID to a vector of packet ID
     std::map<int, LIST_TYPE> m_packetIdListTypes;  // map feature ID to a flag, indicates whether packet ID vector is a block list or an allow list
     MediaFeatureConstSettings *m_featureConstSettings = nullptr;
@@ -55,6 +55,12 @@ MediaCopyBaseState::~MediaCopyBaseState()
         m_inUseGPUMutex = nullptr;
     }
 
+    if (m_engineCacheMutex)
+    {
+        MosUtilities::MosDestroyMutex(m_engineCacheMutex);
+        m_engineCacheMutex = nullptr;
+    }
+
    #if (_DEBUG || _RELEASE_INTERNAL)
     if (m_surfaceDumper != nullptr)
     {
@@ -78,6 +84,11 @@ MOS_STATUS MediaCopyBaseState::Initialize(PMOS_INTERFACE osInterface)
         m_inUseGPUMutex     = MosUtilities::MosCreateMutex();
         MCPY_CHK_NULL_RETURN(m_inUseGPUMutex);
     }
+    if (m_engineCacheMutex == nullptr)
+    {
+        m_engineCacheMutex  = MosUtilities::MosCreateMutex();
+        MCPY_CHK_NULL_RETURN(m_engineCacheMutex);
+    }
     MCPY_CHK_NULL_RETURN(m_osInterface);
     Mos_SetVirtualEngineSupported(m_osInterface, true);
     m_osInterface->pfnVirtualEngineSupported(m_osInterface, true, true);
@@ -139,6 +150,7 @@ MOS_STATUS MediaCopyBaseState::CapabilityCheck(MCPY_STATE_PARAMS &mcpySrc, MCPY_
         caps.engineRender = false;
     }
 
+    // a gpu engine is still needed when the surfaces are busy.
     if (!caps.engineVebox && !caps.engineBlt && !caps.engineRender)
     {
         return MOS_STATUS_INVALID_PARAMETER; // unsupport copy on each hw engine.
@@ -274,6 +286,236 @@ MOS_STATUS CheckResourceSizeValidForCopy(MOS_SURFACE& res)
     return MOS_STATUS_SUCCESS;
 }
 
+static bool IsSameResourceKey(const MCPY_RESOURCE_KEY &key1, const MCPY_RESOURCE_KEY &key2)
+{
+    return key1.pGmmResInfo     == key2.pGmmResInfo     &&
+           key1.handle          == key2.handle          &&
+           key1.gmmFormat       == key2.gmmFormat       &&
+           key1.width           == key2.width           &&
+           key1.height          == key2.height          &&
+           key1.pitch           == key2.pitch           &&
+           key1.size            == key2.size            &&
+           key1.bNotLockable    == key2.bNotLockable    &&
+           key1.CompressionMode == key2.CompressionMode &&
+           key1.CpMode          == key2.CpMode;
+}
+
+static const char *GetEngineName(MCPY_ENGINE mcpyEngine)
+{
+    switch (mcpyEngine)
+    {
+        case MCPY_ENGINE_VEBOX:
+            return "VeBox";
+        case MCPY_ENGINE_BLT:
+            return "BLT";
+        case MCPY_ENGINE_RENDER:
+            return "Render";
+        case MCPY_ENGINE_CPU:
+            return "CPU";
+        default:
+            return "Unknown";
+    }
+}
+
+bool MediaCopyBaseState::IsResourceIdle(PMOS_RESOURCE res)
+{
+    if (m_osInterface == nullptr || m_osInterface->pfnIsResourceBusy == nullptr)
+    {
+        return false;
+    }
+
+    return !m_osInterface->pfnIsResourceBusy(m_osInterface, res);
+}
+
+bool MediaCopyBaseState::LookupEngineCache(MCPY_ENGINE_CACHE_ENTRY &entry)
+{
+    bool found = false;
+
+    if (m_engineCacheMutex == nullptr)
+    {
+        return false;
+    }
+
+    MosUtilities::MosLockMutex(m_engineCacheMutex);
+    for (uint32_t i = 0; i < MCPY_ENGINE_CACHE_SIZE; i++)
+    {
+        const MCPY_ENGINE_CACHE_ENTRY &cached = m_engineCache[i];
+        if (cached.bValid                                &&
+            cached.preferMethod    == entry.preferMethod &&
+            cached.bAllowCPBltCopy == entry.bAllowCPBltCopy &&
+            IsSameResourceKey(cached.src, entry.src)     &&
+            IsSameResourceKey(cached.dst, entry.dst))
+        {
+            entry = cached;
+            found = true;
+            break;
+        }
+    }
+    MosUtilities::MosUnlockMutex(m_engineCacheMutex);
+
+    return found;
+}
+
+void MediaCopyBaseState::UpdateEngineCache(const MCPY_ENGINE_CACHE_ENTRY &entry)
+{
+    if (m_engineCacheMutex == nullptr)
+    {
+        return;
+    }
+
+    MosUtilities::MosLockMutex(m_engineCacheMutex);
+    m_engineCache[m_engineCacheNext]        = entry;
+    m_engineCache[m_engineCacheNext].bValid = true;
+    m_engineCacheNext                       = (m_engineCacheNext + 1) % MCPY_ENGINE_CACHE_SIZE;
+    MosUtilities::MosUnlockMutex(m_engineCacheMutex);
+}
+
+MOS_STATUS MediaCopyBaseState::GetResourceKey(PMOS_RESOURCE res, MCPY_RESOURCE_KEY &key)
+{
+    MCPY_CHK_NULL_RETURN(m_osInterface);
+    MCPY_CHK_NULL_RETURN(res);
+    MCPY_CHK_NULL_RETURN(res->pGmmResInfo);
+
+    GMM_RESOURCE_INFO *gmmResInfo = res->pGmmResInfo;
+    key.pGmmResInfo  = gmmResInfo;
+    key.handle       = m_osInterface->pfnGetResourceHandle ? m_osInterface->pfnGetResourceHandle(m_osInterface->osStreamState, res) : 0;
+    key.gmmFormat    = gmmResInfo->GetResourceFormat();
+    key.width        = gmmResInfo->GetBaseWidth();
+    key.height       = gmmResInfo->GetBaseHeight();
+    key.pitch        = gmmResInfo->GetRenderPitch();
+    key.size         = gmmResInfo->GetSizeSurface();
+    key.bNotLockable = gmmResInfo->GetResFlags().Info.NotLockable;
+    key.CpMode       = gmmResInfo->GetSetCpSurfTag(false, 0) ? MCPY_CPMODE_CP : MCPY_CPMODE_CLEAR;
+    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetMemoryCompressionMode(m_osInterface, res, (PMOS_MEMCOMP_STATE)&key.CompressionMode));
+
+    return MOS_STATUS_SUCCESS;
+}
+
+MOS_STATUS MediaCopyBaseState::GetResourceDetails(MCPY_STATE_PARAMS &mcpyState, MOS_SURFACE &details, const char *surfaceName)
+{
+    MOS_ZeroMemory(&details, sizeof(MOS_SURFACE));
+    details.Format = Format_Invalid;
+    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, mcpyState.OsRes, &details));
+    mcpyState.TileMode = details.TileType;
+    MCPY_NORMALMESSAGE("%s surface's format %d, width %d; hight %d, pitch %d, tiledmode %d, mmc mode %d",
+        surfaceName, details.Format, details.dwWidth, details.dwHeight, details.dwPitch, mcpyState.TileMode, mcpyState.CompressionMode);
+    MT_LOG7(MT_MEDIA_COPY, MT_NORMAL, 
+        MT_SURF_PITCH,          details.dwPitch, 
+        MT_SURF_HEIGHT,         details.dwHeight, 
+        MT_SURF_WIDTH,          details.dwWidth, 
+        MT_SURF_MOS_FORMAT,     details.Format, 
+        MT_MEDIA_COPY_DATASIZE, details.dwSize,
+        MT_SURF_TILE_TYPE,      details.TileType,
+        MT_SURF_COMP_MODE,      mcpyState.CompressionMode);
+    MCPY_CHK_STATUS_RETURN(CheckResourceSizeValidForCopy(details));
+
+    return MOS_STATUS_SUCCESS;
+}
+
+//!
+//! \brief    cpu copy support.
+//! \details  small linear clear surfaces with the same layout, on integrated gpu only,
+//!           when the caller has no engine preference.
+//! \param    entry
+//!           [in] Cache entry holding the resource keys and prefered method
+//! \param    source
+//!           [in] Resource info of source surface
+//! \param    target
+//!           [in] Resource info of destination surface
+//! \return   bool
+//!           Return true if support, otherwise return false.
+//!
+bool MediaCopyBaseState::IsCpuCopySupported(const MCPY_ENGINE_CACHE_ENTRY &entry, const MOS_SURFACE &source, const MOS_SURFACE &target)
+{
+    if (m_osInterface == nullptr || entry.preferMethod != MCPY_METHOD_DEFAULT)
+    {
+        return false;
+    }
+#if (_DEBUG || _RELEASE_INTERNAL)
+    if (m_MCPYForceMode != 0)
+    {
+        return false;
+    }
+#endif
+
+    // reading device local memory through the BAR is far slower than any gpu copy.
+    if (MEDIA_IS_SKU(m_osInterface->pfnGetSkuTable(m_osInterface), FtrLocalMemory))
+    {
+        return false;
+    }
+
+    if (entry.src.CpMode != MCPY_CPMODE_CLEAR || entry.dst.CpMode != MCPY_CPMODE_CLEAR ||
+        entry.src.CompressionMode != MOS_MMC_DISABLED || entry.dst.CompressionMode != MOS_MMC_DISABLED ||
+        entry.src.bNotLockable || entry.dst.bNotLockable ||
+        entry.src.pGmmResInfo == entry.dst.pGmmResInfo ||
+        source.TileType != MOS_TILE_LINEAR || target.TileType != MOS_TILE_LINEAR)
+    {
+        return false;
+    }
+
+    // the whole allocation is copied, so planes must be at the same place in both surfaces.
+    if (source.Format != target.Format || source.dwWidth != target.dwWidth ||
+        source.dwHeight != target.dwHeight || source.dwPitch != target.dwPitch ||
+        source.UPlaneOffset.iSurfaceOffset != target.UPlaneOffset.iSurfaceOffset ||
+        source.VPlaneOffset.iSurfaceOffset != target.VPlaneOffset.iSurfaceOffset ||
+        source.dwSize == 0 || source.dwSize > target.dwSize)
+    {
+        return false;
+    }
+
+    return source.dwSize <= MCPY_CPU_COPY_MAX_SIZE;
+}
+
+//!
+//! \brief    use cpu to do surface copy.
+//! \details  lock both surfaces and copy the whole allocation, only called when both are idle.
+//! \param    src
+//!           [in] Pointer to source surface
+//! \param    dst
+//!           [in] Pointer to destination surface
+//! \param    srcSize
+//!           [in] Size of source surface, from the resource info read at engine selection
+//! \param    dstSize
+//!           [in] Size of destination surface, from the resource info read at engine selection
+//! \return   MOS_STATUS
+//!           Return MOS_STATUS_SUCCESS if success, otherwise return failed.
+//!
+MOS_STATUS MediaCopyBaseState::MediaCpuCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst, uint32_t srcSize, uint32_t dstSize)
+{
+    MOS_STATUS      eStatus   = MOS_STATUS_SUCCESS;
+    MOS_LOCK_PARAMS lockFlags = {};
+    uint8_t        *srcData   = nullptr;
+    uint8_t        *dstData   = nullptr;
+
+    MCPY_CHK_NULL_RETURN(m_osInterface);
+    MCPY_CHK_NULL_RETURN(src);
+    MCPY_CHK_NULL_RETURN(dst);
+    if (srcSize > dstSize)
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    lockFlags.ReadOnly = 1;
+    srcData = (uint8_t *)m_osInterface->pfnLockResource(m_osInterface, src, &lockFlags);
+    MCPY_CHK_NULL_RETURN(srcData);
+
+    MOS_ZeroMemory(&lockFlags, sizeof(lockFlags));
+    lockFlags.WriteOnly = 1;
+    dstData = (uint8_t *)m_osInterface->pfnLockResource(m_osInterface, dst, &lockFlags);
+    if (dstData == nullptr)
+    {
+        m_osInterface->pfnUnlockResource(m_osInterface, src);
+        return MOS_STATUS_NULL_POINTER;
+    }
+
+    eStatus = MOS_SecureMemcpy(dstData, dstSize, srcData, srcSize);
+
+    m_osInterface->pfnUnlockResource(m_osInterface, dst);
+    m_osInterface->pfnUnlockResource(m_osInterface, src);
+
+    return eStatus;
+}
+
 //!
 //! \brief    surface copy func.
 //! \details  copy surface.
@@ -288,55 +530,70 @@ MOS_STATUS MediaCopyBaseState::SurfaceCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst,
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
-    MOS_SURFACE ResDetails;
-    MOS_ZeroMemory(&ResDetails, sizeof(MOS_SURFACE));
-    ResDetails.Format = Format_Invalid;
-
+    MOS_SURFACE           srcDetails = {};
+    MOS_SURFACE           dstDetails = {};
     MCPY_STATE_PARAMS     mcpySrc = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
     MCPY_STATE_PARAMS     mcpyDst = {nullptr, MOS_MMC_DISABLED, MOS_TILE_LINEAR, MCPY_CPMODE_CLEAR, false};
     MCPY_ENGINE           mcpyEngine = MCPY_ENGINE_BLT;
-    MCPY_ENGINE_CAPS      mcpyEngineCaps = {1, 1, 1, 1};
-    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, src, &ResDetails));
-    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetMemoryCompressionMode(m_osInterface, src, (PMOS_MEMCOMP_STATE)&(mcpySrc.CompressionMode)));
-    mcpySrc.CpMode          = src->pGmmResInfo->GetSetCpSurfTag(false, 0)?MCPY_CPMODE_CP:MCPY_CPMODE_CLEAR;
-    mcpySrc.TileMode        = ResDetails.TileType;
+    MCPY_ENGINE_CAPS      mcpyEngineCaps = {1, 1, 1};
+    MCPY_ENGINE_CACHE_ENTRY cacheEntry   = {};
+
+    // a pair copied before is found by identity, without querying the resource info again.
+    MCPY_CHK_STATUS_RETURN(GetResourceKey(src, cacheEntry.src));
+    MCPY_CHK_STATUS_RETURN(GetResourceKey(dst, cacheEntry.dst));
+    cacheEntry.preferMethod    = preferMethod;
+    cacheEntry.bAllowCPBltCopy = m_allowCPBltCopy;
+    bool cached = LookupEngineCache(cacheEntry);
+
     mcpySrc.OsRes           = src;
-    MCPY_NORMALMESSAGE("input surface's format %d, width %d; hight %d, pitch %d, tiledmode %d, mmc mode %d",
-        ResDetails.Format, ResDetails.dwWidth, ResDetails.dwHeight, ResDetails.dwPitch, mcpySrc.TileMode, mcpySrc.CompressionMode);
-    MT_LOG7(MT_MEDIA_COPY, MT_NORMAL, 
-        MT_SURF_PITCH,          ResDetails.dwPitch, 
-        MT_SURF_HEIGHT,         ResDetails.dwHeight, 
-        MT_SURF_WIDTH,          ResDetails.dwWidth, 
-        MT_SURF_MOS_FORMAT,     ResDetails.Format, 
-        MT_MEDIA_COPY_DATASIZE, ResDetails.dwSize,
-        MT_SURF_TILE_TYPE,      ResDetails.TileType,
-        MT_SURF_COMP_MODE,      mcpySrc.CompressionMode);
-    MCPY_CHK_STATUS_RETURN(CheckResourceSizeValidForCopy(ResDetails));
-
-    MOS_ZeroMemory(&ResDetails, sizeof(MOS_SURFACE));
-    ResDetails.Format = Format_Invalid;
-    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetResourceInfo(m_osInterface, dst, &ResDetails));
-    MCPY_CHK_STATUS_RETURN(m_osInterface->pfnGetMemoryCompressionMode(m_osInterface,dst, (PMOS_MEMCOMP_STATE) &(mcpyDst.CompressionMode)));
-    mcpyDst.CpMode          = dst->pGmmResInfo->GetSetCpSurfTag(false, 0)?MCPY_CPMODE_CP:MCPY_CPMODE_CLEAR;
-    mcpyDst.TileMode        = ResDetails.TileType;
+    mcpySrc.CompressionMode = cacheEntry.src.CompressionMode;
+    mcpySrc.CpMode          = cacheEntry.src.CpMode;
     mcpyDst.OsRes           = dst;
-    MCPY_NORMALMESSAGE("Output surface's format %d, width %d; hight %d, pitch %d, tiledmode %d, mmc mode %d",
-        ResDetails.Format, ResDetails.dwWidth, ResDetails.dwHeight, ResDetails.dwPitch, mcpyDst.TileMode, mcpyDst.CompressionMode);
-    MT_LOG7(MT_MEDIA_COPY, MT_NORMAL, 
-        MT_SURF_PITCH,          ResDetails.dwPitch, 
-        MT_SURF_HEIGHT,         ResDetails.dwHeight, 
-        MT_SURF_WIDTH,          ResDetails.dwWidth, 
-        MT_SURF_MOS_FORMAT,     ResDetails.Format, 
-        MT_MEDIA_COPY_DATASIZE, ResDetails.dwSize,
-        MT_SURF_TILE_TYPE,      ResDetails.TileType,
-        MT_SURF_COMP_MODE,      mcpyDst.CompressionMode);
-    MCPY_CHK_STATUS_RETURN(CheckResourceSizeValidForCopy(ResDetails));
+    mcpyDst.CompressionMode = cacheEntry.dst.CompressionMode;
+    mcpyDst.CpMode          = cacheEntry.dst.CpMode;
+    if (cached)
+    {
+        mcpySrc.TileMode = cacheEntry.srcTileMode;
+        mcpyDst.TileMode = cacheEntry.dstTileMode;
+        mcpyEngine       = cacheEntry.mcpyEngine;
+    }
+    else
+    {
+        MCPY_CHK_STATUS_RETURN(GetResourceDetails(mcpySrc, srcDetails, "input"));
+        MCPY_CHK_STATUS_RETURN(GetResourceDetails(mcpyDst, dstDetails, "Output"));
+    }
 
     MCPY_CHK_STATUS_RETURN(PreCheckCpCopy(mcpySrc, mcpyDst, preferMethod));
 
-    MCPY_CHK_STATUS_RETURN(CapabilityCheck(mcpySrc, mcpyDst, mcpyEngineCaps, preferMethod));
+    if (!cached)
+    {
+        MCPY_CHK_STATUS_RETURN(CapabilityCheck(mcpySrc, mcpyDst, mcpyEngineCaps, preferMethod));
+
+        // the debug bypass mode makes the selection fail, keep it out of the cache.
+        if (CopyEnigneSelect(preferMethod, mcpyEngine, mcpyEngineCaps) == MOS_STATUS_SUCCESS)
+        {
+            cacheEntry.mcpyEngine        = mcpyEngine;
+            cacheEntry.bCpuCopySupported = IsCpuCopySupported(cacheEntry, srcDetails, dstDetails);
+            cacheEntry.srcTileMode       = mcpySrc.TileMode;
+            cacheEntry.dstTileMode       = mcpyDst.TileMode;
+            cacheEntry.dwSrcSize         = srcDetails.dwSize;
+            cacheEntry.dwDstSize         = dstDetails.dwSize;
+            UpdateEngineCache(cacheEntry);
+        }
+    }
 
-    CopyEnigneSelect(preferMethod, mcpyEngine, mcpyEngineCaps);
+    // the cpu copy only pays off when the locks don't wait for gpu work, check it on every call.
+    // it takes no gpu context, so it runs outside m_inUseGPUMutex.
+    if (cacheEntry.bCpuCopySupported && IsResourceIdle(src) && IsResourceIdle(dst))
+    {
+        MOS_STATUS cpuStatus = MediaCpuCopy(src, dst, cacheEntry.dwSrcSize, cacheEntry.dwDstSize);
+        if (MOS_STATUS_SUCCESS == cpuStatus)
+        {
+            MCPY_NORMALMESSAGE("Media Copy works on %s Engine", GetEngineName(MCPY_ENGINE_CPU));
+            return cpuStatus;
+        }
+        MCPY_NORMALMESSAGE("cpu copy failed %d, fall back to %s", cpuStatus, GetEngineName(mcpyEngine));
+    }
 
     MCPY_CHK_STATUS_RETURN(TaskDispatch(mcpySrc, mcpyDst, mcpyEngine));
 
@@ -416,7 +673,7 @@ MOS_STATUS MediaCopyBaseState::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STAT
     MosUtilities::MosUnlockMutex(m_inUseGPUMutex);
 
 #if (_DEBUG || _RELEASE_INTERNAL)
-    std::string copyEngine = mcpyEngine ?(mcpyEngine == MCPY_ENGINE_BLT?"BLT":"Render"):"VeBox";
+    std::string copyEngine = GetEngineName(mcpyEngine);
     MediaUserSettingSharedPtr userSettingPtr = m_osInterface->pfnGetUserSettingInstance(m_osInterface);
     ReportUserSettingForDebug(
         userSettingPtr,
@@ -441,7 +698,7 @@ MOS_STATUS MediaCopyBaseState::TaskDispatch(MCPY_STATE_PARAMS mcpySrc, MCPY_STAT
         m_surfaceDumper->m_frameNum++;
     }
 #endif
-    MCPY_NORMALMESSAGE("Media Copy works on %s Engine", mcpyEngine ?(mcpyEngine == MCPY_ENGINE_BLT?"BLT":"Render"):"VeBox");
+    MCPY_NORMALMESSAGE("Media Copy works on %s Engine", GetEngineName(mcpyEngine));
 
     return eStatus;
 }
@@ -52,8 +52,15 @@ enum MCPY_ENGINE
     MCPY_ENGINE_VEBOX = 0,
     MCPY_ENGINE_BLT,
     MCPY_ENGINE_RENDER,
+    MCPY_ENGINE_CPU,
 };
 
+// Copying a small idle linear surface with the CPU costs one mmap set-domain call plus a memcpy at
+// several GB/s, a GPU copy costs building and submitting a command buffer, which is tens of us
+// whatever the size. Both are about equal at 64KB, larger surfaces go to the GPU.
+#define MCPY_CPU_COPY_MAX_SIZE      (64 * 1024)
+#define MCPY_ENGINE_CACHE_SIZE      8
+
 enum MCPY_CPMODE
 {
     MCPY_CPMODE_CP = 0,
@@ -77,6 +84,44 @@ typedef struct _MCPY_STATE_PARAMS
     bool                  bAuxSuface;
 }MCPY_STATE_PARAMS;
 
+//!
+//! \brief  Resource identity and the resource state the engine selection depends on
+//! \details Read from GMM without querying the full resource info. The layout values
+//!          tell a reallocation at the same GMM resource info and handle apart, the
+//!          compression mode and CP tag can change on a live resource.
+//!
+typedef struct _MCPY_RESOURCE_KEY
+{
+    GMM_RESOURCE_INFO    *pGmmResInfo;
+    uint64_t              handle;
+    GMM_RESOURCE_FORMAT   gmmFormat;
+    uint64_t              width;
+    uint32_t              height;
+    uint64_t              pitch;
+    uint64_t              size;
+    bool                  bNotLockable;
+    MOS_RESOURCE_MMC_MODE CompressionMode;
+    MCPY_CPMODE           CpMode;
+}MCPY_RESOURCE_KEY;
+
+//!
+//! \brief  Cached engine selection of one source/destination pair
+//!
+typedef struct _MCPY_ENGINE_CACHE_ENTRY
+{
+    bool                  bValid;
+    MCPY_RESOURCE_KEY     src;
+    MCPY_RESOURCE_KEY     dst;
+    MCPY_METHOD           preferMethod;
+    bool                  bAllowCPBltCopy;
+    MCPY_ENGINE           mcpyEngine;           // gpu engine, cpu copy is decided on each call
+    bool                  bCpuCopySupported;
+    MOS_TILE_TYPE         srcTileMode;
+    MOS_TILE_TYPE         dstTileMode;
+    uint32_t              dwSrcSize;
+    uint32_t              dwDstSize;
+}MCPY_ENGINE_CACHE_ENTRY;
+
 class MediaCopyBaseState
 {
 public:
@@ -196,6 +241,21 @@ protected:
     virtual bool RenderFormatSupportCheck(PMOS_RESOURCE src, PMOS_RESOURCE dst)
     {return false;}
 
+    //!
+    //! \brief    cpu copy support.
+    //! \details  small linear clear surfaces with the same layout, on integrated gpu only,
+    //!           when the caller has no engine preference.
+    //! \param    entry
+    //!           [in] Cache entry holding the resource keys and prefered method
+    //! \param    source
+    //!           [in] Resource info of source surface
+    //! \param    target
+    //!           [in] Resource info of destination surface
+    //! \return   bool
+    //!           Return true if support, otherwise return false.
+    //!
+    virtual bool IsCpuCopySupported(const MCPY_ENGINE_CACHE_ENTRY &entry, const MOS_SURFACE &source, const MOS_SURFACE &target);
+
     //!
     //! \brief    feature support check on specific check.
     //! \details  media copy feature support.
@@ -265,6 +325,73 @@ protected:
     virtual MOS_STATUS MediaVeboxCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst)
     {return MOS_STATUS_SUCCESS;}
 
+    //!
+    //! \brief    use cpu to do surface copy.
+    //! \details  lock both surfaces and copy the whole allocation, only called when both are idle.
+    //! \param    src
+    //!           [in] Pointer to source surface
+    //! \param    dst
+    //!           [in] Pointer to destination surface
+    //! \param    srcSize
+    //!           [in] Size of source surface, from the resource info read at engine selection
+    //! \param    dstSize
+    //!           [in] Size of destination surface, from the resource info read at engine selection
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if success, otherwise return failed.
+    //!
+    virtual MOS_STATUS MediaCpuCopy(PMOS_RESOURCE src, PMOS_RESOURCE dst, uint32_t srcSize, uint32_t dstSize);
+
+    //!
+    //! \brief    get the identity and state of a resource the engine cache is keyed on.
+    //! \details  only cheap GMM reads, the full resource info is queried on a cache miss.
+    //! \param    res
+    //!           [in] Pointer to resource
+    //! \param    key
+    //!           [out] Resource key
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if success, otherwise return failed.
+    //!
+    virtual MOS_STATUS GetResourceKey(PMOS_RESOURCE res, MCPY_RESOURCE_KEY &key);
+
+    //!
+    //! \brief    query resource info of a surface to copy.
+    //! \details  fills the tile mode of the copy state and checks the surface size.
+    //! \param    mcpyState
+    //!           [in/out] Media copy state of the surface
+    //! \param    details
+    //!           [out] Resource info
+    //! \param    surfaceName
+    //!           [in] Surface name for the log
+    //! \return   MOS_STATUS
+    //!           Return MOS_STATUS_SUCCESS if success, otherwise return failed.
+    //!
+    MOS_STATUS GetResourceDetails(MCPY_STATE_PARAMS &mcpyState, MOS_SURFACE &details, const char *surfaceName);
+
+    //!
+    //! \brief    check no gpu work is pending on a resource.
+    //! \param    res
+    //!           [in] Pointer to resource
+    //! \return   bool
+    //!           Return true if idle, false if busy or unknown.
+    //!
+    bool IsResourceIdle(PMOS_RESOURCE res);
+
+    //!
+    //! \brief    look up the engine selected before for a source/destination pair.
+    //! \param    entry
+    //!           [in/out] Cache entry holding the key to look up, the cached selection is copied in if found
+    //! \return   bool
+    //!           Return true if found, otherwise return false.
+    //!
+    bool LookupEngineCache(MCPY_ENGINE_CACHE_ENTRY &entry);
+
+    //!
+    //! \brief    remember the engine selected for a source/destination pair.
+    //! \param    entry
+    //!           [in] Cache entry with key and selected engine
+    //!
+    void UpdateEngineCache(const MCPY_ENGINE_CACHE_ENTRY &entry);
+
 public:
     PMOS_INTERFACE        m_osInterface    = nullptr;
     bool                  m_allowCPBltCopy = false;  // allow cp call media copy only for output clear cases.
@@ -276,6 +403,11 @@ public:
 
 protected:
     PMOS_MUTEX           m_inUseGPUMutex = nullptr; // Mutex for in-use GPU context
+    // Engine selection of the last pairs copied, keyed by MCPY_RESOURCE_KEY. A pair copied again
+    // skips the resource info queries and capability checks.
+    PMOS_MUTEX              m_engineCacheMutex = nullptr;
+    MCPY_ENGINE_CACHE_ENTRY m_engineCache[MCPY_ENGINE_CACHE_SIZE] = {};
+    uint32_t                m_engineCacheNext = 0;
 MEDIA_CLASS_DEFINE_END(MediaCopyBaseState)
 };
 #endif
@@ -55,10 +55,17 @@ MOS_STATUS MediaStatusReport::GetReport(uint16_t requireNum, void *status)
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
 
     Lock();
+    // Observers are loaded once for all the frames completed since last query.
+    // They are still notified frame by frame from ParseStatus: an observer may update
+    // the report before ParseStatus copies it out, so the calls can't be deferred.
+    m_notifyObservers = std::atomic_load(&m_completeObservers);
+
+    // Reports up to the submitted count are initialized once the count is read.
+    uint32_t submittedCount = m_submittedCount;
     uint32_t completedCount = *m_completedCount;
     uint32_t reportedCount = m_reportedCount;
-    uint32_t reportedCountOrigin = m_reportedCount;
-    uint32_t availableCount = m_submittedCount - reportedCount;
+    uint32_t reportedCountOrigin = reportedCount;
+    uint32_t availableCount = submittedCount - reportedCount;
     uint32_t generatedReportCount = 0;
     uint32_t reportIndex = 0;
     bool reverseOrder = (requireNum > 1);
@@ -86,6 +93,7 @@ MOS_STATUS MediaStatusReport::GetReport(uint16_t requireNum, void *status)
     }
 
     m_reportedCount = reportedCount;
+    m_notifyObservers.reset();
     UnLock();
 
     return eStatus;
@@ -94,18 +102,21 @@ MOS_STATUS MediaStatusReport::GetReport(uint16_t requireNum, void *status)
 MOS_STATUS MediaStatusReport::RegistObserver(MediaStatusReportObserver *observer)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
-    std::vector<MediaStatusReportObserver *>::iterator it;
 
-    it = std::find(m_completeObservers.begin(), m_completeObservers.end(), observer);
-    if (it != m_completeObservers.end())
+    std::lock_guard<std::mutex> guard(m_observerLock);
+
+    std::shared_ptr<const ObserverList> observers = std::atomic_load(&m_completeObservers);
+    if (observers != nullptr &&
+        std::find(observers->begin(), observers->end(), observer) != observers->end())
     {
         // the observer already in the vector
         return MOS_STATUS_SUCCESS;
     }
 
-    Lock();
-    m_completeObservers.push_back(observer);
-    UnLock();
+    std::shared_ptr<ObserverList> newObservers = observers ?
+        std::make_shared<ObserverList>(*observers) : std::make_shared<ObserverList>();
+    newObservers->push_back(observer);
+    std::atomic_store(&m_completeObservers, std::shared_ptr<const ObserverList>(newObservers));
 
     return eStatus;
 }
@@ -113,17 +124,30 @@ MOS_STATUS MediaStatusReport::RegistObserver(MediaStatusReportObserver *observer
 MOS_STATUS MediaStatusReport::UnregistObserver(MediaStatusReportObserver *observer)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
-    std::vector<MediaStatusReportObserver *>::iterator it;
 
-    it = std::find(m_completeObservers.begin(), m_completeObservers.end(), observer);
-    if (it == m_completeObservers.end())
     {
-        // the observer not in the vector
-        return MOS_STATUS_INVALID_PARAMETER;
+        std::lock_guard<std::mutex> guard(m_observerLock);
+
+        std::shared_ptr<const ObserverList> observers = std::atomic_load(&m_completeObservers);
+        if (observers == nullptr)
+        {
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+
+        ObserverList::const_iterator it = std::find(observers->begin(), observers->end(), observer);
+        if (it == observers->end())
+        {
+            // the observer not in the vector
+            return MOS_STATUS_INVALID_PARAMETER;
+        }
+
+        std::shared_ptr<ObserverList> newObservers = std::make_shared<ObserverList>(*observers);
+        newObservers->erase(newObservers->begin() + (it - observers->begin()));
+        std::atomic_store(&m_completeObservers, std::shared_ptr<const ObserverList>(newObservers));
     }
 
+    // A GetReport in progress may still hold the old list, wait for it before the observer goes away.
     Lock();
-    m_completeObservers.erase(it);
     UnLock();
 
     return eStatus;
@@ -132,15 +156,18 @@ MOS_STATUS MediaStatusReport::UnregistObserver(MediaStatusReportObserver *observ
 MOS_STATUS MediaStatusReport::NotifyObservers(void *mfxStatus, void *rcsStatus, void *statusReport)
 {
     MOS_STATUS eStatus = MOS_STATUS_SUCCESS;
-    std::vector<MediaStatusReportObserver *>::iterator it;
 
-    for (it = m_completeObservers.begin(); it != m_completeObservers.end(); it++)
+    std::shared_ptr<const ObserverList> observers = m_notifyObservers ?
+        m_notifyObservers : std::atomic_load(&m_completeObservers);
+    if (observers == nullptr)
+    {
+        return eStatus;
+    }
+
+    for (auto observer : *observers)
     {
-        eStatus = (*it)->Completed(mfxStatus, rcsStatus, statusReport);
+        eStatus = observer->Completed(mfxStatus, rcsStatus, statusReport);
     }
 
     return eStatus;
 }
-
-
-
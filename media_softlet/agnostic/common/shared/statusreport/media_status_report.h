@@ -27,6 +27,10 @@
 #ifndef __MEDIA_STATUS_REPORT_H__
 #define __MEDIA_STATUS_REPORT_H__
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "mos_os_specific.h"
 #include "media_status_report_observer.h"
 
@@ -145,6 +149,7 @@ public:
 
     //!
     //! \brief  Unregist observer of complete event.
+    //! \details Waits for the status report being parsed, the observer is not notified after return.
     //! \param  [in] observer
     //!         The point to StatusReportObserver
     //! \return MOS_STATUS
@@ -174,6 +179,7 @@ protected:
     virtual MOS_STATUS SetStatus(void *report, uint32_t index, bool outOfRange = false) = 0;
     //!
     //! \brief  Notify observers that the frame has been completed.
+    //! \details Called from ParseStatus, uses the observer snapshot taken by GetReport.
     //! \param  [in] statusBuffer
     //!         The point to status buffer
     //! \param  [in,out] statusReport
@@ -193,16 +199,20 @@ protected:
 
     static const uint32_t m_statusNum        = 512;
 
-    PMOS_RESOURCE    m_completedCountBuf     = nullptr;
-    uint32_t         *m_completedCount       = nullptr;
-    uint32_t         m_submittedCount        = 0;
-    uint32_t         m_reportedCount         = 0;
-    uint32_t         m_sizeOfReport          = 0;
+    using ObserverList = std::vector<MediaStatusReportObserver *>;
 
-    StatusBufAddr    *m_statusBufAddr        = nullptr;
+    PMOS_RESOURCE         m_completedCountBuf     = nullptr;
+    uint32_t              *m_completedCount       = nullptr;
+    std::atomic<uint32_t> m_submittedCount        {0};      //!< Only written by the submission thread
+    std::atomic<uint32_t> m_reportedCount         {0};
+    uint32_t              m_sizeOfReport          = 0;
 
-    std::recursive_mutex                      m_lock;
-    std::vector<MediaStatusReportObserver *>  m_completeObservers;
+    StatusBufAddr         *m_statusBufAddr        = nullptr;
+
+    std::recursive_mutex                  m_lock;               //!< Serializes GetReport, submission never takes it
+    std::mutex                            m_observerLock;       //!< Serializes observer list updates
+    std::shared_ptr<const ObserverList>   m_completeObservers;  //!< Replaced on update, read without m_observerLock
+    std::shared_ptr<const ObserverList>   m_notifyObservers;    //!< Snapshot for the GetReport in progress
 MEDIA_CLASS_DEFINE_END(MediaStatusReport)
 };
 
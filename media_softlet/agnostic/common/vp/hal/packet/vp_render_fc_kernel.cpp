@@ -1287,18 +1287,29 @@ MOS_STATUS VpRenderFcKernel::GetKernelEntry(Kdll_CacheEntry &entry)
             filterSize,
             1);
 
-        // Search kernel
-        if (!kernelDllState->pfnSearchKernel(kernelDllState, pSearchState))
+        // Kernel built by previous process
+        if (KernelDll_GetDiskCachedKernel(kernelDllState, pSearchState, m_searchFilter, filterSize, kernelHash))
         {
-            VP_RENDER_ASSERTMESSAGE("Failed to find a kernel.");
-            return MOS_STATUS_UNKNOWN;
+            VP_RENDER_NORMALMESSAGE("Use kernel from disk cache.");
         }
-
-        // Build kernel
-        if (!kernelDllState->pfnBuildKernel(kernelDllState, pSearchState))
+        else
         {
-            VP_RENDER_ASSERTMESSAGE("Failed to build kernel.");
-            return MOS_STATUS_UNKNOWN;
+            // Search kernel
+            if (!kernelDllState->pfnSearchKernel(kernelDllState, pSearchState))
+            {
+                VP_RENDER_ASSERTMESSAGE("Failed to find a kernel.");
+                return MOS_STATUS_UNKNOWN;
+            }
+
+            // Build kernel
+            if (!kernelDllState->pfnBuildKernel(kernelDllState, pSearchState))
+            {
+                VP_RENDER_ASSERTMESSAGE("Failed to build kernel.");
+                return MOS_STATUS_UNKNOWN;
+            }
+
+            // Persist kernel for next processes
+            KernelDll_StoreDiskCachedKernel(kernelDllState, pSearchState, m_searchFilter, filterSize, kernelHash);
         }
 
         // Load resulting kernel into kernel cache
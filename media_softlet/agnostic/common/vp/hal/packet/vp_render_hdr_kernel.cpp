@@ -2054,9 +2054,67 @@ MOS_STATUS VpRenderHdrKernel::InitOETF1DLUT(
     return eStatus;
 }
 
+//!
+//! \brief    Get CRI 3D LUT Key
+//! \details  Collect every input of VpHal_HdrColorTransfer3dLut for a layer,
+//!           so that an unchanged 3D LUT can be reused instead of regenerated
+//! \param    PRENDER_HDR_PARAMS params
+//!           [in] Pointer to HDR params
+//! \param    int32_t iIndex
+//!           [in] input surface index
+//! \param    VP_SURFACE *pCRI3DLUTSurface
+//!           [in] Pointer to Cri 3D Lut Surface
+//! \param    HDR_CRI_3DLUT_KEY &key
+//!           [out] 3D LUT key
+//! \return   void
+//!
+void VpRenderHdrKernel::GetCri3DLUTKey(
+    PRENDER_HDR_PARAMS params,
+    int32_t            iIndex,
+    VP_SURFACE         *pCRI3DLUTSurface,
+    HDR_CRI_3DLUT_KEY  &key)
+{
+    VP_FUNC_CALL();
+
+    auto        inputSurface = m_surfaceGroup->find(SurfaceType(SurfaceTypeHdrInputLayer0 + iIndex));
+    VP_SURFACE *input        = (m_surfaceGroup->end() != inputSurface) ? inputSurface->second : nullptr;
+    HDR_PARAMS &target       = params->targetHDRParams[0];
+
+    MOS_ZeroMemory(&key, sizeof(key));
+
+    key.lutSize          = params->Cri3DLUTSize;
+    key.format           = (uint32_t)pCRI3DLUTSurface->osSurface->Format;
+    key.pitch            = pCRI3DLUTSurface->osSurface->dwPitch;
+    key.gpuGenerate3DLUT = params->bGpuGenerate3DLUT;
+    key.stageEnables     = params->StageEnableFlags[iIndex].value;
+    key.isAYUV           = (input && input->osSurface && input->osSurface->Format == Format_AYUV);
+    key.priorCSC         = (uint32_t)params->PriorCSC[iIndex];
+    key.eotfGamma        = (uint32_t)params->EOTFGamma[iIndex];
+    key.ccm              = (uint32_t)params->CCM[iIndex];
+    key.hdrMode          = (uint32_t)params->HdrMode[iIndex];
+    key.ccmExt1          = (uint32_t)params->CCMExt1[iIndex];
+    key.ccmExt2          = (uint32_t)params->CCMExt2[iIndex];
+    key.oetfGamma        = (uint32_t)params->OETFGamma[iIndex];
+    key.postCSC          = (uint32_t)params->PostCSC[iIndex];
+
+    // Target display gamut is used by monitor CCM
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        key.displayPrimariesX[i] = target.display_primaries_x[i];
+        key.displayPrimariesY[i] = target.display_primaries_y[i];
+    }
+    key.whitePointX                  = target.white_point_x;
+    key.whitePointY                  = target.white_point_y;
+    key.maxDisplayMasteringLuminance = target.max_display_mastering_luminance;
+    key.minDisplayMasteringLuminance = target.min_display_mastering_luminance;
+    key.maxCLL                       = target.MaxCLL;
+    key.maxFALL                      = target.MaxFALL;
+}
+
 //!
 //! \brief    Initiate Cri 3D Lut Surface for HDR
 //! \details  Initiate Cri 3D Lut Surface for HDR
+//!           The 3D Lut is kept per layer and only regenerated when its inputs change
 //! \param    PVPHAL_HDR_STATE pHdrStatee
 //!           [in] Pointer to HDR state
 //! \param    int32_t iIndex
@@ -2072,103 +2130,133 @@ MOS_STATUS VpRenderHdrKernel::InitCri3DLUT(
 {
     VP_FUNC_CALL();
 
-    MOS_STATUS      eStatus = MOS_STATUS_SUCCESS;
-    uint32_t        i = 0, j = 0, k = 0;
-    uint16_t        u3dLutOutputX = 0, u3dLutOutputY = 0, u3dLutOutputZ = 0;
-    uint16_t       *pwDst3dLut = nullptr;
-    uint32_t       *puiDst3dLut = nullptr;
-    uint8_t        *pByte = nullptr;
-    MOS_LOCK_PARAMS LockFlags     = {};
-    uint8_t         bBytePerPixel = 0;
+    MOS_STATUS        eStatus = MOS_STATUS_SUCCESS;
+    uint32_t          i = 0, j = 0, k = 0;
+    uint16_t          u3dLutOutputX = 0, u3dLutOutputY = 0, u3dLutOutputZ = 0;
+    uint16_t         *pwDst3dLut = nullptr;
+    uint32_t         *puiDst3dLut = nullptr;
+    uint8_t          *pByte = nullptr;
+    uint8_t          *pLut = nullptr;
+    MOS_LOCK_PARAMS   LockFlags     = {};
+    uint8_t           bBytePerPixel = 0;
+    uint32_t          dwLutSize     = 0;
+    uint32_t          dwRowSize     = 0;
+    HDR_CRI_3DLUT_KEY key           = {};
 
+    VP_PUBLIC_CHK_NULL_RETURN(params);
     VP_PUBLIC_CHK_NULL_RETURN(pCRI3DLUTSurface);
     VP_PUBLIC_CHK_NULL_RETURN(pCRI3DLUTSurface->osSurface);
+    if (iIndex < 0 || iIndex >= VPHAL_MAX_HDR_INPUT_LAYER)
+    {
+        VP_PUBLIC_CHK_STATUS_RETURN(MOS_STATUS_INVALID_PARAMETER);
+    }
 
-    MOS_ZeroMemory(&LockFlags, sizeof(MOS_LOCK_PARAMS));
-
-    LockFlags.WriteOnly = 1;
+    if (pCRI3DLUTSurface->osSurface->Format == Format_A16B16G16R16)
+    {
+        bBytePerPixel = 8;
+    }
+    else if (pCRI3DLUTSurface->osSurface->Format == Format_R10G10B10A2)
+    {
+        bBytePerPixel = 4;
+    }
+    else
+    {
+        VP_RENDER_ASSERTMESSAGE("Unexpected HDR 3DLUT format.");
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
 
-    // Lock the surface for writing
-    pByte = (uint8_t *)m_allocator->Lock(
-        &(pCRI3DLUTSurface->osSurface->OsResource),
-        &LockFlags);
+    dwLutSize = params->Cri3DLUTSize;
+    dwRowSize = dwLutSize * bBytePerPixel;
 
-    VP_PUBLIC_CHK_NULL_RETURN(pByte);
+    // Regenerate the LUT only if any of its inputs changed since last time
+    GetCri3DLUTKey(params, iIndex, pCRI3DLUTSurface, key);
+    std::vector<uint8_t> &lut = m_cri3DLUT[iIndex];
 
-    if (pCRI3DLUTSurface->osSurface->Format == Format_A16B16G16R16)
+    if (!m_cri3DLUTValid[iIndex] ||
+        memcmp(&key, &m_cri3DLUTKey[iIndex], sizeof(key)) != 0)
     {
-        bBytePerPixel = 8;
+        m_cri3DLUTValid[iIndex] = false;
+        lut.resize((size_t)dwLutSize * dwLutSize * dwRowSize);
+        pLut = lut.data();
 
-        for (i = 0; i < params->Cri3DLUTSize; i++)
+        for (i = 0; i < dwLutSize; i++)
         {
-            for (j = 0; j < params->Cri3DLUTSize; j++)
+            for (j = 0; j < dwLutSize; j++)
             {
-                for (k = 0; k < params->Cri3DLUTSize; k++)
+                for (k = 0; k < dwLutSize; k++, pLut += bBytePerPixel)
                 {
-                    pwDst3dLut = (uint16_t *)(pByte +
-                                              i * params->Cri3DLUTSize * pCRI3DLUTSurface->osSurface->dwPitch +
-                                              j * pCRI3DLUTSurface->osSurface->dwPitch +
-                                              k * bBytePerPixel);
-
                     u3dLutOutputX = u3dLutOutputY = u3dLutOutputZ = 0;
 
                     VpHal_HdrColorTransfer3dLut(params,
                         iIndex,
-                        (float)k / (float)(params->Cri3DLUTSize - 1),
-                        (float)j / (float)(params->Cri3DLUTSize - 1),
-                        (float)i / (float)(params->Cri3DLUTSize - 1),
+                        (float)k / (float)(dwLutSize - 1),
+                        (float)j / (float)(dwLutSize - 1),
+                        (float)i / (float)(dwLutSize - 1),
                         &u3dLutOutputX,
                         &u3dLutOutputY,
                         &u3dLutOutputZ);
 
-                    *pwDst3dLut++ = u3dLutOutputX;
-                    *pwDst3dLut++ = u3dLutOutputY;
-                    *pwDst3dLut++ = u3dLutOutputZ;
+                    if (bBytePerPixel == 8)
+                    {
+                        pwDst3dLut    = (uint16_t *)pLut;
+                        *pwDst3dLut++ = u3dLutOutputX;
+                        *pwDst3dLut++ = u3dLutOutputY;
+                        *pwDst3dLut   = u3dLutOutputZ;
+                    }
+                    else
+                    {
+                        puiDst3dLut  = (uint32_t *)pLut;
+                        *puiDst3dLut = (uint32_t)u3dLutOutputX +
+                                       ((uint32_t)u3dLutOutputY << 10) +
+                                       ((uint32_t)u3dLutOutputZ << 20);
+                    }
                 }
             }
         }
 
-        eStatus = MOS_STATUS_SUCCESS;
+        m_cri3DLUTKey[iIndex]   = key;
+        m_cri3DLUTValid[iIndex] = true;
     }
-    else if (pCRI3DLUTSurface->osSurface->Format == Format_R10G10B10A2)
+    else
     {
-        bBytePerPixel = 4;
+        // Keep the side effect of VpHal_HdrColorTransfer3dLut
+        params->f3DLUTNormalizationFactor = params->bGpuGenerate3DLUT ? 1023.0f : 65535.0f;
+    }
 
-        for (i = 0; i < params->Cri3DLUTSize; i++)
-        {
-            for (j = 0; j < params->Cri3DLUTSize; j++)
-            {
-                for (k = 0; k < params->Cri3DLUTSize; k++)
-                {
-                    puiDst3dLut = (uint32_t *)(pByte +
-                                               i * params->Cri3DLUTSize * pCRI3DLUTSurface->osSurface->dwPitch +
-                                               j * pCRI3DLUTSurface->osSurface->dwPitch +
-                                               k * bBytePerPixel);
+    LockFlags.WriteOnly = 1;
 
-                    u3dLutOutputX = u3dLutOutputY = u3dLutOutputZ = 0;
+    // Lock the surface for writing
+    pByte = (uint8_t *)m_allocator->Lock(
+        &(pCRI3DLUTSurface->osSurface->OsResource),
+        &LockFlags);
 
-                    VpHal_HdrColorTransfer3dLut(params,
-                        iIndex,
-                        (float)k / (float)(params->Cri3DLUTSize - 1),
-                        (float)j / (float)(params->Cri3DLUTSize - 1),
-                        (float)i / (float)(params->Cri3DLUTSize - 1),
-                        &u3dLutOutputX,
-                        &u3dLutOutputY,
-                        &u3dLutOutputZ);
+    VP_PUBLIC_CHK_NULL_RETURN(pByte);
+
+    pLut = lut.data();
+    for (i = 0; i < dwLutSize; i++)
+    {
+        for (j = 0; j < dwLutSize; j++, pLut += dwRowSize)
+        {
+            uint8_t *pRow = pByte +
+                            i * dwLutSize * pCRI3DLUTSurface->osSurface->dwPitch +
+                            j * pCRI3DLUTSurface->osSurface->dwPitch;
 
-                    *puiDst3dLut = (uint32_t)u3dLutOutputX +
-                                   ((uint32_t)u3dLutOutputY << 10) +
-                                   ((uint32_t)u3dLutOutputZ << 20);
+            if (bBytePerPixel == 8)
+            {
+                // Alpha channel is left as it is in the surface
+                for (k = 0; k < dwLutSize; k++)
+                {
+                    pwDst3dLut    = (uint16_t *)(pRow + k * bBytePerPixel);
+                    pwDst3dLut[0] = ((uint16_t *)(pLut + k * bBytePerPixel))[0];
+                    pwDst3dLut[1] = ((uint16_t *)(pLut + k * bBytePerPixel))[1];
+                    pwDst3dLut[2] = ((uint16_t *)(pLut + k * bBytePerPixel))[2];
                 }
             }
+            else
+            {
+                MOS_SecureMemcpy(pRow, dwRowSize, pLut, dwRowSize);
+            }
         }
-
-        eStatus = MOS_STATUS_SUCCESS;
-    }
-    else
-    {
-        VP_RENDER_ASSERTMESSAGE("Unexpected HDR 3DLUT format.");
-        eStatus = MOS_STATUS_INVALID_PARAMETER;
     }
 
     VP_PUBLIC_CHK_STATUS_RETURN(m_allocator->UnLock(&pCRI3DLUTSurface->osSurface->OsResource));
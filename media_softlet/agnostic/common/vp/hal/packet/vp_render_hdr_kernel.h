@@ -1033,7 +1033,46 @@ protected:
     MEDIA_CSPACE        m_srcCspace  = CSpace_None;
     MEDIA_CSPACE        m_dstCspace  = CSpace_None;
 
+    //!
+    //! \brief    Inputs of CRI 3D LUT generation for one layer
+    //! \details  All uint32_t so that keys can be compared with memcmp
+    //!
+    struct HDR_CRI_3DLUT_KEY
+    {
+        uint32_t lutSize;
+        uint32_t format;
+        uint32_t pitch;
+        uint32_t gpuGenerate3DLUT;
+        uint32_t stageEnables;
+        uint32_t isAYUV;
+        uint32_t priorCSC;
+        uint32_t eotfGamma;
+        uint32_t ccm;
+        uint32_t hdrMode;
+        uint32_t ccmExt1;
+        uint32_t ccmExt2;
+        uint32_t oetfGamma;
+        uint32_t postCSC;
+        uint32_t displayPrimariesX[3];
+        uint32_t displayPrimariesY[3];
+        uint32_t whitePointX;
+        uint32_t whitePointY;
+        uint32_t maxDisplayMasteringLuminance;
+        uint32_t minDisplayMasteringLuminance;
+        uint32_t maxCLL;
+        uint32_t maxFALL;
+    };
+
+    void GetCri3DLUTKey(
+        PRENDER_HDR_PARAMS params,
+        int32_t            iIndex,
+        VP_SURFACE         *pCRI3DLUTSurface,
+        HDR_CRI_3DLUT_KEY  &key);
+
     PRENDER_HDR_PARAMS   m_hdrParams = nullptr;
+    HDR_CRI_3DLUT_KEY    m_cri3DLUTKey[VPHAL_MAX_HDR_INPUT_LAYER]   = {};     //!< Inputs of the last generated CRI 3D LUT per layer
+    bool                 m_cri3DLUTValid[VPHAL_MAX_HDR_INPUT_LAYER] = {};     //!< Whether m_cri3DLUT holds the LUT for m_cri3DLUTKey
+    std::vector<uint8_t> m_cri3DLUT[VPHAL_MAX_HDR_INPUT_LAYER];               //!< Last generated CRI 3D LUT per layer, packed without pitch
     MEDIA_WALKER_HDR_STATIC_DATA m_hdrCurbe = {};
     MHW_VFE_SCOREBOARD      m_scoreboardParams;
 
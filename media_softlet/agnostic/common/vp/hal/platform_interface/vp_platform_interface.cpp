@@ -138,6 +138,19 @@ MOS_STATUS VpPlatformInterface::InitVPFCKernels(
             patchKernelSize,
             ModifyFunctionPointers);
 
+        // Load FC kernels linked by previous processes
+        MediaUserSetting::Value kdllDiskCacheFile;
+        if (vpKernel.GetKdllState() &&
+            MOS_STATUS_SUCCESS == ReadUserSetting(
+                m_userSettingPtr,
+                kdllDiskCacheFile,
+                __VPHAL_KDLL_DISK_CACHE_FILE,
+                MediaUserSetting::Group::Sequence) &&
+            kdllDiskCacheFile.ConstString().size() > 0)
+        {
+            KernelDll_LoadDiskCache(vpKernel.GetKdllState(), kdllDiskCacheFile.ConstString().c_str());
+        }
+
         m_kernelPool.insert(std::make_pair(vpKernel.GetKernelName(), vpKernel));
     }
 
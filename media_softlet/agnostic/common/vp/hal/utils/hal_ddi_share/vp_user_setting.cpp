@@ -183,6 +183,13 @@ MOS_STATUS VpUserSetting::InitVpUserSetting(MediaUserSettingSharedPtr userSettin
             0,
             true);
 
+        DeclareUserSettingKey(  // File to persist dynamically linked FC kernels across processes. Empty: disabled
+            userSettingPtr,
+            __VPHAL_KDLL_DISK_CACHE_FILE,
+            MediaUserSetting::Group::Sequence,
+            "",
+            true);
+
 #if (_DEBUG || _RELEASE_INTERNAL)
         DeclareUserSettingKeyForDebug(  // FORCE VP DECOMPRESSED OUTPUT
             userSettingPtr,
@@ -293,6 +293,7 @@ protected:
 #define __VPHAL_PRIMARY_MMC_COMPRESSMODE                                "VP Primary Surface Compress Mode"
 #define __VPHAL_RT_MMC_COMPRESSMODE                                     "VP RT Compress Mode"
 #define __VPHAL_RT_Cache_Setting                                        "VP RT Cache Setting"
+#define __VPHAL_KDLL_DISK_CACHE_FILE                                    "VP Kernel Dll Disk Cache File"
 
 #if (_DEBUG || _RELEASE_INTERNAL)
 #define __VPHAL_RT_Old_Cache_Setting                                    "VP RT Old Cache Setting"
@@ -36,6 +36,10 @@
 #include <math.h>
 #include "support.h"
 #elif LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #else  // !(EMUL | VPHAL_LIB) && !LINUX
 
 #endif  // EMUL | VPHAL_LIB
@@ -1281,6 +1285,56 @@ Kdll_CacheEntry *KernelDll_GetCombinedKernel(
     }
 }
 
+//--------------------------------------------------------------
+// KernelDll_GetRuleIndexKey - Setup rule lookup key from search state
+//     Key holds every search state field tested by KernelDll_FindRule
+//--------------------------------------------------------------
+static bool KernelDll_GetRuleIndexKey(
+    Kdll_SearchState  *pSearchState,
+    Kdll_RuleIndexKey *pKey,
+    uint32_t          *pdwHash)
+{
+    // Current filter entry must be part of the search filter
+    if (pSearchState->pFilter < pSearchState->Filter ||
+        pSearchState->pFilter >= pSearchState->Filter + DL_MAX_SEARCH_FILTER_SIZE)
+    {
+        return false;
+    }
+
+    MOS_ZeroMemory(pKey, sizeof(Kdll_RuleIndexKey));
+    MOS_SecureMemcpy(&pKey->filter, sizeof(Kdll_FilterEntry), pSearchState->pFilter, sizeof(Kdll_FilterEntry));
+
+    pKey->state               = pSearchState->state;
+    pKey->cspace              = pSearchState->cspace;
+    pKey->chromasiting        = pSearchState->Filter[0].chromasiting;
+    pKey->ShuffleSamplerData  = pSearchState->ShuffleSamplerData;
+    pKey->bRTRotate           = pSearchState->bRTRotate;
+    pKey->bProcamp            = pSearchState->bProcamp;
+    pKey->bCscBeforeMix       = pSearchState->bCscBeforeMix;
+    pKey->b64BSaveEnabled     = pSearchState->b64BSaveEnabled;
+    pKey->quadrant            = pSearchState->quadrant;
+    pKey->layer_number        = pSearchState->layer_number;
+    pKey->src0_format         = pSearchState->src0_format;
+    pKey->src0_sampling       = pSearchState->src0_sampling;
+    pKey->src0_colorfill      = pSearchState->src0_colorfill;
+    pKey->src0_lumakey        = pSearchState->src0_lumakey;
+    pKey->src0_coeff          = pSearchState->src0_coeff;
+    pKey->src0_process        = pSearchState->src0_process;
+    pKey->src0_rotation       = pSearchState->src0_rotation;
+    pKey->src1_format         = pSearchState->src1_format;
+    pKey->src1_sampling       = pSearchState->src1_sampling;
+    pKey->src1_lumakey        = pSearchState->src1_lumakey;
+    pKey->src1_samplerlumakey = pSearchState->src1_samplerlumakey;
+    pKey->src1_coeff          = pSearchState->src1_coeff;
+    pKey->src1_process        = pSearchState->src1_process;
+    pKey->target_format       = pSearchState->target_format;
+    pKey->target_tiletype     = pSearchState->target_tiletype;
+
+    *pdwHash = KernelDll_SimpleHash(pKey, sizeof(Kdll_RuleIndexKey));
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------
 | Name      : KernelDll_FindRule
 | Purpose   : Find a rule that matches the current search/input state
@@ -1304,6 +1358,9 @@ bool KernelDll_FindRule(
     bool                  bSrc1FormatMatched;
     bool                  bTargetFormatMatched;
     bool                  bSrc0SampingMatched;
+    Kdll_RuleIndexKey     key;
+    Kdll_RuleIndexEntry * pIndexEntry = nullptr;
+    uint32_t              dwHash      = 0;
 
     VP_RENDER_FUNCTION_ENTER;
 
@@ -1323,6 +1380,19 @@ bool KernelDll_FindRule(
         return false;
     }
 
+    // Hashed lookup - same search state always matches the same rule set
+    if (KernelDll_GetRuleIndexKey(pSearchState, &key, &dwHash))
+    {
+        pIndexEntry = &pState->RuleIndex[dwHash & (DL_RULE_INDEX_SIZE - 1)];
+        if (pIndexEntry->pRuleSet &&
+            pIndexEntry->dwHash == dwHash &&
+            memcmp(&pIndexEntry->Key, &key, sizeof(Kdll_RuleIndexKey)) == 0)
+        {
+            pSearchState->pMatchingRuleSet = pIndexEntry->pRuleSet;
+            return true;
+        }
+    }
+
     // Search matching entry
     for (; iRuleCount > 0; iRuleCount--, pRuleSet++)
     {
@@ -1855,6 +1925,14 @@ bool KernelDll_FindRule(
         // Match
         if (iMatchCount == 0)
         {
+            // Save match in rule lookup
+            if (pIndexEntry)
+            {
+                pIndexEntry->dwHash   = dwHash;
+                pIndexEntry->Key      = key;
+                pIndexEntry->pRuleSet = pRuleSet;
+            }
+
             pSearchState->pMatchingRuleSet = pRuleSet;
             return true;
         }
@@ -3161,6 +3239,9 @@ bool KernelDll_SortRuleTable(Kdll_State *pState)
         MOS_ZeroMemory(pState->iDllRuleCount, sizeof(pState->iDllRuleCount));
     }
 
+    // Rule lookup points to the previous table
+    MOS_ZeroMemory(pState->RuleIndex, sizeof(pState->RuleIndex));
+
     // Zero counters
     MOS_ZeroMemory(iNoOverr, sizeof(iNoOverr));
     MOS_ZeroMemory(iDefault, sizeof(iDefault));
@@ -3711,6 +3792,9 @@ void KernelDll_ReleaseStates(Kdll_State *pState)
     if (!pState)
         return;
     KernelDll_ReleaseAdditionalCacheEntries(&pState->KernelCache);
+    MOS_FreeMemory(pState->pcDiskCacheFile);
+    MOS_FreeMemory(pState->pDiskCache);
+    MOS_FreeMemory(pState->pDiskCacheIndex);
     MOS_FreeMemory(pState->ComponentKernelCache.pCache);
     MOS_FreeMemory(pState->CmFcPatchCache.pCache);
     MOS_FreeMemory(pState->pSortedRules);
@@ -4365,6 +4449,631 @@ KernelDll_AddKernel(Kdll_State       *pState,           // Kernel Dll state
     return pCacheEntry;
 }
 
+//--------------------------------------------------------------
+// KernelDll_GetBinaryHash - Hash component kernels and rules
+//     Disk cache records built from other binaries are ignored
+//--------------------------------------------------------------
+static uint32_t KernelDll_GetBinaryHash(Kdll_State *pState)
+{
+    const Kdll_RuleEntry *pRule;
+    int32_t               iRuleCount = 0;
+    uint32_t              dwHash[5];
+
+    // Component kernels and CMFC patch kernels
+    dwHash[0] = KernelDll_SimpleHash(pState->ComponentKernelCache.pCache, pState->ComponentKernelCache.iCacheSize);
+    dwHash[1] = KernelDll_SimpleHash(pState->CmFcPatchCache.pCache, pState->CmFcPatchCache.iCacheSize);
+
+    // Default rule table (including end of table marker)
+    pRule = pState->pRuleTableDefault;
+    if (pRule)
+    {
+        for (; pRule[iRuleCount].id != RID_Op_EOF; iRuleCount++)
+        {
+            if (RID_IS_EXTENDED(pRule[iRuleCount].id))
+            {
+                iRuleCount += pRule[iRuleCount].value;
+            }
+        }
+        iRuleCount++;
+    }
+    dwHash[2] = KernelDll_SimpleHash((void *)pRule, iRuleCount * sizeof(Kdll_RuleEntry));
+
+    // Record layout
+    dwHash[3] = (uint32_t)(sizeof(Kdll_FilterEntry) << 16) | (uint32_t)sizeof(Kdll_CSC_Params);
+
+    // Driver build (CSC and search code)
+#ifdef MEDIA_VERSION_DETAILS
+    dwHash[4] = KernelDll_SimpleHash((void *)MEDIA_VERSION_DETAILS, sizeof(MEDIA_VERSION_DETAILS));
+#else
+    dwHash[4] = DL_DISK_CACHE_VERSION;
+#endif
+
+    return KernelDll_SimpleHash(dwHash, sizeof(dwHash));
+}
+
+//--------------------------------------------------------------
+// KernelDll_GetDiskCacheRecordSize - Validate disk cache record header
+//     Returns record size, 0 if header is invalid
+//--------------------------------------------------------------
+static uint32_t KernelDll_GetDiskCacheRecordSize(Kdll_DiskCacheHeader *pHeader)
+{
+    if (pHeader->dwMagic != DL_DISK_CACHE_MAGIC ||
+        pHeader->dwVersion != DL_DISK_CACHE_VERSION ||
+        pHeader->iFilterSize < 1 || pHeader->iFilterSize > DL_MAX_SEARCH_FILTER_SIZE ||
+        pHeader->iOutFilterSize < 1 || pHeader->iOutFilterSize > DL_MAX_SEARCH_FILTER_SIZE ||
+        pHeader->iKernelCount < 0 || pHeader->iKernelCount > DL_MAX_KERNELS ||
+        pHeader->iKernelSize < 1 || pHeader->iKernelSize > DL_MAX_KERNEL_SIZE)
+    {
+        return 0;
+    }
+
+    // Records are 8-byte aligned (zero padded)
+    return (uint32_t)MOS_ALIGN_CEIL(sizeof(Kdll_DiskCacheHeader) +
+                                    (pHeader->iFilterSize + pHeader->iOutFilterSize) * sizeof(Kdll_FilterEntry) +
+                                    sizeof(Kdll_CSC_Params) +
+                                    pHeader->iKernelCount * sizeof(int) +
+                                    pHeader->iKernelSize, 8);
+}
+
+//--------------------------------------------------------------
+// KernelDll_GetDiskCacheValidSize - Size of the valid records at
+//     the start of the buffer; parsing stops at the first corrupted
+//     (e.g. truncated) record
+//--------------------------------------------------------------
+static uint32_t KernelDll_GetDiskCacheValidSize(uint8_t *pData, uint32_t dwSize)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    uint32_t              dwOffset = 0;
+    uint32_t              dwRecord;
+
+    while (dwSize - dwOffset >= sizeof(Kdll_DiskCacheHeader))
+    {
+        pHeader  = (Kdll_DiskCacheHeader *)(pData + dwOffset);
+        dwRecord = KernelDll_GetDiskCacheRecordSize(pHeader);
+        if (dwRecord == 0 ||
+            dwRecord > dwSize - dwOffset ||
+            pHeader->dwChecksum != KernelDll_SimpleHash(pHeader + 1, dwRecord - sizeof(Kdll_DiskCacheHeader)))
+        {
+            VP_RENDER_NORMALMESSAGE("Invalid kernel disk cache record @ offset %d.", dwOffset);
+            break;
+        }
+        dwOffset += dwRecord;
+    }
+
+    return dwOffset;
+}
+
+//--------------------------------------------------------------
+// KernelDll_OpenDiskCache - Open the disk cache file. Symbolic
+//     links are not followed; files not owned by the effective
+//     user or writable by group/others are refused, their records
+//     may have been written by another user.
+//--------------------------------------------------------------
+static MOS_STATUS KernelDll_OpenDiskCache(HANDLE *phFile, const char *pcFileName, uint32_t iOpenFlag)
+{
+    struct stat fileStat;
+
+    if (MosUtilities::MosCreateFile(phFile, (char *)pcFileName, iOpenFlag | O_NOFOLLOW | O_CLOEXEC) != MOS_STATUS_SUCCESS)
+    {
+        return (errno == ENOENT) ? MOS_STATUS_FILE_NOT_FOUND : MOS_STATUS_FILE_OPEN_FAILED;
+    }
+
+    if (fstat((int)(intptr_t)*phFile, &fileStat) != 0 ||
+        !S_ISREG(fileStat.st_mode) ||
+        fileStat.st_uid != geteuid() ||
+        (fileStat.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+    {
+        VP_RENDER_NORMALMESSAGE("Kernel disk cache '%s' is not private to the current user, ignored.", pcFileName);
+        MosUtilities::MosCloseHandle(*phFile);
+        return MOS_STATUS_FILE_OPEN_FAILED;
+    }
+
+    return MOS_STATUS_SUCCESS;
+}
+
+//--------------------------------------------------------------
+// KernelDll_ReadDiskCache - Read the disk cache file. Records past
+//     the size cap are never used, they are not read.
+//--------------------------------------------------------------
+static MOS_STATUS KernelDll_ReadDiskCache(const char *pcFileName,
+                                          uint8_t   **ppData,
+                                          uint32_t   *pdwFileSize,
+                                          uint32_t   *pdwReadSize)
+{
+    HANDLE     hFile;
+    uint8_t *  pData      = nullptr;
+    uint32_t   dwFileSize = 0;
+    uint32_t   dwReadSize = 0;
+    MOS_STATUS eStatus;
+
+    eStatus = KernelDll_OpenDiskCache(&hFile, pcFileName, O_RDONLY);
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        return eStatus;
+    }
+
+    eStatus = MosUtilities::MosGetFileSize(hFile, &dwFileSize, nullptr);
+    if (eStatus == MOS_STATUS_SUCCESS && dwFileSize > 0)
+    {
+        pData = (uint8_t *)MOS_AllocMemory(MOS_MIN(dwFileSize, DL_DISK_CACHE_MAX_SIZE));
+        if (!pData)
+        {
+            eStatus = MOS_STATUS_NO_SPACE;
+        }
+        else
+        {
+            eStatus = MosUtilities::MosReadFile(hFile, pData, MOS_MIN(dwFileSize, DL_DISK_CACHE_MAX_SIZE), &dwReadSize, nullptr);
+        }
+    }
+    MosUtilities::MosCloseHandle(hFile);
+
+    if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        MOS_FreeMemory(pData);
+        return eStatus;
+    }
+
+    *ppData      = pData;
+    *pdwFileSize = dwFileSize;
+    *pdwReadSize = dwReadSize;
+
+    return MOS_STATUS_SUCCESS;
+}
+
+//--------------------------------------------------------------
+// KernelDll_RewriteDiskCache - Replace the disk cache file with
+//     the given records. Written to a new private temporary file
+//     renamed over the cache, so other processes never see a
+//     partial file.
+//--------------------------------------------------------------
+static bool KernelDll_RewriteDiskCache(const char *pcFileName, uint8_t *pData, uint32_t dwSize)
+{
+    char       pcTmpFileName[MOS_MAX_PATH_LENGTH + 1];
+    HANDLE     hFile;
+    int        fd;
+    uint32_t   dwWritten = 0;
+    MOS_STATUS eStatus   = MOS_STATUS_SUCCESS;
+
+    if (MOS_SecureStringPrint(pcTmpFileName, sizeof(pcTmpFileName), sizeof(pcTmpFileName),
+            "%s.XXXXXX", pcFileName) <= 0 ||
+        strlen(pcTmpFileName) + 1 >= sizeof(pcTmpFileName))
+    {
+        return false;
+    }
+
+    // Unique name, created exclusively with mode 0600
+    fd = mkostemp(pcTmpFileName, O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    hFile = (HANDLE)(intptr_t)fd;
+
+    if (dwSize > 0)
+    {
+        eStatus = MosUtilities::MosWriteFile(hFile, pData, dwSize, &dwWritten, nullptr);
+    }
+    MosUtilities::MosCloseHandle(hFile);
+
+    if (eStatus != MOS_STATUS_SUCCESS || dwWritten != dwSize || rename(pcTmpFileName, pcFileName) != 0)
+    {
+        remove(pcTmpFileName);
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------
+// KernelDll_CompactDiskCache - Make room for a record in a full
+//     disk cache file. Oldest records are evicted until the file
+//     is at most half full, then the record is appended. Records
+//     built from other binaries are kept like any other record.
+//--------------------------------------------------------------
+static bool KernelDll_CompactDiskCache(const char *pcFileName, uint8_t *pRecord, uint32_t dwRecord)
+{
+    uint8_t *pFile      = nullptr;
+    uint8_t *pData;
+    uint32_t dwFileSize = 0;
+    uint32_t dwReadSize = 0;
+    uint32_t dwValid;
+    uint32_t dwOffset   = 0;
+    bool     bResult;
+
+    if (KernelDll_ReadDiskCache(pcFileName, &pFile, &dwFileSize, &dwReadSize) != MOS_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    dwValid = KernelDll_GetDiskCacheValidSize(pFile, dwReadSize);
+    while (dwOffset < dwValid && dwValid - dwOffset + dwRecord > DL_DISK_CACHE_MAX_SIZE / 2)
+    {
+        dwOffset += KernelDll_GetDiskCacheRecordSize((Kdll_DiskCacheHeader *)(pFile + dwOffset));
+    }
+
+    pData = (uint8_t *)MOS_AllocMemory(dwValid - dwOffset + dwRecord);
+    if (!pData)
+    {
+        MOS_FreeMemory(pFile);
+        return false;
+    }
+    if (dwValid > dwOffset)
+    {
+        MOS_SecureMemcpy(pData, dwValid - dwOffset, pFile + dwOffset, dwValid - dwOffset);
+    }
+    MOS_SecureMemcpy(pData + dwValid - dwOffset, dwRecord, pRecord, dwRecord);
+
+    bResult = KernelDll_RewriteDiskCache(pcFileName, pData, dwValid - dwOffset + dwRecord);
+
+    MOS_FreeMemory(pData);
+    MOS_FreeMemory(pFile);
+
+    return bResult;
+}
+
+//--------------------------------------------------------------
+// KernelDll_AppendDiskCache - Append record to the disk cache file.
+//     Single write per record; concurrent writers may duplicate
+//     records, never interleave them. A torn append is dropped by
+//     the next KernelDll_LoadDiskCache.
+//--------------------------------------------------------------
+static bool KernelDll_AppendDiskCache(const char *pcFileName, uint8_t *pRecord, uint32_t dwRecord)
+{
+    HANDLE     hFile;
+    uint32_t   dwFileSize = 0;
+    uint32_t   dwWritten  = 0;
+    MOS_STATUS eStatus;
+
+    eStatus = KernelDll_OpenDiskCache(&hFile, pcFileName, O_WRONLY | O_APPEND);
+    if (eStatus == MOS_STATUS_FILE_NOT_FOUND)
+    {
+        return KernelDll_RewriteDiskCache(pcFileName, pRecord, dwRecord);
+    }
+    else if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        return false;
+    }
+
+    if (MosUtilities::MosGetFileSize(hFile, &dwFileSize, nullptr) != MOS_STATUS_SUCCESS ||
+        dwFileSize + dwRecord > DL_DISK_CACHE_MAX_SIZE)
+    {
+        MosUtilities::MosCloseHandle(hFile);
+        return KernelDll_CompactDiskCache(pcFileName, pRecord, dwRecord);
+    }
+
+    eStatus = MosUtilities::MosWriteFile(hFile, pRecord, dwRecord, &dwWritten, nullptr);
+    MosUtilities::MosCloseHandle(hFile);
+
+    return (eStatus == MOS_STATUS_SUCCESS && dwWritten == dwRecord);
+}
+
+//--------------------------------------------------------------
+// KernelDll_InsertDiskCacheIndex - Insert record offset in the
+//     open addressing index (linear probing, offset + 1 stored,
+//     0 marks an empty slot)
+//--------------------------------------------------------------
+static void KernelDll_InsertDiskCacheIndex(uint32_t *pIndex, uint32_t dwIndexSize, uint32_t dwHash, uint32_t dwOffset)
+{
+    uint32_t i;
+
+    for (i = dwHash & (dwIndexSize - 1); pIndex[i] != 0; i = (i + 1) & (dwIndexSize - 1))
+        ;
+    pIndex[i] = dwOffset + 1;
+}
+
+//--------------------------------------------------------------
+// KernelDll_AddDiskCacheRecord - Add record to the in-process
+//     disk cache, indexed by search filter hash
+//--------------------------------------------------------------
+static bool KernelDll_AddDiskCacheRecord(Kdll_State *pState, uint8_t *pRecord, uint32_t dwRecord)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    uint8_t *             pDiskCache;
+    uint32_t *            pIndex;
+    uint32_t              dwAllocSize;
+    uint32_t              dwIndexSize;
+    uint32_t              i;
+
+    // Grow the record buffer geometrically
+    if (pState->dwDiskCacheSize + dwRecord > pState->dwDiskCacheAllocSize)
+    {
+        dwAllocSize = MOS_MAX(pState->dwDiskCacheAllocSize * 2, DL_DISK_CACHE_MIN_ALLOC_SIZE);
+        while (dwAllocSize < pState->dwDiskCacheSize + dwRecord)
+        {
+            dwAllocSize *= 2;
+        }
+        pDiskCache = (uint8_t *)MOS_ReallocMemory(pState->pDiskCache, dwAllocSize);
+        if (!pDiskCache)
+        {
+            return false;
+        }
+        pState->pDiskCache           = pDiskCache;
+        pState->dwDiskCacheAllocSize = dwAllocSize;
+    }
+
+    // Keep the index at most half full
+    if ((pState->dwDiskCacheCount + 1) * 2 > pState->dwDiskCacheIndexSize)
+    {
+        dwIndexSize = MOS_MAX(pState->dwDiskCacheIndexSize * 2, DL_DISK_CACHE_MIN_INDEX_SIZE);
+        pIndex      = (uint32_t *)MOS_AllocAndZeroMemory(dwIndexSize * sizeof(uint32_t));
+        if (!pIndex)
+        {
+            return false;
+        }
+        for (i = 0; i < pState->dwDiskCacheIndexSize; i++)
+        {
+            if (pState->pDiskCacheIndex[i] != 0)
+            {
+                pHeader = (Kdll_DiskCacheHeader *)(pState->pDiskCache + pState->pDiskCacheIndex[i] - 1);
+                KernelDll_InsertDiskCacheIndex(pIndex, dwIndexSize, pHeader->dwHash, pState->pDiskCacheIndex[i] - 1);
+            }
+        }
+        MOS_FreeMemory(pState->pDiskCacheIndex);
+        pState->pDiskCacheIndex      = pIndex;
+        pState->dwDiskCacheIndexSize = dwIndexSize;
+    }
+
+    MOS_SecureMemcpy(pState->pDiskCache + pState->dwDiskCacheSize, dwRecord, pRecord, dwRecord);
+    pHeader = (Kdll_DiskCacheHeader *)(pState->pDiskCache + pState->dwDiskCacheSize);
+    KernelDll_InsertDiskCacheIndex(pState->pDiskCacheIndex, pState->dwDiskCacheIndexSize, pHeader->dwHash, pState->dwDiskCacheSize);
+
+    pState->dwDiskCacheSize += dwRecord;
+    pState->dwDiskCacheCount++;
+
+    return true;
+}
+
+//--------------------------------------------------------------
+// KernelDll_ReleaseDiskCache - Release the in-process disk cache
+//--------------------------------------------------------------
+static void KernelDll_ReleaseDiskCache(Kdll_State *pState)
+{
+    MOS_FreeMemory(pState->pcDiskCacheFile);
+    MOS_FreeMemory(pState->pDiskCache);
+    MOS_FreeMemory(pState->pDiskCacheIndex);
+    pState->pcDiskCacheFile      = nullptr;
+    pState->pDiskCache           = nullptr;
+    pState->pDiskCacheIndex      = nullptr;
+    pState->dwDiskCacheSize      = 0;
+    pState->dwDiskCacheAllocSize = 0;
+    pState->dwDiskCacheIndexSize = 0;
+    pState->dwDiskCacheCount     = 0;
+}
+
+//--------------------------------------------------------------
+// KernelDll_LoadDiskCache - Load combined kernels persisted by
+//     previous processes. Records with valid checksum built from
+//     the current component kernels are indexed; records of other
+//     binaries stay in the file for the drivers that use them.
+//     A torn append and anything after it is dropped.
+//--------------------------------------------------------------
+bool KernelDll_LoadDiskCache(Kdll_State *pState, const char *pcFileName)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    uint8_t *             pFile      = nullptr;
+    uint32_t              dwFileSize = 0;
+    uint32_t              dwReadSize = 0;
+    uint32_t              dwValid;
+    uint32_t              dwOffset;
+    uint32_t              dwRecord;
+    MOS_STATUS            eStatus;
+    size_t                len;
+
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState || !pcFileName || !pcFileName[0])
+    {
+        return false;
+    }
+
+    // Release previous disk cache
+    KernelDll_ReleaseDiskCache(pState);
+
+    len = strlen(pcFileName) + 1;
+    pState->pcDiskCacheFile = (char *)MOS_AllocAndZeroMemory(len);
+    if (!pState->pcDiskCacheFile)
+    {
+        return false;
+    }
+    MOS_SecureMemcpy(pState->pcDiskCacheFile, len, pcFileName, len);
+
+    pState->dwBinaryHash = KernelDll_GetBinaryHash(pState);
+
+    // Missing file is created on the first kernel build
+    eStatus = KernelDll_ReadDiskCache(pcFileName, &pFile, &dwFileSize, &dwReadSize);
+    if (eStatus == MOS_STATUS_FILE_NOT_FOUND)
+    {
+        return true;
+    }
+    else if (eStatus != MOS_STATUS_SUCCESS)
+    {
+        // Keep the file untouched, stop appending to it
+        MOS_FreeMemory(pState->pcDiskCacheFile);
+        pState->pcDiskCacheFile = nullptr;
+        return true;
+    }
+
+    dwValid = KernelDll_GetDiskCacheValidSize(pFile, dwReadSize);
+    for (dwOffset = 0; dwOffset < dwValid; dwOffset += dwRecord)
+    {
+        pHeader  = (Kdll_DiskCacheHeader *)(pFile + dwOffset);
+        dwRecord = KernelDll_GetDiskCacheRecordSize(pHeader);
+        if (pHeader->dwBinaryHash == pState->dwBinaryHash &&
+            !KernelDll_AddDiskCacheRecord(pState, (uint8_t *)pHeader, dwRecord))
+        {
+            break;
+        }
+    }
+
+    // Truncate at the first bad record, new records are appended after the valid ones
+    if (dwValid != dwFileSize && !KernelDll_RewriteDiskCache(pcFileName, pFile, dwValid))
+    {
+        VP_RENDER_NORMALMESSAGE("Failed to rewrite kernel disk cache '%s', disk cache is read only.", pcFileName);
+        MOS_FreeMemory(pState->pcDiskCacheFile);
+        pState->pcDiskCacheFile = nullptr;
+    }
+
+    MOS_FreeMemory(pFile);
+
+    return true;
+}
+
+//--------------------------------------------------------------
+// KernelDll_GetDiskCachedKernel - Find combined kernel in disk
+//     cache; on success search state holds the same output as
+//     pfnSearchKernel + pfnBuildKernel (for KernelDll_AddKernel)
+//--------------------------------------------------------------
+bool KernelDll_GetDiskCachedKernel(Kdll_State       *pState,
+                                   Kdll_SearchState *pSearchState,
+                                   Kdll_FilterEntry *pFilter,
+                                   int32_t           iFilterSize,
+                                   uint32_t          dwHash)
+{
+    Kdll_DiskCacheHeader *pHeader;
+    uint32_t              dwMask;
+    uint32_t              i;
+    uint8_t *             ptr;
+
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState || !pState->pDiskCacheIndex || !pSearchState || !pFilter)
+    {
+        return false;
+    }
+
+    // Records were validated at load time
+    dwMask = pState->dwDiskCacheIndexSize - 1;
+    for (i = dwHash & dwMask; pState->pDiskCacheIndex[i] != 0; i = (i + 1) & dwMask)
+    {
+        pHeader = (Kdll_DiskCacheHeader *)(pState->pDiskCache + pState->pDiskCacheIndex[i] - 1);
+
+        ptr = (uint8_t *)(pHeader + 1);
+        if (pHeader->dwHash != dwHash ||
+            pHeader->iFilterSize != iFilterSize ||
+            memcmp(ptr, pFilter, iFilterSize * sizeof(Kdll_FilterEntry)) != 0)
+        {
+            continue;
+        }
+        ptr += iFilterSize * sizeof(Kdll_FilterEntry);
+
+        // Modified filter
+        pSearchState->iFilterSize = pHeader->iOutFilterSize;
+        MOS_SecureMemcpy(pSearchState->Filter, sizeof(pSearchState->Filter), ptr, pHeader->iOutFilterSize * sizeof(Kdll_FilterEntry));
+        ptr += pHeader->iOutFilterSize * sizeof(Kdll_FilterEntry);
+
+        // CSC parameters
+        MOS_SecureMemcpy(&pSearchState->CscParams, sizeof(Kdll_CSC_Params), ptr, sizeof(Kdll_CSC_Params));
+        ptr += sizeof(Kdll_CSC_Params);
+
+        // Component kernels
+        pSearchState->KernelCount = pHeader->iKernelCount;
+        MOS_SecureMemcpy(pSearchState->KernelID, sizeof(pSearchState->KernelID), ptr, pHeader->iKernelCount * sizeof(int));
+        ptr += pHeader->iKernelCount * sizeof(int);
+
+        // Combined kernel
+        pSearchState->KernelSize = pHeader->iKernelSize;
+        pSearchState->KernelLeft = sizeof(pSearchState->Kernel) - pHeader->iKernelSize;
+        MOS_SecureMemcpy(pSearchState->Kernel, sizeof(pSearchState->Kernel), ptr, pHeader->iKernelSize);
+
+        pState->colorfill_cspace = pHeader->colorfill_cspace;
+
+        return true;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------
+// KernelDll_StoreDiskCachedKernel - Append combined kernel to
+//     disk cache. Kernels with Procamp are not persisted, their
+//     CSC matrices depend on the current Procamp parameters.
+//--------------------------------------------------------------
+bool KernelDll_StoreDiskCachedKernel(Kdll_State       *pState,
+                                     Kdll_SearchState *pSearchState,
+                                     Kdll_FilterEntry *pFilter,
+                                     int32_t           iFilterSize,
+                                     uint32_t          dwHash)
+{
+    Kdll_DiskCacheHeader  header;
+    Kdll_DiskCacheHeader *pHeader;
+    uint8_t *             pRecord;
+    uint8_t *             ptr;
+    uint32_t              dwRecord;
+    int32_t               i;
+    bool                  bResult = false;
+
+    VP_RENDER_FUNCTION_ENTER;
+
+    if (!pState || !pState->pcDiskCacheFile || !pSearchState || !pFilter)
+    {
+        return false;
+    }
+
+    for (i = 0; i < DL_CSC_MAX; i++)
+    {
+        if (pSearchState->CscParams.Matrix[i].bInUse &&
+            pSearchState->CscParams.Matrix[i].iProcampID != DL_PROCAMP_DISABLED)
+        {
+            return false;
+        }
+    }
+
+    MOS_ZeroMemory(&header, sizeof(header));
+    header.dwMagic          = DL_DISK_CACHE_MAGIC;
+    header.dwVersion        = DL_DISK_CACHE_VERSION;
+    header.dwBinaryHash     = pState->dwBinaryHash;
+    header.dwHash           = dwHash;
+    header.iFilterSize      = iFilterSize;
+    header.iOutFilterSize   = pSearchState->iFilterSize;
+    header.iKernelCount     = pSearchState->KernelCount;
+    header.iKernelSize      = pSearchState->KernelSize;
+    header.colorfill_cspace = pState->colorfill_cspace;
+
+    // Records are validated on load as well, don't write records that would be dropped
+    dwRecord = KernelDll_GetDiskCacheRecordSize(&header);
+    if (dwRecord == 0 || pState->dwDiskCacheSize + dwRecord > DL_DISK_CACHE_MAX_SIZE)
+    {
+        return false;
+    }
+
+    pRecord = (uint8_t *)MOS_AllocAndZeroMemory(dwRecord);
+    if (!pRecord)
+    {
+        return false;
+    }
+    pHeader  = (Kdll_DiskCacheHeader *)pRecord;
+    *pHeader = header;
+
+    ptr = (uint8_t *)(pHeader + 1);
+    MOS_SecureMemcpy(ptr, iFilterSize * sizeof(Kdll_FilterEntry), pFilter, iFilterSize * sizeof(Kdll_FilterEntry));
+    ptr += iFilterSize * sizeof(Kdll_FilterEntry);
+    MOS_SecureMemcpy(ptr, header.iOutFilterSize * sizeof(Kdll_FilterEntry), pSearchState->Filter, header.iOutFilterSize * sizeof(Kdll_FilterEntry));
+    ptr += header.iOutFilterSize * sizeof(Kdll_FilterEntry);
+    MOS_SecureMemcpy(ptr, sizeof(Kdll_CSC_Params), &pSearchState->CscParams, sizeof(Kdll_CSC_Params));
+    ptr += sizeof(Kdll_CSC_Params);
+    MOS_SecureMemcpy(ptr, header.iKernelCount * sizeof(int), pSearchState->KernelID, header.iKernelCount * sizeof(int));
+    ptr += header.iKernelCount * sizeof(int);
+    MOS_SecureMemcpy(ptr, header.iKernelSize, pSearchState->Kernel, header.iKernelSize);
+
+    pHeader->dwChecksum = KernelDll_SimpleHash(pHeader + 1, dwRecord - sizeof(Kdll_DiskCacheHeader));
+
+    if (KernelDll_AppendDiskCache(pState->pcDiskCacheFile, pRecord, dwRecord))
+    {
+        bResult = true;
+    }
+    else
+    {
+        VP_RENDER_NORMALMESSAGE("Failed to append kernel to disk cache '%s'.", pState->pcDiskCacheFile);
+    }
+
+    // Keep in-process copy, avoids appending the same kernel after eviction
+    KernelDll_AddDiskCacheRecord(pState, pRecord, dwRecord);
+
+    MOS_FreeMemory(pRecord);
+
+    return bResult;
+}
+
 //--------------------------------------------------------------
 // KernelDll_ReleaseHashEntry - Release hash table entry
 //--------------------------------------------------------------
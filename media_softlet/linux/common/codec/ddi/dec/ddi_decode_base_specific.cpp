@@ -1025,7 +1025,7 @@ VAStatus DdiDecodeBase::CreateBuffer(
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    buf = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+    buf = m_bufferPool.AcquireBuffer();
     if (buf == nullptr)
     {
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
@@ -1048,7 +1048,7 @@ VAStatus DdiDecodeBase::CreateBuffer(
             va = AllocBsBuffer(&(m_decodeCtx->BufMgr), buf);
             if (va != VA_STATUS_SUCCESS)
             {
-                MOS_FreeMemory(buf);
+                m_bufferPool.ReleaseBuffer(buf);
                 return va;
             }
             break;
@@ -1056,7 +1056,7 @@ VAStatus DdiDecodeBase::CreateBuffer(
             va = AllocSliceControlBuffer(buf);
             if (va != VA_STATUS_SUCCESS)
             {
-                MOS_FreeMemory(buf);
+                m_bufferPool.ReleaseBuffer(buf);
                 return va;
             }
             buf->format = Media_Format_CPU;
@@ -1070,14 +1070,14 @@ VAStatus DdiDecodeBase::CreateBuffer(
             if (numElements > 440)
             {
                 va = VA_STATUS_ERROR_INVALID_PARAMETER;
-                MOS_FreeMemory(buf);
+                m_bufferPool.ReleaseBuffer(buf);
                 return va;
             }
-            buf->pData  = (uint8_t*)MOS_AllocAndZeroMemory(size * numElements);
+            buf->pData  = m_bufferPool.AcquireData(size * numElements);
             buf->format = Media_Format_CPU;
             break;
         case VAIQMatrixBufferType:
-            buf->pData  = (uint8_t*)MOS_AllocAndZeroMemory(size * numElements);
+            buf->pData  = m_bufferPool.AcquireData(size * numElements);
             buf->format = Media_Format_CPU;
             break;
         case VAProbabilityBufferType:
@@ -1098,7 +1098,7 @@ VAStatus DdiDecodeBase::CreateBuffer(
             if (size < MOS_ALIGN_CEIL(segMapHeight * segMapWidth * CODEC_SIZE_MFX_STREAMOUT_DATA, 64))
             {
                 va = VA_STATUS_ERROR_INVALID_PARAMETER;
-                MOS_FreeMemory(buf);
+                m_bufferPool.ReleaseBuffer(buf);
                 return va;
             }
             buf->iSize  = size * numElements;
@@ -1106,13 +1106,13 @@ VAStatus DdiDecodeBase::CreateBuffer(
             va = MediaLibvaUtilNext::CreateBuffer(buf, m_decodeCtx->pMediaCtx->pDrmBufMgr);
             if (va != VA_STATUS_SUCCESS)
             {
-                MOS_FreeMemory(buf);
+                m_bufferPool.ReleaseBuffer(buf);
                 return va;
             }
             break;
         }
         case VAHuffmanTableBufferType:
-            buf->pData  = (uint8_t*)MOS_AllocAndZeroMemory(size * numElements);
+            buf->pData  = m_bufferPool.AcquireData(size * numElements);
             buf->format = Media_Format_CPU;
             break;
 #if VA_CHECK_VERSION(1, 10, 0)
@@ -1142,7 +1142,7 @@ VAStatus DdiDecodeBase::CreateBuffer(
     if (nullptr == bufferHeapElement)
     {
         va = VA_STATUS_ERROR_MAX_NUM_EXCEEDED;
-        MOS_FreeMemory(buf);
+        m_bufferPool.ReleaseBuffer(buf);
         return va;
     }
     bufferHeapElement->pBuffer   = buf;
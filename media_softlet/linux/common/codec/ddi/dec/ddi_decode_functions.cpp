@@ -994,13 +994,28 @@ VAStatus DdiDecodeFunctions::DestroyBuffer(
     case VASubsetsParameterBufferType:
     case VAIQMatrixBufferType:
     case VAHuffmanTableBufferType:
-        MOS_FreeMemory(buf->pData);
+        if (decCtx && decCtx->m_ddiDecodeNext)
+        {
+            decCtx->m_ddiDecodeNext->GetBufferPool()->ReleaseData(buf->pData, buf->iSize);
+        }
+        else
+        {
+            MOS_FreeMemory(buf->pData);
+        }
         break;
     default:
         MOS_FreeMemory(buf->pData);
         break;
     }
-    MOS_FreeMemory(buf);
+
+    if (decCtx && decCtx->m_ddiDecodeNext)
+    {
+        decCtx->m_ddiDecodeNext->GetBufferPool()->ReleaseBuffer(buf);
+    }
+    else
+    {
+        MOS_FreeMemory(buf);
+    }
 
     MediaLibvaInterfaceNext::DestroyBufFromVABufferID(mediaCtx, buffer_id);
     MOS_TraceEventExt(EVENT_VA_FREE_BUFFER, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
@@ -33,6 +33,7 @@
 #include "media_ddi_factory.h"
 #include "media_libva_caps_next.h"
 #include "media_libva_interface_next.h"
+#include "bit_writer.h"
 
 namespace encode
 {
@@ -1770,51 +1771,6 @@ VAStatus DdiEncodeAvc::ParsePackedHeaderParams(void *ptr)
     return VA_STATUS_SUCCESS;
 }
 
-AvcOutBits::AvcOutBits(uint8_t *pOutBits, uint32_t BitSize)
-{
-    m_pOutBits = pOutBits;
-    m_BitSize = BitSize;
-    m_BitOffset = 0;
-}
-
-inline uint32_t AvcOutBits::GetBitOffset()
-{
-    return m_BitOffset;
-}
-
-void AvcOutBits::PutBit(uint32_t v)
-{
-    DDI_ASSERT(m_BitOffset + 1 <= m_BitSize);
-
-    uint32_t LeftOffset = m_BitOffset % 8;
-    uint8_t *p = m_pOutBits + m_BitOffset / 8;
-    (*p) |= ((v & 1) << (7 - LeftOffset));
-
-    m_BitOffset++;
-}
-
-void AvcOutBits::PutBits(uint32_t v, uint32_t n)
-{
-    DDI_ASSERT((n > 0) && (n <= 32));
-
-    uint32_t t = 0;
-
-    if (!(m_BitOffset % 8) && !(n % 8))
-    {
-        uint32_t nBytes = n / 8;
-        uint8_t *p = m_pOutBits + m_BitOffset / 8;
-
-        while (nBytes-- > 0)
-            (*p++) = (v >> nBytes) & 0xFF;
-
-        m_BitOffset += n;
-        return;
-    }
-
-    while (n-- > 0)
-        PutBit((v >> n) & 1);
-}
-
 AvcInBits::AvcInBits(uint8_t *pInBits, uint32_t BitSize)
 {
     m_pInBits = pInBits;
@@ -1936,13 +1892,15 @@ MOS_STATUS DdiEncodeAvc::CheckPackedSlcHeaderData(
     OutBitSize = LeftBitSize + HdrBitSize + 1;
     *ppOutSlcHdr = MOS_AllocAndZeroMemory((OutBitSize + 7) / 8);
 
-    AvcOutBits OutBits((uint8_t*)(*ppOutSlcHdr), OutBitSize);
+    DDI_CODEC_CHK_NULL(*ppOutSlcHdr, "nullptr OutSlcHdr", MOS_STATUS_NULL_POINTER);
+
+    BitWriter OutBits((uint8_t*)(*ppOutSlcHdr), (OutBitSize + 7) / 8);
 
     InBits.ResetBitOffset();
-    OutBits.PutBits(InBits.GetBits(StartBitSize), StartBitSize);
-    OutBits.PutBits(InBits.GetBits(8), 8);
+    OutBits.PutBits(StartBitSize, InBits.GetBits(StartBitSize));
+    OutBits.PutBits(8, InBits.GetBits(8));
     if (20 == nalUnitType)
-        OutBits.PutBits(InBits.GetBits(24), 24);
+        OutBits.PutBits(24, InBits.GetBits(24));
 
     // Replace first_mb_in_slice
     first_mb_in_slice = InBits.GetUE();
@@ -1951,12 +1909,13 @@ MOS_STATUS DdiEncodeAvc::CheckPackedSlcHeaderData(
     // Copy the left data
     while (LeftBitSize >= 32)
     {
-        OutBits.PutBits(InBits.GetBits(32), 32);
+        OutBits.PutBits(32, InBits.GetBits(32));
         LeftBitSize -= 32;
     }
 
     if (LeftBitSize)
-        OutBits.PutBits(InBits.GetBits(LeftBitSize), LeftBitSize);
+        OutBits.PutBits(LeftBitSize, InBits.GetBits(LeftBitSize));
+    DDI_ASSERT(!OutBits.IsOverflow());
 
     return MOS_STATUS_SUCCESS;
 }
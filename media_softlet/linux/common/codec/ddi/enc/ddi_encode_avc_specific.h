@@ -61,31 +61,6 @@ protected:
 MEDIA_CLASS_DEFINE_END(encode__AvcInBits) 
 };
 
-class AvcOutBits
-{
-public:
-    AvcOutBits() = delete;
-
-    AvcOutBits(uint8_t *pOutBits, uint32_t BitSize);
-
-    virtual ~AvcOutBits() {};
-
-    void PutBit(uint32_t v);
-
-    void PutBits(uint32_t v, uint32_t n);
-
-    uint32_t GetBitOffset();
-
-protected:
-    uint8_t *m_pOutBits = nullptr;
-    uint8_t *m_pOutBitsEnd = nullptr;
-    uint32_t m_BitSize = 0;
-    uint32_t m_ByteSize = 0;
-    uint32_t m_BitOffset = 0;
-
-MEDIA_CLASS_DEFINE_END(encode__AvcOutBits)
-};
-
 //!
 //! \class  DdiEncodeAvc
 //! \brief  Ddi encode AVC
@@ -24,6 +24,7 @@
 //! \brief    Implements base class for DDI media encode and encode parameters parser
 //!
 
+#include <chrono>
 #include "media_libva_util.h"
 #include "ddi_encode_base_specific.h"
 #include "media_libva_util_next.h"
@@ -173,7 +174,7 @@ VAStatus DdiEncodeBase::StatusReport(
     uint32_t size         = 0;
     int32_t  index        = 0;
     uint32_t status       = 0;
-    uint32_t timeOutCount = 0;
+    uint32_t waitedUs     = 0;
     VAStatus eStatus      = VA_STATUS_SUCCESS;
 
     // Get encoded frame information from status buffer queue.
@@ -252,13 +253,9 @@ VAStatus DdiEncodeBase::StatusReport(
         else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReportData[0].codecStatus)
         {
             // Wait until encode PAK complete, sometimes we application detect encoded buffer object is Idle, may Enc done, but Pak not.
-            uint32_t maxTimeOut                               = 100000;  //set max sleep times to 100000 = 1s, other wise return error.
-            if (timeOutCount < maxTimeOut)
+            uint32_t maxTimeOutUs = 1000000;  //set max wait time to 1s, other wise return error.
+            if (WaitStatusReport(mediaBuf, waitedUs, maxTimeOutUs))
             {
-                //sleep 10 us to wait encode complete, it won't impact the performance.
-                uint32_t sleepTime                            = 10;      //sleep 10 us when encode is not complete.
-                usleep(sleepTime);
-                timeOutCount++;
                 continue;
             }
             else
@@ -305,9 +302,8 @@ VAStatus DdiEncodeBase::EncStatusReport(
 
     EncodeStatusReportData* encodeStatusReportData = (EncodeStatusReportData*)m_encodeCtx->pEncodeStatusReport;
     uint16_t numStatus    = 1;
-    uint32_t maxTimeOut   = 500000;  //set max sleep times to 500000 = 5s, other wise return error.
-    uint32_t sleepTime    = 10;  //sleep 10 us when encode is not complete.
-    uint32_t timeOutCount = 0;
+    uint32_t maxTimeOutUs = 5000000;  //set max wait time to 5s, other wise return error.
+    uint32_t waitedUs     = 0;
 
     //when this function is called, there must be a frame is ready, will wait until get the right information.
     while (1)
@@ -329,11 +325,8 @@ VAStatus DdiEncodeBase::EncStatusReport(
         else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReportData[0].codecStatus)
         {
             // Wait until encode PAK complete, sometimes we application detect encoded buffer object is Idle, may Enc done, but Pak not.
-            if (timeOutCount < maxTimeOut)
+            if (WaitStatusReport(mediaBuf, waitedUs, maxTimeOutUs))
             {
-                //sleep 10 us to wait encode complete, it won't impact the performance.
-                usleep(sleepTime);
-                timeOutCount++;
                 continue;
             }
             else
@@ -365,9 +358,8 @@ VAStatus DdiEncodeBase::PreEncStatusReport(
 
     EncodeStatusReportData* encodeStatusReportData = (EncodeStatusReportData*)m_encodeCtx->pEncodeStatusReport;
     uint16_t numStatus    = 1;
-    uint32_t maxTimeOut   = 500000;  //set max sleep times to 500000 = 5s, other wise return error.
-    uint32_t sleepTime    = 10;  //sleep 10 us when encode is not complete.
-    uint32_t timeOutCount = 0;
+    uint32_t maxTimeOutUs = 5000000;  //set max wait time to 5s, other wise return error.
+    uint32_t waitedUs     = 0;
 
     //when this function is called, there must be a frame is ready, will wait until get the right information.
     while (1)
@@ -389,11 +381,8 @@ VAStatus DdiEncodeBase::PreEncStatusReport(
         else if (CODECHAL_STATUS_INCOMPLETE == encodeStatusReportData[0].codecStatus)
         {
             // Wait until encode PAK complete, sometimes we application detect encoded buffer object is Idle, may Enc done, but Pak not.
-            if (timeOutCount < maxTimeOut)
+            if (WaitStatusReport(mediaBuf, waitedUs, maxTimeOutUs))
             {
-                //sleep 10 us to wait encode complete, it won't impact the performance.
-                usleep(sleepTime);
-                timeOutCount++;
                 continue;
             }
             else
@@ -416,6 +405,33 @@ VAStatus DdiEncodeBase::PreEncStatusReport(
     return VA_STATUS_SUCCESS;
 }
 
+bool DdiEncodeBase::WaitStatusReport(
+    DDI_MEDIA_BUFFER *mediaBuf,
+    uint32_t         &waitedUs,
+    uint32_t         timeoutUs)
+{
+    if (waitedUs >= timeoutUs)
+    {
+        return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    if (mediaBuf != nullptr && mediaBuf->bo != nullptr && mos_bo_busy(mediaBuf->bo))
+    {
+        // GPU still owns the buffer, let the kernel wake us up on completion
+        mos_bo_wait(mediaBuf->bo, (int64_t)(timeoutUs - waitedUs) * 1000);
+    }
+    else
+    {
+        // Status is written after the buffer is released, back off in proportion to the time waited
+        usleep(MOS_CLAMP_MIN_MAX(waitedUs >> 3, m_statusReportMinSleepUs, m_statusReportMaxSleepUs));
+    }
+
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    waitedUs += MOS_MAX((uint32_t)elapsedUs, 1);
+    return true;
+}
+
 VAStatus DdiEncodeBase::RemoveFromStatusReportQueue(DDI_MEDIA_BUFFER *buf)
 {
     VAStatus eStatus = VA_STATUS_SUCCESS;
@@ -895,7 +911,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         return VA_STATUS_ERROR_INVALID_PARAMETER;
     }
 
-    DDI_MEDIA_BUFFER *buf = (DDI_MEDIA_BUFFER *)MOS_New(DDI_MEDIA_BUFFER);
+    DDI_MEDIA_BUFFER *buf = m_bufferPool.AcquireBuffer();
     if (buf == nullptr)
     {
         return VA_STATUS_ERROR_ALLOCATION_FAILED;
@@ -921,7 +937,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -952,7 +968,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -967,7 +983,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1087,7 +1103,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1100,7 +1116,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1140,7 +1156,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1154,7 +1170,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1168,7 +1184,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1181,7 +1197,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1207,7 +1223,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
 
@@ -1221,7 +1237,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1235,7 +1251,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va           = MediaLibvaUtilNext::CreateBuffer(buf, mediaCtx->pDrmBufMgr);
         if (va != VA_STATUS_SUCCESS)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             return VA_STATUS_ERROR_ALLOCATION_FAILED;
         }
         break;
@@ -1267,7 +1283,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         va = m_encodeCtx->pCpDdiInterfaceNext->CreateBuffer(type, buf, size, elementsNum);
         if (va  == VA_STATUS_ERROR_UNSUPPORTED_BUFFERTYPE)
         {
-            MOS_FreeMemory(buf);
+            m_bufferPool.ReleaseBuffer(buf);
             DDI_CODEC_ASSERTMESSAGE("DDI: non supported buffer type = %d, size = %d, num = %d", type, size, elementsNum);
             return va;
         }
@@ -1293,7 +1309,7 @@ VAStatus DdiEncodeBase::CreateBuffer(
         (VAEncMacroblockDisableSkipMapBufferType != (int32_t)type) &&
         (VAProbabilityBufferType != (int32_t)type))
     {
-        buf->pData = (uint8_t*)MOS_NewArray(uint8_t,bufSize);
+        buf->pData = m_bufferPool.AcquireData(bufSize);
         if (nullptr == buf->pData)
         {
             va = VA_STATUS_ERROR_ALLOCATION_FAILED;
@@ -1359,8 +1375,15 @@ void DdiEncodeBase::CleanUpBufferandReturn(DDI_MEDIA_BUFFER *buf)
 {
     if (buf)
     {
-        MOS_FreeMemory(buf->pData);
-        MOS_FreeMemory(buf);
+        if (buf->format == Media_Format_CPU)
+        {
+            m_bufferPool.ReleaseData(buf->pData, buf->iSize);
+        }
+        else
+        {
+            MOS_FreeMemory(buf->pData);
+        }
+        m_bufferPool.ReleaseBuffer(buf);
     }
 }
 
@@ -570,6 +570,29 @@ protected:
         return VA_STATUS_SUCCESS;
     }
 
+    //!
+    //! \brief    Wait before querying an incomplete status report again
+    //!
+    //! \details  Blocks on the buffer object while the GPU still uses it. Otherwise
+    //!           sleeps for a fraction of the time already waited, so a status that
+    //!           completes quickly is seen quickly, and a long wait does not wake
+    //!           the thread every few microseconds.
+    //!
+    //! \param    [in] mediaBuf
+    //!           Pointer to the buffer whose status is queried
+    //! \param    [in,out] waitedUs
+    //!           Time waited so far in microseconds, 0 for the first call
+    //! \param    [in] timeoutUs
+    //!           Maximum time to wait in microseconds
+    //!
+    //! \return   bool
+    //!           true if waited, false if the timeout is reached
+    //!
+    bool WaitStatusReport(
+        DDI_MEDIA_BUFFER *mediaBuf,
+        uint32_t         &waitedUs,
+        uint32_t         timeoutUs);
+
     //!
     //! \brief    Clean Up Buffer and Return
     //!
@@ -586,6 +609,9 @@ protected:
     uint8_t m_scalingLists4x4[6][16]{};          //!< Inverse quantization scale lists 4x4.
     uint8_t m_scalingLists8x8[2][64]{};          //!< Inverse quantization scale lists 8x8
 
+    static const uint32_t m_statusReportMinSleepUs = 2;    //!< Shortest back off sleep while a status report is incomplete
+    static const uint32_t m_statusReportMaxSleepUs = 200;  //!< Longest back off sleep while a status report is incomplete
+
 MEDIA_CLASS_DEFINE_END(encode__DdiEncodeBase)
 };
 
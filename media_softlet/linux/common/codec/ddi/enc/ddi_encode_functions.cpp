@@ -650,12 +650,22 @@ VAStatus DdiEncodeFunctions::DestroyBuffer (
     encCtx = encode::GetEncContextFromPVOID(ctxPtr);
     bufMgr = &(encCtx->BufMgr);
 
+    // CPU format buffers come from the buffer pool of the context which created them
+    codec::DdiCodecBufferPool *bufPool = encCtx->m_encode ? encCtx->m_encode->GetBufferPool() : nullptr;
+
     switch ((int32_t)buf->uiType)
     {
         case VAImageBufferType:
             if(buf->format == Media_Format_CPU)
             {
-                MOS_DeleteArray(buf->pData);
+                if (bufPool)
+                {
+                    bufPool->ReleaseData(buf->pData, buf->iSize);
+                }
+                else
+                {
+                    MOS_FreeMemory(buf->pData);
+                }
             }
             else
             {
@@ -675,7 +685,14 @@ VAStatus DdiEncodeFunctions::DestroyBuffer (
         case VAEncSequenceParameterBufferType:
         case VAEncPackedHeaderDataBufferType:
         case VAEncPackedHeaderParameterBufferType:
-            MOS_DeleteArray(buf->pData);
+            if (bufPool)
+            {
+                bufPool->ReleaseData(buf->pData, buf->iSize);
+            }
+            else
+            {
+                MOS_FreeMemory(buf->pData);
+            }
             break;
         case VAEncMacroblockMapBufferType:
             MediaLibvaUtilNext::FreeBuffer(buf);
@@ -692,7 +709,14 @@ VAStatus DdiEncodeFunctions::DestroyBuffer (
             break;
 #endif
         case VAStatsStatisticsParameterBufferType:
-            MOS_DeleteArray(buf->pData);
+            if (bufPool)
+            {
+                bufPool->ReleaseData(buf->pData, buf->iSize);
+            }
+            else
+            {
+                MOS_FreeMemory(buf->pData);
+            }
             break;
         case VAStatsStatisticsBufferType:
         case VAStatsStatisticsBottomFieldBufferType:
@@ -762,11 +786,32 @@ VAStatus DdiEncodeFunctions::DestroyBuffer (
             MediaLibvaUtilNext::FreeBuffer(buf);
             break;
         default: // do not handle any un-listed buffer type
-            MOS_DeleteArray(buf->pData);
+            if (buf->format == Media_Format_CPU)
+            {
+                if (bufPool)
+                {
+                    bufPool->ReleaseData(buf->pData, buf->iSize);
+                }
+                else
+                {
+                    MOS_FreeMemory(buf->pData);
+                }
+            }
+            else
+            {
+                MOS_DeleteArray(buf->pData);
+            }
             break;
             //return va_STATUS_SUCCESS;
     }
-    MOS_Delete(buf);
+    if (bufPool)
+    {
+        bufPool->ReleaseBuffer(buf);
+    }
+    else
+    {
+        MOS_FreeMemory(buf);
+    }
 
     MediaLibvaInterfaceNext::DestroyBufFromVABufferID(mediaCtx, buffer_id);
     MOS_TraceEventExt(EVENT_VA_FREE_BUFFER, EVENT_TYPE_END, nullptr, 0, nullptr, 0);
@@ -33,6 +33,7 @@
 
 #include "ddi_codec_def_specific.h"
 #include "media_libva_common_next.h"
+#include "ddi_codec_buffer_pool_specific.h"
 
 namespace codec
 {
@@ -144,6 +145,15 @@ public:
     //!
     VAStatus UnRegisterRTSurfaces(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE *surface);
 
+    //!
+    //! \brief    Get buffer pool
+    //! \details  Get the free lists recycling the buffers created on this context
+    //!
+    //! \return   DdiCodecBufferPool*
+    //!           Pointer to the buffer pool of this context
+    //!
+    DdiCodecBufferPool *GetBufferPool() { return &m_bufferPool; }
+
 protected:
     //!
     //! \brief    Get Render Target Index
@@ -186,6 +196,8 @@ protected:
     //!           VA_STATUS_SUCCESS if success, else fail reason
     //!
     VAStatus UpdateRegisteredRTSurfaceFlag(DDI_CODEC_RENDER_TARGET_TABLE *rtTbl, DDI_MEDIA_SURFACE *surface);
+
+    DdiCodecBufferPool m_bufferPool;  //!< Free lists of buffer descriptors and CPU parameter storage
 MEDIA_CLASS_DEFINE_END(codec__DdiCodecBase)
 };
 
@@ -0,0 +1,148 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     ddi_codec_buffer_pool_specific.cpp
+//! \brief    Implements the per context free lists of DDI buffer descriptors and CPU parameter storage.
+//!
+
+#include "ddi_codec_buffer_pool_specific.h"
+
+namespace codec
+{
+DdiCodecBufferPool::DdiCodecBufferPool()
+{
+    m_mutex = MosUtilities::MosCreateMutex();
+}
+
+DdiCodecBufferPool::~DdiCodecBufferPool()
+{
+    for (auto buf : m_freeBuffers)
+    {
+        MOS_FreeMemory(buf);
+    }
+    m_freeBuffers.clear();
+
+    for (auto &bucket : m_freeData)
+    {
+        for (auto data : bucket.second)
+        {
+            MOS_FreeMemory(data);
+        }
+    }
+    m_freeData.clear();
+    m_freeDataSize = 0;
+
+    MosUtilities::MosDestroyMutex(m_mutex);
+    m_mutex = nullptr;
+}
+
+DDI_MEDIA_BUFFER *DdiCodecBufferPool::AcquireBuffer()
+{
+    DDI_MEDIA_BUFFER *buf = nullptr;
+
+    MosUtilities::MosLockMutex(m_mutex);
+    if (!m_freeBuffers.empty())
+    {
+        buf = m_freeBuffers.back();
+        m_freeBuffers.pop_back();
+    }
+    MosUtilities::MosUnlockMutex(m_mutex);
+
+    if (buf == nullptr)
+    {
+        buf = (DDI_MEDIA_BUFFER *)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_BUFFER));
+        if (buf == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    *buf = DDI_MEDIA_BUFFER();
+    return buf;
+}
+
+void DdiCodecBufferPool::ReleaseBuffer(DDI_MEDIA_BUFFER *buf)
+{
+    if (buf == nullptr)
+    {
+        return;
+    }
+
+    MosUtilities::MosLockMutex(m_mutex);
+    if (m_freeBuffers.size() < DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS)
+    {
+        m_freeBuffers.push_back(buf);
+        buf = nullptr;
+    }
+    MosUtilities::MosUnlockMutex(m_mutex);
+
+    MOS_FreeMemory(buf);
+}
+
+uint8_t *DdiCodecBufferPool::AcquireData(uint32_t size)
+{
+    uint8_t *data = nullptr;
+
+    if (size == 0)
+    {
+        return nullptr;
+    }
+
+    MosUtilities::MosLockMutex(m_mutex);
+    auto bucket = m_freeData.find(size);
+    if (bucket != m_freeData.end() && !bucket->second.empty())
+    {
+        data = bucket->second.back();
+        bucket->second.pop_back();
+        m_freeDataSize -= size;
+    }
+    MosUtilities::MosUnlockMutex(m_mutex);
+
+    if (data == nullptr)
+    {
+        return (uint8_t *)MOS_AllocAndZeroMemory(size);
+    }
+
+    MOS_ZeroMemory(data, size);
+    return data;
+}
+
+void DdiCodecBufferPool::ReleaseData(uint8_t *data, uint32_t size)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    MosUtilities::MosLockMutex(m_mutex);
+    if (size != 0 && size <= DDI_CODEC_BUFFER_POOL_MAX_DATA_SIZE - m_freeDataSize)
+    {
+        m_freeData[size].push_back(data);
+        m_freeDataSize += size;
+        data = nullptr;
+    }
+    MosUtilities::MosUnlockMutex(m_mutex);
+
+    MOS_FreeMemory(data);
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file     ddi_codec_buffer_pool_specific.h
+//! \brief    Defines the per context free lists of DDI buffer descriptors and CPU parameter storage.
+//!
+
+#ifndef _DDI_CODEC_BUFFER_POOL_SPECIFIC_H_
+#define _DDI_CODEC_BUFFER_POOL_SPECIFIC_H_
+
+#include <map>
+#include <vector>
+#include "media_libva_common_next.h"
+
+namespace codec
+{
+#define DDI_CODEC_BUFFER_POOL_MAX_DESCRIPTORS   256               //!< Max number of cached DDI_MEDIA_BUFFER descriptors
+#define DDI_CODEC_BUFFER_POOL_MAX_DATA_SIZE     (4 * 1024 * 1024) //!< Max bytes of cached CPU parameter storage
+
+//!
+//! \class  DdiCodecBufferPool
+//! \brief  Recycles the DDI_MEDIA_BUFFER descriptors and CPU parameter storage created by vaCreateBuffer
+//! \details Every vaCreateBuffer/vaDestroyBuffer pair used to malloc and free a descriptor plus, for
+//!          most parameter buffer types, a CPU side copy of the parameters. Applications recreate the
+//!          same buffers every frame, so the released memory is parked here and handed out again.
+//!          All memory is allocated with MOS_AllocAndZeroMemory, so anything not returned to the pool
+//!          can still be released with MOS_FreeMemory.
+//!
+class DdiCodecBufferPool
+{
+public:
+    //!
+    //! \brief Constructor
+    //!
+    DdiCodecBufferPool();
+
+    //!
+    //! \brief Destructor
+    //!
+    virtual ~DdiCodecBufferPool();
+
+    //!
+    //! \brief    Acquire a buffer descriptor
+    //!
+    //! \return   DDI_MEDIA_BUFFER*
+    //!           Default initialized descriptor, nullptr if allocation failed
+    //!
+    DDI_MEDIA_BUFFER *AcquireBuffer();
+
+    //!
+    //! \brief    Release a buffer descriptor
+    //! \details  The descriptor must not own any resource anymore
+    //!
+    //! \param    [in] buf
+    //!           Descriptor returned by AcquireBuffer or allocated by MOS_AllocAndZeroMemory
+    //!
+    void ReleaseBuffer(DDI_MEDIA_BUFFER *buf);
+
+    //!
+    //! \brief    Acquire zeroed CPU parameter storage
+    //!
+    //! \param    [in] size
+    //!           Size in bytes
+    //!
+    //! \return   uint8_t*
+    //!           Zeroed storage of exactly size bytes, nullptr if allocation failed
+    //!
+    uint8_t *AcquireData(uint32_t size);
+
+    //!
+    //! \brief    Release CPU parameter storage
+    //!
+    //! \param    [in] data
+    //!           Storage returned by AcquireData or allocated by MOS_AllocAndZeroMemory
+    //! \param    [in] size
+    //!           Size in bytes the storage was allocated with
+    //!
+    void ReleaseData(uint8_t *data, uint32_t size);
+
+private:
+    PMOS_MUTEX                                 m_mutex = nullptr;
+    std::vector<DDI_MEDIA_BUFFER *>            m_freeBuffers;
+    std::map<uint32_t, std::vector<uint8_t *>> m_freeData;      //!< Free storage keyed by size
+    uint32_t                                   m_freeDataSize = 0;
+
+MEDIA_CLASS_DEFINE_END(codec__DdiCodecBufferPool)
+};
+
+}
+#endif /*  _DDI_CODEC_BUFFER_POOL_SPECIFIC_H_ */
@@ -21,10 +21,12 @@
 if(NOT CMAKE_WDDM_LINUX)
 set(TMP_SOURCES_
     ${CMAKE_CURRENT_LIST_DIR}/ddi_codec_base_specific.cpp 
+    ${CMAKE_CURRENT_LIST_DIR}/ddi_codec_buffer_pool_specific.cpp
 )
 
 set(TMP_HEADERS_
     ${CMAKE_CURRENT_LIST_DIR}/ddi_codec_base_specific.h
+    ${CMAKE_CURRENT_LIST_DIR}/ddi_codec_buffer_pool_specific.h
 )
 
 if(NOT "${Media_Reserved}" STREQUAL "yes")
@@ -44,12 +44,9 @@ DDI_MEDIA_SURFACE* MediaLibvaCommonNext::GetSurfaceFromVASurfaceID(PDDI_MEDIA_CO
     bool validSurface = (id != VA_INVALID_SURFACE);
     if(validSurface)
     {
-        DDI_CHK_LESS(id, mediaCtx->pSurfaceHeap->uiAllocatedHeapElements, "invalid surface id", nullptr);
-        MosUtilities::MosLockMutex(&mediaCtx->SurfaceMutex);
-        surfaceElement  = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)mediaCtx->pSurfaceHeap->pHeapBase;
-        surfaceElement += id;
-        surface         = surfaceElement->pSurface;
-        MosUtilities::MosUnlockMutex(&mediaCtx->SurfaceMutex);
+        surfaceElement = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)GetHeapElement(mediaCtx->pSurfaceHeap, id, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+        DDI_CHK_NULL(surfaceElement, "invalid surface id", nullptr);
+        surface        = __atomic_load_n(&surfaceElement->pSurface, __ATOMIC_ACQUIRE);
     }
 
     return surface;
@@ -281,17 +278,90 @@ DDI_MEDIA_BUFFER* MediaLibvaCommonNext::GetBufferFromVABufferID(
     PDDI_MEDIA_BUFFER              buf = nullptr;
 
     i = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, mediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", nullptr);
-
-    MosUtilities::MosLockMutex(&mediaCtx->BufferMutex);
-    bufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)mediaCtx->pBufferHeap->pHeapBase;
-    bufHeapElement += i;
-    buf             = bufHeapElement->pBuffer;
-    MosUtilities::MosUnlockMutex(&mediaCtx->BufferMutex);
+    bufHeapElement = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)GetHeapElement(mediaCtx->pBufferHeap, i, sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
+    DDI_CHK_NULL(bufHeapElement, "invalid buffer id", nullptr);
+    buf            = __atomic_load_n(&bufHeapElement->pBuffer, __ATOMIC_ACQUIRE);
 
     return buf;
 }
 
+uint32_t MediaLibvaCommonNext::GrowHeap(
+    PDDI_MEDIA_HEAP  mediaHeap,
+    uint32_t         elementSize)
+{
+    DDI_FUNC_ENTER;
+    DDI_CHK_NULL(mediaHeap, "nullptr mediaHeap", 0);
+
+    uint32_t allocatedElements = mediaHeap->uiAllocatedHeapElements;
+    // Grow geometrically so the retired bases never add up to more than the live one
+    uint32_t growElements      = MOS_MAX(allocatedElements, DDI_MEDIA_HEAP_INCREMENTAL_SIZE);
+
+    uint8_t *newHeapBase = (uint8_t *)MOS_AllocAndZeroMemory((size_t)(allocatedElements + growElements) * elementSize);
+    DDI_CHK_NULL(newHeapBase, "DDI: heap allocation failed.", 0);
+
+    PDDI_MEDIA_RETIRED_HEAP_BASE retiredHeapBase = nullptr;
+    if (mediaHeap->pHeapBase)
+    {
+        retiredHeapBase = (PDDI_MEDIA_RETIRED_HEAP_BASE)MOS_AllocAndZeroMemory(sizeof(DDI_MEDIA_RETIRED_HEAP_BASE));
+        if (nullptr == retiredHeapBase)
+        {
+            MOS_FreeMemory(newHeapBase);
+            DDI_ASSERTMESSAGE("DDI: heap allocation failed.");
+            return 0;
+        }
+        MOS_SecureMemcpy(newHeapBase, (size_t)allocatedElements * elementSize, mediaHeap->pHeapBase, (size_t)allocatedElements * elementSize);
+
+        // Lock free readers may still be reading the old base
+        retiredHeapBase->pHeapBase  = mediaHeap->pHeapBase;
+        retiredHeapBase->pNext      = mediaHeap->pRetiredHeapBase;
+        mediaHeap->pRetiredHeapBase = retiredHeapBase;
+    }
+
+    // Publish the base before the element count, GetHeapElement loads them in reverse order
+    __atomic_store_n(&mediaHeap->pHeapBase, (void *)newHeapBase, __ATOMIC_RELEASE);
+    __atomic_store_n(&mediaHeap->uiAllocatedHeapElements, allocatedElements + growElements, __ATOMIC_RELEASE);
+
+    return growElements;
+}
+
+void MediaLibvaCommonNext::FreeHeap(PDDI_MEDIA_HEAP mediaHeap)
+{
+    DDI_FUNC_ENTER;
+    DDI_CHK_NULL(mediaHeap, "nullptr mediaHeap", );
+
+    PDDI_MEDIA_RETIRED_HEAP_BASE retiredHeapBase = mediaHeap->pRetiredHeapBase;
+    while (retiredHeapBase)
+    {
+        PDDI_MEDIA_RETIRED_HEAP_BASE next = retiredHeapBase->pNext;
+        MOS_FreeMemory(retiredHeapBase->pHeapBase);
+        MOS_FreeMemory(retiredHeapBase);
+        retiredHeapBase = next;
+    }
+    mediaHeap->pRetiredHeapBase = nullptr;
+
+    MOS_FreeMemory(mediaHeap->pHeapBase);
+    mediaHeap->pHeapBase = nullptr;
+}
+
+void* MediaLibvaCommonNext::GetHeapElement(
+    PDDI_MEDIA_HEAP  mediaHeap,
+    uint32_t         index,
+    uint32_t         elementSize)
+{
+    DDI_CHK_NULL(mediaHeap, "nullptr mediaHeap", nullptr);
+
+    uint32_t allocatedElements = __atomic_load_n(&mediaHeap->uiAllocatedHeapElements, __ATOMIC_ACQUIRE);
+    if (index >= allocatedElements)
+    {
+        return nullptr;
+    }
+
+    uint8_t *heapBase = (uint8_t *)__atomic_load_n(&mediaHeap->pHeapBase, __ATOMIC_ACQUIRE);
+    DDI_CHK_NULL(heapBase, "nullptr heapBase", nullptr);
+
+    return heapBase + (size_t)index * elementSize;
+}
+
 void* MediaLibvaCommonNext::GetVaContextFromHeap(
     PDDI_MEDIA_HEAP  mediaHeap,
     uint32_t         index,
@@ -301,16 +371,14 @@ void* MediaLibvaCommonNext::GetVaContextFromHeap(
     void                              *context      = nullptr;
     DDI_FUNC_ENTER;
 
-    MosUtilities::MosLockMutex(mutex);
-    if(nullptr == mediaHeap || index >= mediaHeap->uiAllocatedHeapElements)
+    // Heap bases are never freed before the heap itself, so the mutex is not needed for lookups
+    DDI_UNUSED(mutex);
+    vaCtxHeapElmt = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)GetHeapElement(mediaHeap, index, sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
+    if (nullptr == vaCtxHeapElmt)
     {
-        MosUtilities::MosUnlockMutex(mutex);
         return nullptr;
     }
-    vaCtxHeapElmt  = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)mediaHeap->pHeapBase;
-    vaCtxHeapElmt  += index;
-    context        = vaCtxHeapElmt->pVaContext;
-    MosUtilities::MosUnlockMutex(mutex);
+    context       = __atomic_load_n(&vaCtxHeapElmt->pVaContext, __ATOMIC_ACQUIRE);
 
     return context;
 }
@@ -381,12 +449,9 @@ uint32_t MediaLibvaCommonNext::GetCtxTypeFromVABufferID(PDDI_MEDIA_CONTEXT media
     DDI_CHK_NULL(mediaCtx->pBufferHeap, "nullptr mediaCtx->pBufferHeap", VA_STATUS_ERROR_INVALID_PARAMETER);
 
     i = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, mediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", DDI_MEDIA_CONTEXT_TYPE_NONE);
-    MosUtilities::MosLockMutex(&mediaCtx->BufferMutex);
-    bufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)mediaCtx->pBufferHeap->pHeapBase;
-    bufHeapElement  += i;
-    ctxType = bufHeapElement->uiCtxType;
-    MosUtilities::MosUnlockMutex(&mediaCtx->BufferMutex);
+    bufHeapElement = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)GetHeapElement(mediaCtx->pBufferHeap, i, sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
+    DDI_CHK_NULL(bufHeapElement, "invalid buffer id", DDI_MEDIA_CONTEXT_TYPE_NONE);
+    ctxType        = __atomic_load_n(&bufHeapElement->uiCtxType, __ATOMIC_ACQUIRE);
 
     return ctxType;
 }
@@ -400,12 +465,9 @@ void* MediaLibvaCommonNext::GetCtxFromVABufferID(PDDI_MEDIA_CONTEXT mediaCtx, VA
     DDI_CHK_NULL(mediaCtx->pBufferHeap, "nullptr mediaCtx->pBufferHeap", nullptr);
 
     i = (uint32_t)bufferID;
-    DDI_CHK_LESS(i, mediaCtx->pBufferHeap->uiAllocatedHeapElements, "invalid buffer id", nullptr);
-    MosUtilities::MosLockMutex(&mediaCtx->BufferMutex);
-    bufHeapElement  = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)mediaCtx->pBufferHeap->pHeapBase;
-    bufHeapElement += i;
-    void *temp      = bufHeapElement->pCtx;
-    MosUtilities::MosUnlockMutex(&mediaCtx->BufferMutex);
+    bufHeapElement = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)GetHeapElement(mediaCtx->pBufferHeap, i, sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
+    DDI_CHK_NULL(bufHeapElement, "invalid buffer id", nullptr);
+    void *temp     = __atomic_load_n(&bufHeapElement->pCtx, __ATOMIC_ACQUIRE);
 
     return temp;
 }
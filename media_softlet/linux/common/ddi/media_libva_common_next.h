@@ -64,6 +64,10 @@
 
 #define DDI_MEDIA_MAX_COLOR_PLANES                 4       //Maximum color planes supported by media driver, like (A/R/G/B in different planes)
 
+#define DDI_MEDIA_SHADOW_BAND_HEIGHT               32      // Rows per band of the system shadow, one row of TileY/Tile4 tiles
+#define DDI_MEDIA_SHADOW_BAND_VALID                0x1     // Band is detiled into the system shadow
+#define DDI_MEDIA_SHADOW_BAND_DIRTY                0x2     // Band was mapped for write and must be retiled on unlock
+
 #define DDI_CODEC_GEN_CONFIG_ATTRIBUTES_DEC_BASE   0       // Dec config_id starts at this value
 #define DDI_CODEC_GEN_CONFIG_ATTRIBUTES_DEC_MAX    1023
 #define DDI_CODEC_GEN_CONFIG_ATTRIBUTES_ENC_BASE   1024    // Enc config_id starts at this value
@@ -252,6 +256,8 @@ typedef struct _DDI_MEDIA_SURFACE
     PMEDIA_SEM_T            pReferenceFrameSemaphore; // to sync reference frame surface. when this semaphore is posted, the surface is not used as reference frame, and safe to be destroied
 
     uint8_t                 *pSystemShadow;           // Shadow surface in system memory
+    uint8_t                 *pShadowBandState;        // DDI_MEDIA_SHADOW_BAND_* flags per band of pSystemShadow
+    uint32_t                uiShadowBandCount;
     _DDI_MEDIA_BUFFER       *pShadowBuffer;
 
     uint32_t                uiMapFlag;
@@ -321,12 +327,19 @@ typedef struct _DDI_MEDIA_VACONTEXT_HEAP_ELEMENT
     struct _DDI_MEDIA_VACONTEXT_HEAP_ELEMENT   *pNextFree;
 }DDI_MEDIA_VACONTEXT_HEAP_ELEMENT, *PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT;
 
+typedef struct _DDI_MEDIA_RETIRED_HEAP_BASE
+{
+    void                                   *pHeapBase;
+    struct _DDI_MEDIA_RETIRED_HEAP_BASE    *pNext;
+}DDI_MEDIA_RETIRED_HEAP_BASE, *PDDI_MEDIA_RETIRED_HEAP_BASE;
+
 typedef struct _DDI_MEDIA_HEAP
 {
     void               *pHeapBase;
     uint32_t           uiHeapElementSize;
     uint32_t           uiAllocatedHeapElements;
     void               *pFirstFreeHeapElement;
+    PDDI_MEDIA_RETIRED_HEAP_BASE pRetiredHeapBase;  // Heap bases replaced on growth, kept for lock free readers until the heap is destroyed
 }DDI_MEDIA_HEAP, *PDDI_MEDIA_HEAP;
 
 #ifndef ANDROID
@@ -456,6 +469,45 @@ public:
     //!
     static void MediaSurfaceToMosResource(DDI_MEDIA_SURFACE *mediaSurface, MOS_RESOURCE *mhalOsResource);
 
+    //!
+    //! \brief  Grow media heap
+    //! \details Allocates a larger heap base, copies the existing elements and appends zeroed
+    //!          ones. The previous base is retired rather than freed so lookups through
+    //!          GetHeapElement never need the heap mutex. Must be called with the heap mutex held.
+    //!
+    //! \param  [in] mediaHeap
+    //!         Pointer to ddi media heap
+    //! \param  [in] elementSize
+    //!         Size of one heap element
+    //!
+    //! \return uint32_t
+    //!         Number of elements appended starting at the previous element count, 0 if failed
+    //!
+    static uint32_t GrowHeap(PDDI_MEDIA_HEAP mediaHeap, uint32_t elementSize);
+
+    //!
+    //! \brief  Free media heap base and all retired heap bases
+    //!
+    //! \param  [in] mediaHeap
+    //!         Pointer to ddi media heap
+    //!
+    static void FreeHeap(PDDI_MEDIA_HEAP mediaHeap);
+
+    //!
+    //! \brief  Get heap element without holding the heap mutex
+    //!
+    //! \param  [in] mediaHeap
+    //!         Pointer to ddi media heap
+    //! \param  [in] index
+    //!         Element index
+    //! \param  [in] elementSize
+    //!         Size of one heap element
+    //!
+    //! \return void*
+    //!         Pointer to heap element, nullptr if index is out of range
+    //!
+    static void* GetHeapElement(PDDI_MEDIA_HEAP mediaHeap, uint32_t index, uint32_t elementSize);
+
     //!
     //! \brief  Get PVA context from heap
     //!
@@ -675,25 +675,25 @@ VAStatus MediaLibvaInterfaceNext::HeapDestroy(PDDI_MEDIA_CONTEXT mediaCtx)
 
     DDI_CHK_NULL(mediaCtx, "nullptr ctx", VA_STATUS_ERROR_INVALID_CONTEXT);
     // destroy heaps
-    MOS_FreeMemory(mediaCtx->pSurfaceHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pSurfaceHeap);
     MOS_FreeMemory(mediaCtx->pSurfaceHeap);
 
-    MOS_FreeMemory(mediaCtx->pBufferHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pBufferHeap);
     MOS_FreeMemory(mediaCtx->pBufferHeap);
 
-    MOS_FreeMemory(mediaCtx->pImageHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pImageHeap);
     MOS_FreeMemory(mediaCtx->pImageHeap);
 
-    MOS_FreeMemory(mediaCtx->pDecoderCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pDecoderCtxHeap);
     MOS_FreeMemory(mediaCtx->pDecoderCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pEncoderCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pEncoderCtxHeap);
     MOS_FreeMemory(mediaCtx->pEncoderCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pVpCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pVpCtxHeap);
     MOS_FreeMemory(mediaCtx->pVpCtxHeap);
 
-    MOS_FreeMemory(mediaCtx->pProtCtxHeap->pHeapBase);
+    MediaLibvaCommonNext::FreeHeap(mediaCtx->pProtCtxHeap);
     MOS_FreeMemory(mediaCtx->pProtCtxHeap);
 
     // destroy the mutexs
@@ -1498,14 +1498,10 @@ VAImage* MediaLibvaInterfaceNext::GetVAImageFromVAImageID(PDDI_MEDIA_CONTEXT med
     DDI_CHK_NULL(mediaCtx, "nullptr mediaCtx", nullptr);
 
     uint32_t i       = (uint32_t)imageID;
-    DDI_CHK_LESS(i, mediaCtx->pImageHeap->uiAllocatedHeapElements, "invalid image id", nullptr);
-    MosUtilities::MosLockMutex(&mediaCtx->ImageMutex);
-
-    PDDI_MEDIA_IMAGE_HEAP_ELEMENT imageElement = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)mediaCtx->pImageHeap->pHeapBase;
-    imageElement    += i;
-    VAImage *vaImage = imageElement->pImage;
-
-    MosUtilities::MosUnlockMutex(&mediaCtx->ImageMutex);
+    PDDI_MEDIA_IMAGE_HEAP_ELEMENT imageElement = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)MediaLibvaCommonNext::GetHeapElement(
+        mediaCtx->pImageHeap, i, sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
+    DDI_CHK_NULL(imageElement, "invalid image id", nullptr);
+    VAImage *vaImage = __atomic_load_n(&imageElement->pImage, __ATOMIC_ACQUIRE);
 
     return vaImage;
 }
@@ -1559,17 +1555,55 @@ void MediaLibvaInterfaceNext::CopyPlane(
     uint32_t dstPitch,
     uint8_t  *src,
     uint32_t srcPitch,
-    uint32_t height)
+    uint32_t height,
+    bool     srcIsWC)
 {
+    // Plain loads from write-combined memory are uncached
+    if (dstPitch == srcPitch)
+    {
+        // Same layout, copy the plane at once
+        size_t planeSize = (size_t)dstPitch * height;
+        if (srcIsWC)
+        {
+            MosUtilities::MosSecureMemcpyFromWC(dst, planeSize, src, planeSize);
+        }
+        else
+        {
+            MosUtilities::MosSecureMemcpy(dst, planeSize, src, planeSize);
+        }
+        return;
+    }
+
     uint32_t rowSize = std::min(dstPitch, srcPitch);
-    for (int y = 0; y < height; y += 1)
+    for (uint32_t y = 0; y < height; y += 1)
     {
-        MOS_SecureMemcpy(dst, rowSize, src, rowSize);
+        if (srcIsWC)
+        {
+            // One fence before the first row orders the whole plane
+            MosUtilities::MosSecureMemcpyFromWC(dst, rowSize, src, rowSize, y == 0);
+        }
+        else
+        {
+            MosUtilities::MosSecureMemcpy(dst, rowSize, src, rowSize);
+        }
         dst += dstPitch;
         src += srcPitch;
     }
 }
 
+bool MediaLibvaInterfaceNext::IsSurfaceDataWC(
+    DDI_MEDIA_SURFACE *surface,
+    void              *data)
+{
+    if (surface == nullptr || data == nullptr || data == surface->pSystemShadow)
+    {
+        return false;
+    }
+
+    MOS_LINUX_BO *bo = surface->pShadowBuffer ? surface->pShadowBuffer->bo : surface->bo;
+    return bo != nullptr && mos_bo_is_mapped_wc(bo);
+}
+
 VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
     VADriverContextP  ctx,
     DDI_MEDIA_SURFACE *surface,
@@ -1595,7 +1629,8 @@ VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
         }
     }
 
-    void *surfData = MediaLibvaUtilNext::LockSurface(surface, flag);
+    // Only the rows copied below are detiled when the surface is SW swizzled
+    void *surfData = MediaLibvaUtilNext::LockSurfaceRegion(surface, flag, 0, image->height);
     if (surfData == nullptr)
     {
         DDI_ASSERTMESSAGE("nullptr surfData.");
@@ -1613,8 +1648,9 @@ VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
 
     uint8_t *ySrc = (uint8_t*)surfData;
     uint8_t *yDst = (uint8_t*)imageData;
+    bool srcIsWC  = IsSurfaceDataWC(surface, surfData);
 
-    CopyPlane(yDst, image->pitches[0], ySrc, surface->iPitch, image->height);
+    CopyPlane(yDst, image->pitches[0], ySrc, surface->iPitch, image->height, srcIsWC);
     if (image->num_planes > 1)
     {
         uint8_t *uSrc = ySrc + surface->iPitch * surface->iHeight;
@@ -1625,13 +1661,24 @@ VAStatus MediaLibvaInterfaceNext::CopySurfaceToImage(
         uint32_t imageChromaHeight = 0;
         GetChromaPitchHeight(MediaFormatToOsFormat(surface->format), surface->iPitch, surface->iHeight, &chromaPitch, &chromaHeight);
         GetChromaPitchHeight(image->format.fourcc, image->pitches[0], image->height, &imageChromaPitch, &imageChromaHeight);
-        CopyPlane(uDst, image->pitches[1], uSrc, chromaPitch, imageChromaHeight);
+
+        uint64_t chromaSize = (uint64_t)chromaPitch * imageChromaHeight;
+        if (image->num_planes > 2)
+        {
+            chromaSize += (uint64_t)chromaPitch * chromaHeight;
+        }
+        if (surface->iPitch > 0)
+        {
+            MediaLibvaUtilNext::SyncSurfaceShadowRows(surface, flag, surface->iHeight, (uint32_t)MOS_ROUNDUP_DIVIDE(chromaSize, (uint64_t)surface->iPitch));
+        }
+
+        CopyPlane(uDst, image->pitches[1], uSrc, chromaPitch, imageChromaHeight, srcIsWC);
 
         if(image->num_planes > 2)
         {
             uint8_t *vSrc = uSrc + chromaPitch * chromaHeight;
             uint8_t *vDst = yDst + image->offsets[2];
-            CopyPlane(vDst, image->pitches[2], vSrc, chromaPitch, imageChromaHeight);
+            CopyPlane(vDst, image->pitches[2], vSrc, chromaPitch, imageChromaHeight, srcIsWC);
         }
     }
 
@@ -1961,9 +2008,15 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
         }
         else
         {
+            bool srcIsWC = false;
+            if (Media_Format_CPU != buf->format)
+            {
+                srcIsWC = buf->pSurface ? IsSurfaceDataWC(buf->pSurface, imageData) : (buf->bo != nullptr && mos_bo_is_mapped_wc(buf->bo));
+            }
+
             uint8_t *ySrc = (uint8_t *)imageData + vaimg->offsets[0];
             uint8_t *yDst = (uint8_t *)surfData;
-            CopyPlane(yDst, mediaSurface->iPitch, ySrc, vaimg->pitches[0], srcHeight);
+            CopyPlane(yDst, mediaSurface->iPitch, ySrc, vaimg->pitches[0], srcHeight, srcIsWC);
 
             if (vaimg->num_planes > 1)
             {
@@ -1975,12 +2028,12 @@ VAStatus MediaLibvaInterfaceNext::PutImage(
 
                 uint8_t *uSrc = (uint8_t *)imageData + vaimg->offsets[1];
                 uint8_t *uDst = yDst + mediaSurface->iPitch * mediaSurface->iHeight;
-                CopyPlane(uDst, chromaPitch, uSrc, vaimg->pitches[1], chromaHeight);
+                CopyPlane(uDst, chromaPitch, uSrc, vaimg->pitches[1], chromaHeight, srcIsWC);
                 if (vaimg->num_planes > 2)
                 {
                     uint8_t *vSrc = (uint8_t *)imageData + vaimg->offsets[2];
                     uint8_t *vDst = uDst + chromaPitch * chromaHeight;
-                    CopyPlane(vDst, chromaPitch, vSrc, vaimg->pitches[2], chromaHeight);
+                    CopyPlane(vDst, chromaPitch, vSrc, vaimg->pitches[2], chromaHeight, srcIsWC);
                 }
             }
         } 
@@ -1556,13 +1556,31 @@ private:
     //!         Source plane pitch
     //! \param  [in] height
     //!         Plane hight
+    //! \param  [in] srcIsWC
+    //!         Source is mapped write-combined, read it with streaming loads
     //!
     static void CopyPlane(
         uint8_t  *dst,
         uint32_t dstPitch,
         uint8_t  *src,
         uint32_t srcPitch,
-        uint32_t height);
+        uint32_t height,
+        bool     srcIsWC);
+
+    //!
+    //! \brief  Check if locked surface data is a write-combined mapping
+    //!
+    //! \param  [in] surface
+    //!         Locked media surface
+    //! \param  [in] data
+    //!         Pointer returned by the surface lock
+    //!
+    //! \return bool
+    //!         true for GTT and WC mappings, false for the system shadow and WB mappings
+    //!
+    static bool IsSurfaceDataWC(
+        DDI_MEDIA_SURFACE *surface,
+        void              *data);
 
     //!
     //! \brief  Map CompType from entrypoint
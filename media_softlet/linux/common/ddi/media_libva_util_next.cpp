@@ -843,23 +843,21 @@ PDDI_MEDIA_SURFACE_HEAP_ELEMENT MediaLibvaUtilNext::AllocPMediaSurfaceFromHeap(P
 
     if (nullptr == surfaceHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(surfaceHeap->pHeapBase, (surfaceHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
-
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = surfaceHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(surfaceHeap, sizeof(DDI_MEDIA_SURFACE_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        surfaceHeap->pHeapBase                    = newHeapBase;
-        PDDI_MEDIA_SURFACE_HEAP_ELEMENT surfaceHeapBase  = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pHeapBase;
-        surfaceHeap->pFirstFreeHeapElement        = (void*)(&surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_SURFACE_HEAP_ELEMENT surfaceHeapBase = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pHeapBase;
+        surfaceHeap->pFirstFreeHeapElement              = (void*)(&surfaceHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            mediaSurfaceHeapElmt                  = &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i];
-            mediaSurfaceHeapElmt->pNextFree       = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &surfaceHeapBase[surfaceHeap->uiAllocatedHeapElements + i + 1];
-            mediaSurfaceHeapElmt->uiVaSurfaceID   = surfaceHeap->uiAllocatedHeapElements + i;
+            mediaSurfaceHeapElmt                = &surfaceHeapBase[firstNewElement + i];
+            mediaSurfaceHeapElmt->pNextFree     = (i == (newElements - 1)) ? nullptr : &surfaceHeapBase[firstNewElement + i + 1];
+            mediaSurfaceHeapElmt->uiVaSurfaceID = firstNewElement + i;
         }
-        surfaceHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     mediaSurfaceHeapElmt                          = (PDDI_MEDIA_SURFACE_HEAP_ELEMENT)surfaceHeap->pFirstFreeHeapElement;
@@ -1138,9 +1136,10 @@ void* MediaLibvaUtilNext::LockSurface(DDI_MEDIA_SURFACE *surface, uint32_t flag)
          {
             LockSurfaceInternal(surface, flag);
          }
-         else
+         else if (surface->pShadowBandState != nullptr)
          {
-             // do nothing here
+             // Already locked by region, the whole shadow must be valid now
+             SyncSurfaceShadowRows(surface, flag, 0, surface->uiShadowBandCount * DDI_MEDIA_SHADOW_BAND_HEIGHT);
          }
          surface->iRefCount++;
     }
@@ -1148,7 +1147,86 @@ void* MediaLibvaUtilNext::LockSurface(DDI_MEDIA_SURFACE *surface, uint32_t flag)
     return surface->pData;
 }
 
-void* MediaLibvaUtilNext::LockSurfaceInternal(DDI_MEDIA_SURFACE  *surface, uint32_t flag)
+void* MediaLibvaUtilNext::LockSurfaceRegion(DDI_MEDIA_SURFACE *surface, uint32_t flag, uint32_t rowOffset, uint32_t rowCount)
+{
+    DDI_FUNC_ENTER;
+    DDI_CHK_NULL(surface,            "nullptr surface",            nullptr);
+    DDI_CHK_NULL(surface->pMediaCtx, "nullptr surface->pMediaCtx", nullptr);
+
+    if (MEDIA_IS_SKU(&surface->pMediaCtx->SkuTable, FtrLocalMemory))
+    {
+        // Local memory surfaces are swizzled by HW into a shadow buffer as a whole
+        return LockSurface(surface, flag);
+    }
+
+    if ((surface->iRefCount == 0) && (false == surface->bMapped))
+    {
+        LockSurfaceInternal(surface, flag, true);
+    }
+    if (SyncSurfaceShadowRows(surface, flag, rowOffset, rowCount) != VA_STATUS_SUCCESS)
+    {
+        DDI_ASSERTMESSAGE("Failed to swizzle surface rows into shadow.");
+    }
+    surface->iRefCount++;
+
+    return surface->pData;
+}
+
+VAStatus MediaLibvaUtilNext::SyncSurfaceShadowRows(DDI_MEDIA_SURFACE *surface, uint32_t flag, uint32_t rowOffset, uint32_t rowCount)
+{
+    VAStatus vaStatus = VA_STATUS_SUCCESS;
+    DDI_FUNC_ENTER;
+    DDI_CHK_NULL(surface, "nullptr surface", VA_STATUS_ERROR_INVALID_SURFACE);
+
+    if (surface->pShadowBandState == nullptr || surface->pSystemShadow == nullptr || rowCount == 0)
+    {
+        // Not swizzled through a system shadow, every row is accessible
+        return VA_STATUS_SUCCESS;
+    }
+    DDI_CHK_NULL(surface->bo,       "nullptr surface->bo",       VA_STATUS_ERROR_INVALID_SURFACE);
+    DDI_CHK_NULL(surface->bo->virt, "nullptr surface->bo->virt", VA_STATUS_ERROR_INVALID_SURFACE);
+
+    uint8_t  *bandState = surface->pShadowBandState;
+    uint32_t firstBand  = rowOffset / DDI_MEDIA_SHADOW_BAND_HEIGHT;
+    uint32_t endBand    = (uint32_t)MOS_MIN(MOS_ROUNDUP_DIVIDE((uint64_t)rowOffset + rowCount, DDI_MEDIA_SHADOW_BAND_HEIGHT),
+                                            (uint64_t)surface->uiShadowBandCount);
+    uint8_t  dirty      = (flag & MOS_LOCKFLAG_WRITEONLY) ? DDI_MEDIA_SHADOW_BAND_DIRTY : 0;
+
+    uint32_t band = firstBand;
+    while (band < endBand)
+    {
+        if (bandState[band] & DDI_MEDIA_SHADOW_BAND_VALID)
+        {
+            bandState[band] |= dirty;
+            band++;
+            continue;
+        }
+
+        // Detile consecutive invalid bands with one blt
+        uint32_t last = band;
+        while (last < endBand && !(bandState[last] & DDI_MEDIA_SHADOW_BAND_VALID))
+        {
+            last++;
+        }
+        vaStatus = SwizzleSurfaceRows(surface->pMediaCtx,
+                                      surface->pGmmResourceInfo,
+                                      surface->bo->virt,
+                                      surface->pSystemShadow,
+                                      band * DDI_MEDIA_SHADOW_BAND_HEIGHT,
+                                      (last - band) * DDI_MEDIA_SHADOW_BAND_HEIGHT,
+                                      false);
+        DDI_CHK_RET(vaStatus, "SwizzleSurfaceRows failed");
+
+        for (; band < last; band++)
+        {
+            bandState[band] = DDI_MEDIA_SHADOW_BAND_VALID | dirty;
+        }
+    }
+
+    return vaStatus;
+}
+
+void* MediaLibvaUtilNext::LockSurfaceInternal(DDI_MEDIA_SURFACE  *surface, uint32_t flag, bool lazySwizzle)
 {
     int      err      = 0;
     uint64_t surfSize = 0;
@@ -1211,13 +1289,27 @@ void* MediaLibvaUtilNext::LockSurfaceInternal(DDI_MEDIA_SURFACE  *surface, uint3
                     DDI_CHK_CONDITION((surface->pSystemShadow == nullptr), "Failed to allocate shadow surface", nullptr);
                 }
 
-                vaStatus = SwizzleSurface(surface->pMediaCtx,
-                                                   surface->pGmmResourceInfo,
-                                                   surface->bo->virt,
-                                                   (MOS_TILE_TYPE)surface->TileType,
-                                                   (uint8_t *)surface->pSystemShadow,
-                                                   false);
-                DDI_CHK_CONDITION((vaStatus != VA_STATUS_SUCCESS), "SwizzleSurface failed", nullptr);
+                if (surface->pShadowBandState == nullptr)
+                {
+                    surface->uiShadowBandCount = MOS_ROUNDUP_DIVIDE(surface->bo->size / surface->iPitch, DDI_MEDIA_SHADOW_BAND_HEIGHT);
+                    surface->pShadowBandState  = (uint8_t *)MOS_AllocAndZeroMemory(surface->uiShadowBandCount);
+                    DDI_CHK_CONDITION((surface->pShadowBandState == nullptr), "Failed to allocate shadow band state", nullptr);
+                }
+
+                // Lazy locks detile rows on demand through SyncSurfaceShadowRows
+                if (!lazySwizzle)
+                {
+                    vaStatus = SwizzleSurface(surface->pMediaCtx,
+                                                       surface->pGmmResourceInfo,
+                                                       surface->bo->virt,
+                                                       (MOS_TILE_TYPE)surface->TileType,
+                                                       (uint8_t *)surface->pSystemShadow,
+                                                       false);
+                    DDI_CHK_CONDITION((vaStatus != VA_STATUS_SUCCESS), "SwizzleSurface failed", nullptr);
+
+                    uint8_t bandState = DDI_MEDIA_SHADOW_BAND_VALID | ((flag & MOS_LOCKFLAG_WRITEONLY) ? DDI_MEDIA_SHADOW_BAND_DIRTY : 0);
+                    MOS_FillMemory(surface->pShadowBandState, surface->uiShadowBandCount, bandState);
+                }
             }
 
         }
@@ -1289,12 +1381,46 @@ void MediaLibvaUtilNext::UnlockSurface(DDI_MEDIA_SURFACE  *surface)
             }
             else if (surface->pSystemShadow)
             {
-                SwizzleSurface(surface->pMediaCtx,
-                               surface->pGmmResourceInfo,
-                               surface->bo->virt,
-                               (MOS_TILE_TYPE)surface->TileType,
-                               (uint8_t *)surface->pSystemShadow,
-                               true);
+                if (surface->pShadowBandState != nullptr)
+                {
+                    // Retile only the bands which were locked for write
+                    uint32_t band = 0;
+                    while (band < surface->uiShadowBandCount)
+                    {
+                        if (!(surface->pShadowBandState[band] & DDI_MEDIA_SHADOW_BAND_DIRTY))
+                        {
+                            band++;
+                            continue;
+                        }
+
+                        uint32_t last = band;
+                        while (last < surface->uiShadowBandCount && (surface->pShadowBandState[last] & DDI_MEDIA_SHADOW_BAND_DIRTY))
+                        {
+                            last++;
+                        }
+                        SwizzleSurfaceRows(surface->pMediaCtx,
+                                           surface->pGmmResourceInfo,
+                                           surface->bo->virt,
+                                           surface->pSystemShadow,
+                                           band * DDI_MEDIA_SHADOW_BAND_HEIGHT,
+                                           (last - band) * DDI_MEDIA_SHADOW_BAND_HEIGHT,
+                                           true);
+                        band = last;
+                    }
+
+                    MOS_FreeMemory(surface->pShadowBandState);
+                    surface->pShadowBandState  = nullptr;
+                    surface->uiShadowBandCount = 0;
+                }
+                else
+                {
+                    SwizzleSurface(surface->pMediaCtx,
+                                   surface->pGmmResourceInfo,
+                                   surface->bo->virt,
+                                   (MOS_TILE_TYPE)surface->TileType,
+                                   (uint8_t *)surface->pSystemShadow,
+                                   true);
+                }
 
                 MOS_DeleteArray(surface->pSystemShadow);
                 surface->pSystemShadow = nullptr;
@@ -1496,6 +1622,57 @@ VAStatus MediaLibvaUtilNext::SwizzleSurface(
     return vaStatus;
 }
 
+VAStatus MediaLibvaUtilNext::SwizzleSurfaceRows(
+    PDDI_MEDIA_CONTEXT         mediaCtx,
+    PGMM_RESOURCE_INFO         pGmmResInfo,
+    void                       *pLockedAddr,
+    uint8_t                    *pResourceBase,
+    uint32_t                   rowOffset,
+    uint32_t                   rowCount,
+    bool                       bUpload)
+{
+    uint32_t            uiSize        = 0, uiPitch = 0, uiRows = 0;
+    GMM_RES_COPY_BLT    gmmResCopyBlt = {0};
+    bool                isPlanar      = false;
+    DDI_FUNC_ENTER;
+
+    DDI_CHK_NULL(mediaCtx,      "mediaCtx is NULL",      VA_STATUS_ERROR_INVALID_CONTEXT);
+    DDI_CHK_NULL(pGmmResInfo,   "pGmmResInfo is NULL",   VA_STATUS_ERROR_OPERATION_FAILED);
+    DDI_CHK_NULL(pLockedAddr,   "pLockedAddr is NULL",   VA_STATUS_ERROR_OPERATION_FAILED);
+    DDI_CHK_NULL(pResourceBase, "pResourceBase is NULL", VA_STATUS_ERROR_ALLOCATION_FAILED);
+
+    uiSize   = pGmmResInfo->GetSizeSurface();
+    uiPitch  = pGmmResInfo->GetRenderPitch();
+    DDI_CHK_CONDITION((uiPitch == 0), "Invalid pitch", VA_STATUS_ERROR_OPERATION_FAILED);
+    isPlanar = mediaCtx->pGmmClientContext->IsPlanar(pGmmResInfo->GetResourceFormat());
+
+    // Same extent as SwizzleSurface, planar surfaces are copied as one tall plane
+    uiRows = isPlanar ? uiSize / uiPitch : pGmmResInfo->GetBaseHeight();
+    if (rowOffset >= uiRows || rowCount == 0)
+    {
+        return VA_STATUS_SUCCESS;
+    }
+    rowCount = MOS_MIN(rowCount, uiRows - rowOffset);
+
+    gmmResCopyBlt.Gpu.pData      = pLockedAddr;
+    gmmResCopyBlt.Gpu.OffsetY    = rowOffset;
+    gmmResCopyBlt.Sys.pData      = pResourceBase + (uint64_t)rowOffset * uiPitch;
+    gmmResCopyBlt.Sys.RowPitch   = uiPitch;
+    gmmResCopyBlt.Sys.BufferSize = uiSize - rowOffset * uiPitch;
+    gmmResCopyBlt.Sys.SlicePitch = gmmResCopyBlt.Sys.BufferSize;
+    gmmResCopyBlt.Blt.Slices     = 1;
+    gmmResCopyBlt.Blt.Upload     = bUpload;
+    gmmResCopyBlt.Blt.Height     = rowCount;
+    if (isPlanar)
+    {
+        gmmResCopyBlt.Blt.Width  = pGmmResInfo->GetBaseWidth();
+    }
+
+    pGmmResInfo->CpuBlt(&gmmResCopyBlt);
+
+    return VA_STATUS_SUCCESS;
+}
+
 void MediaLibvaUtilNext::ReleasePMediaBufferFromHeap(
     PDDI_MEDIA_HEAP  bufferHeap,
     uint32_t         vaBufferID)
@@ -1776,22 +1953,21 @@ PDDI_MEDIA_BUFFER_HEAP_ELEMENT MediaLibvaUtilNext::AllocPMediaBufferFromHeap(PDD
     PDDI_MEDIA_BUFFER_HEAP_ELEMENT  mediaBufferHeapElmt = nullptr;
     if (nullptr == bufferHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(bufferHeap->pHeapBase, (bufferHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = bufferHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(bufferHeap, sizeof(DDI_MEDIA_BUFFER_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        bufferHeap->pHeapBase                                 = newHeapBase;
-        PDDI_MEDIA_BUFFER_HEAP_ELEMENT mediaBufferHeapBase    = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pHeapBase;
-        bufferHeap->pFirstFreeHeapElement     = (void*)(&mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_BUFFER_HEAP_ELEMENT mediaBufferHeapBase = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pHeapBase;
+        bufferHeap->pFirstFreeHeapElement                  = (void*)(&mediaBufferHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            mediaBufferHeapElmt               = &mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements + i];
-            mediaBufferHeapElmt->pNextFree    = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &mediaBufferHeapBase[bufferHeap->uiAllocatedHeapElements + i + 1];
-            mediaBufferHeapElmt->uiVaBufferID = bufferHeap->uiAllocatedHeapElements + i;
+            mediaBufferHeapElmt               = &mediaBufferHeapBase[firstNewElement + i];
+            mediaBufferHeapElmt->pNextFree    = (i == (newElements - 1)) ? nullptr : &mediaBufferHeapBase[firstNewElement + i + 1];
+            mediaBufferHeapElmt->uiVaBufferID = firstNewElement + i;
         }
-        bufferHeap->uiAllocatedHeapElements  += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     mediaBufferHeapElmt                       = (PDDI_MEDIA_BUFFER_HEAP_ELEMENT)bufferHeap->pFirstFreeHeapElement;
@@ -1807,24 +1983,21 @@ PDDI_MEDIA_IMAGE_HEAP_ELEMENT MediaLibvaUtilNext::AllocPVAImageFromHeap(PDDI_MED
 
     if (nullptr == imageHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(imageHeap->pHeapBase, (imageHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
-
-        if (nullptr == newHeapBase)
+        uint32_t firstNewElement = imageHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(imageHeap, sizeof(DDI_MEDIA_IMAGE_HEAP_ELEMENT));
+        if (0 == newElements)
         {
-            DDI_ASSERTMESSAGE("DDI: realloc failed.");
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
             return nullptr;
         }
-        imageHeap->pHeapBase                           = newHeapBase;
-        PDDI_MEDIA_IMAGE_HEAP_ELEMENT vaimageHeapBase  = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pHeapBase;
-        imageHeap->pFirstFreeHeapElement               = (void*)(&vaimageHeapBase[imageHeap->uiAllocatedHeapElements]);
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        PDDI_MEDIA_IMAGE_HEAP_ELEMENT vaimageHeapBase = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pHeapBase;
+        imageHeap->pFirstFreeHeapElement              = (void*)(&vaimageHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            vaimageHeapElmt                   = &vaimageHeapBase[imageHeap->uiAllocatedHeapElements + i];
-            vaimageHeapElmt->pNextFree        = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &vaimageHeapBase[imageHeap->uiAllocatedHeapElements + i + 1];
-            vaimageHeapElmt->uiVaImageID      = imageHeap->uiAllocatedHeapElements + i;
+            vaimageHeapElmt              = &vaimageHeapBase[firstNewElement + i];
+            vaimageHeapElmt->pNextFree   = (i == (newElements - 1)) ? nullptr : &vaimageHeapBase[firstNewElement + i + 1];
+            vaimageHeapElmt->uiVaImageID = firstNewElement + i;
         }
-        imageHeap->uiAllocatedHeapElements   += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
-
     }
 
     vaimageHeapElmt                           = (PDDI_MEDIA_IMAGE_HEAP_ELEMENT)imageHeap->pFirstFreeHeapElement;
@@ -2022,21 +2195,21 @@ PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT MediaLibvaUtilNext::DdiAllocPVAContextFromHeap
 
     if (nullptr == vaContextHeap->pFirstFreeHeapElement)
     {
-        void *newHeapBase = MOS_ReallocMemory(vaContextHeap->pHeapBase, (vaContextHeap->uiAllocatedHeapElements + DDI_MEDIA_HEAP_INCREMENTAL_SIZE) * sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
-        DDI_CHK_NULL(newHeapBase, "DDI: realloc failed.", nullptr);
-
-        vaContextHeap->pHeapBase                            = newHeapBase;
+        uint32_t firstNewElement = vaContextHeap->uiAllocatedHeapElements;
+        uint32_t newElements     = MediaLibvaCommonNext::GrowHeap(vaContextHeap, sizeof(DDI_MEDIA_VACONTEXT_HEAP_ELEMENT));
+        if (0 == newElements)
+        {
+            DDI_ASSERTMESSAGE("DDI: heap growth failed.");
+            return nullptr;
+        }
         PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT vacontextHeapBase = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)vaContextHeap->pHeapBase;
-        DDI_CHK_NULL(vacontextHeapBase, "nullptr vacontextHeapBase.", nullptr);
-        vaContextHeap->pFirstFreeHeapElement        = (void*)(&(vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements]));
-        for (int32_t i = 0; i < (DDI_MEDIA_HEAP_INCREMENTAL_SIZE); i++)
+        vaContextHeap->pFirstFreeHeapElement                = (void*)(&vacontextHeapBase[firstNewElement]);
+        for (uint32_t i = 0; i < newElements; i++)
         {
-            vacontextHeapElmt                       = &vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements + i];
-            vacontextHeapElmt->pNextFree            = (i == (DDI_MEDIA_HEAP_INCREMENTAL_SIZE - 1))? nullptr : &vacontextHeapBase[vaContextHeap->uiAllocatedHeapElements + i + 1];
-            vacontextHeapElmt->uiVaContextID        = vaContextHeap->uiAllocatedHeapElements + i;
-            vacontextHeapElmt->pVaContext           = nullptr;
+            vacontextHeapElmt                = &vacontextHeapBase[firstNewElement + i];
+            vacontextHeapElmt->pNextFree     = (i == (newElements - 1)) ? nullptr : &vacontextHeapBase[firstNewElement + i + 1];
+            vacontextHeapElmt->uiVaContextID = firstNewElement + i;
         }
-        vaContextHeap->uiAllocatedHeapElements     += DDI_MEDIA_HEAP_INCREMENTAL_SIZE;
     }
 
     vacontextHeapElmt                    = (PDDI_MEDIA_VACONTEXT_HEAP_ELEMENT)vaContextHeap->pFirstFreeHeapElement;
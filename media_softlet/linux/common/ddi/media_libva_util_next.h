@@ -582,6 +582,45 @@ public:
     //!
     static void* LockSurface(DDI_MEDIA_SURFACE  *surface, uint32_t flag);
 
+    //!
+    //! \brief  Lock surface for access to a range of rows
+    //! \details When the surface is software swizzled into a system shadow,
+    //!          only the requested rows are detiled, and only rows locked with
+    //!          MOS_LOCKFLAG_WRITEONLY are retiled on unlock. More rows can be
+    //!          made available later through SyncSurfaceShadowRows. Otherwise
+    //!          it behaves as LockSurface.
+    //!
+    //! \param  [in] surface
+    //!         Ddi media surface
+    //! \param  [in] flag
+    //!         Flag
+    //! \param  [in] rowOffset
+    //!         First row to access, counted from the start of the surface
+    //! \param  [in] rowCount
+    //!         Number of rows to access
+    //!
+    //! \return void*
+    //!     Pointer to lock surface data
+    //!
+    static void* LockSurfaceRegion(DDI_MEDIA_SURFACE *surface, uint32_t flag, uint32_t rowOffset, uint32_t rowCount);
+
+    //!
+    //! \brief  Make rows of a locked surface valid in its system shadow
+    //!
+    //! \param  [in] surface
+    //!         Ddi media surface
+    //! \param  [in] flag
+    //!         Flag, rows are marked dirty if MOS_LOCKFLAG_WRITEONLY is set
+    //! \param  [in] rowOffset
+    //!         First row to access, counted from the start of the surface
+    //! \param  [in] rowCount
+    //!         Number of rows to access
+    //!
+    //! \return VAStatus
+    //!     VA_STATUS_SUCCESS if success, else fail reason
+    //!
+    static VAStatus SyncSurfaceShadowRows(DDI_MEDIA_SURFACE *surface, uint32_t flag, uint32_t rowOffset, uint32_t rowCount);
+
     //!
     //! \brief  Lock surface
     //!
@@ -589,11 +628,13 @@ public:
     //!         Ddi media surface
     //! \param  [in] flag
     //!         Flag
+    //! \param  [in] lazySwizzle
+    //!         Only set up the system shadow, rows are detiled on demand
     //!
     //! \return void*
     //!     Pointer to lock surface data
     //!
-    static void* LockSurfaceInternal(DDI_MEDIA_SURFACE *surface, uint32_t flag);
+    static void* LockSurfaceInternal(DDI_MEDIA_SURFACE *surface, uint32_t flag, bool lazySwizzle = false);
 
     //!
     //! \brief  Create Shadow Resource of Ddi media surface
@@ -660,6 +701,35 @@ public:
         uint8_t                    *pResourceBase, 
         bool                       bUpload);
 
+    //!
+    //! \brief  Swizzle a range of rows between surface and its linear copy
+    //!
+    //! \param  [in] mediaCtx
+    //!         Pointer to VA driver context
+    //! \param  [in] pGmmResInfo
+    //!         Gmm resource info
+    //! \param  [in] pLockedAddr
+    //!         Pointer to locked address
+    //! \param  [in] pResourceBase
+    //!         Pointer to the linear copy of the whole surface
+    //! \param  [in] rowOffset
+    //!         First row to swizzle
+    //! \param  [in] rowCount
+    //!         Number of rows to swizzle, clamped to the surface
+    //! \param  [in] bUpload
+    //!         Blt upload
+    //! \return     VAStatus
+    //!     VA_STATUS_SUCCESS if success, else fail reason
+    //!
+    static VAStatus SwizzleSurfaceRows(
+        PDDI_MEDIA_CONTEXT         mediaCtx,
+        PGMM_RESOURCE_INFO         pGmmResInfo,
+        void                       *pLockedAddr,
+        uint8_t                    *pResourceBase,
+        uint32_t                   rowOffset,
+        uint32_t                   rowCount,
+        bool                       bUpload);
+
     //!
     //! \brief  Create buffer
     //! 
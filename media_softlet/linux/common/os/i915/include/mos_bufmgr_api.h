@@ -411,6 +411,7 @@ drm_export int mos_bo_wait(struct mos_linux_bo *bo, int64_t timeout_ns);
 
 drm_export bool mos_bo_is_softpin(struct mos_linux_bo *bo);
 drm_export bool mos_bo_is_exec_object_async(struct mos_linux_bo *bo);
+drm_export bool mos_bo_is_mapped_wc(struct mos_linux_bo *bo);
 #if defined(__cplusplus)
 }
 #endif
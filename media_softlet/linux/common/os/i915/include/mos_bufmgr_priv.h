@@ -366,6 +366,7 @@ struct mos_bufmgr {
                                    unsigned int flags, int *fence);
     bool (*bo_is_exec_object_async)(struct mos_linux_bo *bo);
     bool (*bo_is_softpin)(struct mos_linux_bo *bo);
+    bool (*bo_is_mapped_wc)(struct mos_linux_bo *bo);
     int (*bo_map_gtt)(struct mos_linux_bo *bo);
     int (*bo_unmap_gtt)(struct mos_linux_bo *bo);
     int (*bo_map_wc)(struct mos_linux_bo *bo);
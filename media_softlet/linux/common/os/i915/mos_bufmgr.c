@@ -41,6 +41,7 @@
 #include "xf86drm.h"
 #include "xf86atomic.h"
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -115,9 +116,22 @@
 
 #define INITIAL_SOFTPIN_TARGET_COUNT  1024
 
+/* BO reuse cache: smallest power of two bucket with quarter steps, how long
+ * a cached bo is kept, how often the cache is scanned and its total size cap.
+ */
+#define BO_CACHE_POW2_MIN_SHIFT       14
+#define BO_CACHE_MAX_AGE_MS           1000
+#define BO_CACHE_CLEANUP_INTERVAL_MS  100
+#define BO_CACHE_MAX_SIZE             (512ul * 1024 * 1024)
+
 struct mos_gem_bo_bucket {
     drmMMListHead head;
     unsigned long size;
+
+    /* reuse statistics, reported on bufmgr destroy */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
 };
 
 struct mos_bufmgr_gem {
@@ -137,10 +151,23 @@ struct mos_bufmgr_gem {
     int exec_size;
     int exec_count;
 
+    /** Arrays reused by do_exec3, only ever grown to the high water mark */
+    struct drm_i915_gem_exec_object2 *exec3_objects;
+    int exec3_objects_size;
+    struct drm_i915_gem_exec_object2 *exec3_batch_objects;
+    int exec3_batch_objects_size;
+    struct drm_i915_gem_relocation_entry *exec3_relocs;
+    int exec3_relocs_size;
+    /** Bumped per do_exec3 call, bos already in exec3_objects carry the current value */
+    uint64_t exec3_generation;
+
     /** Array of lists of cached gem objects of power-of-two sizes */
     struct mos_gem_bo_bucket cache_bucket[14 * 4];
     int num_buckets;
+    /** Monotonic time of the last cache cleanup, in ms */
     time_t time;
+    /** Total size of the bos held in cache_bucket */
+    unsigned long cache_size;
 
     drmMMListHead managers;
 
@@ -173,6 +200,8 @@ struct mos_bufmgr_gem {
     mos_vma_heap vma_heap[MEMZONE_COUNT];
     bool use_softpin;
     bool softpin_va1Malign;
+    /** Softpin target count of the last cleared batch, sizes new target lists */
+    int last_softpin_target_count;
 
     bool object_capture_disabled;
 
@@ -219,6 +248,11 @@ struct mos_bo_gem {
      */
     int validate_index;
 
+    /**
+     * do_exec3 generation in which the buffer was added to the exec object list
+     */
+    uint64_t exec3_generation;
+
     /**
      * Current tiling mode
      */
@@ -242,6 +276,16 @@ struct mos_bo_gem {
     int softpin_target_count;
     /** Maximum amount of softpinned BOs that are referenced by this buffer */
     int max_softpin_target_count;
+    /**
+     * Last buffer whose softpin target list got this buffer added, and the
+     * index there. Lets mos_gem_bo_add_softpin_target find duplicates
+     * without walking the list. Reset when the owner's list is released,
+     * so a non-null owner always lists this buffer at softpin_owner_index.
+     */
+    struct mos_linux_bo *softpin_owner;
+    int softpin_owner_index;
+    /** Number of softpin target lists this buffer is on */
+    int softpin_list_count;
 
     /** Mapped address for the buffer, saved across map/unmap cycles */
     void *mem_virtual;
@@ -364,15 +408,12 @@ struct mos_exec_info {
     struct drm_i915_gem_exec_object2* obj;
     /* save batch buffer*/
     struct drm_i915_gem_exec_object2* batch_obj;
-    /* save previous ptr to void mem leak when free*/
-    struct drm_i915_gem_exec_object2* pSavePreviousExec2Objects;
     /*bo resource count*/
     uint32_t obj_count;
     /*batch buffer bo count*/
     uint32_t batch_count;
-    /*remain size of 'obj'*/
-    uint32_t obj_remain_size;
-#define      OBJ512_SIZE    512
+    /*relocation entry count copied for all batch buffers*/
+    uint32_t reloc_count;
 };
 
 static unsigned int
@@ -459,15 +500,42 @@ mos_gem_bo_bucket_for_size(struct mos_bufmgr_gem *bufmgr_gem,
 {
     int i;
 
-    for (i = 0; i < bufmgr_gem->num_buckets; i++) {
-        struct mos_gem_bo_bucket *bucket =
-            &bufmgr_gem->cache_bucket[i];
-        if (bucket->size >= size) {
-            return bucket;
-        }
+    /* Computed from the layout built by init_cache_buckets: 1, 2 and 3
+     * pages, then each power of two from 4 pages with 3 quarter steps
+     * between it and the next one.
+     */
+    if (size <= (1ul << BO_CACHE_POW2_MIN_SHIFT)) {
+        i = size <= 4096 ? 0 : (int)((size - 1) / 4096);
+    } else {
+        int shift = (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl(size - 1);
+        unsigned long quarter = 1ul << (shift - 2);
+        int step = (int)((size - (1ul << shift) + quarter - 1) / quarter);
+        i = 3 + (shift - BO_CACHE_POW2_MIN_SHIFT) * 4 + step;
     }
 
-    return nullptr;
+    if (i >= bufmgr_gem->num_buckets)
+        return nullptr;
+
+    assert(bufmgr_gem->cache_bucket[i].size >= size);
+    assert(i == 0 || bufmgr_gem->cache_bucket[i - 1].size < size);
+    return &bufmgr_gem->cache_bucket[i];
+}
+
+static inline time_t
+mos_gem_get_time_ms(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+
+/* Take a bo out of the reuse cache */
+static inline void
+mos_gem_bo_cache_del(struct mos_bufmgr_gem *bufmgr_gem, struct mos_bo_gem *bo_gem)
+{
+    DRMLISTDEL(&bo_gem->head);
+    bufmgr_gem->cache_size -= bo_gem->bo.size;
 }
 
 static void
@@ -887,7 +955,8 @@ mos_gem_bo_cache_purge_bucket(struct mos_bufmgr_gem *bufmgr_gem,
             (bufmgr_gem, bo_gem, I915_MADV_DONTNEED))
             break;
 
-        DRMLISTDEL(&bo_gem->head);
+        mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
+        bucket->evictions++;
         mos_gem_bo_free(&bo_gem->bo);
     }
 }
@@ -1069,7 +1138,7 @@ retry:
              */
             bo_gem = DRMLISTENTRY(struct mos_bo_gem,
                           bucket->head.prev, head);
-            DRMLISTDEL(&bo_gem->head);
+            mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
             alloc_from_cache = true;
             bo_gem->bo.align = alignment;
         } else {
@@ -1085,7 +1154,7 @@ retry:
                           bucket->head.next, head);
             if (!mos_gem_bo_busy(&bo_gem->bo)) {
                 alloc_from_cache = true;
-                DRMLISTDEL(&bo_gem->head);
+                mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
             }
         }
 
@@ -1114,6 +1183,12 @@ retry:
             }
         }
     }
+    if (bucket != nullptr) {
+        if (alloc_from_cache)
+            bucket->hits++;
+        else
+            bucket->misses++;
+    }
     pthread_mutex_unlock(&bufmgr_gem->lock);
 
     if (!alloc_from_cache) {
@@ -1674,13 +1749,17 @@ mos_gem_bo_mark_mmaps_incoherent(struct mos_linux_bo *bo)
 #endif
 }
 
-/** Frees all cached buffers significantly older than @time. */
+/** Frees all cached buffers older than BO_CACHE_MAX_AGE_MS at @time (ms),
+ * then the oldest buffers of the largest buckets while the cache is above
+ * BO_CACHE_MAX_SIZE.
+ */
 static void
 mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
 {
     int i;
 
-    if (bufmgr_gem->time == time)
+    if (time - bufmgr_gem->time < BO_CACHE_CLEANUP_INTERVAL_MS &&
+        bufmgr_gem->cache_size <= BO_CACHE_MAX_SIZE)
         return;
 
     for (i = 0; i < bufmgr_gem->num_buckets; i++) {
@@ -1692,10 +1771,29 @@ mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
 
             bo_gem = DRMLISTENTRY(struct mos_bo_gem,
                           bucket->head.next, head);
-            if (time - bo_gem->free_time <= 1)
+            if (time - bo_gem->free_time <= BO_CACHE_MAX_AGE_MS)
                 break;
 
-            DRMLISTDEL(&bo_gem->head);
+            mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
+            bucket->evictions++;
+
+            mos_gem_bo_free(&bo_gem->bo);
+        }
+    }
+
+    for (i = bufmgr_gem->num_buckets - 1;
+         i >= 0 && bufmgr_gem->cache_size > BO_CACHE_MAX_SIZE; i--) {
+        struct mos_gem_bo_bucket *bucket =
+            &bufmgr_gem->cache_bucket[i];
+
+        while (!DRMLISTEMPTY(&bucket->head) &&
+               bufmgr_gem->cache_size > BO_CACHE_MAX_SIZE) {
+            struct mos_bo_gem *bo_gem;
+
+            bo_gem = DRMLISTENTRY(struct mos_bo_gem,
+                          bucket->head.next, head);
+            mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
+            bucket->evictions++;
 
             mos_gem_bo_free(&bo_gem->bo);
         }
@@ -1704,6 +1802,18 @@ mos_gem_cleanup_bo_cache(struct mos_bufmgr_gem *bufmgr_gem, time_t time)
     bufmgr_gem->time = time;
 }
 
+/* Takes target_bo off the softpin target list of bo, before the list's
+ * reference on it is dropped. */
+static void
+mos_gem_bo_release_softpin_target(struct mos_linux_bo *bo, struct mos_linux_bo *target_bo)
+{
+    struct mos_bo_gem *target_bo_gem = (struct mos_bo_gem *) target_bo;
+
+    target_bo_gem->softpin_list_count--;
+    if (target_bo_gem->softpin_owner == bo)
+        target_bo_gem->softpin_owner = nullptr;
+}
+
 drm_export void
 mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
 {
@@ -1720,9 +1830,11 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
                                   time);
         }
     }
-    for (i = 0; i < bo_gem->softpin_target_count; i++)
+    for (i = 0; i < bo_gem->softpin_target_count; i++) {
+        mos_gem_bo_release_softpin_target(bo, bo_gem->softpin_target[i].bo);
         mos_gem_bo_unreference_locked_timed(bo_gem->softpin_target[i].bo,
                                   time);
+    }
     bo_gem->reloc_count = 0;
     bo_gem->used_as_reloc_target = false;
     bo_gem->softpin_target_count = 0;
@@ -1767,6 +1879,7 @@ mos_gem_bo_unreference_final(struct mos_linux_bo *bo, time_t time)
         bo_gem->validate_index = -1;
 
         DRMLISTADDTAIL(&bo_gem->head, &bucket->head);
+        bufmgr_gem->cache_size += bo->size;
     } else {
         mos_gem_bo_free(bo);
     }
@@ -1791,15 +1904,13 @@ static void mos_gem_bo_unreference(struct mos_linux_bo *bo)
     if (atomic_add_unless(&bo_gem->refcount, -1, 1)) {
         struct mos_bufmgr_gem *bufmgr_gem =
             (struct mos_bufmgr_gem *) bo->bufmgr;
-        struct timespec time;
-
-        clock_gettime(CLOCK_MONOTONIC, &time);
+        time_t time = mos_gem_get_time_ms();
 
         pthread_mutex_lock(&bufmgr_gem->lock);
 
         if (atomic_dec_and_test(&bo_gem->refcount)) {
-            mos_gem_bo_unreference_final(bo, time.tv_sec);
-            mos_gem_cleanup_bo_cache(bufmgr_gem, time.tv_sec);
+            mos_gem_bo_unreference_final(bo, time);
+            mos_gem_cleanup_bo_cache(bufmgr_gem, time);
         }
 
         pthread_mutex_unlock(&bufmgr_gem->lock);
@@ -2454,6 +2565,30 @@ mos_gem_bo_start_gtt_access(struct mos_linux_bo *bo, int write_enable)
     }
 }
 
+/* Report the reuse statistics of a bucket to the debug output and the memory profiler log */
+static void
+mos_gem_bo_cache_report_bucket(struct mos_bufmgr_gem *bufmgr_gem,
+                    struct mos_gem_bo_bucket *bucket)
+{
+    if (bucket->hits == 0 && bucket->misses == 0 && bucket->evictions == 0)
+        return;
+
+    MOS_DBG("bo_cache: bucket %lu, hits %lu, misses %lu, evictions %lu\n",
+        bucket->size, (unsigned long)bucket->hits,
+        (unsigned long)bucket->misses, (unsigned long)bucket->evictions);
+
+    if (bufmgr_gem->mem_profiler_fd != -1)
+    {
+        snprintf(bufmgr_gem->mem_profiler_buffer, MEM_PROFILER_BUFFER_SIZE, "BO_CACHE, %d, %lu, %lu, %lu, %lu\n", getpid(), bucket->size,
+            (unsigned long)bucket->hits, (unsigned long)bucket->misses, (unsigned long)bucket->evictions);
+        int ret = write(bufmgr_gem->mem_profiler_fd, bufmgr_gem->mem_profiler_buffer, strnlen(bufmgr_gem->mem_profiler_buffer, MEM_PROFILER_BUFFER_SIZE));
+        if (ret == -1)
+        {
+            MOS_DBG("Failed to write to %s: %s\n", bufmgr_gem->mem_profiler_path, strerror(errno));
+        }
+    }
+}
+
 static void
 mos_bufmgr_gem_destroy(struct mos_bufmgr *bufmgr)
 {
@@ -2464,6 +2599,9 @@ mos_bufmgr_gem_destroy(struct mos_bufmgr *bufmgr)
     free(bufmgr_gem->exec2_objects);
     free(bufmgr_gem->exec_objects);
     free(bufmgr_gem->exec_bos);
+    free(bufmgr_gem->exec3_objects);
+    free(bufmgr_gem->exec3_batch_objects);
+    free(bufmgr_gem->exec3_relocs);
     pthread_mutex_destroy(&bufmgr_gem->lock);
 
     /* Free any cached buffer objects we were going to reuse */
@@ -2472,10 +2610,12 @@ mos_bufmgr_gem_destroy(struct mos_bufmgr *bufmgr)
             &bufmgr_gem->cache_bucket[i];
         struct mos_bo_gem *bo_gem;
 
+        mos_gem_bo_cache_report_bucket(bufmgr_gem, bucket);
+
         while (!DRMLISTEMPTY(&bucket->head)) {
             bo_gem = DRMLISTENTRY(struct mos_bo_gem,
                           bucket->head.next, head);
-            DRMLISTDEL(&bo_gem->head);
+            mos_gem_bo_cache_del(bufmgr_gem, bo_gem);
 
             mos_gem_bo_free(&bo_gem->bo);
         }
@@ -2655,12 +2795,51 @@ mos_gem_bo_add_softpin_target(struct mos_linux_bo *bo, struct mos_linux_bo *targ
     if (target_bo_gem == bo_gem)
         return -EINVAL;
 
+    int flags = EXEC_OBJECT_PINNED;
+    if (target_bo_gem->pad_to_size)
+        flags |= EXEC_OBJECT_PAD_TO_SIZE;
+    if (target_bo_gem->use_48b_address_range)
+        flags |= EXEC_OBJECT_SUPPORTS_48B_ADDRESS;
+    if (target_bo_gem->exec_async)
+        flags |= EXEC_OBJECT_ASYNC;
+    if (target_bo_gem->exec_capture)
+        flags |= EXEC_OBJECT_CAPTURE;
+    if (write_flag)
+        flags |= EXEC_OBJECT_WRITE;
+
+    /* Already a target of this bo: merge the flags, as do_exec3 would do
+     * for the duplicated exec object, instead of adding another entry. */
+    int index = -1;
+    if (target_bo_gem->softpin_owner == bo) {
+        index = target_bo_gem->softpin_owner_index;
+        assert(bo_gem->softpin_target[index].bo == target_bo);
+    } else if (target_bo_gem->softpin_list_count > 1 ||
+               (target_bo_gem->softpin_list_count == 1 && target_bo_gem->softpin_owner == nullptr)) {
+        /* Target is also on another live list, e.g. a secondary batch, so
+         * the owner doesn't tell whether this bo lists it too. Otherwise it
+         * is on no list or only on its owner's one, and can't be a duplicate. */
+        for (int i = 0; i < bo_gem->softpin_target_count; i++) {
+            if (bo_gem->softpin_target[i].bo == target_bo) {
+                index = i;
+                break;
+            }
+        }
+    }
+    if (index >= 0) {
+        bo_gem->softpin_target[index].flags |= flags;
+        target_bo_gem->softpin_owner = bo;
+        target_bo_gem->softpin_owner_index = index;
+        return 0;
+    }
+
     if (bo_gem->softpin_target_count == bo_gem->max_softpin_target_count) {
         int max_softpin_target_count = bo_gem->max_softpin_target_count * 2;
 
-        /* initial softpin target count*/
+        /* initial softpin target count, large enough for the last batch */
         if (max_softpin_target_count == 0){
             max_softpin_target_count = INITIAL_SOFTPIN_TARGET_COUNT;
+            while (max_softpin_target_count < bufmgr_gem->last_softpin_target_count)
+                max_softpin_target_count *= 2;
         }
 
         bo_gem->softpin_target = (struct mos_softpin_target *)realloc(bo_gem->softpin_target, max_softpin_target_count *
@@ -2671,21 +2850,12 @@ mos_gem_bo_add_softpin_target(struct mos_linux_bo *bo, struct mos_linux_bo *targ
         bo_gem->max_softpin_target_count = max_softpin_target_count;
     }
 
-    int flags = EXEC_OBJECT_PINNED;
-    if (target_bo_gem->pad_to_size)
-        flags |= EXEC_OBJECT_PAD_TO_SIZE;
-    if (target_bo_gem->use_48b_address_range)
-        flags |= EXEC_OBJECT_SUPPORTS_48B_ADDRESS;
-    if (target_bo_gem->exec_async)
-        flags |= EXEC_OBJECT_ASYNC;
-    if (target_bo_gem->exec_capture)
-        flags |= EXEC_OBJECT_CAPTURE;
-    if (write_flag)
-        flags |= EXEC_OBJECT_WRITE;
-
     bo_gem->softpin_target[bo_gem->softpin_target_count].bo = target_bo;
     bo_gem->softpin_target[bo_gem->softpin_target_count].flags = flags;
     mos_gem_bo_reference(target_bo);
+    target_bo_gem->softpin_owner = bo;
+    target_bo_gem->softpin_owner_index = bo_gem->softpin_target_count;
+    target_bo_gem->softpin_list_count++;
     bo_gem->softpin_target_count++;
 
     return 0;
@@ -2810,9 +2980,7 @@ mos_gem_bo_clear_relocs(struct mos_linux_bo *bo, int start)
     struct mos_bufmgr_gem *bufmgr_gem = (struct mos_bufmgr_gem *) bo->bufmgr;
     struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
     int i;
-    struct timespec time;
-
-    clock_gettime(CLOCK_MONOTONIC, &time);
+    time_t time = mos_gem_get_time_ms();
 
     assert(bo_gem->reloc_count >= start);
 
@@ -2826,15 +2994,18 @@ mos_gem_bo_clear_relocs(struct mos_linux_bo *bo, int start)
             target_bo_gem->used_as_reloc_target = false;
             target_bo_gem->reloc_count = 0;
             mos_gem_bo_unreference_locked_timed(&target_bo_gem->bo,
-                                  time.tv_sec);
+                                  time);
         }
     }
     bo_gem->reloc_count = start;
 
     for (i = 0; i < bo_gem->softpin_target_count; i++) {
         struct mos_bo_gem *target_bo_gem = (struct mos_bo_gem *) bo_gem->softpin_target[i].bo;
-        mos_gem_bo_unreference_locked_timed(&target_bo_gem->bo, time.tv_sec);
+        mos_gem_bo_release_softpin_target(bo, &target_bo_gem->bo);
+        mos_gem_bo_unreference_locked_timed(&target_bo_gem->bo, time);
     }
+    if (bo_gem->softpin_target_count > 0)
+        bufmgr_gem->last_softpin_target_count = bo_gem->softpin_target_count;
     bo_gem->softpin_target_count = 0;
 
     pthread_mutex_unlock(&bufmgr_gem->lock);
@@ -2888,8 +3059,11 @@ mos_gem_bo_process_reloc2(struct mos_linux_bo *bo)
 
         mos_gem_bo_mark_mmaps_incoherent(bo);
 
-        /* Continue walking the tree depth-first. */
-        mos_gem_bo_process_reloc2(target_bo);
+        /* Continue walking the tree depth-first. A target already on the
+         * validate list had its own targets added before it.
+         */
+        if (to_bo_gem(target_bo)->validate_index == -1)
+            mos_gem_bo_process_reloc2(target_bo);
 
         /* Add the target to the validate list */
         mos_add_reloc_objects(bo_gem->reloc_target_info[i]);
@@ -2902,7 +3076,8 @@ mos_gem_bo_process_reloc2(struct mos_linux_bo *bo)
             continue;
 
         mos_gem_bo_mark_mmaps_incoherent(bo);
-        mos_gem_bo_process_reloc2(target_bo);
+        if (to_bo_gem(target_bo)->validate_index == -1)
+            mos_gem_bo_process_reloc2(target_bo);
         mos_add_softpin_objects(bo_gem->softpin_target[i]);
     }
 }
@@ -3092,6 +3267,28 @@ skip_execution:
     return ret;
 }
 
+/* Grow a do_exec3 array to hold at least count elements. Arrays are never
+ * shrunk, so steady state submissions do not allocate.
+ */
+static int
+mos_gem_exec3_reserve(void **array, int *size, uint64_t count, size_t elem_size)
+{
+    if (count <= (uint64_t)*size)
+        return 0;
+
+    uint64_t new_size = ((uint64_t)*size * 2 > count) ? (uint64_t)*size * 2 : count;
+    if (new_size > INT_MAX)
+        return -ENOMEM;
+
+    void *new_array = realloc(*array, new_size * elem_size);
+    if (new_array == nullptr)
+        return -ENOMEM;
+
+    *array = new_array;
+    *size = (int)new_size;
+    return 0;
+}
+
 static int
 do_exec3(struct mos_linux_bo **bo, int _num_bo, struct mos_linux_context *ctx,
      drm_clip_rect_t *cliprects, int num_cliprects, int DR4,
@@ -3114,19 +3311,15 @@ do_exec3(struct mos_linux_bo **bo, int _num_bo, struct mos_linux_context *ctx,
 
     struct mos_exec_info exec_info;
     memset(static_cast<void*>(&exec_info), 0, sizeof(exec_info));
-    exec_info.batch_obj = (struct drm_i915_gem_exec_object2 *) calloc (num_bo, sizeof(struct drm_i915_gem_exec_object2));
-    if(exec_info.batch_obj == nullptr)
-    {
-        ret = -ENOMEM;
-        goto skip_execution;
-    }
-    exec_info.obj_remain_size = OBJ512_SIZE;
-    exec_info.obj = (struct drm_i915_gem_exec_object2 *) calloc (OBJ512_SIZE, sizeof(struct drm_i915_gem_exec_object2));
-    if(exec_info.obj == nullptr)
+    bufmgr_gem->exec3_generation++;
+
+    if (mos_gem_exec3_reserve((void **)&bufmgr_gem->exec3_batch_objects, &bufmgr_gem->exec3_batch_objects_size,
+            num_bo, sizeof(struct drm_i915_gem_exec_object2)) != 0)
     {
         ret = -ENOMEM;
         goto skip_execution;
     }
+    exec_info.batch_obj = bufmgr_gem->exec3_batch_objects;
 
     for(i = 0; i < num_bo; i++)
     {
@@ -3144,63 +3337,49 @@ do_exec3(struct mos_linux_bo **bo, int _num_bo, struct mos_linux_context *ctx,
          */
         mos_add_validate_buffer2(bo[i], 0);
 
-        if((bufmgr_gem->exec_count - 1 + num_bo) > exec_info.obj_remain_size)
-        {
-            // origin size + OBJ512_SIZE + obj_count + batch_count;
-            uint32_t new_obj_size = exec_info.obj_count + exec_info.obj_remain_size + OBJ512_SIZE + bufmgr_gem->exec_count - 1 + num_bo;
-            struct drm_i915_gem_exec_object2 *new_obj = (struct drm_i915_gem_exec_object2 *)realloc(exec_info.obj, new_obj_size * sizeof(struct drm_i915_gem_exec_object2));
-            if(new_obj == nullptr)
-            {
-                ret = -ENOMEM;
-                goto skip_execution;
-            }
-            exec_info.obj_remain_size = new_obj_size - exec_info.obj_count;
-            exec_info.obj = new_obj;
-        }
-        if(0 == i)
+        // room for this batch's targets plus all batch objects appended at the end
+        if (mos_gem_exec3_reserve((void **)&bufmgr_gem->exec3_objects, &bufmgr_gem->exec3_objects_size,
+                exec_info.obj_count + bufmgr_gem->exec_count - 1 + num_bo, sizeof(struct drm_i915_gem_exec_object2)) != 0)
         {
-            uint32_t cp_size = (bufmgr_gem->exec_count - 1) * sizeof(struct drm_i915_gem_exec_object2);
-            memcpy(exec_info.obj, bufmgr_gem->exec2_objects, cp_size);
-            exec_info.obj_count += (bufmgr_gem->exec_count - 1);
-            exec_info.obj_remain_size -= (bufmgr_gem->exec_count - 1);
+            ret = -ENOMEM;
+            goto skip_execution;
         }
-        else
+        exec_info.obj = bufmgr_gem->exec3_objects;
+
+        for(int e = 0; e < bufmgr_gem->exec_count - 1; e++)
         {
-            for(int e2 = 0; e2 < bufmgr_gem->exec_count - 1; e2++)
+            struct mos_bo_gem *target_gem = to_bo_gem(bufmgr_gem->exec_bos[e]);
+
+            // skip the bo if a previous batch already added it to exec_info.obj
+            if (target_gem->exec3_generation == bufmgr_gem->exec3_generation)
             {
-                int e1;
-                for(e1 = 0; e1 < exec_info.obj_count; e1++)
-                {
-                    // skip the duplicated bo if it is already in the list of exec_info.obj
-                    if(bufmgr_gem->exec2_objects[e2].handle == exec_info.obj[e1].handle)
-                    {
-                        break;
-                    }
-                }
-                //if no duplicated bo found, add it into list of exec_info.obj
-                if(e1 == exec_info.obj_count)
-                {
-                    exec_info.obj[exec_info.obj_count] = bufmgr_gem->exec2_objects[e2];
-                    exec_info.obj_count++;
-                    exec_info.obj_remain_size--;
-                }
+                continue;
             }
+            target_gem->exec3_generation = bufmgr_gem->exec3_generation;
+            exec_info.obj[exec_info.obj_count] = bufmgr_gem->exec2_objects[e];
+            exec_info.obj_count++;
         }
         memcpy(&exec_info.batch_obj[i], &bufmgr_gem->exec2_objects[bufmgr_gem->exec_count - 1], sizeof(struct drm_i915_gem_exec_object2));
         exec_info.batch_count++;
         uint32_t reloc_count = bufmgr_gem->exec2_objects[bufmgr_gem->exec_count - 1].relocation_count;
-        uint32_t cp_size = (reloc_count * sizeof(struct drm_i915_gem_relocation_entry));
-        
-        struct drm_i915_gem_relocation_entry* ptr_reloc = (struct drm_i915_gem_relocation_entry *)calloc(reloc_count,sizeof(struct drm_i915_gem_relocation_entry));
-        if(ptr_reloc == nullptr)
+
+        if (mos_gem_exec3_reserve((void **)&bufmgr_gem->exec3_relocs, &bufmgr_gem->exec3_relocs_size,
+                exec_info.reloc_count + reloc_count, sizeof(struct drm_i915_gem_relocation_entry)) != 0)
         {
             ret = -ENOMEM;
             goto skip_execution;
         }
-        memcpy(ptr_reloc, (struct drm_i915_gem_relocation_entry *)bufmgr_gem->exec2_objects[bufmgr_gem->exec_count - 1].relocs_ptr, cp_size);
+        if (reloc_count)
+        {
+            memcpy(&bufmgr_gem->exec3_relocs[exec_info.reloc_count],
+                (struct drm_i915_gem_relocation_entry *)bufmgr_gem->exec2_objects[bufmgr_gem->exec_count - 1].relocs_ptr,
+                reloc_count * sizeof(struct drm_i915_gem_relocation_entry));
+        }
 
-        exec_info.batch_obj[i].relocs_ptr = (uintptr_t)ptr_reloc;
+        // store the offset for now, exec3_relocs may still move while later batches are added
+        exec_info.batch_obj[i].relocs_ptr = exec_info.reloc_count;
         exec_info.batch_obj[i].relocation_count = reloc_count;
+        exec_info.reloc_count += reloc_count;
 
         //clear bo
         if (bufmgr_gem->bufmgr.debug)
@@ -3226,19 +3405,15 @@ do_exec3(struct mos_linux_bo **bo, int _num_bo, struct mos_linux_context *ctx,
     //add back batch obj to the last position
     for(i = 0; i < num_bo; i++)
     {
+       exec_info.batch_obj[i].relocs_ptr = exec_info.batch_obj[i].relocation_count ?
+           (uintptr_t)&bufmgr_gem->exec3_relocs[exec_info.batch_obj[i].relocs_ptr] : 0;
        exec_info.obj[exec_info.obj_count] = exec_info.batch_obj[i];
        exec_info.obj_count++;
-       exec_info.obj_remain_size--;
     }
 
-    //save previous ptr
-    exec_info.pSavePreviousExec2Objects = bufmgr_gem->exec2_objects;
-    bufmgr_gem->exec_count = exec_info.obj_count;
-    bufmgr_gem->exec2_objects = exec_info.obj;
-
     memclear(execbuf);
-    execbuf.buffers_ptr = (uintptr_t)bufmgr_gem->exec2_objects;
-    execbuf.buffer_count = bufmgr_gem->exec_count;
+    execbuf.buffers_ptr = (uintptr_t)exec_info.obj;
+    execbuf.buffer_count = exec_info.obj_count;
     execbuf.batch_start_offset = 0;
     execbuf.cliprects_ptr = (uintptr_t)cliprects;
     execbuf.num_cliprects = num_cliprects;
@@ -3269,18 +3444,14 @@ do_exec3(struct mos_linux_bo **bo, int _num_bo, struct mos_linux_context *ctx,
     if (ret != 0) {
         ret = -errno;
         if (ret == -ENOSPC) {
+            /* The validate list is already cleared, only the object count is left to report */
             MOS_DBG("Execbuffer fails to pin. "
-                "Estimate: %u. Actual: %u. Available: %u\n",
-                mos_gem_estimate_batch_space(bufmgr_gem->exec_bos,
-                                   bufmgr_gem->exec_count),
-                mos_gem_compute_batch_space(bufmgr_gem->exec_bos,
-                                  bufmgr_gem->exec_count),
+                "Objects: %u. Available: %u\n",
+                exec_info.obj_count,
                 (unsigned int) bufmgr_gem->gtt_size);
         }
     }
 
-    bufmgr_gem->exec2_objects = exec_info.pSavePreviousExec2Objects;
-
     if(flags & I915_EXEC_FENCE_OUT)
     {
         *fence = execbuf.rsvd2 >> 32;
@@ -3290,16 +3461,17 @@ skip_execution:
     if (bufmgr_gem->bufmgr.debug)
         mos_gem_dump_validation_list(bufmgr_gem);
 
-    bufmgr_gem->exec_count = 0;
-    if(exec_info.batch_obj)
-    {
-        for(i = 0; i < num_bo; i++)
+    /* Disconnect whatever an early exit left on the validate list */
+    for (i = 0; i < bufmgr_gem->exec_count; i++) {
+        struct mos_bo_gem *bo_gem = to_bo_gem(bufmgr_gem->exec_bos[i]);
+
+        if (bo_gem)
         {
-            mos_safe_free((struct drm_i915_gem_relocation_entry *)exec_info.batch_obj[i].relocs_ptr);
+            bo_gem->validate_index = -1;
+            bufmgr_gem->exec_bos[i] = nullptr;
         }
     }
-    mos_safe_free(exec_info.obj);
-    mos_safe_free(exec_info.batch_obj);
+    bufmgr_gem->exec_count = 0;
     pthread_mutex_unlock(&bufmgr_gem->lock);
 
     return ret;
@@ -4918,6 +5090,18 @@ static bool mos_gem_bo_is_softpin(struct mos_linux_bo *bo)
     return bo_gem->is_softpin;
 }
 
+static bool mos_gem_bo_is_mapped_wc(struct mos_linux_bo *bo)
+{
+    struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
+    if (bo_gem == nullptr || bo->virt == nullptr)
+    {
+        return false;
+    }
+
+    // GTT and WC mmaps are write-combined, CPU and userptr mappings are write-back
+    return bo->virt == bo_gem->gtt_virtual || bo->virt == bo_gem->mem_wc_virtual;
+}
+
 static bool
 mos_gem_bo_is_exec_object_async(struct mos_linux_bo *bo)
 {
@@ -5183,6 +5367,7 @@ mos_bufmgr_gem_init_i915(int fd, int batch_size)
     bufmgr_gem->bufmgr.bo_context_exec3 = mos_gem_bo_context_exec3;
     bufmgr_gem->bufmgr.bo_is_exec_object_async = mos_gem_bo_is_exec_object_async;
     bufmgr_gem->bufmgr.bo_is_softpin = mos_gem_bo_is_softpin;
+    bufmgr_gem->bufmgr.bo_is_mapped_wc = mos_gem_bo_is_mapped_wc;
     bufmgr_gem->bufmgr.bo_map_gtt = mos_gem_bo_map_gtt;
     bufmgr_gem->bufmgr.bo_unmap_gtt = mos_gem_bo_unmap_gtt;
     bufmgr_gem->bufmgr.bo_map_wc = mos_gem_bo_map_wc;
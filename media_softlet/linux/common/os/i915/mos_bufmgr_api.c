@@ -855,6 +855,26 @@ mos_bo_is_exec_object_async(struct mos_linux_bo *bo)
     }
 }
 
+drm_export bool
+mos_bo_is_mapped_wc(struct mos_linux_bo *bo)
+{
+    if(!bo)
+    {
+        MOS_OS_CRITICALMESSAGE("Input null ptr\n");
+        return false;
+    }
+
+    if (bo->bufmgr && bo->bufmgr->bo_is_mapped_wc)
+    {
+        return bo->bufmgr->bo_is_mapped_wc(bo);
+    }
+    else
+    {
+        // Assume the slowest mapping when the type is unknown
+        return true;
+    }
+}
+
 drm_export bool
 mos_bo_is_softpin(struct mos_linux_bo *bo)
 {
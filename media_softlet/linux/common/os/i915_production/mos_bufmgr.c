@@ -4963,6 +4963,18 @@ static bool mos_gem_bo_is_softpin(struct mos_linux_bo *bo)
     return bo_gem->is_softpin;
 }
 
+static bool mos_gem_bo_is_mapped_wc(struct mos_linux_bo *bo)
+{
+    struct mos_bo_gem *bo_gem = (struct mos_bo_gem *) bo;
+    if (bo_gem == nullptr || bo->virt == nullptr)
+    {
+        return false;
+    }
+
+    // GTT and WC mmaps are write-combined, CPU and userptr mappings are write-back
+    return bo->virt == bo_gem->gtt_virtual || bo->virt == bo_gem->mem_wc_virtual;
+}
+
 static bool
 mos_gem_bo_is_exec_object_async(struct mos_linux_bo *bo)
 {
@@ -5227,6 +5239,7 @@ mos_bufmgr_gem_init_i915(int fd, int batch_size)
     bufmgr_gem->bufmgr.bo_context_exec3 = mos_gem_bo_context_exec3;
     bufmgr_gem->bufmgr.bo_is_exec_object_async = mos_gem_bo_is_exec_object_async;
     bufmgr_gem->bufmgr.bo_is_softpin = mos_gem_bo_is_softpin;
+    bufmgr_gem->bufmgr.bo_is_mapped_wc = mos_gem_bo_is_mapped_wc;
     bufmgr_gem->bufmgr.bo_map_gtt = mos_gem_bo_map_gtt;
     bufmgr_gem->bufmgr.bo_unmap_gtt = mos_gem_bo_unmap_gtt;
     bufmgr_gem->bufmgr.bo_map_wc = mos_gem_bo_map_wc;
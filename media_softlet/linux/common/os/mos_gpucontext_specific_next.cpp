@@ -581,6 +581,17 @@ MOS_STATUS GpuContextSpecificNext::Init(OsContextNext *osContext,
     m_writeModeList = (bool *)MOS_AllocAndZeroMemory(sizeof(bool) * ALLOCATIONLIST_SIZE);
     MOS_OS_CHK_NULL_RETURN(m_writeModeList);
 
+    // Keep the load factor of the bo hash at most 1/2
+    uint32_t hashSize = 1;
+    while (hashSize < 2 * ALLOCATIONLIST_SIZE)
+    {
+        hashSize <<= 1;
+    }
+    m_resHashTable = (ResourceHashEntry *)MOS_AllocAndZeroMemory(sizeof(ResourceHashEntry) * hashSize);
+    MOS_OS_CHK_NULL_RETURN(m_resHashTable);
+    m_resHashMask       = hashSize - 1;
+    m_resHashGeneration = 1;
+
     m_GPUStatusTag = 1;
 
     StoreCreateOptions(createOption);
@@ -700,6 +711,8 @@ void GpuContextSpecificNext::Clear()
     m_attachedResources = nullptr;
     MOS_SafeFreeMemory(m_writeModeList);
     m_writeModeList = nullptr;
+    MOS_SafeFreeMemory(m_resHashTable);
+    m_resHashTable = nullptr;
 
     for (int i=0; i<MAX_ENGINE_INSTANCE_NUM; i++)
     {
@@ -713,6 +726,34 @@ void GpuContextSpecificNext::Clear()
                       nullptr, 0, nullptr, 0);
 }
 
+uint32_t GpuContextSpecificNext::FindResourceHashSlot(MOS_LINUX_BO *bo)
+{
+    // Fibonacci hashing of the bo address, low bits are always zero
+    uint32_t slot = (uint32_t)((((uint64_t)(uintptr_t)bo >> 4) * 0x9E3779B97F4A7C15ull) >> 32) & m_resHashMask;
+
+    while (m_resHashTable[slot].generation == m_resHashGeneration &&
+           m_resHashTable[slot].bo != bo)
+    {
+        slot = (slot + 1) & m_resHashMask;
+    }
+
+    return slot;
+}
+
+void GpuContextSpecificNext::ResetResourceHash()
+{
+    m_resHashGeneration++;
+    if (m_resHashGeneration == 0)
+    {
+        // Generation wrapped around, stale entries could look valid again
+        if (m_resHashTable)
+        {
+            MosUtilities::MosZeroMemory(m_resHashTable, sizeof(ResourceHashEntry) * (m_resHashMask + 1));
+        }
+        m_resHashGeneration = 1;
+    }
+}
+
 MOS_STATUS GpuContextSpecificNext::RegisterResource(
     PMOS_RESOURCE osResource,
     bool          writeFlag)
@@ -722,17 +763,17 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
     MOS_OS_CHK_NULL_RETURN(osResource);
 
     MOS_OS_CHK_NULL_RETURN(m_attachedResources);
+    MOS_OS_CHK_NULL_RETURN(m_resHashTable);
 
-    PMOS_RESOURCE registeredResources = m_attachedResources;
-    uint32_t      allocationIndex     = 0;
+#if (_DEBUG || _RELEASE_INTERNAL)
+    double startTime = MosUtilities::MosGetTime();
+    m_regResCount++;
+#endif
 
-    for ( allocationIndex = 0; allocationIndex < m_resCount; allocationIndex++, registeredResources++)
-    {
-        if (osResource->bo == registeredResources->bo)
-        {
-            break;
-        }
-    }
+    uint32_t           slot            = FindResourceHashSlot(osResource->bo);
+    ResourceHashEntry *entry           = &m_resHashTable[slot];
+    bool               registered      = (entry->generation == m_resHashGeneration);
+    uint32_t           allocationIndex = registered ? entry->allocationIndex : m_resCount;
 
     // Allocation list to be updated
     if (allocationIndex < m_maxNumAllocations)
@@ -741,6 +782,9 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
         if (allocationIndex == m_resCount)
         {
             m_resCount++;
+            entry->bo              = osResource->bo;
+            entry->allocationIndex = allocationIndex;
+            entry->generation      = m_resHashGeneration;
         }
 
         // Set allocation
@@ -751,7 +795,19 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
         }
 
         osResource->iAllocationIndex[m_gpuContext] = (allocationIndex);
-        m_attachedResources[allocationIndex]           = *osResource;
+        // Same resource registered again, the slot already holds an identical copy
+        if (!registered ||
+            memcmp(&m_attachedResources[allocationIndex], osResource, sizeof(MOS_RESOURCE)) != 0)
+        {
+            m_attachedResources[allocationIndex] = *osResource;
+        }
+#if (_DEBUG || _RELEASE_INTERNAL)
+        else
+        {
+            m_regResCopySkipped++;
+        }
+        m_regResNewCount += registered ? 0 : 1;
+#endif
         m_writeModeList[allocationIndex] |= writeFlag;
         m_allocationList[allocationIndex].hAllocation = &m_attachedResources[allocationIndex];
         m_allocationList[allocationIndex].WriteOperation |= writeFlag;
@@ -763,6 +819,10 @@ MOS_STATUS GpuContextSpecificNext::RegisterResource(
         return MOS_STATUS_UNKNOWN;
     }
 
+#if (_DEBUG || _RELEASE_INTERNAL)
+    m_regResTime += MosUtilities::MosGetTime() - startTime;
+#endif
+
     return MOS_STATUS_SUCCESS;
 }
 
@@ -1682,6 +1742,16 @@ if (streamState->dumpCommandBuffer)
     m_currentNumPatchLocations = 0;
     MosUtilities::MosZeroMemory(m_patchLocationList, sizeof(PATCHLOCATIONLIST) * m_maxNumAllocations);
     m_resCount = 0;
+    ResetResourceHash();
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    MOS_OS_VERBOSEMESSAGE("RegisterResource: %u calls, %u allocations, %u copies skipped, %.2f us.",
+        m_regResCount, m_regResNewCount, m_regResCopySkipped, m_regResTime);
+    m_regResCount       = 0;
+    m_regResNewCount    = 0;
+    m_regResCopySkipped = 0;
+    m_regResTime        = 0;
+#endif
 
     MosUtilities::MosZeroMemory(m_writeModeList, sizeof(bool) * m_maxNumAllocations);
 finish:
@@ -1922,6 +1992,7 @@ void GpuContextSpecificNext::ResetGpuContextStatus()
 
     MosUtilities::MosZeroMemory(m_attachedResources, sizeof(MOS_RESOURCE) * ALLOCATIONLIST_SIZE);
     m_resCount = 0;
+    ResetResourceHash();
 
     MosUtilities::MosZeroMemory(m_writeModeList, sizeof(bool) * ALLOCATIONLIST_SIZE);
 
@@ -331,6 +331,21 @@ protected:
 
     void UnlockPendingOcaBuffers(PMOS_COMMAND_BUFFER cmdBuffer, PMOS_CONTEXT mosContext);
 
+    //!
+    //! \brief    Find the hash slot of a bo in resource registrations
+    //! \return   uint32_t
+    //!           Slot holding the bo in current registrations, or the empty
+    //!           slot where it should be inserted
+    //!
+    uint32_t FindResourceHashSlot(MOS_LINUX_BO *bo);
+
+    //!
+    //! \brief    Drop all bo to allocation index mappings
+    //! \details  Done by bumping the generation, so the table is not touched
+    //! \return   void
+    //!
+    void ResetResourceHash();
+
 protected:
     //! \brief    internal command buffer pool per gpu context
     std::vector<CommandBufferNext *> m_cmdBufPool;
@@ -369,6 +384,25 @@ protected:
     PMOS_RESOURCE m_attachedResources = nullptr;  //!< Pointer to resources list
     bool         *m_writeModeList     = nullptr;  //!< Write mode
 
+    //! \brief    Open addressing bo to allocation index map for current registrations
+    struct ResourceHashEntry
+    {
+        MOS_LINUX_BO *bo;
+        uint32_t      allocationIndex;
+        uint32_t      generation;  //!< Entry is valid only if equal to m_resHashGeneration
+    };
+    ResourceHashEntry *m_resHashTable      = nullptr;
+    uint32_t           m_resHashMask       = 0;
+    uint32_t           m_resHashGeneration = 1;
+
+#if (_DEBUG || _RELEASE_INTERNAL)
+    //! \brief    Resource registration counters of the current submission
+    uint32_t m_regResCount        = 0;  //!< RegisterResource calls
+    uint32_t m_regResNewCount     = 0;  //!< Calls adding a new allocation
+    uint32_t m_regResCopySkipped  = 0;  //!< Calls which skipped the resource copy
+    double   m_regResTime         = 0;  //!< Time spent in RegisterResource in us
+#endif
+
     //! \brief    GPU Status tag
     uint32_t m_GPUStatusTag = 0;
 
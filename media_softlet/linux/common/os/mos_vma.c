@@ -31,6 +31,8 @@ mos_vma_heap_init(mos_vma_heap *heap, uint64_t start, uint64_t size)
 {
     assert(heap);
     list_inithead(&heap->holes);
+    heap->root = NULL;
+    heap->seed = 0x9e3779b9;
     mos_vma_heap_free(heap, start, size);
 
     /* Default to using high addresses */
@@ -45,6 +47,275 @@ mos_vma_heap_finish(mos_vma_heap *heap)
     {
         free(hole);
     }
+    heap->root = NULL;
+}
+
+/* The holes are kept both in an address ordered list, used for validation
+ * and for walking adjacent holes, and in a treap keyed by offset. Each tree
+ * node carries the largest hole size of its subtree, which lets the
+ * allocator skip whole subtrees of holes that are too small while still
+ * returning the same hole a high-to-low (or low-to-high) list walk would.
+ *
+ * Size alone does not prune aligned allocations: a 4KB buffer placed at 64KB
+ * alignment leaves a 60KB hole that is large enough but can never hold
+ * another 64KB aligned buffer. Each node therefore also carries, for the
+ * alignment classes, the largest size its subtree can allocate aligned.
+ */
+static inline uint64_t
+mos_vma_hole_aligned_size(mos_vma_hole *hole, uint64_t alignment)
+{
+    uint64_t misalign = hole->offset & (alignment - 1);
+    uint64_t pad = misalign ? alignment - misalign : 0;
+    return pad <= hole->size ? hole->size - pad : 0;
+}
+
+static inline void
+mos_vma_hole_merge_child(mos_vma_hole *hole, mos_vma_hole *child)
+{
+    if (child == NULL)
+        return;
+    if (child->max_size > hole->max_size)
+        hole->max_size = child->max_size;
+    for (int i = 0; i < MOS_VMA_ALIGN_CLASS_COUNT; i++) {
+        if (child->max_aligned_size[i] > hole->max_aligned_size[i])
+            hole->max_aligned_size[i] = child->max_aligned_size[i];
+    }
+}
+
+static inline void
+mos_vma_hole_update(mos_vma_hole *hole)
+{
+    hole->max_size = hole->size;
+    for (int i = 0; i < MOS_VMA_ALIGN_CLASS_COUNT; i++)
+        hole->max_aligned_size[i] =
+            mos_vma_hole_aligned_size(hole, 1ull << MOS_VMA_ALIGN_CLASS_SHIFT(i));
+
+    mos_vma_hole_merge_child(hole, hole->left);
+    mos_vma_hole_merge_child(hole, hole->right);
+}
+
+/* Largest alignment class the alignment is a multiple of, or -1 */
+static inline int
+mos_vma_align_class(uint64_t alignment)
+{
+    for (int i = MOS_VMA_ALIGN_CLASS_COUNT - 1; i >= 0; i--) {
+        if (alignment % (1ull << MOS_VMA_ALIGN_CLASS_SHIFT(i)) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/* Upper bound of the size a subtree can allocate in the alignment class */
+static inline uint64_t
+mos_vma_hole_subtree_max(mos_vma_hole *hole, int align_class)
+{
+    if (hole == NULL)
+        return 0;
+    return align_class < 0 ? hole->max_size : hole->max_aligned_size[align_class];
+}
+
+static mos_vma_hole *
+mos_vma_tree_rotate_right(mos_vma_hole *hole)
+{
+    mos_vma_hole *left = hole->left;
+    hole->left = left->right;
+    left->right = hole;
+    mos_vma_hole_update(hole);
+    mos_vma_hole_update(left);
+    return left;
+}
+
+static mos_vma_hole *
+mos_vma_tree_rotate_left(mos_vma_hole *hole)
+{
+    mos_vma_hole *right = hole->right;
+    hole->right = right->left;
+    right->left = hole;
+    mos_vma_hole_update(hole);
+    mos_vma_hole_update(right);
+    return right;
+}
+
+static mos_vma_hole *
+mos_vma_tree_insert(mos_vma_hole *root, mos_vma_hole *hole)
+{
+    if (root == NULL) {
+        hole->left = hole->right = NULL;
+        mos_vma_hole_update(hole);
+        return hole;
+    }
+
+    if (hole->offset < root->offset) {
+        root->left = mos_vma_tree_insert(root->left, hole);
+        if (root->left->priority > root->priority)
+            return mos_vma_tree_rotate_right(root);
+    } else {
+        root->right = mos_vma_tree_insert(root->right, hole);
+        if (root->right->priority > root->priority)
+            return mos_vma_tree_rotate_left(root);
+    }
+
+    mos_vma_hole_update(root);
+    return root;
+}
+
+static mos_vma_hole *
+mos_vma_tree_remove(mos_vma_hole *root, mos_vma_hole *hole)
+{
+    assert(root);
+
+    if (root == hole) {
+        if (root->left == NULL)
+            return root->right;
+        if (root->right == NULL)
+            return root->left;
+
+        /* Rotate the hole down until it has at most one child */
+        if (root->left->priority > root->right->priority) {
+            root = mos_vma_tree_rotate_right(root);
+            root->right = mos_vma_tree_remove(root->right, hole);
+        } else {
+            root = mos_vma_tree_rotate_left(root);
+            root->left = mos_vma_tree_remove(root->left, hole);
+        }
+    } else if (hole->offset < root->offset) {
+        root->left = mos_vma_tree_remove(root->left, hole);
+    } else {
+        root->right = mos_vma_tree_remove(root->right, hole);
+    }
+
+    mos_vma_hole_update(root);
+    return root;
+}
+
+/* Refresh max_size on the path to a hole whose size, or whose offset within
+ * its neighbours, changed in place.
+ */
+static void
+mos_vma_tree_update_path(mos_vma_hole *root, mos_vma_hole *hole)
+{
+    assert(root);
+
+    if (root != hole) {
+        if (hole->offset < root->offset)
+            mos_vma_tree_update_path(root->left, hole);
+        else
+            mos_vma_tree_update_path(root->right, hole);
+    }
+
+    mos_vma_hole_update(root);
+}
+
+/* Highest hole that can hold the aligned allocation, and its offset */
+static mos_vma_hole *
+mos_vma_tree_find_high(mos_vma_hole *root, uint64_t size, uint64_t alignment, int align_class, uint64_t *offset)
+{
+    if (mos_vma_hole_subtree_max(root, align_class) < size)
+        return NULL;
+
+    mos_vma_hole *hole = mos_vma_tree_find_high(root->right, size, alignment, align_class, offset);
+    if (hole)
+        return hole;
+
+    if (size <= root->size) {
+        /* Compute the offset as the highest address where a chunk of the
+        * given size can be without going over the top of the hole.
+        *
+        * This calculation is known to not overflow because we know that
+        * hole->size + hole->offset can only overflow to 0 and size > 0.
+        */
+        uint64_t high_offset = (root->size - size) + root->offset;
+
+        /* Align the offset.  We align down and not up because we are
+        * allocating from the top of the hole and not the bottom.
+        */
+        high_offset = (high_offset / alignment) * alignment;
+
+        if (high_offset >= root->offset) {
+            *offset = high_offset;
+            return root;
+        }
+    }
+
+    return mos_vma_tree_find_high(root->left, size, alignment, align_class, offset);
+}
+
+/* Lowest hole that can hold the aligned allocation, and its offset */
+static mos_vma_hole *
+mos_vma_tree_find_low(mos_vma_hole *root, uint64_t size, uint64_t alignment, int align_class, uint64_t *offset)
+{
+    if (mos_vma_hole_subtree_max(root, align_class) < size)
+        return NULL;
+
+    mos_vma_hole *hole = mos_vma_tree_find_low(root->left, size, alignment, align_class, offset);
+    if (hole)
+        return hole;
+
+    if (size <= root->size) {
+        uint64_t low_offset = root->offset;
+
+        /* Align the offset */
+        uint64_t misalign = low_offset % alignment;
+        uint64_t pad = misalign ? alignment - misalign : 0;
+        if (pad <= root->size - size) {
+            *offset = low_offset + pad;
+            return root;
+        }
+    }
+
+    return mos_vma_tree_find_low(root->right, size, alignment, align_class, offset);
+}
+
+/* Hole with the highest offset that is <= offset */
+static mos_vma_hole *
+mos_vma_tree_find_floor(mos_vma_hole *root, uint64_t offset)
+{
+    mos_vma_hole *floor = NULL;
+    while (root) {
+        if (root->offset <= offset) {
+            floor = root;
+            root = root->right;
+        } else {
+            root = root->left;
+        }
+    }
+    return floor;
+}
+
+/* Hole with the lowest offset that is > offset */
+static mos_vma_hole *
+mos_vma_tree_find_above(mos_vma_hole *root, uint64_t offset)
+{
+    mos_vma_hole *above = NULL;
+    while (root) {
+        if (root->offset > offset) {
+            above = root;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+    return above;
+}
+
+static mos_vma_hole *
+mos_vma_hole_create(mos_vma_heap *heap, uint64_t offset, uint64_t size)
+{
+    mos_vma_hole *hole = (mos_vma_hole*)calloc(1, sizeof(*hole));
+    if (hole == nullptr)
+        return nullptr;
+
+    hole->offset = offset;
+    hole->size = size;
+
+    /* xorshift32 */
+    heap->seed ^= heap->seed << 13;
+    heap->seed ^= heap->seed >> 17;
+    heap->seed ^= heap->seed << 5;
+    hole->priority = heap->seed;
+
+    heap->root = mos_vma_tree_insert(heap->root, hole);
+    return hole;
 }
 
 #ifdef _DEBUG
@@ -85,14 +356,16 @@ mos_vma_heap_validate(mos_vma_heap *heap)
 #endif
 
 static void
-mos_vma_hole_alloc(mos_vma_hole *hole, uint64_t offset, uint64_t size)
+mos_vma_hole_alloc(mos_vma_heap *heap, mos_vma_hole *hole, uint64_t offset, uint64_t size)
 {
+    assert(heap);
     assert(hole);
     assert(hole->offset <= offset);
     assert(hole->size >= offset - hole->offset + size);
 
     if (offset == hole->offset && size == hole->size) {
         /* Just get rid of the hole. */
+        heap->root = mos_vma_tree_remove(heap->root, hole);
         list_del(&hole->link);
         free(hole);
         return;
@@ -102,6 +375,7 @@ mos_vma_hole_alloc(mos_vma_hole *hole, uint64_t offset, uint64_t size)
     if (waste == 0) {
         /* We allocated at the top.  Shrink the hole down. */
         hole->size -= size;
+        mos_vma_tree_update_path(heap->root, hole);
         return;
     }
 
@@ -109,13 +383,14 @@ mos_vma_hole_alloc(mos_vma_hole *hole, uint64_t offset, uint64_t size)
         /* We allocated at the bottom. Shrink the hole up. */
         hole->offset += size;
         hole->size -= size;
+        mos_vma_tree_update_path(heap->root, hole);
         return;
     }
 
     /* We allocated in the middle.  We need to split the old hole into two
     * holes, one high and one low.
     */
-    mos_vma_hole *high_hole = (mos_vma_hole*)calloc(1, sizeof(*hole));
+    mos_vma_hole *high_hole = mos_vma_hole_create(heap, offset + size, waste);
     if(high_hole == nullptr)
     {
         assert(high_hole);
@@ -123,13 +398,11 @@ mos_vma_hole_alloc(mos_vma_hole *hole, uint64_t offset, uint64_t size)
         return;
     }
 
-    high_hole->offset = offset + size;
-    high_hole->size = waste;
-
     /* Adjust the hole to be the amount of space left at he bottom of the
     * original hole.
     */
     hole->size = offset - hole->offset;
+    mos_vma_tree_update_path(heap->root, hole);
 
     /* Place the new hole before the old hole so that the list is in order
     * from high to low.
@@ -147,53 +420,15 @@ mos_vma_heap_alloc(mos_vma_heap *heap, uint64_t size, uint64_t alignment)
 
     mos_vma_heap_validate(heap);
 
-    if (heap->alloc_high) {
-        list_for_each_entry_safe(mos_vma_hole, hole, &heap->holes, link)
-        {
-            if (size > hole->size)
-                continue;
-
-            /* Compute the offset as the highest address where a chunk of the
-            * given size can be without going over the top of the hole.
-            *
-            * This calculation is known to not overflow because we know that
-            * hole->size + hole->offset can only overflow to 0 and size > 0.
-            */
-            uint64_t offset = (hole->size - size) + hole->offset;
-
-            /* Align the offset.  We align down and not up because we are
-            * allocating from the top of the hole and not the bottom.
-            */
-            offset = (offset / alignment) * alignment;
-
-            if (offset < hole->offset)
-            continue;
-
-            mos_vma_hole_alloc(hole, offset, size);
-            mos_vma_heap_validate(heap);
-            return offset;
-        }
-    } else {
-        list_for_each_entry_safe_rev(mos_vma_hole, hole, &heap->holes, link) {
-            if (size > hole->size)
-                continue;
-
-            uint64_t offset = hole->offset;
-
-            /* Align the offset */
-            uint64_t misalign = offset % alignment;
-            if (misalign) {
-                uint64_t pad = alignment - misalign;
-                if (pad > hole->size - size)
-                    continue;
-
-                offset += pad;
-            }
-
-            mos_vma_hole_alloc(hole, offset, size);
-            mos_vma_heap_validate(heap);
-            return offset;
-        }
+    uint64_t offset = 0;
+    int align_class = mos_vma_align_class(alignment);
+    mos_vma_hole *hole = heap->alloc_high ?
+        mos_vma_tree_find_high(heap->root, size, alignment, align_class, &offset) :
+        mos_vma_tree_find_low(heap->root, size, alignment, align_class, &offset);
+    if (hole) {
+        mos_vma_hole_alloc(heap, hole, offset, size);
+        mos_vma_heap_validate(heap);
+        return offset;
     }
 
     /* Failed to allocate */
@@ -217,26 +452,22 @@ mos_vma_heap_alloc_addr(mos_vma_heap *heap, uint64_t offset, uint64_t size)
     */
     assert(offset + size == 0 || offset + size > offset);
 
-    /* Find the hole if one exists. */
-    list_for_each_entry_safe(mos_vma_hole, hole, &heap->holes, link)
-    {
-        if (hole->offset > offset)
-            continue;
-
-        /* Holes are ordered high-to-low so the first hole we find with
-        * hole->offset <= is our hole.  If it's not big enough to contain the
-        * requested range, then the allocation fails.
-        */
-        assert(hole->offset <= offset);
-        if (hole->size < offset - hole->offset + size)
-            return false;
-
-        mos_vma_hole_alloc(hole, offset, size);
-        return true;
+    /* Find the hole if one exists.  The highest hole with
+    * hole->offset <= offset is our hole.  If it's not big enough to contain
+    * the requested range, then the allocation fails.
+    */
+    mos_vma_hole *hole = mos_vma_tree_find_floor(heap->root, offset);
+    if (hole == NULL) {
+        /* We didn't find a suitable hole */
+        return false;
     }
 
-    /* We didn't find a suitable hole */
-    return false;
+    assert(hole->offset <= offset);
+    if (hole->size < offset - hole->offset + size)
+        return false;
+
+    mos_vma_hole_alloc(heap, hole, offset, size);
+    return true;
 }
 
 void
@@ -259,15 +490,8 @@ mos_vma_heap_free(mos_vma_heap *heap, uint64_t offset, uint64_t size)
     mos_vma_heap_validate(heap);
 
     /* Find immediately higher and lower holes if they exist. */
-    mos_vma_hole *high_hole = NULL, *low_hole = NULL;
-    list_for_each_entry(mos_vma_hole, hole, &heap->holes, link)
-    {
-        if (hole->offset <= offset) {
-            low_hole = hole;
-            break;
-        }
-        high_hole = hole;
-    }
+    mos_vma_hole *high_hole = mos_vma_tree_find_above(heap->root, offset);
+    mos_vma_hole *low_hole = mos_vma_tree_find_floor(heap->root, offset);
 
     if (high_hole)
     {
@@ -285,24 +509,25 @@ mos_vma_heap_free(mos_vma_heap *heap, uint64_t offset, uint64_t size)
     if (low_adjacent && high_adjacent) {
         /* Merge the two holes */
         low_hole->size += size + high_hole->size;
+        heap->root = mos_vma_tree_remove(heap->root, high_hole);
+        mos_vma_tree_update_path(heap->root, low_hole);
         list_del(&high_hole->link);
         free(high_hole);
     } else if (low_adjacent) {
         /* Merge into the low hole */
         low_hole->size += size;
+        mos_vma_tree_update_path(heap->root, low_hole);
     } else if (high_adjacent) {
-        /* Merge into the high hole */
+        /* Merge into the high hole, it stays ordered between its neighbours */
         high_hole->offset = offset;
         high_hole->size += size;
+        mos_vma_tree_update_path(heap->root, high_hole);
     } else {
         /* Neither hole is adjacent; make a new one */
-        mos_vma_hole *hole = (mos_vma_hole*)calloc(1, sizeof(*hole));
+        mos_vma_hole *hole = mos_vma_hole_create(heap, offset, size);
         assert(hole);
         if(hole)
         {
-            hole->offset = offset;
-            hole->size = size;
-
             /* Add it after the high hole so we maintain high-to-low ordering */
             if (high_hole)
                 list_add(&hole->link, &high_hole->link);
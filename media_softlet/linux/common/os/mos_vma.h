@@ -37,9 +37,25 @@
 extern "C" {
 #endif
 
+struct _mos_vma_hole;
+
+/** Alignments for which the hole tree tracks the largest allocatable size,
+ * 64KB and 1MB, the alignments mos_bufmgr softpins buffers at
+ */
+#define MOS_VMA_ALIGN_CLASS_COUNT    2
+#define MOS_VMA_ALIGN_CLASS_SHIFT(i) (16 + 4 * (i))
+
 typedef struct _mos_vma_heap {
    struct list_head holes;
 
+   /** Root of the hole tree, ordered by address and augmented with the
+    * largest hole size of each subtree
+    */
+   struct _mos_vma_hole *root;
+
+   /** Random state for the tree priorities */
+   uint32_t seed;
+
    /** If true, util_vma_heap_alloc will prefer high addresses
     *
     * Default is true.
@@ -51,6 +67,15 @@ typedef struct _mos_vma_hole {
    struct list_head link;
    uint64_t offset;
    uint64_t size;
+
+   /** Treap links, keyed by offset */
+   struct _mos_vma_hole *left;
+   struct _mos_vma_hole *right;
+   /** Largest hole size within this subtree */
+   uint64_t max_size;
+   /** Largest size this subtree can allocate at each alignment class */
+   uint64_t max_aligned_size[MOS_VMA_ALIGN_CLASS_COUNT];
+   uint32_t priority;
 } mos_vma_hole;
 
 //!
@@ -29,6 +29,12 @@ set(TMP_HEADERS_
     ${CMAKE_BINARY_DIR}/mos_compat.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_utilities_specific.h
     ${CMAKE_CURRENT_LIST_DIR}/mos_util_debug_specific.h
+    ${CMAKE_CURRENT_LIST_DIR}/mos_utilities_sse4_impl.h
+)
+
+set(SOURCES_SSE4
+    ${SOURCES_SSE4}
+    ${CMAKE_CURRENT_LIST_DIR}/mos_utilities_sse4_impl.cpp
 )
 
 set(SOFTLET_MOS_COMMON_SOURCES_
@@ -43,6 +43,7 @@
 #include "mos_compat.h" // libc variative definitions: backtrace
 #include "mos_user_setting.h"
 #include "mos_utilities_specific.h"
+#include "mos_utilities_sse4_impl.h"
 #include "mos_utilities.h"
 #include "mos_util_debug.h"
 #include "inttypes.h"
@@ -208,6 +209,43 @@ MOS_STATUS MosUtilities::MosSecureMemcpy(void  *pDestination, size_t dstLength,
     return MOS_STATUS_SUCCESS;
 }
 
+MOS_STATUS MosUtilities::MosSecureMemcpyFromWC(void  *pDestination, size_t dstLength, PCVOID pSource, size_t srcLength, bool fence)
+{
+#ifdef MOS_SSE4_IMPL_AVAILABLE
+    static const bool isSse41Supported = __builtin_cpu_supports("sse4.1");
+#else
+    static const bool isSse41Supported = false;
+#endif
+
+    if ( (pDestination == nullptr) || (pSource == nullptr) )
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    if ( dstLength < srcLength )
+    {
+        return MOS_STATUS_INVALID_PARAMETER;
+    }
+
+    if (pDestination == pSource)
+    {
+        return MOS_STATUS_SUCCESS;
+    }
+
+#ifdef MOS_SSE4_IMPL_AVAILABLE
+    // Short copies don't fill a streaming load buffer
+    if (isSse41Supported && srcLength >= MOS_WC_COPY_MIN_SIZE)
+    {
+        MosMemcpyFromWC_SSE4(pDestination, pSource, srcLength, fence);
+        return MOS_STATUS_SUCCESS;
+    }
+#endif
+
+    memcpy(pDestination, pSource, srcLength);
+
+    return MOS_STATUS_SUCCESS;
+}
+
 MOS_STATUS MosUtilities::MosSecureFileOpen(
     FILE       **ppFile,
     const char *filename,
@@ -2777,49 +2815,11 @@ void MosUtilities::MosMMPWriteFile(
     ofs.write(static_cast<const char *>(data), size);
 }
 #endif  //(_DEBUG || _RELEASE_INTERNAL)
-void PerfUtility::startTick(std::string tag)
-{
-    std::lock_guard<std::mutex> lock(perfMutex);
-    Tick newTick = {};
-    struct timespec ts = {};
-
-    // get start tick count
-    clock_gettime(CLOCK_REALTIME, &ts);
-    newTick.start = int(ts.tv_sec * 1000000) + int(ts.tv_nsec / 1000); // us
-
-    std::vector<Tick> *perf = nullptr;
-    std::map<std::string, std::vector<Tick>*>::iterator it;
-    it = records.find(tag);
-    if (it == records.end())
-    {
-        perf = new std::vector<Tick>;
-        perf->push_back(newTick);
-        records[tag] = perf;
-    }
-    else
-    {
-        it->second->push_back(newTick);
-    }
-}
-
-void PerfUtility::stopTick(std::string tag)
+int64_t PerfUtility::getTimeNs()
 {
-    std::lock_guard<std::mutex> lock(perfMutex);
     struct timespec ts = {};
-    std::map<std::string, std::vector<Tick>*>::iterator it;
-    it = records.find(tag);
-    if (it == records.end())
-    {
-        // should not happen
-        return;
-    }
-
-    // get stop tick count
-    clock_gettime(CLOCK_REALTIME, &ts);
-    it->second->back().stop = int(ts.tv_sec * 1000000) + int(ts.tv_nsec / 1000); // us
-
-    // calculate time interval
-    it->second->back().time = double(it->second->back().stop - it->second->back().start) / 1000.0; // ms
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
 }
 
 /*----------------------------------------------------------------------------
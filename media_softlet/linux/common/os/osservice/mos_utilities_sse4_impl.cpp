@@ -0,0 +1,93 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file        mos_utilities_sse4_impl.cpp
+//! \brief       SSE4.1 implementations of MOS memory utilities
+//!
+
+#include "mos_utilities_sse4_impl.h"
+
+#if defined(__SSE4_1__)
+
+#include <stdint.h>
+#include <string.h>
+#include <smmintrin.h>
+
+void MosMemcpyFromWC_SSE4(void *dst, const void *src, size_t bytes, bool fence)
+{
+    uint8_t       *tempDst = (uint8_t *)dst;
+    const uint8_t *tempSrc = (const uint8_t *)src;
+    size_t         count   = bytes;
+
+    // Streaming loads must be 16-byte aligned
+    size_t alignBytes = (16 - ((uintptr_t)tempSrc & 15)) & 15;
+    if (alignBytes > count)
+    {
+        alignBytes = count;
+    }
+    if (alignBytes)
+    {
+        memcpy(tempDst, tempSrc, alignBytes);
+        tempDst += alignBytes;
+        tempSrc += alignBytes;
+        count   -= alignBytes;
+    }
+
+    __m128i *mmSrc = (__m128i *)tempSrc;
+    __m128i *mmDst = (__m128i *)tempDst;
+    __m128i  xmm0, xmm1, xmm2, xmm3;
+
+    // Order the streaming loads after previous writes to WC memory
+    if (fence)
+    {
+        _mm_mfence();
+    }
+
+    // One 64-byte line per iteration fills a streaming load buffer
+    for (; count >= 64; count -= 64)
+    {
+        xmm0 = _mm_stream_load_si128(mmSrc);
+        xmm1 = _mm_stream_load_si128(mmSrc + 1);
+        xmm2 = _mm_stream_load_si128(mmSrc + 2);
+        xmm3 = _mm_stream_load_si128(mmSrc + 3);
+        mmSrc += 4;
+
+        _mm_storeu_si128(mmDst, xmm0);
+        _mm_storeu_si128(mmDst + 1, xmm1);
+        _mm_storeu_si128(mmDst + 2, xmm2);
+        _mm_storeu_si128(mmDst + 3, xmm3);
+        mmDst += 4;
+    }
+
+    for (; count >= 16; count -= 16)
+    {
+        _mm_storeu_si128(mmDst++, _mm_stream_load_si128(mmSrc++));
+    }
+
+    // Copy remaining bytes
+    if (count)
+    {
+        memcpy(mmDst, mmSrc, count);
+    }
+}
+
+#endif // __SSE4_1__
@@ -0,0 +1,52 @@
+/*
+* Copyright (c) 2024, Intel Corporation
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+* OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+//!
+//! \file        mos_utilities_sse4_impl.h
+//! \brief       SSE4.1 implementations of MOS memory utilities
+//!
+#ifndef __MOS_UTILITIES_SSE4_IMPL_H__
+#define __MOS_UTILITIES_SSE4_IMPL_H__
+
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MOS_SSE4_IMPL_AVAILABLE 1
+#endif
+
+#define MOS_WC_COPY_MIN_SIZE 64  // Copies below one cache line use plain memcpy
+
+//!
+//! \brief    Copy from write-combined memory with streaming loads
+//! \details  Uses MOVNTDQA, caller must check SSE4.1 support
+//! \param    [out] dst
+//!           Pointer to destination buffer
+//! \param    [in] src
+//!           Pointer to source buffer, usually write-combined
+//! \param    [in] bytes
+//!           Number of bytes to copy
+//! \param    [in] fence
+//!           Order the loads after earlier writes to write-combined memory
+//! \return   void
+//!
+void MosMemcpyFromWC_SSE4(void *dst, const void *src, size_t bytes, bool fence);
+
+#endif // __MOS_UTILITIES_SSE4_IMPL_H__
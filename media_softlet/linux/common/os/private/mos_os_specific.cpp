@@ -2765,6 +2765,28 @@ MOS_STATUS Mos_Specific_SkipResourceSync(
     return MOS_STATUS_SUCCESS;
 }
 
+//!
+//! \brief    Checks if GPU work submitted on a resource is still pending
+//! \details  Does not wait, a lock of an idle resource does not block
+//! \param    PMOS_INTERFACE osInterface
+//!           [in] Pointer to OS Interface
+//! \param    PMOS_RESOURCE osResource
+//!           [in] Pointer to OS Resource
+//! \return   bool
+//!           Return true if the resource is busy or unknown, false if idle
+//!
+bool Mos_Specific_IsResourceBusy(
+    PMOS_INTERFACE              osInterface,
+    PMOS_RESOURCE               osResource)
+{
+    if (osResource == nullptr || osResource->bo == nullptr)
+    {
+        return true;
+    }
+
+    return mos_bo_busy(osResource->bo) != 0;
+}
+
 //!
 //! \brief    Gets the HW rendering flags
 //! \details  Gets the HW rendering flags
@@ -3495,6 +3517,7 @@ MOS_STATUS Mos_Specific_LoadFunction(
     osInterface->pfnWaitForBBCompleteNotifyEvent  = Mos_Specific_WaitForBBCompleteNotifyEvent;
     osInterface->pfnCachePolicyGetMemoryObject    = Mos_Specific_CachePolicyGetMemoryObject;
     osInterface->pfnSkipResourceSync              = Mos_Specific_SkipResourceSync;
+    osInterface->pfnIsResourceBusy                = Mos_Specific_IsResourceBusy;
     osInterface->pfnIsGPUHung                     = Mos_Specific_IsGPUHung;
     osInterface->pfnGetAuxTableBaseAddr           = Mos_Specific_GetAuxTableBaseAddr;
     osInterface->pfnGetResourceIndex              = Mos_Specific_GetResourceIndex;